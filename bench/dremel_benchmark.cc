@@ -2,6 +2,7 @@
 // IMLAB
 // ---------------------------------------------------------------------------------------------------
 
+#include <atomic>
 #include <cstdint>
 #include <chrono>  // NOLINT
 #include <iostream>
@@ -77,7 +78,68 @@ void BM_Shredding_nLanguage(benchmark::State &state) {
     }
 
     for (auto _ : state) {
-        Shredder::DissectRecord(dynamic_cast<TableBase&>(document_table), document);
+        document_table.insert(document);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+/// Same as BM_Shredding_nLanguage, but with the generic shredder that walks the record via reflection.
+void BM_Shredding_Reflection_nLanguage(benchmark::State &state) {
+    imlab::schema::DocumentTable document_table {};
+
+    Document document {};
+    document.set_docid(0);
+    Document_Name* document_name = document.add_name();
+    for (int i = 0; i < state.range(0); i++) {
+        Document_Name_Language* document_name_language = document_name->add_language();
+        document_name_language->set_code("en-us");
+    }
+
+    for (auto _ : state) {
+        document_table.insert_reflection(document);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+/// Same as BM_Shredding_nLanguage, but the record arrives serialized and is parsed into a message first.
+void BM_Shredding_Parsed_nLanguage(benchmark::State &state) {
+    imlab::schema::DocumentTable document_table {};
+
+    Document document {};
+    document.set_docid(0);
+    Document_Name* document_name = document.add_name();
+    for (int i = 0; i < state.range(0); i++) {
+        Document_Name_Language* document_name_language = document_name->add_language();
+        document_name_language->set_code("en-us");
+    }
+    std::string bytes = document.SerializeAsString();
+
+    for (auto _ : state) {
+        Document parsed {};
+        parsed.ParseFromString(bytes);
+        document_table.insert(parsed);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+/// Same as BM_Shredding_Parsed_nLanguage, but the record is shredded straight from the wire format.
+void BM_Shredding_Serialized_nLanguage(benchmark::State &state) {
+    imlab::schema::DocumentTable document_table {};
+
+    Document document {};
+    document.set_docid(0);
+    Document_Name* document_name = document.add_name();
+    for (int i = 0; i < state.range(0); i++) {
+        Document_Name_Language* document_name_language = document_name->add_language();
+        document_name_language->set_code("en-us");
+    }
+    std::string bytes = document.SerializeAsString();
+
+    for (auto _ : state) {
+        document_table.insert_serialized(bytes);
     }
 
     state.SetItemsProcessed(state.iterations());
@@ -180,6 +242,33 @@ void BM_Assembly_Generated_Dataset_Singlethreaded(benchmark::State &state) {
     state.SetBytesProcessed(number_of_records * average_record_size);  // only rough estimation
 }
 
+/// Same as BM_Assembly_Generated_Dataset_Singlethreaded, but the records are assembled on an arena.
+void BM_Assembly_Generated_Dataset_Arena(benchmark::State &state) {
+    uint64_t number_of_records = 50 * 1024 * 1024 / state.range(0);  // ~ 50 MiB
+    uint64_t average_record_size = state.range(0);
+
+    std::string test_data_file = GenerateTestData(number_of_records, average_record_size);
+
+    imlab::Database db;
+    std::fstream dremel_file(test_data_file, std::fstream::in);
+    db.LoadDocumentTable(dremel_file);
+    assert(db.DocumentTable.size() == number_of_records);
+
+    for (auto _ : state) {
+        const auto& documents_read = db.DocumentTable.get_batch(0, db.DocumentTable.size(), {
+                DocId_Field,
+                Links_Backward_Field,
+                Links_Forward_Field,
+                Name_Language_Code_Field,
+                Name_Language_Country_Field,
+                Name_Url_Field
+        });
+    }
+
+    state.SetItemsProcessed(number_of_records);
+    state.SetBytesProcessed(number_of_records * average_record_size);  // only rough estimation
+}
+
 /// Measures the time it takes to assemble all records from a randomly generated dataset.
 /// You can pass the average record size in byte as an parameter of this benchmark.
 void BM_Assembly_Generated_Dataset_Multithreaded(benchmark::State &state) {
@@ -210,6 +299,38 @@ void BM_Assembly_Generated_Dataset_Multithreaded(benchmark::State &state) {
     state.SetBytesProcessed(number_of_records * average_record_size);  // only rough estimation
 }
 
+/// Same as BM_Assembly_Generated_Dataset_Multithreaded, but the records are assembled by a morsel scan:
+/// every worker sets up its readers once and assembles the records of its morsels into one reused message.
+void BM_Assembly_Generated_Dataset_Morsels(benchmark::State &state) {
+    uint64_t number_of_records = 50 * 1024 * 1024 / state.range(0);  // ~ 50 MiB
+    uint64_t average_record_size = state.range(0);
+
+    std::string test_data_file = GenerateTestData(number_of_records, average_record_size);
+
+    imlab::Database db;
+    std::fstream dremel_file(test_data_file, std::fstream::in);
+    db.LoadDocumentTable(dremel_file);
+    assert(db.DocumentTable.size() == number_of_records);
+
+    for (auto _ : state) {
+        std::atomic<uint64_t> docids = 0;
+        db.DocumentTable.scan_morsels({
+                DocId_Field,
+                Links_Backward_Field,
+                Links_Forward_Field,
+                Name_Language_Code_Field,
+                Name_Language_Country_Field,
+                Name_Url_Field
+        }, [&](uint64_t, const Document& record) {
+            docids.fetch_add(record.docid(), std::memory_order_relaxed);
+        });
+        benchmark::DoNotOptimize(docids.load());
+    }
+
+    state.SetItemsProcessed(number_of_records);
+    state.SetBytesProcessed(number_of_records * average_record_size);  // only rough estimation
+}
+
 /// I am NOT proud of how this benchmark is written.
 void BM_Apache_Drill_Json(benchmark::State &state) {
     uint64_t number_of_records = 50 * 1024 * 1024 / state.range(0);  // ~ 50 MiB
@@ -308,10 +429,15 @@ void BM_Apache_Drill_Parquet(benchmark::State &state) {
 
 BENCHMARK(BM_Construct_FSM_Fields)->DenseRange(1, 6);
 //BENCHMARK(BM_Shredding_nLanguage)->RangeMultiplier(2)->Range(1, 1024);
+//BENCHMARK(BM_Shredding_Reflection_nLanguage)->RangeMultiplier(2)->Range(1, 1024);
+//BENCHMARK(BM_Shredding_Parsed_nLanguage)->RangeMultiplier(2)->Range(1, 1024);
+//BENCHMARK(BM_Shredding_Serialized_nLanguage)->RangeMultiplier(2)->Range(1, 1024);
 //BENCHMARK(BM_Load_Generated_Dataset)->Iterations(2)->Unit(benchmark::kMillisecond);
 BENCHMARK(BM_Assemble_Document)->DenseRange(1, 6);
 BENCHMARK(BM_Assembly_Generated_Dataset_Singlethreaded)->Unit(benchmark::kMillisecond)->Iterations(5)->RangeMultiplier(2)->Range(64, 4096);
+//BENCHMARK(BM_Assembly_Generated_Dataset_Arena)->Unit(benchmark::kMillisecond)->Iterations(5)->RangeMultiplier(2)->Range(64, 4096);
 BENCHMARK(BM_Assembly_Generated_Dataset_Multithreaded)->Unit(benchmark::kMillisecond)->Iterations(5)->RangeMultiplier(2)->Range(64, 4096);
+BENCHMARK(BM_Assembly_Generated_Dataset_Morsels)->Unit(benchmark::kMillisecond)->Iterations(5)->RangeMultiplier(2)->Range(64, 4096);
 BENCHMARK(BM_Apache_Drill_Json)->Unit(benchmark::kMillisecond)->UseManualTime()->Iterations(5)->RangeMultiplier(2)->Range(64, 4096);
 BENCHMARK(BM_Apache_Drill_Parquet)->Unit(benchmark::kMillisecond)->UseManualTime()->Iterations(5)->RangeMultiplier(2)->Range(64, 4096);
 
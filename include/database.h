@@ -7,6 +7,7 @@
 
 #include <istream>
 #include <functional>
+#include <string>
 #include "./imlab/algebra/query.h"
 #include "../tools/protobuf/gen/schema.h"
 
@@ -23,8 +24,19 @@ class Database {
     /// Load data from JSON into DocumentTable.
     /// The underlying file format of the istream should be JSON.
     /// The JSON should be an array at the top level.
+    /// The records are shredded while the JSON is parsed (see dremel::ShredJson).
     void LoadDocumentTable(std::istream& in);
 
+    /// Load newline-delimited JSON (one record per line) into DocumentTable.
+    /// Chunks of the input are shredded in parallel.
+    void LoadDocumentTableJsonLines(std::istream& in);
+
+    /// Load a file of length-delimited serialized Documents into DocumentTable.
+    /// Every record is preceded by its size as a varint, the standard format for streams of Protobuf messages.
+    /// The file is memory-mapped and chunks of it are shredded in parallel, straight from the wire format.
+    void LoadDocumentTableProtobuf(const std::string& path);
+
+    /// Decode a JSON array of documents into Protobuf messages.
     static void DecodeJson(std::istream& in, const std::function<void (Document&)>& handler);
 
     QueryStats RunQuery(Query& query);
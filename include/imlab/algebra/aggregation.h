@@ -0,0 +1,78 @@
+// ---------------------------------------------------------------------------
+// IMLAB
+// ---------------------------------------------------------------------------
+#ifndef INCLUDE_IMLAB_ALGEBRA_AGGREGATION_H_
+#define INCLUDE_IMLAB_ALGEBRA_AGGREGATION_H_
+// ---------------------------------------------------------------------------
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "./operator.h"
+// ---------------------------------------------------------------------------
+namespace imlab {
+// ---------------------------------------------------------------------------
+// An aggregate function over the values of a leaf field, e.g. COUNT(Name.Language.Code)
+struct Aggregate {
+    enum class Function { kCount, kSum, kMin, kMax, kAvg };
+
+    // Function
+    Function function;
+    // Field whose values are aggregated; nullptr for COUNT(*), which counts records (with GROUP BY, their tuples)
+    const google::protobuf::FieldDescriptor* field;
+
+    // Name of the aggregate in the output, e.g. COUNT(Name.Language.Code)
+    std::string Name() const;
+};
+// ---------------------------------------------------------------------------
+class Aggregation: public Operator {
+ protected:
+    // Child operator
+    std::unique_ptr<Operator> child_;
+    // Aggregates
+    std::vector<Aggregate> aggregates_;
+    // Whether the values are aggregated per record (WITHIN RECORD) instead of over all records
+    bool within_record_;
+    // Fields whose values are passed on with the aggregates:
+    // WITHIN RECORD the values of the record, otherwise the fields to group by
+    std::vector<const google::protobuf::FieldDescriptor*> fields_;
+
+    // Required ius
+    std::vector<const google::protobuf::FieldDescriptor*> required_fields_;
+    // Consumer
+    Operator *consumer_;
+
+ public:
+    // Constructor; throws a QueryCompilationError if an aggregate doesn't fit the type of its field
+    Aggregation(std::unique_ptr<Operator> child, std::vector<Aggregate> aggregates, bool within_record = false,
+                std::vector<const google::protobuf::FieldDescriptor*> fields = {});
+
+    // Collect all IUs produced by the operator
+    std::vector<const google::protobuf::FieldDescriptor*> CollectFields() override;
+
+    // Prepare the operator
+    void Prepare(const std::vector<const google::protobuf::FieldDescriptor*> &required, Operator* consumer) override;
+    // Produce all tuples
+    void Produce(std::ostream& _o) override;
+    // Begin a task of the child's pipeline
+    void BeginTask(std::ostream& _o, const Operator* child) override;
+    // Consume tuple
+    void Consume(std::ostream& _o, const Operator* child) override;
+
+ private:
+    // Whether the records are grouped by the fields
+    bool Grouped() const { return !within_record_ && !fields_.empty(); }
+    // The distinct fields of the aggregates (nullptr for COUNT(*))
+    std::vector<const google::protobuf::FieldDescriptor*> AggregatedFields() const;
+    // The fields that are flattened with GROUP BY: the fields to group by, then the aggregated fields
+    std::vector<const google::protobuf::FieldDescriptor*> FlattenedFields() const;
+    // Generate the struct that holds the aggregates of a record, a thread or a group
+    void GenerateState(std::ostream& _o);
+    // Generate the code that adds the values of the current record to aggregation_state
+    void GenerateUpdate(std::ostream& _o);
+};
+// ---------------------------------------------------------------------------
+}  // namespace imlab
+// ---------------------------------------------------------------------------
+#endif  // INCLUDE_IMLAB_ALGEBRA_AGGREGATION_H_
+// ---------------------------------------------------------------------------
@@ -40,6 +40,12 @@ class InnerJoin: public Operator {
     void Prepare(const std::vector<const google::protobuf::FieldDescriptor*> &required, Operator* consumer) override;
     // Produce all tuples
     void Produce(std::ostream& _o) override;
+    // Begin a task of the child's pipeline; only the probe side (right) continues the pipeline of the consumer
+    void BeginTask(std::ostream& _o, const Operator* child) override {
+        if (child == right_child_.get()) {
+            consumer_->BeginTask(_o, this);
+        }
+    }
     // Consume tuple
     void Consume(std::ostream& _o, const Operator* child) override;
 
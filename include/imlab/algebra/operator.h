@@ -4,13 +4,63 @@
 #ifndef INCLUDE_IMLAB_ALGEBRA_OPERATOR_H_
 #define INCLUDE_IMLAB_ALGEBRA_OPERATOR_H_
 // ---------------------------------------------------------------------------
+#include <algorithm>
 #include <vector>
 #include <ostream>
 #include <iostream>
+#include <string>
 #include <google/protobuf/descriptor.h>
 // ---------------------------------------------------------------------------
 namespace imlab {
 // ---------------------------------------------------------------------------
+// Name of the variable that gives the values of a field in generated code, e.g. Document_Name_Url.
+// It is a function that returns the (non-NULL) values of the field in the current record.
+inline std::string FieldVariable(const google::protobuf::FieldDescriptor* field) {
+    auto name = field->full_name();
+    std::replace(name.begin(), name.end(), '.', '_');
+    return name;
+}
+// ---------------------------------------------------------------------------
+// Code that yields the descriptor of a field
+inline std::string FieldDescriptorCode(const google::protobuf::FieldDescriptor* field) {
+    auto message_name = field->containing_type()->full_name();
+    std::replace(message_name.begin(), message_name.end(), '.', '_');
+    return message_name + "::descriptor()->FindFieldByName(\"" + field->name() + "\")";
+}
+// ---------------------------------------------------------------------------
+// C++ type of the values of a field in generated code (the type of its column)
+inline std::string FieldValueType(const google::protobuf::FieldDescriptor* field) {
+    switch (field->cpp_type()) {
+        case google::protobuf::FieldDescriptor::CPPTYPE_INT32: return "int32_t";
+        case google::protobuf::FieldDescriptor::CPPTYPE_INT64: return "int64_t";
+        case google::protobuf::FieldDescriptor::CPPTYPE_UINT32: return "uint32_t";
+        case google::protobuf::FieldDescriptor::CPPTYPE_UINT64: return "uint64_t";
+        case google::protobuf::FieldDescriptor::CPPTYPE_DOUBLE: return "double";
+        case google::protobuf::FieldDescriptor::CPPTYPE_FLOAT: return "float";
+        case google::protobuf::FieldDescriptor::CPPTYPE_BOOL: return "bool";
+        case google::protobuf::FieldDescriptor::CPPTYPE_STRING: return "std::string";
+        default: return "";  // Groups and messages have no values of their own
+    }
+}
+// ---------------------------------------------------------------------------
+// C++ string literal with the given contents
+inline std::string StringLiteral(const std::string& value) {
+    static const char digits[] = "01234567";
+    std::string literal = "\"";
+    for (unsigned char c : value) {
+        if (c == '"' || c == '\\') {
+            literal += '\\';
+            literal += c;
+        } else if (c < 0x20 || c >= 0x7f) {
+            // Three octal digits, so that the next character can't be taken as part of the escape sequence
+            literal += {'\\', digits[c >> 6], digits[(c >> 3) & 7], digits[c & 7]};
+        } else {
+            literal += c;
+        }
+    }
+    return literal + "\"";
+}
+// ---------------------------------------------------------------------------
 class Operator {
  public:
     // Collect all IUs produced by the operator
@@ -20,6 +70,9 @@ class Operator {
     virtual void Prepare(const std::vector<const google::protobuf::FieldDescriptor*> &required, Operator* parent) = 0;
     // Produce all tuples
     virtual void Produce(std::ostream& _o) = 0;
+    // Begin a task of the child's pipeline: called once per parallel task before its tuples are consumed,
+    // e.g. to look up thread-local state once instead of for every tuple
+    virtual void BeginTask(std::ostream& _o, const Operator* child) {}
     // Consume tuple
     virtual void Consume(std::ostream&_o, const Operator* child) = 0;
 
@@ -0,0 +1,63 @@
+// ---------------------------------------------------------------------------
+// IMLAB
+// ---------------------------------------------------------------------------
+#ifndef INCLUDE_IMLAB_ALGEBRA_PREDICATE_H_
+#define INCLUDE_IMLAB_ALGEBRA_PREDICATE_H_
+// ---------------------------------------------------------------------------
+#include <optional>
+#include <string>
+#include <utility>
+#include "./operator.h"
+// ---------------------------------------------------------------------------
+namespace imlab {
+// ---------------------------------------------------------------------------
+// Comparison of a leaf field with constants, e.g. Name.Url LIKE 'http://%'.
+// A predicate holds for a record if any value of the field in the record satisfies it (as in Dremel),
+// so records without a value of the field never qualify.
+class Predicate {
+ public:
+    enum class Type {
+        kEqual,     // field = value
+        kNotEqual,  // field <> value
+        kLess,      // field < value
+        kGreater,   // field > value
+        kBetween,   // field BETWEEN value AND upper (inclusive)
+        kLike,      // field LIKE value, where value is a prefix followed by '%'
+    };
+
+    // Constructor; throws a QueryCompilationError if the constants don't fit the type of the field
+    Predicate(const google::protobuf::FieldDescriptor* field, Type type, std::string value, std::string upper = {});
+
+    // The field that is compared
+    const google::protobuf::FieldDescriptor* field() const { return field_; }
+    // The comparison
+    Type type() const { return type_; }
+
+    // Generate a boolean expression that checks the current record (see TableScan::Produce)
+    std::string GenerateCode() const;
+    // Whether a scan can compare the values in the column instead, with a dremel::ColumnMatcher.
+    // This holds for string equalities: dictionary-encoded segments then compare codes instead of strings.
+    bool MatchesInColumn() const;
+    // Generate the declaration of that matcher
+    std::string GenerateMatcher(const std::string& matcher) const;
+    // The values that satisfy the predicate as inclusive bounds, for the zone maps (std::nullopt if unbounded).
+    // Returns false if the predicate can't be expressed as a range (<>).
+    bool GetRange(std::optional<std::string>* lower, std::optional<std::string>* upper) const;
+
+ protected:
+    // Field
+    const google::protobuf::FieldDescriptor* field_;
+    // Comparison
+    Type type_;
+    // Constants (the prefix for LIKE)
+    std::string value_;
+    std::string upper_;
+
+    // Generate a constant of the field's type
+    std::string GenerateConstant(const std::string& value) const;
+};
+// ---------------------------------------------------------------------------
+}  // namespace imlab
+// ---------------------------------------------------------------------------
+#endif  // INCLUDE_IMLAB_ALGEBRA_PREDICATE_H_
+// ---------------------------------------------------------------------------
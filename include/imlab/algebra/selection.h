@@ -9,6 +9,7 @@
 #include <vector>
 #include <string>
 #include "./operator.h"
+#include "./predicate.h"
 // ---------------------------------------------------------------------------
 namespace imlab {
 // ---------------------------------------------------------------------------
@@ -17,7 +18,9 @@ class Selection: public Operator {
     // Child operator
     std::unique_ptr<Operator> child_;
     // Predicates
-    std::vector<std::pair<const google::protobuf::FieldDescriptor*, std::string>> predicates_;
+    std::vector<Predicate> predicates_;
+    // Whether the predicates are evaluated by the child (a table scan)
+    bool pushed_down_ = false;
 
     // Required ius
     std::vector<const google::protobuf::FieldDescriptor*> required_fields_;
@@ -26,7 +29,7 @@ class Selection: public Operator {
 
  public:
     // Constructor
-    Selection(std::unique_ptr<Operator> child, std::vector<std::pair<const google::protobuf::FieldDescriptor*, std::string>> predicates)
+    Selection(std::unique_ptr<Operator> child, std::vector<Predicate> predicates)
         : child_(std::move(child)), predicates_(std::move(predicates)) {}
 
     // Collect all IUs produced by the operator
@@ -36,6 +39,8 @@ class Selection: public Operator {
     void Prepare(const std::vector<const google::protobuf::FieldDescriptor*> &required, Operator* consumer) override;
     // Produce all tuples
     void Produce(std::ostream& _o) override;
+    // Begin a task of the child's pipeline
+    void BeginTask(std::ostream& _o, const Operator* child) override { consumer_->BeginTask(_o, this); }
     // Consume tuple
     void Consume(std::ostream& _o, const Operator* child) override;
 };
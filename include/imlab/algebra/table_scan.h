@@ -5,9 +5,13 @@
 #define INCLUDE_IMLAB_ALGEBRA_TABLE_SCAN_H_
 // ---------------------------------------------------------------------------
 #include <memory>
+#include <optional>
+#include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 #include "./operator.h"
+#include "./predicate.h"
 // ---------------------------------------------------------------------------
 namespace imlab {
 // ---------------------------------------------------------------------------
@@ -20,11 +24,30 @@ class TableScan: public Operator {
     std::vector<const google::protobuf::FieldDescriptor*> required_fields_;
     // Consumer
     Operator *consumer_;
+    // Value ranges (field, inclusive lower bound, inclusive upper bound) that are checked against the zone maps
+    std::vector<std::tuple<const google::protobuf::FieldDescriptor*, std::optional<std::string>, std::optional<std::string>>> ranges_;
+    // Predicates that records have to satisfy before they are passed to the consumer
+    std::vector<Predicate> predicates_;
 
  public:
     // Constructor
     explicit TableScan(const char *table) : table_(table) {}
 
+    // Only scan records that might contain a value of the field within [lower, upper]
+    void PushDownRange(const google::protobuf::FieldDescriptor* field, std::optional<std::string> lower, std::optional<std::string> upper) {
+        ranges_.emplace_back(field, std::move(lower), std::move(upper));
+    }
+
+    // Only pass records that satisfy the predicate to the consumer.
+    // The predicate's field has to be required from the scan. Its range is also checked against the zone maps.
+    void PushDownPredicate(const Predicate& predicate) {
+        std::optional<std::string> lower, upper;
+        if (predicate.GetRange(&lower, &upper) && (lower || upper)) {
+            PushDownRange(predicate.field(), std::move(lower), std::move(upper));
+        }
+        predicates_.push_back(predicate);
+    }
+
     // Collect all IUs produced by the operator
     std::vector<const google::protobuf::FieldDescriptor*> CollectFields() override;
 
@@ -34,6 +57,10 @@ class TableScan: public Operator {
     void Produce(std::ostream& _o) override;
     // Consume tuple
     void Consume(std::ostream& _o, const Operator* child) override {}
+
+ private:
+    // Generate a string literal for a bound (or std::nullopt)
+    static std::string GenerateBound(const std::optional<std::string>& bound);
 };
 // ---------------------------------------------------------------------------
 }  // namespace imlab
@@ -26,41 +26,58 @@ class RecordAssembler {
     /// This assembler is stateful:
     /// You can repeatedly call AssembleNextRecord() to assemble the following records from the storage as well.
     /// The Assembler is not thread-safe.
-    RecordAssembler(RecordFSM& fsm, std::vector<IFieldReader*>& readers) : _fsm(fsm), _root_reader(readers[0]) {
-        _field_reader_map.clear();
+    RecordAssembler(RecordFSM& fsm, std::vector<IFieldReader*>& readers)
+        : _fsm(fsm), _readers(fsm.field_count(), nullptr) {
         for (auto& r : readers) {
-            _field_reader_map[r->field()] = r;
+            _readers[_fsm.IndexOf(r->field())] = r;
         }
     }
 
     /// Assembles a shredded record from a column-store table.
     R AssembleNextRecord() {
         R record {};  // Record that is assembled
+        AssembleNextRecord(&record);
+        return record;
+    }
+
+    /// Assembles a shredded record into an existing message, e.g. one on an Arena or one that is reused.
+    /// The message is cleared first.
+    void AssembleNextRecord(R* record) {
+        record->Clear();
 
         // Init all the things for a new record.
-        _msg_stack = { &record };
+        _msg_stack = { record };
         _last_read_field = nullptr;
-        _currently_read_field = _root_reader->field();
+        uint32_t state = 0;
 
-        while (_currently_read_field != nullptr) {
-            auto value = _field_reader_map.at(_currently_read_field)->ReadNext();
+        while (state != _fsm.field_count()) {
+            _currently_read_field = _fsm.field(state);
+            auto* reader = _readers[state];
+            auto value = reader->ReadNext();
             if (!value.is_null()) {
                 MoveToLevel(_currently_read_field);
                 value.AppendToRecord(_msg_stack[_msg_stack.size() - 1]);
             } else {
                 auto* new_level = _currently_read_field;
                 for (int i = 0; i < GetFullDefinitionLevel(_currently_read_field) - value.definition_level(); i++) {
-                    new_level = GetFieldDescriptor(new_level->containing_type());
+                    new_level = GetParentField(new_level);
                 }
                 MoveToLevel(new_level);
             }
 
-            _currently_read_field = _fsm.NextField(_currently_read_field, _field_reader_map.at(_currently_read_field)->Peek().repetition_level());
-            ReturnToLevel(_currently_read_field);
+            const auto* read_field = _currently_read_field;
+            unsigned repetition_level = reader->Peek().repetition_level();
+            uint32_t next_state = _fsm.NextIndex(state, repetition_level);
+            if (next_state <= state) {
+                // A backward or reflexive transition: the message at the repetition level starts again.
+                ReturnToRepetitionLevel(_fsm.field(next_state), repetition_level);
+            } else {
+                ReturnToLevel(read_field, next_state != _fsm.field_count() ? _fsm.field(next_state) : nullptr);
+            }
+            state = next_state;
         }
 
-        ReturnToLevel(nullptr);
-        return record;
+        ReturnToLevel(_last_read_field, nullptr);
     }
 
  protected:
@@ -73,10 +90,8 @@ class RecordAssembler {
 
     // A finite state machine to switch between fields within a record.
     RecordFSM& _fsm;
-    // A reader to the first field in the record.
-    IFieldReader* _root_reader;
-    // We also create a mapping between fields and FieldReaders
-    std::unordered_map<const FieldDescriptor*, IFieldReader*> _field_reader_map;
+    // The FieldReaders, indexed by the states of the FSM.
+    std::vector<IFieldReader*> _readers;
 
 
     void MoveToLevel(const FieldDescriptor* new_field) {
@@ -110,7 +125,7 @@ class RecordAssembler {
         // Maybe the target_field_type is even further up...
         // Unwind the message stack even further if that's the case.
         if (GetFullDefinitionLevel(GetFieldDescriptor(target_field_type)) < _msg_stack.size() - 1) {
-            ReturnToLevel(GetFieldDescriptor(target_field_type));
+            ReturnToLevel(_last_read_field, GetFieldDescriptor(target_field_type));
         }
 
         // Now we can actually start to build up the message stack again up to target_field_type.
@@ -130,9 +145,12 @@ class RecordAssembler {
         _last_read_field = new_field;
     }
 
-    void ReturnToLevel(const FieldDescriptor* new_field) {
+    /// Ends the nested records that the next field does not continue, after a forward transition.
+    /// The common ancestor has to be computed from the field that was just read, not from _last_read_field:
+    /// After a NULL, _last_read_field is the level the NULL was defined at.
+    void ReturnToLevel(const FieldDescriptor* read_field, const FieldDescriptor* new_field) {
         // Unwind message stack: End nested records up to the level of the lowest common ancestor.
-        const auto* common_ancestor = GetCommonAncestor(_last_read_field, new_field);
+        const auto* common_ancestor = GetCommonAncestor(read_field, new_field);
         auto common_ancestor_level = GetFullDefinitionLevel(common_ancestor);
         int elements_to_remove = _msg_stack.size() - common_ancestor_level - 1/*don't pop root*/;
         if (elements_to_remove >= 0) {
@@ -143,6 +161,25 @@ class RecordAssembler {
             _last_read_field = common_ancestor;
         }
     }
+
+    /// Ends the nested records down from the repeated message at the given repetition level, so that the next value
+    /// of new_field starts a new one. Only the ancestors of new_field with a lower repetition level are kept.
+    /// (The common ancestor of two fields cannot tell at which level a field repeats itself, e.g. whether the next
+    /// Name.Language.Country is in a new Language or in a new Name.)
+    void ReturnToRepetitionLevel(const FieldDescriptor* new_field, unsigned repetition_level) {
+        std::vector<const FieldDescriptor*> ancestors {};
+        for (auto* field = GetParentField(new_field); field != nullptr; field = GetParentField(field)) {
+            ancestors.insert(ancestors.begin(), field);
+        }
+        size_t depth = 0;
+        while (depth < ancestors.size() && GetMaxRepetitionLevel(ancestors[depth]) < repetition_level) {
+            depth++;
+        }
+        if (_msg_stack.size() > depth + 1) {
+            _msg_stack.resize(depth + 1);
+            _last_read_field = depth == 0 ? nullptr : ancestors[depth - 1];
+        }
+    }
 };
 
 //---------------------------------------------------------------------------
@@ -0,0 +1,61 @@
+// ---------------------------------------------------------------------------
+// IMLAB
+// ---------------------------------------------------------------------------
+#ifndef INCLUDE_IMLAB_DREMEL_BULK_LOADING_H_
+#define INCLUDE_IMLAB_DREMEL_BULK_LOADING_H_
+//---------------------------------------------------------------------------
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <tbb/parallel_for.h>
+//---------------------------------------------------------------------------
+namespace imlab {
+namespace dremel {
+//---------------------------------------------------------------------------
+
+/// The default number of bytes of input that one task shreds.
+constexpr size_t kDefaultBulkLoadChunkSize = 4 << 20;
+
+/// Loads records into a table in parallel.
+/// The input is split into chunks that end at record boundaries. The chunks are shredded by TBB workers into
+/// fragments, tables of their own, which are then appended to the table in the order of the input
+/// (see Table::append(), which moves the segments of the fragment's columns instead of inserting their rows again).
+/// The input is processed in rounds of a few chunks per thread, so only these chunks and fragments are in memory.
+///
+/// If a chunk is invalid, the exception is rethrown after its round; the records of all earlier rounds
+/// have been loaded by then and the table is consistent.
+///
+/// The chunks are strings that are read from a stream, or views into input that is already in memory
+/// (e.g. a mapped file), which are shredded without being copied.
+///
+/// \param read_chunk bool(Chunk* chunk): Reads the next chunk and returns false at the end of the input.
+/// \param shred_chunk void(Table& fragment, const Chunk& chunk): Shreds all records of a chunk into a fragment.
+template<typename Table, typename Chunk = std::string, typename ReadChunk, typename ShredChunk>
+void BulkLoad(Table& table, ReadChunk&& read_chunk, ShredChunk&& shred_chunk) {
+    const size_t chunks_per_round = 2 * std::max(1u, std::thread::hardware_concurrency());
+    std::vector<Chunk> chunks(chunks_per_round);
+    std::vector<std::unique_ptr<Table>> fragments(chunks_per_round);
+    for (bool more = true; more;) {
+        size_t chunk_count = 0;
+        while (chunk_count < chunks_per_round && (more = read_chunk(&chunks[chunk_count]))) {
+            chunk_count++;
+        }
+        tbb::parallel_for(size_t(0), chunk_count, [&](size_t i) {
+            fragments[i] = std::make_unique<Table>();
+            shred_chunk(*fragments[i], chunks[i]);
+        });
+        for (size_t i = 0; i < chunk_count; i++) {
+            table.append(*fragments[i]);
+            fragments[i].reset();
+        }
+    }
+}
+
+//---------------------------------------------------------------------------
+}  // namespace dremel
+}  // namespace imlab
+//---------------------------------------------------------------------------
+#endif  // INCLUDE_IMLAB_DREMEL_BULK_LOADING_H_
+//---------------------------------------------------------------------------
@@ -4,8 +4,13 @@
 #ifndef INCLUDE_IMLAB_DREMEL_FIELD_READER_H_
 #define INCLUDE_IMLAB_DREMEL_FIELD_READER_H_
 //---------------------------------------------------------------------------
+#include <algorithm>
+#include <optional>
+#include <utility>
+#include <vector>
 #include "./storage.h"
 #include "./schema_helper.h"
+#include "../infra/simd.h"
 #include <google/protobuf/message.h>
 //---------------------------------------------------------------------------
 namespace imlab {
@@ -24,27 +29,48 @@ class IFieldReader {
     virtual FieldValue Peek() = 0;
     virtual const FieldDescriptor* field() = 0;
 
+    /// Decodes the levels of the next n rows into the given buffers (one byte per level) and advances the cursor.
+    /// Returns the number of rows that were decoded (less than n at the end of the column).
+    virtual uint64_t ReadLevels(uint64_t n, uint8_t* repetition_levels, uint8_t* definition_levels) = 0;
+    /// Decodes the next n rows into two bitmasks (bit i % 64 of word i / 64 for the i-th row) and advances the cursor:
+    /// A bit of record_starts is set if the row starts a new record (r = 0),
+    /// a bit of present is set if the row has a value (d = maximum definition level).
+    /// Both masks need (n + 63) / 64 words. Returns the number of rows that were decoded.
+    virtual uint64_t ReadMasks(uint64_t n, uint64_t* record_starts, uint64_t* present) = 0;
+    /// Advances the cursor by n rows without reading them.
+    virtual void SkipRows(uint64_t n) = 0;
+    /// Advances the cursor to the first row of the n-th record after the current one.
+    virtual void SkipRecords(uint64_t n) = 0;
+
  protected:
-    virtual unsigned GetRepetitionLevel(FieldValue* field_value) = 0;
-    virtual unsigned GetDefinitionLevel(FieldValue* field_value) = 0;
     virtual void AppendToRecord(FieldValue* field_value, Message* msg) = 0;
-    virtual bool is_null(FieldValue* field_value) = 0;
 
     uint64_t _current_index;
 };
 
+/// A row that was read by a FieldReader.
+/// The levels are decoded by the reader, only the value itself is fetched lazily.
 class FieldValue {
  public:
-    FieldValue(IFieldReader* reader, uint64_t index) : _reader(reader), _index(index) {}
-    unsigned repetition_level() { return _reader->GetRepetitionLevel(this); }
-    unsigned definition_level() { return _reader->GetDefinitionLevel(this); }
+    FieldValue(IFieldReader* reader, uint64_t index, uint64_t value_index,
+               unsigned repetition_level, unsigned definition_level, bool is_null)
+        : _reader(reader), _index(index), _value_index(value_index),
+          _repetition_level(repetition_level), _definition_level(definition_level), _is_null(is_null) {}
+    unsigned repetition_level() { return _repetition_level; }
+    unsigned definition_level() { return _definition_level; }
     uint64_t index() { return _index; }
-    bool is_null() { return _reader->is_null(this); }
+    /// Position of the value in the dense value vector of the column (only meaningful if not NULL).
+    uint64_t value_index() { return _value_index; }
+    bool is_null() { return _is_null; }
     void AppendToRecord(Message* msg) { _reader->AppendToRecord(this, msg); }
 
  private:
-    uint64_t _index;
     IFieldReader* _reader;
+    uint64_t _index;
+    uint64_t _value_index;
+    unsigned _repetition_level;
+    unsigned _definition_level;
+    bool _is_null;
 };
 
 template<typename T>
@@ -58,60 +84,495 @@ template<> inline void AppendToRecordGeneric(int64_t value, const FieldDescripto
     }
 }
 
-template<> inline void AppendToRecordGeneric(std::string value, const FieldDescriptor* field, Message* msg) { // TODO: make reference
+template<> inline void AppendToRecordGeneric(std::string_view value, const FieldDescriptor* field, Message* msg) {
+    // The string is copied exactly once: from the column into the message.
     if (field->is_repeated()) {
-        AddValue(msg, field, value);
+        AddValue(msg, field, std::string(value));
     } else {
-        SetValue(msg, field, value);
+        SetValue(msg, field, std::string(value));
     }
 }
 
+/// Reads the rows of a DremelColumn sequentially, one segment after the other.
+/// Positions (TIDs and value indexes) are always relative to the whole column.
 template<typename T>
 class FieldReader: public IFieldReader {
  public:
     explicit FieldReader(DremelColumn<T>* column, uint64_t index)
-        : IFieldReader(index), _column(column) {}
+        : IFieldReader(index), _column(column), _current_value_index(column->value_index(index)),
+          _repetition_levels(_end_of_column.cursor(0)), _definition_levels(_end_of_column.cursor(0)) {
+        MoveToSegment();
+    }
 
-    FieldValue Read(uint64_t index) override { return { this, index }; }
+    FieldValue Read(uint64_t index) override {
+        if (index >= _column->size()) {
+            return { this, index, _column->value_index(index), 0, 0, true };
+        }
+        unsigned d = _column->definition_level(index);
+        return { this, index, _column->value_index(index), _column->repetition_level(index), d,
+                 d < _column->max_definition_level() };
+    }
+
+    /// Reads the value under the cursor and advances the cursor.
+    /// The position in the dense value vector is tracked along the way, so sequential reads never
+    /// need to count NULLs.
+    FieldValue ReadNext() override {
+        FieldValue value = Peek();
+        if (!value.is_null()) {
+            _current_value_index++;
+        }
+        _repetition_levels.Next();
+        _definition_levels.Next();
+        _current_index++;
+        if (_definition_levels.at_end()) {
+            MoveToSegment();
+        }
+        return value;
+    }
 
-    FieldValue ReadNext() { return Read(_current_index++); }
+    FieldValue Peek() override {
+        unsigned d = _definition_levels.Get();
+        bool is_null = _definition_levels.at_end() || d < _column->max_definition_level();
+        return { this, _current_index, _current_value_index, _repetition_levels.Get(), d, is_null };
+    }
 
-    FieldValue Peek() { return Read(_current_index); }
+    /// Returns the value under the cursor; Peek() must not be NULL.
+    /// Unlike AppendToRecord(), this needs no segment lookup and no reflection, which the generated assembler uses.
+    typename ValueStore<T>::const_reference PeekValue() {
+        assert(!Peek().is_null());
+        return _segment->values()[_current_value_index - _segment->first_value()];
+    }
 
     const FieldDescriptor* field() override { return _column->field(); };
 
- protected:
-    unsigned GetRepetitionLevel(FieldValue* field_value) override {
-        if (field_value->index() < _column->size()) {
-            const auto &row = _column->get(field_value->index());
-            return row.repetition_level;
+    /// Moves the cursor to any row of the column, so that a reader can be reused for another range of records.
+    /// Moving to the row under the cursor (e.g. to the start of the morsel that follows the last one) costs nothing.
+    void Seek(uint64_t index) {
+        if (index == _current_index) {
+            return;
         }
-        return 0;
+        _current_index = index;
+        _current_value_index = _column->value_index(index);
+        _segment = nullptr;
+        MoveToSegment();
     }
 
-    unsigned GetDefinitionLevel(FieldValue* field_value) override {
-        if (field_value->index() < _column->size()) {
-            const auto &row = _column->get(field_value->index());
-            return row.definition_level;
+    /// Returns the segment under the cursor (nullptr at the end of the column).
+    ColumnSegment<T>* segment() { return _segment; }
+
+    uint64_t ReadLevels(uint64_t n, uint8_t* repetition_levels, uint8_t* definition_levels) override {
+        uint64_t decoded = 0;
+        while (decoded < n && _segment != nullptr) {
+            uint64_t step = _repetition_levels.Decode(repetition_levels + decoded, n - decoded);
+            _definition_levels.Decode(definition_levels + decoded, step);
+            for (uint64_t i = decoded; i < decoded + step; i++) {
+                _current_value_index += (definition_levels[i] == _column->max_definition_level());
+            }
+            _current_index += step;
+            decoded += step;
+            MoveToSegment();
         }
-        return 0;
+        return decoded;
     }
 
-    inline void AppendToRecord(FieldValue* field_value, Message* msg) override {
-        const auto& row = _column->get(field_value->index());
-        AppendToRecordGeneric(row.value.value(), _column->field(), msg);
+    uint64_t ReadMasks(uint64_t n, uint64_t* record_starts, uint64_t* present) override {
+        std::fill(record_starts, record_starts + (n + 63) / 64, 0);
+        std::fill(present, present + (n + 63) / 64, 0);
+        uint64_t decoded = 0;
+        while (decoded < n && _segment != nullptr) {
+            uint64_t step = _repetition_levels.DecodeMask(0, n - decoded, record_starts, decoded);
+            _definition_levels.DecodeMask(_column->max_definition_level(), step, present, decoded);
+            _current_value_index += CountSetBits(present, decoded, step);
+            _current_index += step;
+            decoded += step;
+            MoveToSegment();
+        }
+        return decoded;
     }
 
-    bool is_null(FieldValue* field_value) {
-        if (field_value->index() < _column->size()) {
-            const auto &row = _column->get(field_value->index());
-            return !row.value.has_value();
+    void SkipRows(uint64_t n) override {
+        while (n > 0 && _segment != nullptr) {
+            // Only the definition levels need to be looked at (run by run) to keep track of the value index.
+            uint64_t step = std::min(n, _segment->size() - _definition_levels.position());
+            _repetition_levels.Skip(step);
+            _current_value_index += _definition_levels.Count(_column->max_definition_level(), step);
+            _current_index += step;
+            n -= step;
+            MoveToSegment();
         }
-        return true;
+        _current_index += n;
+    }
+
+    void SkipRecords(uint64_t n) override {
+        if (n == 0 || _segment == nullptr) {
+            return;
+        }
+        // The row under the cursor belongs to the current record, so the search for record starts begins after it.
+        SkipRows(1);
+        while (_segment != nullptr) {
+            auto cursor = _repetition_levels;
+            uint64_t skipped = cursor.SkipToOccurrence(0, n - 1);
+            if (!cursor.at_end()) {
+                SkipRows(skipped);
+                return;
+            }
+            // The record starts in the rest of this segment are not enough; continue in the next one.
+            cursor = _repetition_levels;
+            n -= cursor.Count(0, skipped);
+            SkipRows(skipped);
+        }
+    }
+
+ protected:
+    inline void AppendToRecord(FieldValue* field_value, Message* msg) override {
+        auto& segment = _column->segment_of(field_value->index());
+        AppendToRecordGeneric(segment.values()[field_value->value_index() - segment.first_value()], _column->field(), msg);
     }
 
  private:
+    /// An empty stream that the cursors point to at the end of the column.
+    static inline const LevelStream _end_of_column { 0 };
+
     DremelColumn<T>* _column;
+    /// The segment under the cursor.
+    ColumnSegment<T>* _segment = nullptr;
+    /// Position of the value under the cursor in the dense value vector of the column.
+    uint64_t _current_value_index;
+    /// Cursors to the levels of the row under the cursor within the current segment.
+    LevelStream::Cursor _repetition_levels;
+    LevelStream::Cursor _definition_levels;
+
+    /// Points the level cursors to the segment that contains the current index (if it isn't the current segment).
+    void MoveToSegment() {
+        if (_segment != nullptr && _current_index < _segment->first_tid() + _segment->size()) {
+            return;
+        }
+        if (_current_index >= _column->size()) {
+            _segment = nullptr;
+            _repetition_levels = _end_of_column.cursor(0);
+            _definition_levels = _end_of_column.cursor(0);
+            return;
+        }
+        _segment = &_column->segment_of(_current_index);
+        uint64_t row = _current_index - _segment->first_tid();
+        _repetition_levels = _segment->repetition_levels().cursor(row);
+        _definition_levels = _segment->definition_levels().cursor(row);
+    }
+};
+
+/// The non-NULL values of one field in one record, in the order of the record.
+template<typename T>
+class RecordValues {
+ public:
+    using const_iterator = typename std::vector<T>::const_iterator;
+
+    RecordValues(const std::vector<T>& values, size_t size) : _values(values), _size(size) {}
+
+    size_t size() const { return _size; }
+    bool empty() const { return _size == 0; }
+    const T& operator[](size_t index) const { return _values[index]; }
+    const_iterator begin() const { return _values.begin(); }
+    const_iterator end() const { return _values.begin() + _size; }
+
+ private:
+    const std::vector<T>& _values;
+    size_t _size;
+};
+
+/// The rows of one field in one record, with their repetition levels, so that the rows of several fields can be
+/// walked together (see RecordFlattener).
+template<typename T>
+class RecordRows {
+ public:
+    /// The value index of a NULL row
+    static constexpr size_t kNull = static_cast<size_t>(-1);
+
+    RecordRows(const std::vector<T>& values, const std::vector<unsigned>& repetition_levels,
+               const std::vector<size_t>& value_indexes, size_t size)
+        : _values(values), _repetition_levels(repetition_levels), _value_indexes(value_indexes), _size(size) {}
+
+    size_t size() const { return _size; }
+    const unsigned* repetition_levels() const { return _repetition_levels.data(); }
+    /// Returns the value of a row, nullptr if the row is NULL.
+    const T* value(size_t row) const {
+        return _value_indexes[row] == kNull ? nullptr : &_values[_value_indexes[row]];
+    }
+    std::optional<T> Get(size_t row) const {
+        return _value_indexes[row] == kNull ? std::nullopt : std::optional<T>(_values[_value_indexes[row]]);
+    }
+
+ private:
+    const std::vector<T>& _values;
+    const std::vector<unsigned>& _repetition_levels;
+    const std::vector<size_t>& _value_indexes;
+    size_t _size;
+};
+
+/// Compares the values of a column with a constant, segment by segment (see EqualityMatcher).
+/// The matcher of a segment is set up when the first value of the segment is compared, so the constant is looked up
+/// in the dictionary of every segment once and the values of dictionary-encoded segments are compared by their codes.
+template<typename T>
+class ColumnMatcher {
+ public:
+    explicit ColumnMatcher(T constant) : _constant(std::move(constant)) {}
+
+    /// Whether the value at the given value index of the column, which lies in the given segment, equals the constant.
+    bool matches(const ColumnSegment<T>& segment, uint64_t value_index) {
+        if (&segment != _segment) {
+            _segment = &segment;
+            _matcher.emplace(segment.values(), _constant);
+        }
+        return _matcher->matches(value_index - segment.first_value());
+    }
+
+    const T& constant() const { return _constant; }
+
+ private:
+    const T _constant;
+    /// The segment that the matcher was set up for.
+    const ColumnSegment<T>* _segment = nullptr;
+    std::optional<EqualityMatcher<T>> _matcher;
+};
+
+/// Reads the values of a column record by record, for scans that work on the columns directly
+/// instead of assembling records.
+/// Records are read in ascending order. Records that are passed over are skipped without decoding their values,
+/// so a column that is only needed for some records (e.g. those that satisfy a predicate) is only read for those.
+/// The values are copied out of the column into buffers of the reader, which are reused for the next record.
+/// Record boundaries and NULLs are taken from masks of the next 64 rows (see FieldReader::ReadMasks), so the
+/// levels that are decoded once serve all records in these rows, e.g. to skip the records between two matches.
+template<typename T>
+class RecordValueReader {
+ public:
+    /// Creates a reader that starts at the given record.
+    RecordValueReader(DremelColumn<T>& column, uint64_t record)
+        : _reader(&column, column.record_start(record)), _mask_reader(&column, column.record_start(record)),
+          _record(record) {}
+
+    /// Returns the non-NULL values of a record, which must not be before the last record that was read.
+    /// The values are valid until the next record is read.
+    RecordValues<T> Read(uint64_t record) {
+        if (record + 1 == _record) {
+            return { _values, _size };  // Read already.
+        }
+        assert(record >= _record);
+        SkipRecords(record - _record);
+        _size = 0;
+        _rows = 0;
+        FillMasks();
+        do {
+            bool present = _present & 1;
+            if (_rows == _repetition_levels.size()) {
+                _repetition_levels.emplace_back();
+                _value_indexes.emplace_back();
+            }
+            _value_indexes[_rows] = present ? _size : RecordRows<T>::kNull;
+            if (present) {
+                if (_size == _values.size()) {
+                    _values.emplace_back();
+                }
+                _values[_size++] = _reader.PeekValue();
+            }
+            _repetition_levels[_rows++] = _reader.ReadNext().repetition_level();
+            ConsumeMasks(1);
+        } while (FillMasks() && !(_record_starts & 1));
+        _record = record + 1;
+        return { _values, _size };
+    }
+
+    /// Returns all rows of a record, including the NULLs; like Read(), which reads the same record.
+    RecordRows<T> ReadRows(uint64_t record) {
+        Read(record);
+        return { _values, _repetition_levels, _value_indexes, _rows };
+    }
+
+    /// Whether a value of a record equals the constant of the matcher, e.g. for a predicate that is checked first.
+    /// The values are compared in the column, without copying them out, and the record can still be read afterwards.
+    bool Contains(uint64_t record, ColumnMatcher<T>& matcher) {
+        if (record + 1 == _record) {
+            // Read already.
+            return std::find(_values.begin(), _values.begin() + _size, matcher.constant()) != _values.begin() + _size;
+        }
+        assert(record >= _record);
+        SkipRecords(record - _record);
+        _record = record;
+        FieldReader<T> rows = _reader;
+        do {
+            auto row = rows.Peek();
+            if (!row.is_null() && matcher.matches(*rows.segment(), row.value_index())) {
+                return true;
+            }
+            rows.ReadNext();
+        } while (rows.Peek().repetition_level() > 0);
+        return false;
+    }
+
+ private:
+    FieldReader<T> _reader;
+    /// Reads the masks ahead of _reader: it is always _masked_rows rows behind.
+    FieldReader<T> _mask_reader;
+    /// The masks of the rows from the cursor of _reader on (bit 0 is the row under the cursor).
+    uint64_t _record_starts = 0;
+    uint64_t _present = 0;
+    uint64_t _masked_rows = 0;
+    /// The record under the cursor of the reader.
+    uint64_t _record;
+    /// The values of the last record that was read: the first _size elements.
+    /// Elements are overwritten instead of destroyed, so strings keep their memory.
+    std::vector<T> _values {};
+    size_t _size = 0;
+    /// The rows of the last record that was read: the first _rows elements.
+    std::vector<unsigned> _repetition_levels {};
+    std::vector<size_t> _value_indexes {};
+    size_t _rows = 0;
+
+    /// Reads the masks of the next rows if all masked rows were consumed; returns false at the end of the column.
+    bool FillMasks() {
+        if (_masked_rows == 0) {
+            _masked_rows = _mask_reader.ReadMasks(64, &_record_starts, &_present);
+        }
+        return _masked_rows > 0;
+    }
+
+    /// Drops the masks of the next n masked rows, which the cursor of _reader moved over.
+    void ConsumeMasks(uint64_t n) {
+        _record_starts = n < 64 ? _record_starts >> n : 0;
+        _present = n < 64 ? _present >> n : 0;
+        _masked_rows -= n;
+    }
+
+    /// Moves the cursor from the first row of a record to the first row of the n-th record after it.
+    void SkipRecords(uint64_t n) {
+        // The record under the cursor starts at the first row, which is not one of the records to skip.
+        uint64_t ignored = 1;
+        while (n > 0 && FillMasks()) {
+            uint64_t starts = _record_starts & ~ignored;
+            uint64_t count = __builtin_popcountll(starts);
+            uint64_t rows = count >= n ? NthSetBit(starts, n - 1) : _masked_rows;
+            n -= std::min(count, n);
+            _reader.SkipRows(rows);
+            ConsumeMasks(rows);
+            ignored = 0;
+        }
+    }
+};
+
+/// Flattens the rows of several fields in a record into tuples, walking the fields together by their
+/// repetition levels like the flattening of nested records into a relation.
+/// Fields in the same repeated group pair up (e.g. Name.Language.Code with Name.Language.Country), while
+/// independently repeated fields form the cross product. A repeated group that is missing gives one tuple
+/// with a NULL row, so every record gives at least one tuple.
+/// Only the first `flattened` fields are flattened. The rows of the other fields are narrowed to the
+/// innermost repeated group they share with the flattened fields, e.g. to aggregate their values per tuple.
+class RecordFlattener {
+ public:
+    /// Creates a flattener for fields with the given repeated fields on their paths from the root, as ids that
+    /// are equal for the same repeated field (e.g. {0, 1} for Name.Language.Code).
+    RecordFlattener(std::vector<std::vector<unsigned>> repeated_paths, size_t flattened)
+        : _paths(std::move(repeated_paths)), _flattened(flattened),
+          _levels(_paths.size()), _begin(_paths.size()), _end(_paths.size()) {}
+
+    /// Calls tuple(begin, end) for every tuple of the record, with the rows of every field as a range
+    /// [begin[f], end[f]); for the flattened fields, this is a single row.
+    template<typename Tuple, typename... Rows>
+    void Flatten(Tuple&& tuple, const Rows&... rows) {
+        assert(sizeof...(rows) == _paths.size());
+        size_t f = 0;
+        ((_levels[f] = rows.repetition_levels(), _begin[f] = 0, _end[f] = rows.size(), f++), ...);
+        _units.assign(1, { 0, 0, false });
+        Expand([&] { tuple(_begin.data(), _end.data()); });
+    }
+
+ private:
+    /// An instance of a repeated group at the given depth (the record at depth 0), or all instances of the
+    /// repeated group below it, if repeated is set. The fields below the group are those whose path matches
+    /// the path of the given field.
+    struct Unit {
+        unsigned depth;
+        size_t field;
+        bool repeated;
+    };
+
+    /// The repeated fields on the path of every field
+    std::vector<std::vector<unsigned>> _paths;
+    /// The number of fields that are flattened
+    size_t _flattened;
+    /// The repetition levels of every field, and the range of its rows in the current unit
+    std::vector<const unsigned*> _levels;
+    std::vector<size_t> _begin;
+    std::vector<size_t> _end;
+    /// The units that still have to be expanded for the current tuple
+    std::vector<Unit> _units;
+    /// The ranges of the fields in the repeated groups that are walked, to restore them afterwards
+    std::vector<size_t> _saved;
+
+    /// Whether a field is below the repeated group at the given depth that the other field is below.
+    bool Below(size_t field, unsigned depth, size_t other) const {
+        return _paths[field].size() >= depth && (depth == 0 || _paths[field][depth - 1] == _paths[other][depth - 1]);
+    }
+
+    /// Expands the pending units; emit is called when none is left.
+    template<typename Emit>
+    void Expand(const Emit& emit) {
+        if (_units.empty()) {
+            emit();
+            return;
+        }
+        Unit unit = _units.back();
+        _units.pop_back();
+        if (!unit.repeated) {
+            // The repeated groups directly below the instance are expanded one after the other for the cross product.
+            // Groups without flattened fields are not walked, their fields keep the rows of the whole instance.
+            size_t pending = _units.size();
+            for (size_t f = 0; f < _flattened; f++) {
+                if (!Below(f, unit.depth + 1, f) || !Below(f, unit.depth, unit.field)) {
+                    continue;
+                }
+                bool first = true;
+                for (size_t g = 0; g < f && first; g++) {
+                    first = !(Below(g, unit.depth + 1, f) && Below(g, unit.depth, unit.field));
+                }
+                if (first) {
+                    _units.push_back({ unit.depth, f, true });
+                }
+            }
+            Expand(emit);
+            _units.resize(pending);
+        } else {
+            // Every row with the repetition level of the group starts its next instance, in all fields below it.
+            const unsigned level = unit.depth + 1;
+            const size_t saved = _saved.size();
+            for (size_t f = 0; f < _paths.size(); f++) {
+                _saved.push_back(_begin[f]);
+                _saved.push_back(_end[f]);
+            }
+            while (_begin[unit.field] < _saved[saved + 2 * unit.field + 1]) {
+                for (size_t f = 0; f < _paths.size(); f++) {
+                    if (Below(f, level, unit.field)) {
+                        size_t row = _begin[f] + 1;
+                        while (row < _saved[saved + 2 * f + 1] && _levels[f][row] > level) {
+                            row++;
+                        }
+                        _end[f] = row;
+                    }
+                }
+                _units.push_back({ level, unit.field, false });
+                Expand(emit);
+                _units.pop_back();
+                for (size_t f = 0; f < _paths.size(); f++) {
+                    if (Below(f, level, unit.field)) {
+                        _begin[f] = _end[f];
+                    }
+                }
+            }
+            for (size_t f = 0; f < _paths.size(); f++) {
+                _begin[f] = _saved[saved + 2 * f];
+                _end[f] = _saved[saved + 2 * f + 1];
+            }
+            _saved.resize(saved);
+        }
+        _units.push_back(unit);
+    }
 };
 
 //---------------------------------------------------------------------------
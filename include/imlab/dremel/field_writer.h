@@ -57,6 +57,16 @@ class ProtoFieldValue {
         }
     }
 
+    /// Get a reference to the value of a string field without copying it. Only works if HasValue() is true.
+    /// `scratch` is only used if the string is not stored as a std::string in the message.
+    [[nodiscard]] const std::string& GetStringReference(std::string* scratch) const {
+        if (_field->is_repeated()) {
+            return _ref->GetRepeatedStringReference(_msg, _field, _index, scratch);
+        } else {
+            return _ref->GetStringReference(_msg, _field, scratch);
+        }
+    }
+
  private:
     const Reflection* _ref;
     const Message& _msg;
@@ -135,12 +145,12 @@ class AtomicFieldWriter : public FieldWriter {
         : FieldWriter(column->field()), _column(column) {}
     /// Writes an explicitly given value into the column with the given repetition level.
     /// The definition level is the definition level of this writer.
-    void write_value(T value, unsigned repetition_level) {
-        _column->insert({ value, repetition_level, _definition_level });
+    void write_value(typename ValueStore<T>::const_reference value, unsigned repetition_level) {
+        _column->insert_value(value, repetition_level);
     }
  protected:
     void write(unsigned repetition_level, unsigned definition_level) override {
-        _column->insert({ std::nullopt, repetition_level, definition_level });
+        _column->insert_null(repetition_level, definition_level);
     }
  private:
     DremelColumn<T>* _column;
@@ -172,9 +182,12 @@ inline void WriteField(FieldWriter* writer, const ProtoFieldValue& value, unsign
                 value.GetFieldValue<uint64_t>(), repetition_level);
             break;
         case FieldDescriptor::CPPTYPE_STRING:
+        {
+            std::string scratch;
             dynamic_cast<AtomicFieldWriter<std::string>*>(writer)->write_value(
-                value.GetFieldValue<std::string>(), repetition_level);
+                value.GetStringReference(&scratch), repetition_level);
             break;
+        }
         case FieldDescriptor::CPPTYPE_DOUBLE:  // UNSUPPRTED
         case FieldDescriptor::CPPTYPE_FLOAT:  // UNSUPPRTED
         case FieldDescriptor::CPPTYPE_BOOL:  // UNSUPPRTED
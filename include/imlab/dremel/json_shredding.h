@@ -0,0 +1,466 @@
+// ---------------------------------------------------------------------------
+// IMLAB
+// ---------------------------------------------------------------------------
+#ifndef INCLUDE_IMLAB_DREMEL_JSON_SHREDDING_H_
+#define INCLUDE_IMLAB_DREMEL_JSON_SHREDDING_H_
+//---------------------------------------------------------------------------
+#include <cstdint>
+#include <istream>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include "./storage.h"
+#include "./field_writer.h"
+#include "../infra/error.h"
+#include "rapidjson/reader.h"
+#include "rapidjson/error/en.h"
+#include <google/protobuf/descriptor.h>
+//---------------------------------------------------------------------------
+namespace imlab {
+namespace dremel {
+//---------------------------------------------------------------------------
+
+/// A rapidjson input stream that reads a std::istream in large chunks.
+/// (rapidjson's IStreamWrapper reads the stream a few characters at a time.)
+class JsonInputStream {
+ public:
+    using Ch = char;
+
+    /// The number of characters that are read from the stream at once.
+    static constexpr size_t kBufferSize = 1 << 16;
+
+    explicit JsonInputStream(std::istream& in) : _in(in), _buffer(kBufferSize) {
+        _current = _end = _buffer.data();
+        Refill();
+    }
+
+    Ch Peek() const { return _current < _end ? *_current : '\0'; }
+    Ch Take() {
+        if (_current == _end) {
+            return '\0';
+        }
+        Ch c = *_current++;
+        if (_current == _end) {
+            Refill();
+        }
+        return c;
+    }
+    size_t Tell() const { return _consumed + (_current - _buffer.data()); }
+
+    // Only needed for in-situ parsing, which this stream does not support.
+    Ch* PutBegin() { assert(false); return nullptr; }
+    void Put(Ch) { assert(false); }
+    void Flush() { assert(false); }
+    size_t PutEnd(Ch*) { assert(false); return 0; }
+
+ private:
+    std::istream& _in;
+    std::vector<Ch> _buffer;
+    const Ch* _current;
+    const Ch* _end;
+    /// Number of characters in all previous chunks.
+    size_t _consumed = 0;
+
+    void Refill() {
+        _consumed += _end - _buffer.data();
+        _in.read(_buffer.data(), _buffer.size());
+        _current = _buffer.data();
+        _end = _buffer.data() + _in.gcount();
+    }
+};
+
+
+/// Shreds JSON records straight into the columns of a table, without building a DOM or Protobuf messages.
+/// This is a handler for rapidjson's SAX reader: It tracks the position in the schema while the JSON is tokenized
+/// and hands every value to the AtomicFieldWriter of its column, together with its repetition level.
+/// The FieldWriters take care of the definition levels, also for fields that are missing in a record.
+///
+/// The input is an array of records, or a sequence of records if the shredder is created for `record_sequence`
+/// (e.g. newline-delimited JSON, where every value is parsed on its own).
+/// The keys of an object are the names of the fields in the schema file (e.g. "DocId", "Links", "Backward");
+/// unknown keys are ignored, a repeated field is an array and `null` is the same as a missing field.
+class JsonShredder {
+ public:
+    /// Creates a shredder for records of the given message that are written into the columns of a table.
+    JsonShredder(TableBase& table, const Descriptor* descriptor, bool record_sequence = false)
+        : _root(BuildNode(nullptr, descriptor, table.record_writer())) {
+        if (record_sequence) {
+            _stack.push_back({ &_root, 0, 0, true, true });
+        }
+    }
+
+    /// The number of records that were shredded completely.
+    uint64_t record_count() const { return _record_count; }
+    /// The reason why the handler stopped the parser.
+    const std::string& error() const { return _error; }
+
+    // rapidjson handler interface; returning false stops the parser.
+    bool Null() {
+        Node* field;
+        unsigned repetition_level;
+        if (!NextValue(&field, &repetition_level)) {
+            return false;
+        }
+        if (field == nullptr) {
+            return true;
+        }
+        if (_stack.back().array) {
+            return Fail("null in the repeated field " + field->name);
+        }
+        if (field->required) {
+            return Fail("the required field " + field->name + " is null");
+        }
+        field->writer->write(repetition_level);
+        return true;
+    }
+    bool Bool(bool value) {
+        return Write([&](Node* field, unsigned repetition_level) {
+            return field->type == FieldDescriptor::CPPTYPE_BOOL
+                && WriteValue<bool>(field, value, repetition_level);
+        });
+    }
+    bool Int(int value) { return Integer(static_cast<int64_t>(value)); }
+    bool Uint(unsigned value) { return Integer(static_cast<uint64_t>(value)); }
+    bool Int64(int64_t value) { return Integer(value); }
+    bool Uint64(uint64_t value) { return Integer(value); }
+    bool Double(double value) {
+        return Write([&](Node* field, unsigned repetition_level) {
+            switch (field->type) {
+                case FieldDescriptor::CPPTYPE_DOUBLE: return WriteValue<double>(field, value, repetition_level);
+                case FieldDescriptor::CPPTYPE_FLOAT: return WriteValue<float>(field, value, repetition_level);
+                default: return false;
+            }
+        });
+    }
+    bool RawNumber(const char*, rapidjson::SizeType, bool) { return Fail("unexpected raw number"); }
+    bool String(const char* value, rapidjson::SizeType length, bool) {
+        return Write([&](Node* field, unsigned repetition_level) {
+            return field->type == FieldDescriptor::CPPTYPE_STRING
+                && WriteValue<std::string>(field, std::string_view(value, length), repetition_level);
+        });
+    }
+    bool StartObject() {
+        if (_skipping) {
+            return Skip(1);
+        }
+        if (!_stack.empty() && _stack.back().records) {
+            _stack.push_back({ &_root, 0, ++_object_count, false, false });
+            return true;
+        }
+        Node* field;
+        unsigned repetition_level;
+        if (!NextValue(&field, &repetition_level)) {
+            return false;
+        }
+        if (field->type != FieldDescriptor::CPPTYPE_MESSAGE) {
+            return Fail("unexpected object for the field " + field->name);
+        }
+        _stack.push_back({ field, repetition_level, ++_object_count, false, false });
+        return true;
+    }
+    bool Key(const char* key, rapidjson::SizeType length, bool) {
+        if (_skipping) {
+            return true;
+        }
+        Frame& object = _stack.back();
+        std::string_view name(key, length);
+        for (auto& child : object.node->children) {
+            if (child.name == name) {
+                if (child.seen_in == object.object) {
+                    return Fail("duplicate field " + child.name);
+                }
+                _field = &child;
+                return true;
+            }
+        }
+        // The value of an unknown key is skipped.
+        _skipping = true;
+        _skip_depth = 0;
+        return true;
+    }
+    bool EndObject(rapidjson::SizeType) {
+        if (_skipping) {
+            return Skip(-1);
+        }
+        Frame object = _stack.back();
+        _stack.pop_back();
+        // Missing fields are NULL.
+        for (auto& child : object.node->children) {
+            if (child.seen_in != object.object) {
+                if (child.required) {
+                    return Fail("the required field " + child.name + " is missing");
+                }
+                child.writer->write(object.repetition_level);
+            }
+        }
+        if (_stack.back().records) {
+            _record_count++;
+        }
+        return true;
+    }
+    bool StartArray() {
+        if (_skipping) {
+            return Skip(1);
+        }
+        if (_stack.empty()) {
+            _stack.push_back({ &_root, 0, 0, true, true });
+            return true;
+        }
+        Frame& object = _stack.back();
+        if (object.array || _field == nullptr) {
+            return Fail("unexpected array");
+        }
+        if (!_field->repeated) {
+            return Fail("unexpected array for the field " + _field->name);
+        }
+        _stack.push_back({ _field, object.repetition_level, object.object, true, false });
+        _field = nullptr;
+        return true;
+    }
+    bool EndArray(rapidjson::SizeType) {
+        if (_skipping) {
+            return Skip(-1);
+        }
+        Frame array = _stack.back();
+        _stack.pop_back();
+        if (!array.records && array.node->seen_in != array.object) {
+            // An empty repetition is NULL.
+            array.node->seen_in = array.object;
+            array.node->writer->write(array.repetition_level);
+        }
+        return true;
+    }
+
+ protected:
+    /// A field of the schema.
+    struct Node {
+        /// The name of the field in the schema file, which is also its key.
+        std::string name;
+        /// The writer of the field.
+        FieldWriter* writer;
+        /// The type of the values; CPPTYPE_MESSAGE for nested fields.
+        FieldDescriptor::CppType type;
+        bool repeated;
+        bool required;
+        /// The repetition level of the field, which every value but the first one in a record has.
+        unsigned repetition_level;
+        /// The fields of a nested field.
+        std::vector<Node> children;
+        /// The object in which the field has last been seen.
+        uint64_t seen_in = 0;
+    };
+    /// An object or array that the tokenizer is currently in.
+    struct Frame {
+        /// The message of an object or the repeated field of an array.
+        Node* node;
+        /// The repetition level of the first value in the object (of an array: in the enclosing object).
+        unsigned repetition_level;
+        /// Identifies the object (of an array: the enclosing object).
+        uint64_t object;
+        bool array;
+        /// Whether this is the top-level array of records.
+        bool records;
+    };
+
+    /// The message of the records.
+    Node _root;
+    /// The objects and arrays that the tokenizer is in, the innermost last.
+    std::vector<Frame> _stack;
+    /// The field of the last key.
+    Node* _field = nullptr;
+    /// Whether the value of an unknown key is skipped, and how deeply nested the tokenizer is in it.
+    bool _skipping = false;
+    unsigned _skip_depth = 0;
+    /// Number of objects so far, used to identify them.
+    uint64_t _object_count = 0;
+    uint64_t _record_count = 0;
+    std::string _error;
+
+    /// Builds the tree of fields below the given writer.
+    static Node BuildNode(const FieldDescriptor* field, const Descriptor* descriptor, FieldWriter* writer) {
+        Node node {
+            field == nullptr ? descriptor->name() : field->name(), writer,
+            FieldDescriptor::CPPTYPE_MESSAGE,
+            field != nullptr && field->is_repeated(),
+            field != nullptr && field->is_required(),
+            field == nullptr ? 0 : GetMaxRepetitionLevel(field),
+            {}
+        };
+        auto* complex_writer = dynamic_cast<ComplexFieldWriter*>(writer);
+        for (int i = 0; i < descriptor->field_count(); i++) {
+            auto* child = descriptor->field(i);
+            auto* child_writer = complex_writer->find_child_writer(child->number()).value();
+            if (child->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE) {
+                node.children.push_back(BuildNode(child, child->message_type(), child_writer));
+                // Nested fields are named after their message type, like the columns (see protoc-gen-schema.py).
+                node.children.back().name = child->message_type()->name();
+            } else {
+                node.children.push_back({
+                    child->name(), child_writer, child->cpp_type(), child->is_repeated(), child->is_required(),
+                    GetMaxRepetitionLevel(child), {}
+                });
+            }
+        }
+        return node;
+    }
+
+    /// Stops the parser with an error.
+    bool Fail(std::string error) {
+        _error = std::move(error);
+        return false;
+    }
+
+    /// Tracks the nesting while the value of an unknown key is skipped.
+    bool Skip(int depth) {
+        _skip_depth += depth;
+        _skipping = _skip_depth != 0;
+        return true;
+    }
+
+    /// Finds the field of the next value and the repetition level of the value.
+    /// The field is nullptr if the value is skipped.
+    bool NextValue(Node** field, unsigned* repetition_level) {
+        if (_skipping) {
+            _skipping = _skip_depth != 0;
+            *field = nullptr;
+            return true;
+        }
+        if (_stack.empty()) {
+            return Fail("expected an array of records");
+        }
+        if (_stack.back().records) {
+            return Fail("expected a record");
+        }
+        Frame& frame = _stack.back();
+        if (frame.array) {
+            // Every value of a repeated field but the first one in the record repeats the field.
+            *field = frame.node;
+            *repetition_level = frame.node->seen_in == frame.object ? frame.node->repetition_level : frame.repetition_level;
+        } else {
+            *field = _field;
+            *repetition_level = frame.repetition_level;
+            _field = nullptr;
+        }
+        (*field)->seen_in = frame.object;
+        return true;
+    }
+
+    /// Writes a non-NULL value; write returns false if the type of the value does not fit the field.
+    template<typename Function>
+    bool Write(Function&& write) {
+        Node* field;
+        unsigned repetition_level;
+        if (!NextValue(&field, &repetition_level)) {
+            return false;
+        }
+        if (field == nullptr) {
+            return true;
+        }
+        if (field->type == FieldDescriptor::CPPTYPE_MESSAGE || !write(field, repetition_level)) {
+            return Fail("unexpected value for the field " + field->name);
+        }
+        return true;
+    }
+
+    /// Writes an integer into a column of any numeric type it fits into.
+    template<typename V>
+    bool Integer(V value) {
+        return Write([&](Node* field, unsigned repetition_level) {
+            switch (field->type) {
+                case FieldDescriptor::CPPTYPE_INT32:
+                    return Fits<int32_t>(value) && WriteValue<int32_t>(field, value, repetition_level);
+                case FieldDescriptor::CPPTYPE_INT64:
+                    return Fits<int64_t>(value) && WriteValue<int64_t>(field, value, repetition_level);
+                case FieldDescriptor::CPPTYPE_UINT32:
+                    return Fits<uint32_t>(value) && WriteValue<uint32_t>(field, value, repetition_level);
+                case FieldDescriptor::CPPTYPE_UINT64:
+                    return Fits<uint64_t>(value) && WriteValue<uint64_t>(field, value, repetition_level);
+                case FieldDescriptor::CPPTYPE_DOUBLE:
+                    return WriteValue<double>(field, value, repetition_level);
+                case FieldDescriptor::CPPTYPE_FLOAT:
+                    return WriteValue<float>(field, value, repetition_level);
+                default:
+                    return false;
+            }
+        });
+    }
+
+    /// Whether an integer can be represented by T.
+    template<typename T, typename V>
+    static bool Fits(V value) {
+        if constexpr (std::is_signed_v<V>) {
+            if (value < 0) {
+                return std::is_signed_v<T> && value >= static_cast<int64_t>(std::numeric_limits<T>::min());
+            }
+        }
+        return static_cast<uint64_t>(value) <= static_cast<uint64_t>(std::numeric_limits<T>::max());
+    }
+
+    /// Writes a value into the column of a field. The type of the field has been checked before.
+    template<typename T, typename V>
+    static bool WriteValue(Node* field, const V& value, unsigned repetition_level) {
+        static_cast<AtomicFieldWriter<T>*>(field->writer)->write_value(
+            static_cast<typename ValueStore<T>::const_reference>(value), repetition_level);
+        return true;
+    }
+};
+
+
+/// Shreds a JSON array of records of the given message into the columns of a table and returns their number.
+/// The caller has to account for the new records in the size of the table.
+/// If the JSON turns out to be invalid while the columns are filled, the table is left in an undefined state.
+inline uint64_t ShredJson(TableBase& table, const Descriptor* descriptor, std::istream& in) {
+    JsonInputStream stream(in);
+    JsonShredder shredder(table, descriptor);
+    rapidjson::Reader reader;
+    rapidjson::ParseResult result = reader.Parse(stream, shredder);
+    if (!result) {
+        std::string reason = result.Code() == rapidjson::kParseErrorTermination && !shredder.error().empty()
+            ? shredder.error() : rapidjson::GetParseError_En(result.Code());
+        throw FileFormatError("invalid JSON at offset " + std::to_string(result.Offset()) + ": " + reason);
+    }
+    return shredder.record_count();
+}
+
+/// Shreds newline-delimited JSON records (or any other sequence of records that is not wrapped in an array)
+/// of the given message into the columns of a table and returns their number.
+/// The caller has to account for the new records in the size of the table.
+inline uint64_t ShredJsonLines(TableBase& table, const Descriptor* descriptor, const std::string& json) {
+    rapidjson::StringStream stream(json.c_str());
+    JsonShredder shredder(table, descriptor, true);
+    rapidjson::Reader reader;
+    for (rapidjson::SkipWhitespace(stream); stream.Peek() != '\0'; rapidjson::SkipWhitespace(stream)) {
+        rapidjson::ParseResult result = reader.Parse<rapidjson::kParseStopWhenDoneFlag>(stream, shredder);
+        if (!result) {
+            std::string reason = result.Code() == rapidjson::kParseErrorTermination && !shredder.error().empty()
+                ? shredder.error() : rapidjson::GetParseError_En(result.Code());
+            throw FileFormatError("invalid JSON at offset " + std::to_string(result.Offset()) + ": " + reason);
+        }
+    }
+    return shredder.record_count();
+}
+
+/// Reads the next chunk of newline-delimited JSON: about chunk_size bytes up to the end of a line.
+/// Returns false if the stream is exhausted.
+inline bool ReadJsonLines(std::istream& in, std::string* chunk, size_t chunk_size) {
+    chunk->resize(chunk_size);
+    in.read(chunk->data(), chunk_size);
+    chunk->resize(in.gcount());
+    if (chunk->empty()) {
+        return false;
+    }
+    std::string rest;
+    if (chunk->back() != '\n' && std::getline(in, rest)) {
+        chunk->append(rest);
+    }
+    return true;
+}
+
+//---------------------------------------------------------------------------
+}  // namespace dremel
+}  // namespace imlab
+//---------------------------------------------------------------------------
+#endif  // INCLUDE_IMLAB_DREMEL_JSON_SHREDDING_H_
+//---------------------------------------------------------------------------
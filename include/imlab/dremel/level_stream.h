@@ -0,0 +1,407 @@
+// ---------------------------------------------------------------------------
+// IMLAB
+// ---------------------------------------------------------------------------
+#ifndef INCLUDE_IMLAB_DREMEL_LEVEL_STREAM_H_
+#define INCLUDE_IMLAB_DREMEL_LEVEL_STREAM_H_
+//---------------------------------------------------------------------------
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include "../infra/binary_file.h"
+#include "../infra/bit_packed_vector.h"
+#include "../infra/bits.h"
+#include "../infra/buffer.h"
+#include "../infra/simd.h"
+//---------------------------------------------------------------------------
+namespace imlab {
+namespace dremel {
+//---------------------------------------------------------------------------
+
+/// An append-only stream of repetition or definition levels.
+///
+/// Levels in nested data are highly repetitive (think of a required field where every row has r=0 and d=max),
+/// so the stream uses a hybrid of run-length encoding and bit-packing similar to Parquet:
+///  * a sequence of at least kMinRunLength equal levels becomes one RLE run that only stores the level once.
+///  * everything else is bit-packed with as many bits as the maximum level needs.
+/// If the maximum level is 0, nothing is stored at all.
+///
+/// Random access needs a binary search over the runs; sequential access should go through a Cursor
+/// that can also skip and count whole runs at once. Within bit-packed runs, the cursor unpacks 64 levels
+/// at a time and compares them with SIMD kernels (see simd.h) to count, find or mask levels.
+class LevelStream {
+ public:
+    /// A sequence of equal levels needs to be at least this long to be run-length encoded.
+    static constexpr uint32_t kMinRunLength = 8;
+
+    /// A run of levels that is either run-length encoded or bit-packed.
+    struct Run {
+        /// Position of the first level of the run in the stream.
+        uint64_t begin;
+        /// RLE: The repeated level. Bit-packed: Position of the first level in the bit-packed levels.
+        uint64_t payload;
+        /// Number of levels in the run.
+        uint32_t length;
+        /// Whether the levels of the run are stored individually.
+        bool bit_packed;
+        /// Runs are written as they are, so the padding is explicit and zeroed to keep the files deterministic.
+        uint8_t padding[3] = {};
+
+        uint64_t end() const { return begin + length; }
+    };
+    static_assert(sizeof(Run) == 24, "a Run must not have implicit padding");
+
+    /// Creates an empty stream for levels up to max_level.
+    explicit LevelStream(unsigned max_level) : _packed(BitWidth(max_level)) {}
+
+    /// Reads a stream for levels up to max_level that was written with write(). The runs and levels are not copied,
+    /// but checked once, so that a corrupt file can't make a cursor read beyond the runs or the bit-packed levels.
+    LevelStream(unsigned max_level, BinaryReader& reader)
+        : _size(reader.read<uint64_t>()), _runs(reader.read_buffer<Run>()), _packed(reader),
+          _last_level(reader.read<uint32_t>()), _trailing_repetitions(reader.read<uint32_t>()) {
+        if (!IsValid(max_level)) {
+            throw FileFormatError("invalid level stream");
+        }
+    }
+
+    /// Appends a level to the stream.
+    void push_back(unsigned level) {
+        _size++;
+        if (_packed.bit_width() == 0) {
+            return;  // Every level is 0.
+        }
+
+        // The common case: the level extends the trailing RLE run (whose level is always _last_level).
+        if (level == _last_level && !_runs.empty()) {
+            Run& run = _runs.mutable_back();
+            if (!run.bit_packed && run.length < std::numeric_limits<uint32_t>::max()) {
+                run.length++;
+                return;
+            }
+        }
+        if (_runs.empty() || !_runs.back().bit_packed || _runs.back().length == std::numeric_limits<uint32_t>::max()) {
+            _runs.push_back({ _size - 1, _packed.size(), 0, true });
+        }
+        _packed.push_back(level);
+        _runs.mutable_back().length++;
+
+        // Once the bit-packed run ends in enough equal levels, move them into a new RLE run.
+        _trailing_repetitions = (level == _last_level) ? _trailing_repetitions + 1 : 1;
+        if (_trailing_repetitions == kMinRunLength) {
+            _packed.truncate(_packed.size() - kMinRunLength);
+            _runs.mutable_back().length -= kMinRunLength;
+            if (_runs.back().length == 0) {
+                _runs.pop_back();
+            }
+            _runs.push_back({ _size - kMinRunLength, level, kMinRunLength, false });
+        }
+        _last_level = level;
+    }
+
+    /// Returns the level at the given position.
+    unsigned operator[](uint64_t index) const {
+        assert(index < _size);
+        if (_packed.bit_width() == 0) {
+            return 0;
+        }
+        return Get(_runs[FindRun(index)], index);
+    }
+
+    /// Returns the number of levels in the stream.
+    uint64_t size() const { return _size; }
+
+    /// Returns the runs of the stream.
+    const Buffer<Run>& runs() const { return _runs; }
+
+    /// Returns the number of bytes that are allocated for this stream.
+    uint64_t memory_usage() const { return _runs.capacity() * sizeof(Run) + _packed.memory_usage(); }
+
+    /// Writes the stream to a file.
+    void write(BinaryWriter& writer) const {
+        writer.write<uint64_t>(_size);
+        writer.write_buffer(_runs);
+        _packed.write(writer);
+        writer.write<uint32_t>(_last_level);
+        writer.write<uint32_t>(_trailing_repetitions);
+    }
+
+    /// A read cursor on a LevelStream.
+    /// Reading sequentially through a Cursor never needs to search for the current run.
+    class Cursor {
+     public:
+        /// Creates a cursor pointing to the given position of the stream.
+        Cursor(const LevelStream* stream, uint64_t position)
+            : _stream(stream), _position(position), _run(stream->FindRun(position)) {}
+
+        /// The position of the cursor in the stream.
+        uint64_t position() const { return _position; }
+
+        /// Whether the cursor points behind the last level.
+        bool at_end() const { return _position >= _stream->size(); }
+
+        /// Returns the level under the cursor (0 if the cursor is at the end).
+        unsigned Get() const {
+            if (_run >= _stream->_runs.size()) {
+                return 0;
+            }
+            return _stream->Get(_stream->_runs[_run], _position);
+        }
+
+        /// Returns the number of levels that follow in the current run, including the one under the cursor.
+        /// Within these levels, the cursor can move without crossing a run boundary.
+        uint64_t RemainingInRun() const {
+            if (_run >= _stream->_runs.size()) {
+                return _stream->size() - std::min(_position, _stream->size());
+            }
+            return _stream->_runs[_run].end() - _position;
+        }
+
+        /// Moves the cursor to the next level.
+        void Next() {
+            _position++;
+            if (_run < _stream->_runs.size() && _position >= _stream->_runs[_run].end()) {
+                _run++;
+            }
+        }
+
+        /// Moves the cursor n levels forward, skipping whole runs where possible.
+        void Skip(uint64_t n) {
+            _position += n;
+            while (_run < _stream->_runs.size() && _position >= _stream->_runs[_run].end()) {
+                _run++;
+            }
+        }
+
+        /// Counts how often the given level occurs in the next n levels and moves the cursor behind them.
+        /// Run-length encoded runs are counted without looking at the individual levels.
+        uint64_t Count(unsigned level, uint64_t n) {
+            n = std::min(n, _stream->size() - std::min(_position, _stream->size()));
+            if (_stream->_packed.bit_width() == 0) {
+                _position += n;
+                return (level == 0) ? n : 0;
+            }
+            uint64_t count = 0;
+            while (n > 0) {
+                const auto& run = _stream->_runs[_run];
+                uint64_t step = std::min<uint64_t>(n, run.end() - _position);
+                if (!run.bit_packed) {
+                    count += (run.payload == level) ? step : 0;
+                } else {
+                    for (uint64_t i = 0; i < step; i += 64) {
+                        uint64_t chunk = std::min<uint64_t>(64, step - i);
+                        count += __builtin_popcountll(PackedMask(run, _position + i, chunk, level));
+                    }
+                }
+                Skip(step);
+                n -= step;
+            }
+            return count;
+        }
+
+        /// Moves the cursor forward to the n-th occurrence (counting from 0) of the given level,
+        /// starting with the level under the cursor. Returns the number of levels that were skipped.
+        /// If there are not enough occurrences, the cursor ends up at the end of the stream.
+        uint64_t SkipToOccurrence(unsigned level, uint64_t n) {
+            const uint64_t start = _position;
+            if (_stream->_packed.bit_width() == 0) {
+                _position = (level == 0) ? std::min(_position + n, _stream->size()) : _stream->size();
+                return _position - start;
+            }
+            while (_run < _stream->_runs.size()) {
+                const auto& run = _stream->_runs[_run];
+                if (!run.bit_packed) {
+                    uint64_t step = run.end() - _position;
+                    if (run.payload == level) {
+                        if (n < step) {
+                            _position += n;
+                            return _position - start;
+                        }
+                        n -= step;
+                    }
+                    Skip(step);
+                } else {
+                    while (_position < run.end()) {
+                        uint64_t chunk = std::min<uint64_t>(64, run.end() - _position);
+                        uint64_t mask = PackedMask(run, _position, chunk, level);
+                        uint64_t occurrences = __builtin_popcountll(mask);
+                        if (n < occurrences) {
+                            _position += NthSetBit(mask, n);
+                            return _position - start;
+                        }
+                        n -= occurrences;
+                        _position += chunk;
+                    }
+                    _run++;
+                }
+            }
+            return _position - start;
+        }
+
+        /// Decodes the next n levels into a buffer and moves the cursor behind them.
+        /// Returns the number of decoded levels (less than n at the end of the stream).
+        uint64_t Decode(uint8_t* out, uint64_t n) {
+            n = std::min(n, _stream->size() - std::min(_position, _stream->size()));
+            if (_stream->_packed.bit_width() == 0) {
+                std::memset(out, 0, n);
+                _position += n;
+                return n;
+            }
+            uint64_t decoded = 0;
+            while (decoded < n) {
+                const auto& run = _stream->_runs[_run];
+                uint64_t step = std::min<uint64_t>(n - decoded, run.end() - _position);
+                if (!run.bit_packed) {
+                    std::memset(out + decoded, static_cast<uint8_t>(run.payload), step);
+                } else {
+                    _stream->_packed.decode(run.payload + _position - run.begin, step, out + decoded);
+                }
+                Skip(step);
+                decoded += step;
+            }
+            return n;
+        }
+
+        /// Decodes the next n levels into a bitmask and moves the cursor behind them:
+        /// Bit offset + i of masks (64 bits per word) is set if the i-th level equals the given level.
+        /// Other bits are left as they are, so the masks have to be cleared before.
+        /// Returns the number of decoded levels (less than n at the end of the stream).
+        uint64_t DecodeMask(unsigned level, uint64_t n, uint64_t* masks, uint64_t offset = 0) {
+            n = std::min(n, _stream->size() - std::min(_position, _stream->size()));
+            if (_stream->_packed.bit_width() == 0) {
+                if (level == 0) {
+                    SetBits(masks, offset, n);
+                }
+                _position += n;
+                return n;
+            }
+            uint64_t decoded = 0;
+            while (decoded < n) {
+                const auto& run = _stream->_runs[_run];
+                uint64_t step = std::min<uint64_t>(n - decoded, run.end() - _position);
+                if (!run.bit_packed) {
+                    if (run.payload == level) {
+                        SetBits(masks, offset + decoded, step);
+                    }
+                } else {
+                    for (uint64_t i = 0; i < step; i += 64) {
+                        uint64_t chunk = std::min<uint64_t>(64, step - i);
+                        OrBits(masks, offset + decoded + i, PackedMask(run, _position + i, chunk, level), chunk);
+                    }
+                }
+                Skip(step);
+                decoded += step;
+            }
+            return n;
+        }
+
+     private:
+        const LevelStream* _stream;
+        uint64_t _position;
+        uint64_t _run;
+
+        /// Returns a mask of the (up to 64) levels of a bit-packed run starting at the given position
+        /// that equal the given level.
+        uint64_t PackedMask(const Run& run, uint64_t position, uint64_t n, unsigned level) const {
+            uint8_t levels[64] = {};
+            _stream->_packed.decode(run.payload + position - run.begin, n, levels);
+            return EqualMask64(levels, level) & LowBits(n);
+        }
+
+        /// Sets the bits [begin, begin + n) of masks.
+        static void SetBits(uint64_t* masks, uint64_t begin, uint64_t n) {
+            while (n > 0) {
+                uint64_t bit = begin & 63;
+                uint64_t step = std::min(n, 64 - bit);
+                masks[begin >> 6] |= LowBits(step) << bit;
+                begin += step;
+                n -= step;
+            }
+        }
+
+        /// Copies the lowest n bits of a mask into masks, starting at bit begin.
+        static void OrBits(uint64_t* masks, uint64_t begin, uint64_t mask, uint64_t n) {
+            uint64_t bit = begin & 63;
+            masks[begin >> 6] |= mask << bit;
+            if (bit + n > 64) {
+                masks[(begin >> 6) + 1] |= mask >> (64 - bit);
+            }
+        }
+    };
+
+    /// Creates a cursor at the given position.
+    Cursor cursor(uint64_t position) const { return { this, position }; }
+
+ protected:
+    /// Number of levels in the stream.
+    uint64_t _size = 0;
+    /// The runs of the stream; they cover all levels without gaps.
+    Buffer<Run> _runs;
+    /// All levels of bit-packed runs.
+    BitPackedVector _packed;
+    /// The most recently appended level.
+    unsigned _last_level = std::numeric_limits<unsigned>::max();
+    /// Number of times _last_level was appended to the last bit-packed run in a row.
+    uint32_t _trailing_repetitions = 0;
+
+    /// Whether the runs cover exactly the levels of the stream, their payloads lie within the bit-packed levels,
+    /// and no level exceeds max_level.
+    bool IsValid(unsigned max_level) const {
+        if (_packed.bit_width() != BitWidth(max_level)) {
+            return false;
+        }
+        if (_packed.bit_width() == 0) {
+            return _runs.empty();
+        }
+        uint64_t end = 0;
+        for (const auto& run : _runs) {
+            if (run.begin != end || run.length == 0) {
+                return false;
+            }
+            if (run.bit_packed ? run.payload > _packed.size() || run.length > _packed.size() - run.payload
+                               : run.payload > max_level) {
+                return false;
+            }
+            end = run.end();
+        }
+        if (end != _size) {
+            return false;
+        }
+        // Bit-packed levels can only exceed the maximum if it doesn't use all of their bits.
+        if (max_level != LowBits(_packed.bit_width())) {
+            uint8_t levels[256];
+            for (uint64_t i = 0; i < _packed.size(); i += sizeof(levels)) {
+                uint64_t n = std::min<uint64_t>(sizeof(levels), _packed.size() - i);
+                _packed.decode(i, n, levels);
+                if (*std::max_element(levels, levels + n) > max_level) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    /// Returns the index of the run that contains the given position (or the number of runs if there is none).
+    uint64_t FindRun(uint64_t position) const {
+        auto it = std::upper_bound(_runs.begin(), _runs.end(), position, [](uint64_t p, const Run& run) {
+            return p < run.begin;
+        });
+        if (it == _runs.begin()) {
+            return _runs.size();
+        }
+        --it;
+        return (position < it->end()) ? it - _runs.begin() : _runs.size();
+    }
+
+    /// Returns the level at the given position of a run.
+    unsigned Get(const Run& run, uint64_t position) const {
+        return run.bit_packed ? _packed[run.payload + position - run.begin] : run.payload;
+    }
+};
+
+//---------------------------------------------------------------------------
+}  // namespace dremel
+}  // namespace imlab
+//---------------------------------------------------------------------------
+#endif  // INCLUDE_IMLAB_DREMEL_LEVEL_STREAM_H_
+//---------------------------------------------------------------------------
@@ -0,0 +1,1016 @@
+// ---------------------------------------------------------------------------
+// IMLAB
+// ---------------------------------------------------------------------------
+#ifndef INCLUDE_IMLAB_DREMEL_PARQUET_H_
+#define INCLUDE_IMLAB_DREMEL_PARQUET_H_
+//---------------------------------------------------------------------------
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include <google/protobuf/descriptor.h>
+#include "../infra/binary_file.h"
+#include "../infra/bits.h"
+#include "../infra/error.h"
+#include "../infra/thrift_compact.h"
+#include "./schema_helper.h"
+#include "./storage.h"
+//---------------------------------------------------------------------------
+namespace imlab {
+namespace dremel {
+//---------------------------------------------------------------------------
+using namespace google::protobuf;
+
+/// Parquet stores nested data exactly like Dremel: Every column chunk consists of repetition levels,
+/// definition levels and the non-NULL values, with the same semantics as in a DremelColumn.
+/// This file maps DremelColumns to Parquet files and back without any Parquet or Thrift library.
+///
+/// Supported is the subset of the format that is needed for the schemas of this project:
+///  * physical types BOOLEAN, INT32, INT64, FLOAT, DOUBLE and BYTE_ARRAY
+///  * uncompressed column chunks
+///  * data pages (V1 and V2) with levels in the RLE/bit-packing hybrid
+///  * PLAIN values and dictionary-encoded values (PLAIN_DICTIONARY, RLE_DICTIONARY)
+/// Everything else (compression, delta encodings, ...) is rejected with a FileFormatError.
+namespace parquet {
+
+/// Magic number at the beginning and the end of every Parquet file.
+constexpr std::string_view kMagic = "PAR1";
+
+/// Enums of the Parquet format (see parquet.thrift).
+enum PhysicalType : int32_t { kBoolean = 0, kInt32 = 1, kInt64 = 2, kFloat = 4, kDouble = 5, kByteArray = 6 };
+enum Repetition : int32_t { kRequired = 0, kOptional = 1, kRepeated = 2 };
+enum ConvertedType : int32_t { kUtf8 = 0, kList = 3, kUInt32 = 13, kUInt64 = 14 };
+enum Encoding : int32_t { kPlain = 0, kPlainDictionary = 2, kRle = 3, kRleDictionary = 8 };
+enum PageType : int32_t { kDataPage = 0, kDictionaryPage = 2, kDataPageV2 = 3 };
+enum Codec : int32_t { kUncompressed = 0 };
+
+/// Maps the value type of a DremelColumn to its Parquet type.
+template<typename T> struct TypeOf;
+template<> struct TypeOf<bool> { static constexpr PhysicalType kType = kBoolean; };
+template<> struct TypeOf<int32_t> { static constexpr PhysicalType kType = kInt32; };
+template<> struct TypeOf<uint32_t> { static constexpr PhysicalType kType = kInt32; };
+template<> struct TypeOf<int64_t> { static constexpr PhysicalType kType = kInt64; };
+template<> struct TypeOf<uint64_t> { static constexpr PhysicalType kType = kInt64; };
+template<> struct TypeOf<float> { static constexpr PhysicalType kType = kFloat; };
+template<> struct TypeOf<double> { static constexpr PhysicalType kType = kDouble; };
+template<> struct TypeOf<std::string> { static constexpr PhysicalType kType = kByteArray; };
+
+/// Returns the physical and converted type of a leaf field in a Parquet schema.
+inline std::pair<PhysicalType, std::optional<ConvertedType>> TypeOfField(const FieldDescriptor* field) {
+    switch (field->cpp_type()) {
+        case FieldDescriptor::CPPTYPE_BOOL: return { kBoolean, std::nullopt };
+        case FieldDescriptor::CPPTYPE_INT32: return { kInt32, std::nullopt };
+        case FieldDescriptor::CPPTYPE_UINT32: return { kInt32, kUInt32 };
+        case FieldDescriptor::CPPTYPE_INT64: return { kInt64, std::nullopt };
+        case FieldDescriptor::CPPTYPE_UINT64: return { kInt64, kUInt64 };
+        case FieldDescriptor::CPPTYPE_FLOAT: return { kFloat, std::nullopt };
+        case FieldDescriptor::CPPTYPE_DOUBLE: return { kDouble, std::nullopt };
+        case FieldDescriptor::CPPTYPE_STRING: return { kByteArray, kUtf8 };
+        default: throw FileFormatError("field " + field->full_name() + " can't be stored in Parquet");
+    }
+}
+
+/// Returns the name of a field in a Parquet schema.
+/// Groups are named like their message type, which keeps the capitalization of the schema file.
+inline std::string NameOf(const FieldDescriptor* field) {
+    return field->type() == FieldDescriptor::TYPE_GROUP ? field->message_type()->name() : field->name();
+}
+
+/// Returns the path of a leaf field from the root of the record.
+inline std::vector<std::string> PathOf(const FieldDescriptor* field) {
+    std::vector<std::string> path {};
+    for (; field != nullptr; field = GetParentField(field)) {
+        path.insert(path.begin(), NameOf(field));
+    }
+    return path;
+}
+
+/// Encodes levels (or other small integers) with the RLE/bit-packing hybrid:
+/// Runs of at least kMinRunLength equal values are run-length encoded, everything else is bit-packed in groups of 8.
+class RleEncoder {
+ public:
+    static constexpr uint64_t kMinRunLength = 8;
+
+    explicit RleEncoder(unsigned bit_width) : _bit_width(bit_width) {}
+
+    /// Appends count copies of a value.
+    void put(uint32_t value, uint64_t count = 1) {
+        if (count == 0) {
+            return;
+        }
+        if (_run_length > 0 && value == _run_value) {
+            _run_length += count;
+            return;
+        }
+        FlushRun();
+        _run_value = value;
+        _run_length = count;
+    }
+
+    /// Returns the encoded values.
+    std::string finish() {
+        FlushRun();
+        FlushLiterals();
+        return std::move(_out);
+    }
+
+ protected:
+    const unsigned _bit_width;
+    std::string _out;
+    /// The current run of equal values.
+    uint32_t _run_value = 0;
+    uint64_t _run_length = 0;
+    /// Values that will be bit-packed.
+    std::vector<uint32_t> _literals;
+
+    void FlushRun() {
+        if (_run_length >= kMinRunLength) {
+            // Bit-packed runs consist of groups of 8 values, so the run has to complete the last group.
+            uint64_t fill = (8 - _literals.size() % 8) % 8;
+            _literals.insert(_literals.end(), fill, _run_value);
+            _run_length -= fill;
+            FlushLiterals();
+            Varint(_run_length << 1);
+            for (unsigned byte = 0; byte < (_bit_width + 7) / 8; byte++) {
+                _out.push_back(static_cast<char>(_run_value >> (8 * byte)));
+            }
+        } else {
+            _literals.insert(_literals.end(), _run_length, _run_value);
+        }
+        _run_length = 0;
+    }
+
+    void FlushLiterals() {
+        if (_literals.empty()) {
+            return;
+        }
+        _literals.resize((_literals.size() + 7) / 8 * 8, 0);  // Padding at the end is ignored by readers.
+        Varint((_literals.size() / 8) << 1 | 1);
+        uint64_t buffer = 0;
+        unsigned bits = 0;
+        for (uint32_t value : _literals) {
+            buffer |= static_cast<uint64_t>(value) << bits;
+            bits += _bit_width;
+            while (bits >= 8) {
+                _out.push_back(static_cast<char>(buffer));
+                buffer >>= 8;
+                bits -= 8;
+            }
+        }
+        _literals.clear();
+    }
+
+    void Varint(uint64_t value) {
+        while (value >= 0x80) {
+            _out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        _out.push_back(static_cast<char>(value));
+    }
+};
+
+/// Decodes values that were encoded with the RLE/bit-packing hybrid.
+class RleDecoder {
+ public:
+    RleDecoder(const char* data, uint64_t size, unsigned bit_width)
+        : _data(reinterpret_cast<const uint8_t*>(data)), _end(_data + size), _bit_width(bit_width) {
+        if (bit_width > 32) {
+            throw FileFormatError("invalid bit width in Parquet data");
+        }
+    }
+
+    /// Decodes the next n values.
+    void decode(uint32_t* out, uint64_t n) {
+        while (n > 0) {
+            if (_remaining == 0) {
+                NextRun();
+            }
+            uint64_t step = std::min(n, _remaining);
+            if (_literal) {
+                for (uint64_t i = 0; i < step; i++) {
+                    out[i] = Unpack(_position++);
+                }
+            } else {
+                std::fill(out, out + step, _run_value);
+            }
+            out += step;
+            n -= step;
+            _remaining -= step;
+        }
+    }
+
+ protected:
+    const uint8_t* _data;
+    const uint8_t* _end;
+    const unsigned _bit_width;
+    /// Number of values left in the current run.
+    uint64_t _remaining = 0;
+    /// Whether the current run is bit-packed.
+    bool _literal = false;
+    /// RLE: The repeated value.
+    uint32_t _run_value = 0;
+    /// Bit-packed: The first byte of the run and the index of the next value in it.
+    const uint8_t* _literals = nullptr;
+    uint64_t _position = 0;
+
+    void NextRun() {
+        uint64_t header = Varint();
+        if (header & 1) {
+            _literal = true;
+            _remaining = (header >> 1) * 8;
+            _literals = _data;
+            _position = 0;
+            _data += std::min<uint64_t>((header >> 1) * _bit_width, _end - _data);
+        } else {
+            _literal = false;
+            _remaining = header >> 1;
+            _run_value = 0;
+            for (unsigned byte = 0; byte < (_bit_width + 7) / 8; byte++) {
+                _run_value |= static_cast<uint32_t>(Byte()) << (8 * byte);
+            }
+        }
+        if (_remaining == 0) {
+            throw FileFormatError("empty run in Parquet data");
+        }
+    }
+
+    uint32_t Unpack(uint64_t index) const {
+        uint64_t bit = index * _bit_width;
+        uint64_t value = 0;
+        for (unsigned shift = 0; shift < _bit_width + (bit & 7); shift += 8) {
+            const uint8_t* byte = _literals + (bit >> 3) + shift / 8;
+            if (byte >= _data) {
+                throw FileFormatError("unexpected end of Parquet data");
+            }
+            value |= static_cast<uint64_t>(*byte) << shift;
+        }
+        return static_cast<uint32_t>((value >> (bit & 7)) & ((1ull << _bit_width) - 1));
+    }
+
+    uint8_t Byte() {
+        if (_data == _end) {
+            throw FileFormatError("unexpected end of Parquet data");
+        }
+        return *_data++;
+    }
+
+    uint64_t Varint() {
+        uint64_t value = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7) {
+            uint8_t byte = Byte();
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                return value;
+            }
+        }
+        throw FileFormatError("invalid varint in Parquet data");
+    }
+};
+
+/// Encodes values with the PLAIN encoding: Fixed-size values in little endian, strings prefixed with their length
+/// and booleans bit-packed.
+template<typename T>
+class PlainEncoder {
+ public:
+    void put(typename ValueStore<T>::const_reference value) {
+        if constexpr (std::is_same_v<T, bool>) {
+            if (value) {
+                _bits |= 1 << _bit_count;
+            }
+            if (++_bit_count == 8) {
+                _out.push_back(static_cast<char>(_bits));
+                _bits = _bit_count = 0;
+            }
+        } else if constexpr (std::is_same_v<T, std::string>) {
+            uint32_t length = value.size();
+            _out.append(reinterpret_cast<const char*>(&length), sizeof(length));
+            _out.append(value.data(), value.size());
+        } else {
+            _out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+    }
+
+    /// Returns the encoded values.
+    std::string finish() {
+        if (_bit_count > 0) {
+            _out.push_back(static_cast<char>(_bits));
+        }
+        return std::move(_out);
+    }
+
+ protected:
+    std::string _out;
+    /// Booleans that don't fill a byte yet.
+    unsigned _bits = 0;
+    unsigned _bit_count = 0;
+};
+
+/// Decodes values in the PLAIN encoding. Strings are returned as views into the input.
+template<typename T>
+class PlainDecoder {
+ public:
+    PlainDecoder(const char* data, uint64_t size) : _data(data), _end(data + size) {}
+
+    typename ValueStore<T>::const_reference next() {
+        if constexpr (std::is_same_v<T, bool>) {
+            if (_data == _end) {
+                throw FileFormatError("unexpected end of Parquet values");
+            }
+            bool value = (*_data >> _bit) & 1;
+            if (++_bit == 8) {
+                _bit = 0;
+                _data++;
+            }
+            return value;
+        } else if constexpr (std::is_same_v<T, std::string>) {
+            uint32_t length;
+            std::memcpy(&length, Bytes(sizeof(length)), sizeof(length));
+            return { Bytes(length), length };
+        } else {
+            T value;
+            std::memcpy(&value, Bytes(sizeof(T)), sizeof(T));
+            _value = value;
+            return _value;
+        }
+    }
+
+ protected:
+    const char* _data;
+    const char* _end;
+    /// The next bit of a boolean.
+    unsigned _bit = 0;
+    /// The last decoded value (which is returned by reference).
+    T _value {};
+
+    const char* Bytes(uint64_t size) {
+        if (size > static_cast<uint64_t>(_end - _data)) {
+            throw FileFormatError("unexpected end of Parquet values");
+        }
+        const char* bytes = _data;
+        _data += size;
+        return bytes;
+    }
+};
+
+/// A leaf column of a Parquet schema.
+struct LeafColumn {
+    /// The names of all nodes from the root to the leaf.
+    std::vector<std::string> path;
+    /// The path of the field that is stored in the column. Lists in the 3-level LIST convention
+    /// (a LIST group that contains a repeated group with the element) become a single repeated field here.
+    std::vector<std::string> field_path;
+    PhysicalType type;
+    unsigned max_repetition_level;
+    unsigned max_definition_level;
+};
+
+/// Writes DremelColumns into a Parquet file.
+/// Records are written in row groups: For every row group, the column chunk of every column is written
+/// with write_column_chunk() (in the order of the schema) before the row group is closed with end_row_group().
+class Writer {
+ public:
+    /// Every data page contains at most this many records.
+    static constexpr uint64_t kRecordsPerPage = 1 << 12;
+
+    /// Starts a file for records of the given message type.
+    Writer(std::ostream& out, const Descriptor* descriptor) : _out(out) {
+        Write(kMagic);
+        // The schema is flattened in depth-first order, groups are followed by their children.
+        CompactSchemaElement(descriptor->name(), std::nullopt, descriptor->field_count(), std::nullopt, std::nullopt);
+        WriteSchema(descriptor);
+    }
+
+    /// Writes the rows of the given records of a column as one column chunk of the current row group.
+    template<typename T>
+    void write_column_chunk(DremelColumn<T>& column, uint64_t begin_record, uint64_t end_record) {
+        const uint64_t chunk_offset = _offset;
+        uint64_t values = 0;
+        for (uint64_t record = begin_record; record < end_record; record += kRecordsPerPage) {
+            TID begin = column.record_start(record);
+            TID end = column.record_start(std::min(record + kRecordsPerPage, end_record));
+            WriteDataPage(column, begin, end);
+            values += end - begin;
+        }
+
+        thrift::CompactWriter chunk(&_row_group_columns);
+        chunk.begin_element_struct();
+        chunk.field_i64(2, chunk_offset);  // file_offset
+        chunk.begin_struct(3);  // meta_data
+        chunk.field_i32(1, TypeOf<T>::kType);
+        chunk.begin_list(2, thrift::kI32, 2);  // encodings
+        chunk.element_i32(kPlain);
+        chunk.element_i32(kRle);
+        auto path = PathOf(column.field());
+        chunk.begin_list(3, thrift::kBinary, path.size());  // path_in_schema
+        for (auto& name : path) {
+            chunk.element_binary(name);
+        }
+        chunk.field_i32(4, kUncompressed);
+        chunk.field_i64(5, values);
+        chunk.field_i64(6, _offset - chunk_offset);  // total_uncompressed_size
+        chunk.field_i64(7, _offset - chunk_offset);  // total_compressed_size
+        chunk.field_i64(9, chunk_offset);  // data_page_offset
+        chunk.end_struct();
+        chunk.end_struct();
+        _row_group_column_count++;
+        _row_group_bytes += _offset - chunk_offset;
+    }
+
+    /// Completes a row group with the given number of records.
+    void end_row_group(uint64_t records) {
+        thrift::CompactWriter row_group(&_row_groups);
+        row_group.begin_element_struct();
+        row_group.begin_list(1, thrift::kStruct, _row_group_column_count);
+        _row_groups += _row_group_columns;
+        row_group.field_i64(2, _row_group_bytes);
+        row_group.field_i64(3, records);
+        row_group.end_struct();
+        _row_group_count++;
+        _record_count += records;
+        _row_group_columns.clear();
+        _row_group_column_count = 0;
+        _row_group_bytes = 0;
+    }
+
+    /// Writes the footer of the file.
+    void finish() {
+        std::string footer;
+        thrift::CompactWriter metadata(&footer);
+        metadata.begin_element_struct();
+        metadata.field_i32(1, 1);  // version
+        metadata.begin_list(2, thrift::kStruct, _schema_size);
+        footer += _schema;
+        metadata.field_i64(3, _record_count);
+        metadata.begin_list(4, thrift::kStruct, _row_group_count);
+        footer += _row_groups;
+        metadata.field_binary(6, "imlab");  // created_by
+        metadata.end_struct();
+
+        Write(footer);
+        uint32_t length = footer.size();
+        Write({ reinterpret_cast<const char*>(&length), sizeof(length) });
+        Write(kMagic);
+        if (!_out.flush()) {
+            throw FileFormatError("cannot write Parquet file");
+        }
+    }
+
+ protected:
+    std::ostream& _out;
+    uint64_t _offset = 0;
+    /// The serialized SchemaElements.
+    std::string _schema;
+    uint64_t _schema_size = 0;
+    /// The serialized ColumnChunks of the current row group.
+    std::string _row_group_columns;
+    uint64_t _row_group_column_count = 0;
+    uint64_t _row_group_bytes = 0;
+    /// The serialized RowGroups.
+    std::string _row_groups;
+    uint64_t _row_group_count = 0;
+    uint64_t _record_count = 0;
+
+    void Write(std::string_view bytes) {
+        _out.write(bytes.data(), bytes.size());
+        _offset += bytes.size();
+    }
+
+    void CompactSchemaElement(const std::string& name, std::optional<Repetition> repetition,
+                              std::optional<int32_t> children, std::optional<PhysicalType> type,
+                              std::optional<ConvertedType> converted_type) {
+        thrift::CompactWriter element(&_schema);
+        element.begin_element_struct();
+        if (type.has_value()) {
+            element.field_i32(1, *type);
+        }
+        if (repetition.has_value()) {
+            element.field_i32(3, *repetition);
+        }
+        element.field_binary(4, name);
+        if (children.has_value()) {
+            element.field_i32(5, *children);
+        }
+        if (converted_type.has_value()) {
+            element.field_i32(6, *converted_type);
+        }
+        element.end_struct();
+        _schema_size++;
+    }
+
+    void WriteSchema(const Descriptor* descriptor) {
+        for (int i = 0; i < descriptor->field_count(); i++) {
+            const FieldDescriptor* field = descriptor->field(i);
+            Repetition repetition = field->is_repeated() ? kRepeated : field->is_required() ? kRequired : kOptional;
+            if (field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE) {
+                CompactSchemaElement(NameOf(field), repetition, field->message_type()->field_count(),
+                                     std::nullopt, std::nullopt);
+                WriteSchema(field->message_type());
+            } else {
+                auto [type, converted_type] = TypeOfField(field);
+                CompactSchemaElement(NameOf(field), repetition, std::nullopt, type, converted_type);
+            }
+        }
+    }
+
+    /// Writes the rows [begin, end) of a column as one data page.
+    template<typename T>
+    void WriteDataPage(DremelColumn<T>& column, TID begin, TID end) {
+        RleEncoder repetition_levels(BitWidth(column.max_repetition_level()));
+        RleEncoder definition_levels(BitWidth(column.max_definition_level()));
+        PlainEncoder<T> values;
+        std::vector<uint8_t> r, d;
+        for (TID tid = begin; tid < end;) {
+            auto& segment = column.segment_of(tid);
+            uint64_t row = tid - segment.first_tid();
+            uint64_t n = std::min<uint64_t>(end - tid, segment.size() - row);
+            r.resize(n);
+            d.resize(n);
+            segment.repetition_levels().cursor(row).Decode(r.data(), n);
+            segment.definition_levels().cursor(row).Decode(d.data(), n);
+            uint64_t value_index = segment.value_index(row);
+            for (uint64_t i = 0; i < n; i++) {
+                repetition_levels.put(r[i]);
+                definition_levels.put(d[i]);
+                if (d[i] == column.max_definition_level()) {
+                    values.put(segment.values()[value_index++]);
+                }
+            }
+            tid += n;
+        }
+
+        std::string body;
+        if (column.max_repetition_level() > 0) {
+            AppendLevels(&body, repetition_levels.finish());
+        }
+        if (column.max_definition_level() > 0) {
+            AppendLevels(&body, definition_levels.finish());
+        }
+        body += values.finish();
+
+        std::string header;
+        thrift::CompactWriter page(&header);
+        page.begin_element_struct();
+        page.field_i32(1, kDataPage);
+        page.field_i32(2, body.size());  // uncompressed_page_size
+        page.field_i32(3, body.size());  // compressed_page_size
+        page.begin_struct(5);  // data_page_header
+        page.field_i32(1, end - begin);  // num_values
+        page.field_i32(2, kPlain);
+        page.field_i32(3, kRle);
+        page.field_i32(4, kRle);
+        page.end_struct();
+        page.end_struct();
+        Write(header);
+        Write(body);
+    }
+
+    /// Levels in a data page (V1) are prefixed with their length.
+    static void AppendLevels(std::string* body, const std::string& levels) {
+        uint32_t length = levels.size();
+        body->append(reinterpret_cast<const char*>(&length), sizeof(length));
+        body->append(levels);
+    }
+};
+
+/// Reads the column chunks of a Parquet file into DremelColumns.
+/// The file is mapped into memory and strings are only copied into the columns.
+class Reader {
+ public:
+    /// Opens a Parquet file and reads its metadata.
+    explicit Reader(const std::string& path) : _file(std::make_shared<const MappedFile>(path)) {
+        const char* data = _file->data();
+        uint64_t size = _file->size();
+        if (size < 12 || std::string_view(data, 4) != kMagic || std::string_view(data + size - 4, 4) != kMagic) {
+            throw FileFormatError(path + " is not a Parquet file");
+        }
+        uint32_t footer_length;
+        std::memcpy(&footer_length, data + size - 8, sizeof(footer_length));
+        if (footer_length > size - 12) {
+            throw FileFormatError("invalid Parquet footer");
+        }
+        ReadFileMetaData(data + size - 8 - footer_length, footer_length);
+    }
+
+    /// Returns the number of records in the file.
+    uint64_t record_count() const { return _record_count; }
+    /// Returns the number of row groups.
+    uint64_t row_group_count() const { return _row_groups.size(); }
+    /// Returns the number of records in a row group.
+    uint64_t row_group_size(uint64_t row_group) const { return _row_groups[row_group].records; }
+    /// Returns the leaf columns of the schema.
+    const std::vector<LeafColumn>& columns() const { return _columns; }
+
+    /// Returns the leaf column for the given field, if the file contains it.
+    /// Names are compared case-insensitively, since tools disagree on the capitalization of groups.
+    std::optional<uint64_t> find_column(const FieldDescriptor* field) const {
+        auto path = PathOf(field);
+        for (uint64_t i = 0; i < _columns.size(); i++) {
+            auto& other = _columns[i].field_path;
+            if (std::equal(path.begin(), path.end(), other.begin(), other.end(), EqualsIgnoreCase)) {
+                return i;
+            }
+        }
+        return std::nullopt;
+    }
+
+    /// Appends all rows of a row group to a column.
+    /// If the file does not contain the column, every record is NULL.
+    template<typename T>
+    void read_column_chunk(uint64_t row_group, DremelColumn<T>& column) {
+        auto leaf = find_column(column.field());
+        if (!leaf.has_value()) {
+            if (column.max_definition_level() == 0) {
+                throw FileFormatError("the Parquet file does not contain the required field " + column.field()->full_name());
+            }
+            for (uint64_t i = 0; i < _row_groups[row_group].records; i++) {
+                column.insert_null(0, 0);
+            }
+            return;
+        }
+        const LeafColumn& leaf_column = _columns[*leaf];
+        if (leaf_column.type != TypeOf<T>::kType
+                || leaf_column.max_repetition_level != column.max_repetition_level()
+                || leaf_column.max_definition_level != column.max_definition_level()) {
+            throw FileFormatError("the Parquet column of " + column.field()->full_name() + " does not match the field");
+        }
+        const ColumnChunk* chunk = nullptr;
+        for (auto& c : _row_groups[row_group].columns) {
+            if (c.column == *leaf) {
+                chunk = &c;
+            }
+        }
+        if (chunk == nullptr) {
+            throw FileFormatError("the Parquet row group has no chunk for " + column.field()->full_name());
+        }
+        if (chunk->codec != kUncompressed) {
+            throw FileFormatError("compressed Parquet files are not supported");
+        }
+        ReadPages(*chunk, column);
+    }
+
+ protected:
+    struct ColumnChunk {
+        std::vector<std::string> path;
+        uint64_t column;
+        int32_t codec;
+        uint64_t value_count;
+        uint64_t first_page;
+    };
+    struct RowGroup {
+        std::vector<ColumnChunk> columns;
+        uint64_t records;
+    };
+
+    std::shared_ptr<const MappedFile> _file;
+    std::vector<LeafColumn> _columns;
+    std::vector<RowGroup> _row_groups;
+    uint64_t _record_count = 0;
+
+    static bool EqualsIgnoreCase(const std::string& lhs, const std::string& rhs) {
+        return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), [](char a, char b) {
+            return std::tolower(static_cast<unsigned char>(a)) == std::tolower(static_cast<unsigned char>(b));
+        });
+    }
+
+    void ReadFileMetaData(const char* data, uint64_t size) {
+        thrift::CompactReader reader(data, size);
+        struct SchemaElement {
+            std::string name;
+            int32_t type = -1;
+            int32_t repetition = kRequired;
+            int32_t children = 0;
+            int32_t converted_type = -1;
+        };
+        std::vector<SchemaElement> schema;
+        int16_t id;
+        thrift::Type type;
+        reader.begin_struct();
+        while (reader.next_field(&id, &type)) {
+            if (id == 2 && type == thrift::kList) {  // schema
+                thrift::Type element_type;
+                uint64_t count = reader.read_list_header(&element_type);
+                for (uint64_t i = 0; i < count; i++) {
+                    SchemaElement element;
+                    reader.begin_struct();
+                    while (reader.next_field(&id, &type)) {
+                        if (id == 1) element.type = reader.read_int();
+                        else if (id == 3) element.repetition = reader.read_int();
+                        else if (id == 4) element.name = reader.read_binary();
+                        else if (id == 5) element.children = reader.read_int();
+                        else if (id == 6) element.converted_type = reader.read_int();
+                        else reader.skip(type);
+                    }
+                    schema.push_back(std::move(element));
+                }
+            } else if (id == 3 && type == thrift::kI64) {  // num_rows
+                _record_count = reader.read_int();
+            } else if (id == 4 && type == thrift::kList) {  // row_groups
+                thrift::Type element_type;
+                uint64_t count = reader.read_list_header(&element_type);
+                for (uint64_t i = 0; i < count; i++) {
+                    _row_groups.push_back(ReadRowGroup(reader));
+                }
+            } else {
+                reader.skip(type);
+            }
+        }
+
+        // Flatten the schema into its leaves; the first element is the root.
+        if (schema.empty()) {
+            throw FileFormatError("the Parquet file has no schema");
+        }
+        uint64_t next = 1;
+        std::vector<std::string> path, field_path;
+        for (int32_t i = 0; i < schema[0].children; i++) {
+            CollectLeaves(schema, &next, &path, &field_path, 0, 0, 0);
+        }
+
+        // Resolve the paths of the column chunks.
+        for (auto& row_group : _row_groups) {
+            for (auto& chunk : row_group.columns) {
+                auto column = std::find_if(_columns.begin(), _columns.end(), [&](auto& c) { return c.path == chunk.path; });
+                if (column == _columns.end()) {
+                    throw FileFormatError("the Parquet file has a column chunk without a column");
+                }
+                chunk.column = column - _columns.begin();
+            }
+        }
+    }
+
+    /// Collects the leaves below the next node of the flattened schema.
+    /// The next hidden nodes of the path don't show up in the field path.
+    template<typename Element>
+    void CollectLeaves(const std::vector<Element>& schema, uint64_t* next, std::vector<std::string>* path,
+                       std::vector<std::string>* field_path, unsigned max_r, unsigned max_d, unsigned hidden) {
+        if (*next >= schema.size()) {
+            throw FileFormatError("invalid Parquet schema");
+        }
+        const Element& element = schema[(*next)++];
+        max_r += (element.repetition == kRepeated);
+        max_d += (element.repetition != kRequired);
+        path->push_back(element.name);
+        if (hidden == 0) {
+            field_path->push_back(element.name);
+        }
+        if (element.children == 0) {
+            _columns.push_back({ *path, *field_path, static_cast<PhysicalType>(element.type), max_r, max_d });
+        } else {
+            // The repeated group of a LIST and the element within it are hidden.
+            bool list = element.converted_type == kList && element.children == 1 && *next < schema.size()
+                && schema[*next].repetition == kRepeated && schema[*next].children == 1;
+            for (int32_t i = 0; i < element.children; i++) {
+                CollectLeaves(schema, next, path, field_path, max_r, max_d, list ? 2 : (hidden > 0 ? hidden - 1 : 0));
+            }
+        }
+        path->pop_back();
+        if (hidden == 0) {
+            field_path->pop_back();
+        }
+    }
+
+    RowGroup ReadRowGroup(thrift::CompactReader& reader) {
+        RowGroup row_group {};
+        int16_t id;
+        thrift::Type type;
+        reader.begin_struct();
+        while (reader.next_field(&id, &type)) {
+            if (id == 1 && type == thrift::kList) {  // columns
+                thrift::Type element_type;
+                uint64_t count = reader.read_list_header(&element_type);
+                for (uint64_t i = 0; i < count; i++) {
+                    row_group.columns.push_back(ReadColumnChunk(reader));
+                }
+            } else if (id == 3 && type == thrift::kI64) {  // num_rows
+                row_group.records = reader.read_int();
+            } else {
+                reader.skip(type);
+            }
+        }
+        return row_group;
+    }
+
+    ColumnChunk ReadColumnChunk(thrift::CompactReader& reader) {
+        ColumnChunk chunk { {}, 0, kUncompressed, 0, 0 };
+        int64_t data_page_offset = 0, dictionary_page_offset = 0;
+        int16_t id;
+        thrift::Type type;
+        reader.begin_struct();
+        while (reader.next_field(&id, &type)) {
+            if (id != 3 || type != thrift::kStruct) {
+                reader.skip(type);
+                continue;
+            }
+            reader.begin_struct();  // meta_data
+            while (reader.next_field(&id, &type)) {
+                if (id == 3 && type == thrift::kList) {  // path_in_schema
+                    thrift::Type element_type;
+                    uint64_t count = reader.read_list_header(&element_type);
+                    for (uint64_t i = 0; i < count; i++) {
+                        chunk.path.emplace_back(reader.read_binary());
+                    }
+                } else if (id == 4) {
+                    chunk.codec = reader.read_int();
+                } else if (id == 5) {
+                    chunk.value_count = reader.read_int();
+                } else if (id == 9) {
+                    data_page_offset = reader.read_int();
+                } else if (id == 11) {
+                    dictionary_page_offset = reader.read_int();
+                } else {
+                    reader.skip(type);
+                }
+            }
+        }
+        // Some writers set the dictionary page offset to 0 if there is none.
+        chunk.first_page = (dictionary_page_offset > 0 && dictionary_page_offset < data_page_offset)
+            ? dictionary_page_offset : data_page_offset;
+        return chunk;
+    }
+
+    template<typename T>
+    void ReadPages(const ColumnChunk& chunk, DremelColumn<T>& column) {
+        using Value = std::conditional_t<std::is_same_v<T, std::string>, std::string_view, T>;
+        std::vector<Value> dictionary;
+        std::vector<uint32_t> r, d, indexes;
+        uint64_t position = chunk.first_page;
+        uint64_t values_read = 0;
+        while (values_read < chunk.value_count) {
+            if (position >= _file->size()) {
+                throw FileFormatError("unexpected end of Parquet column chunk");
+            }
+            // Read the page header.
+            thrift::CompactReader reader(_file->data() + position, _file->size() - position);
+            int32_t page_type = -1, page_size = 0, value_count = 0, encoding = kPlain;
+            int32_t r_length = -1, d_length = -1;
+            int16_t id;
+            thrift::Type type;
+            reader.begin_struct();
+            while (reader.next_field(&id, &type)) {
+                if (id == 1) {
+                    page_type = reader.read_int();
+                } else if (id == 3) {
+                    page_size = reader.read_int();
+                } else if ((id == 5 || id == 7 || id == 8) && type == thrift::kStruct) {
+                    // data_page_header, dictionary_page_header and data_page_header_v2 start the same way
+                    reader.begin_struct();
+                    while (reader.next_field(&id, &type)) {
+                        if (id == 1) value_count = reader.read_int();
+                        else if (id == 2 && page_type != kDataPageV2) encoding = reader.read_int();
+                        else if (id == 4 && page_type == kDataPageV2) encoding = reader.read_int();
+                        else if (id == 5 && page_type == kDataPageV2) d_length = reader.read_int();
+                        else if (id == 6 && page_type == kDataPageV2) r_length = reader.read_int();
+                        else reader.skip(type);
+                    }
+                } else {
+                    reader.skip(type);
+                }
+            }
+            const char* body = reader.position();
+            position = body - _file->data();
+            if (page_size < 0 || static_cast<uint64_t>(page_size) > _file->size() - position || value_count < 0) {
+                throw FileFormatError("invalid Parquet page");
+            }
+            position += page_size;
+            const char* body_end = body + page_size;
+
+            if (page_type == kDictionaryPage) {
+                PlainDecoder<T> decoder(body, page_size);
+                dictionary.clear();
+                for (int32_t i = 0; i < value_count; i++) {
+                    dictionary.push_back(decoder.next());
+                }
+                continue;
+            }
+            if (page_type != kDataPage && page_type != kDataPageV2) {
+                continue;  // Index pages are not needed.
+            }
+
+            // Decode the levels: In V1 pages, they are prefixed with their length, in V2 pages it's in the header.
+            r.resize(value_count);
+            d.resize(value_count);
+            body = ReadLevels(body, body_end, page_type == kDataPageV2 ? r_length : -1,
+                              column.max_repetition_level(), r.data(), value_count);
+            body = ReadLevels(body, body_end, page_type == kDataPageV2 ? d_length : -1,
+                              column.max_definition_level(), d.data(), value_count);
+
+            // Decode the values and insert the rows.
+            const uint32_t max_d = column.max_definition_level();
+            if (encoding == kPlain) {
+                PlainDecoder<T> values(body, body_end - body);
+                for (int32_t i = 0; i < value_count; i++) {
+                    if (d[i] == max_d) {
+                        column.insert_value(values.next(), r[i]);
+                    } else {
+                        column.insert_null(r[i], d[i]);
+                    }
+                }
+            } else if (encoding == kPlainDictionary || encoding == kRleDictionary) {
+                if (body == body_end) {
+                    throw FileFormatError("invalid dictionary-encoded Parquet page");
+                }
+                uint64_t non_null = std::count(d.begin(), d.end(), max_d);
+                indexes.resize(non_null);
+                RleDecoder(body + 1, body_end - body - 1, static_cast<uint8_t>(*body)).decode(indexes.data(), non_null);
+                uint64_t next = 0;
+                for (int32_t i = 0; i < value_count; i++) {
+                    if (d[i] == max_d) {
+                        if (indexes[next] >= dictionary.size()) {
+                            throw FileFormatError("invalid dictionary index in Parquet page");
+                        }
+                        column.insert_value(dictionary[indexes[next++]], r[i]);
+                    } else {
+                        column.insert_null(r[i], d[i]);
+                    }
+                }
+            } else {
+                throw FileFormatError("unsupported Parquet encoding " + std::to_string(encoding));
+            }
+            values_read += value_count;
+        }
+    }
+
+    /// Decodes n levels and returns the position behind them.
+    /// A length of -1 means that the levels are prefixed with their length.
+    static const char* ReadLevels(const char* data, const char* end, int64_t length, unsigned max_level,
+                                  uint32_t* out, uint64_t n) {
+        if (max_level == 0) {
+            std::fill(out, out + n, 0);
+            return data;
+        }
+        if (length < 0) {
+            uint32_t prefix;
+            if (end - data < 4) {
+                throw FileFormatError("unexpected end of Parquet page");
+            }
+            std::memcpy(&prefix, data, sizeof(prefix));
+            data += sizeof(prefix);
+            length = prefix;
+        }
+        if (length > end - data) {
+            throw FileFormatError("unexpected end of Parquet page");
+        }
+        RleDecoder(data, length, BitWidth(max_level)).decode(out, n);
+        for (uint64_t i = 0; i < n; i++) {
+            if (out[i] > max_level) {
+                throw FileFormatError("invalid level in Parquet page");
+            }
+        }
+        return data + length;
+    }
+};
+
+}  // namespace parquet
+
+/// Writes all records of a table to a Parquet file.
+/// Every row group holds kRecordsPerRowGroup records; its column chunks hold exactly the rows of these records.
+template<typename Table>
+void ExportParquet(Table& table, const Descriptor* descriptor, std::ostream& out) {
+    constexpr uint64_t kRecordsPerRowGroup = 1 << 16;
+    parquet::Writer writer(out, descriptor);
+    for (uint64_t begin = 0; begin < table.size(); begin += kRecordsPerRowGroup) {
+        uint64_t end = std::min(begin + kRecordsPerRowGroup, table.size());
+        table.for_each_column([&](auto& column) { writer.write_column_chunk(column, begin, end); });
+        writer.end_row_group(end - begin);
+    }
+    writer.finish();
+}
+
+/// Appends the records of a Parquet file to the columns of a table and returns their number.
+/// Levels and values go straight into the columns, there is no detour through Protobuf messages.
+/// Fields that are missing in the file are NULL in every record.
+/// If the file turns out to be invalid while the columns are filled, the table is left in an undefined state.
+template<typename Table>
+uint64_t ImportParquet(Table& table, const std::string& path) {
+    parquet::Reader reader(path);
+    // Optional fields that are missing in the file are NULL, but a file without any of the fields is most likely the wrong one.
+    bool any_column = false;
+    table.for_each_column([&](auto& column) { any_column |= reader.find_column(column.field()).has_value(); });
+    if (!any_column) {
+        throw FileFormatError("the Parquet file " + path + " does not contain any column of the table");
+    }
+    table.for_each_column([&](auto& column) {
+        uint64_t records = column.record_count();
+        for (uint64_t row_group = 0; row_group < reader.row_group_count(); row_group++) {
+            reader.read_column_chunk(row_group, column);
+        }
+        if (column.record_count() != records + reader.record_count()) {
+            throw FileFormatError("the Parquet column of " + column.field()->full_name()
+                + " does not contain " + std::to_string(reader.record_count()) + " records");
+        }
+    });
+    return reader.record_count();
+}
+
+//---------------------------------------------------------------------------
+}  // namespace dremel
+}  // namespace imlab
+//---------------------------------------------------------------------------
+#endif  // INCLUDE_IMLAB_DREMEL_PARQUET_H_
+//---------------------------------------------------------------------------
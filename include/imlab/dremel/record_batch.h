@@ -0,0 +1,55 @@
+// ---------------------------------------------------------------------------
+// IMLAB
+// ---------------------------------------------------------------------------
+#ifndef INCLUDE_IMLAB_DREMEL_RECORD_BATCH_H_
+#define INCLUDE_IMLAB_DREMEL_RECORD_BATCH_H_
+//---------------------------------------------------------------------------
+#include <memory>
+#include <type_traits>
+#include <vector>
+#include <google/protobuf/arena.h>
+#include <google/protobuf/message.h>
+//---------------------------------------------------------------------------
+namespace imlab {
+namespace dremel {
+//---------------------------------------------------------------------------
+
+/// A batch of records that are allocated on a Protobuf arena, together with all their nested messages and strings.
+/// Assembling into a batch costs a few large allocations instead of one per message, and the whole batch
+/// is freed at once when it is destroyed. The records must not outlive the batch.
+template<class R>
+class RecordBatch {
+    static_assert(std::is_base_of<google::protobuf::Message, R>::value, "R must be derived from google::protobuf::Message");
+
+ public:
+    /// Creates a batch of empty records.
+    explicit RecordBatch(size_t size) : _arena(std::make_unique<google::protobuf::Arena>()) {
+        _records.reserve(size);
+        for (size_t i = 0; i < size; i++) {
+            _records.push_back(google::protobuf::Arena::CreateMessage<R>(_arena.get()));
+        }
+    }
+
+    /// The number of records.
+    size_t size() const { return _records.size(); }
+    /// Gets a record.
+    R& operator[](size_t index) { return *_records[index]; }
+    const R& operator[](size_t index) const { return *_records[index]; }
+    /// The records, e.g. for the generated assemblers.
+    R* const* data() const { return _records.data(); }
+    /// The arena that the records are allocated on.
+    google::protobuf::Arena* arena() { return _arena.get(); }
+
+ protected:
+    /// The arena is on the heap, so that a batch can be moved.
+    std::unique_ptr<google::protobuf::Arena> _arena;
+    /// The records on the arena.
+    std::vector<R*> _records;
+};
+
+//---------------------------------------------------------------------------
+}  // namespace dremel
+}  // namespace imlab
+//---------------------------------------------------------------------------
+#endif  // INCLUDE_IMLAB_DREMEL_RECORD_BATCH_H_
+//---------------------------------------------------------------------------
@@ -4,9 +4,14 @@
 #ifndef INCLUDE_IMLAB_DREMEL_RECORD_FSM_H_
 #define INCLUDE_IMLAB_DREMEL_RECORD_FSM_H_
 //---------------------------------------------------------------------------
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <limits>
 #include <unordered_map>
 #include <unordered_set>
 #include <sstream>
+#include <vector>
 #include "./schema_helper.h"
 #include "imlab/infra/hash.h"
 #include <google/protobuf/descriptor.h>
@@ -17,61 +22,102 @@ namespace dremel {
 using namespace google::protobuf;
 
 /// A finite state machine for assembling a shredded record.
+/// The states are the fields, numbered 0..n-1 in the order they were given, and n is the end state.
+/// The transitions are stored in a flat n x (max repetition level + 1) table of state numbers,
+/// so following a transition is a single array access.
 class RecordFSM {
  public:
-    explicit RecordFSM(const std::vector<const FieldDescriptor*>& fields) { ConstructRecordFSM(fields); };
+    explicit RecordFSM(const std::vector<const FieldDescriptor*>& fields) : _fields(fields) { ConstructRecordFSM(fields); };
+
+    /// The number of fields; this is also the number of the end state.
+    uint32_t field_count() const { return _fields.size(); }
+    /// The field of a state.
+    const FieldDescriptor* field(uint32_t index) const { return _fields[index]; }
+    /// The state of a field, or field_count() if the field is not part of the FSM.
+    uint32_t IndexOf(const FieldDescriptor* field) const {
+        return std::find(_fields.begin(), _fields.end(), field) - _fields.begin();
+    }
+
+    /// Yields the next state for a given state and the repetition level of the next value in its column.
+    uint32_t NextIndex(uint32_t index, unsigned repetition_level) const {
+        assert(index < field_count() && repetition_level < _level_count);
+        return _transitions[index * _level_count + repetition_level];
+    }
 
     /// Yields the next field of the FSM for a given state or nullptr if we are at the end.
-    const FieldDescriptor* NextField(const FieldDescriptor* field, unsigned repetition_level) {
-        const auto& it = _transitions.find(std::make_pair(field, repetition_level));
-        if (it != _transitions.end()) {
-            return it->second;
-        } else {
+    const FieldDescriptor* NextField(const FieldDescriptor* field, unsigned repetition_level) const {
+        uint32_t index = IndexOf(field);
+        if (index == field_count() || repetition_level >= _level_count) {
             // There is no matching transition.
             return nullptr;
         }
+        uint32_t next = NextIndex(index, repetition_level);
+        return next == field_count() ? nullptr : _fields[next];
     }
 
     /// Generates a human-readable form of the FSM.
     std::string GenerateFsmGraph() { return GenerateGraphviz(); }
 
  protected:
+    /// Marks transitions that have not been constructed yet.
+    static constexpr uint32_t kNoTransition = std::numeric_limits<uint32_t>::max();
+
     /// Constructs the state transitions of the FSM given a list of fields that should be included.
     void ConstructRecordFSM(const std::vector<const FieldDescriptor*>& fields) {
-        for (int i = 0; i < fields.size(); i++) {
-            auto& field = fields[i];
-            auto maxRepetitionLevel = GetMaxRepetitionLevel(field);
-            auto barrier = (i != fields.size() - 1)? fields[i+1] : nullptr;
-            auto barrierLevel = GetMaxRepetitionLevel(GetCommonAncestor(field, barrier));
+        _level_count = 1;
+        _transitions.clear();
+        if (fields.empty()) {
+            return;
+        }
+        // The levels and common ancestors are looked up by the indexes of the fields in the schema.
+        const auto& schema = SchemaMetadata::Of(fields[0]);
+        std::vector<uint32_t> nodes {};
+        for (auto* field : fields) {
+            nodes.push_back(schema.IndexOf(field));
+            _level_count = std::max(_level_count, schema.max_repetition_level(nodes.back()) + 1);
+        }
+        _transitions.assign(fields.size() * _level_count, kNoTransition);
+        auto transition = [&](uint32_t from, unsigned level) -> uint32_t& {
+            return _transitions[from * _level_count + level];
+        };
+
+        for (uint32_t i = 0; i < fields.size(); i++) {
+            auto field = nodes[i];
+            auto maxRepetitionLevel = schema.max_repetition_level(field);
+            auto barrier = (i != fields.size() - 1)? nodes[i+1] : SchemaMetadata::kRoot;
+            auto barrierLevel = schema.max_repetition_level(schema.common_ancestor(field, barrier));
 
             // Work on all backward edges of the FSM.
             // To refer to the paper, this is an edge like from "Name.Url" to "Name.Language.Code" in Figure 4.
             for (int u = i - 1; u >= 0; u--) {
-                auto& preField = fields[u];
-                if (GetMaxRepetitionLevel(preField) > barrierLevel) {
+                auto preField = nodes[u];
+                if (schema.max_repetition_level(preField) > barrierLevel) {
                     // Get common repetition level of preField and field
-                    auto backLevel = GetMaxRepetitionLevel(GetCommonAncestor(preField, field));
+                    auto backLevel = schema.max_repetition_level(schema.common_ancestor(preField, field));
                     // Insert a transition into the FSM
-                    _transitions.insert_or_assign(std::make_pair(field, backLevel), preField);
+                    transition(i, backLevel) = u;
                 }
             }
 
             // Handle reflexive transitions.
             for (unsigned level = barrierLevel + 1; level <= maxRepetitionLevel; level++) {
-                if (_transitions.find(std::make_pair(field, level)) == _transitions.end()) {
+                if (transition(i, level) == kNoTransition) {
                     // Here, the paper seems to be wrong.
                     // According to the paper, we should copy the transition from (field, level-1) to (field, level),
                     // but this does not work.
                     // Instead, we need to insert a reflexive edge here.
-                    _transitions.insert_or_assign(std::make_pair(field, level), field);
+                    transition(i, level) = i;
                 }
             }
 
             // Handle forward transition to the next field.
             for (unsigned level = 0; level <= barrierLevel; level++) {
-                _transitions.insert_or_assign(std::make_pair(field, level), barrier);
+                transition(i, level) = i + 1;
             }
         }
+
+        // Repetition levels that a field cannot have end the record.
+        std::replace(_transitions.begin(), _transitions.end(), kNoTransition, field_count());
     }
 
     /// Generates code for graphviz to draw a the FSM.
@@ -90,15 +136,18 @@ class RecordFSM {
         // Map of transitions with (source, target) -> [repetition_level, ...]
         std::unordered_multimap<std::pair<std::string, std::string>, unsigned> edges {};
 
-        for (const auto [key, target] : _transitions) {
-            auto [source, level] = key;
+        for (uint32_t index = 0; index < field_count(); index++) {
+            auto* source = _fields[index];
             nodes.emplace(source->full_name());
-            if (target != nullptr) {  // end state
-                nodes.emplace(target->full_name());
-                edges.emplace(std::make_pair(source->full_name(), target->full_name()), level);
-            } else {
-                nodes.emplace("end");
-                edges.emplace(std::make_pair(source->full_name(), "end"), level);
+            for (unsigned level = 0; level <= GetMaxRepetitionLevel(source); level++) {
+                uint32_t target = NextIndex(index, level);
+                if (target != field_count()) {
+                    nodes.emplace(_fields[target]->full_name());
+                    edges.emplace(std::make_pair(source->full_name(), _fields[target]->full_name()), level);
+                } else {  // end state
+                    nodes.emplace("end");
+                    edges.emplace(std::make_pair(source->full_name(), "end"), level);
+                }
             }
         }
 
@@ -126,8 +175,12 @@ class RecordFSM {
     }
 
  private:
-    /// Maps a field and repetition_level to a new field.
-    std::unordered_map<std::pair<const FieldDescriptor*, unsigned>, const FieldDescriptor*> _transitions {};
+    /// The fields, i.e. the states.
+    std::vector<const FieldDescriptor*> _fields;
+    /// The number of repetition levels, i.e. the columns of the transition table.
+    unsigned _level_count = 1;
+    /// The next state for each state and repetition level (row-major).
+    std::vector<uint32_t> _transitions {};
 };
 
 //---------------------------------------------------------------------------
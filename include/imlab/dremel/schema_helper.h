@@ -5,8 +5,7 @@
 #define INCLUDE_IMLAB_DREMEL_SCHEMA_HELPER_H_
 //---------------------------------------------------------------------------
 #include <google/protobuf/message.h>
-#include <unordered_map>
-#include "../infra/hash.h"
+#include "./schema_metadata.h"
 //---------------------------------------------------------------------------
 namespace imlab {
 namespace dremel {
@@ -29,130 +28,56 @@ void AddValue(Message* msg, const FieldDescriptor* field, T value);
 /// but it's kind of hard to get there.
 /// Returns a pointer to the FieldDescriptor or nullptr if we are at the root.
 inline const FieldDescriptor* GetFieldDescriptor(const Descriptor* desc) {
-    auto* parent = desc->containing_type();
-    if (parent == nullptr) {  // root
-        return nullptr;
-    }
-    for (int i = 0; i < parent->field_count(); i++) {
-        if (parent->field(i)->message_type() == desc) {
-            return parent->field(i);
-        }
-    }
-    assert(false);
+    const auto& schema = SchemaMetadata::Of(desc);
+    return schema.field(schema.IndexOf(desc));
+}
+
+/// Gets the group or message field that contains a field, nullptr for top-level fields.
+/// Unlike GetFieldDescriptor(field->containing_type()), the lookup goes by the field itself.
+inline const FieldDescriptor* GetParentField(const FieldDescriptor* field) {
+    const auto& schema = SchemaMetadata::Of(field);
+    return schema.field(schema.parent(schema.IndexOf(field)));
 }
 
 /// Computes the repetition level for a given field.
 /// The repetition level is the number of REPEATED fields in the path.
 inline unsigned GetMaxRepetitionLevel(const FieldDescriptor* desc) {
-    unsigned repetition_level = 0;
-
-    auto* field = desc;
-    while (field != nullptr) {
-        if (field->is_repeated()) {
-            repetition_level++;
-        }
-        field = GetFieldDescriptor(field->containing_type());
+    if (desc == nullptr) {
+        return 0;
     }
-    return repetition_level;
+    const auto& schema = SchemaMetadata::Of(desc);
+    return schema.max_repetition_level(schema.IndexOf(desc));
 }
 
-static std::unordered_map<std::pair<const FieldDescriptor*, const FieldDescriptor*>, const FieldDescriptor*> _common_ancestor_cache {};
-
 /// Gets the lowest common ancestor of two fields.
+/// If field2 does not follow field1 in the schema, this is the field above the repeated field that field2
+/// repeats in, or nullptr if they are in different records.
 inline const FieldDescriptor* GetCommonAncestor(const FieldDescriptor* field1, const FieldDescriptor* field2) {
-    auto cached = _common_ancestor_cache.find(std::make_pair(field1, field2));
-    if (cached != _common_ancestor_cache.end()) {
-        return cached->second;
-    }
-
-    std::vector<const FieldDescriptor*> field1_path { field1 };
-    std::vector<const FieldDescriptor*> field2_path { field2 };
-
-    // Collect the path of FieldDescriptors that lead to both fields (in reverse order!)
-    auto* parent1 = field1;
-    while (parent1 != nullptr) {
-        parent1 = GetFieldDescriptor(parent1->containing_type());
-        field1_path.push_back(parent1);
-    }
-    auto* parent2 = field2;
-    while (parent2 != nullptr) {
-        parent2 = GetFieldDescriptor(parent2->containing_type());
-        field2_path.push_back(parent2);
-    }
-
-    // Index of lowest common ancestor counted from the end.
-    unsigned common_ancestor_index = 0;
-    // Now we have two vectors of paths to the two fields in reversed order (root is at the end).
-    for (unsigned i = 0; i < std::min(field1_path.size(), field2_path.size()); i++) {
-        if (*(field1_path.rbegin() + i) == *(field2_path.rbegin() + i)) {
-            common_ancestor_index = i;
-        } else {
-            break;
-        }
-    }
-
-    // Helper: not necessarily direct parent, but somewhere above.
-    bool field1_is_parent_of_field2 = *(field1_path.rbegin() + common_ancestor_index) == field1 && field1 != field2;
-    bool field2_is_parent_of_field1 = *(field2_path.rbegin() + common_ancestor_index) == field2 && field1 != field2;
-
-    // Edge case:
-    // When field1 is a parent node of field2, return the parent (field1).
-    if (field1_is_parent_of_field2) {
-        _common_ancestor_cache.emplace(std::make_pair(field1, field2), field1);
-        return field1;
-    }
-
-    // Edge case:
-    // When both fields are equal, we need to go up the tree until we find a repeated field and return the field above.
-    // Same happens when field1 and field2 are in reverse order as they were declared in the message schema.
-    // The latter happens either for the trivial case of two (atomic) fields or if field2 is parent of field1.
-    if (field1 == field2 || (field2_is_parent_of_field1 || (*(field1_path.rbegin() + common_ancestor_index + 1))->index() >= (*(field2_path.rbegin() + common_ancestor_index + 1))->index())) {
-        auto f = field1_path.rbegin() + common_ancestor_index;  // common_ancestor could also be the field itself if fields are equal.
-        while (f != field1_path.rbegin() && !(*f)->is_repeated()) {
-            f--;
-        }
-        if (f == field1_path.rbegin()) {
-            // This case happens when both fields need to be in different messages because there is no above repeating field.
-            _common_ancestor_cache.emplace(std::make_pair(field1, field2), nullptr);
-            return nullptr;
-        }
-        auto parent = *(--f);
-        _common_ancestor_cache.emplace(std::make_pair(field1, field2), parent);
-        return parent;  // the field above the repeated field.
+    if (field1 == nullptr || field2 == nullptr) {
+        return nullptr;
     }
-
-    // Normal case:
-    auto common_ancestor = *(field1_path.rbegin() + common_ancestor_index);
-    _common_ancestor_cache.emplace(std::make_pair(field1, field2), common_ancestor);
-    return common_ancestor;
+    const auto& schema = SchemaMetadata::Of(field1);
+    return schema.field(schema.common_ancestor(schema.IndexOf(field1), schema.IndexOf(field2)));
 }
 
 /// Computes the definition level of a given field.
 /// The definition level is the number of optional and repeated fields in the path.
 inline unsigned GetDefinitionLevel(const FieldDescriptor* desc) {
-    unsigned definition_level = 0;
-
-    auto* field = desc;
-    while (field != nullptr) {
-        if (field->is_repeated() || field->is_optional()) {
-            definition_level++;
-        }
-        field = GetFieldDescriptor(field->containing_type());
+    if (desc == nullptr) {
+        return 0;
     }
-    return definition_level;
+    const auto& schema = SchemaMetadata::Of(desc);
+    return schema.definition_level(schema.IndexOf(desc));
 }
 
 /// In contrast to a "normal" definition level, the full definition level takes
 /// all fields in the path into account.
 inline unsigned GetFullDefinitionLevel(const FieldDescriptor* desc) {
-    unsigned full_definition_level = 0;
-
-    auto* field = desc;
-    while (field != nullptr) {
-        full_definition_level++;
-        field = GetFieldDescriptor(field->containing_type());
+    if (desc == nullptr) {
+        return 0;
     }
-    return full_definition_level;
+    const auto& schema = SchemaMetadata::Of(desc);
+    return schema.full_definition_level(schema.IndexOf(desc));
 }
 
 
@@ -0,0 +1,248 @@
+// ---------------------------------------------------------------------------
+// IMLAB
+// ---------------------------------------------------------------------------
+#ifndef INCLUDE_IMLAB_DREMEL_SCHEMA_METADATA_H_
+#define INCLUDE_IMLAB_DREMEL_SCHEMA_METADATA_H_
+//---------------------------------------------------------------------------
+#include <google/protobuf/descriptor.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "../infra/error.h"
+//---------------------------------------------------------------------------
+namespace imlab {
+namespace dremel {
+//---------------------------------------------------------------------------
+using namespace google::protobuf;
+
+/// Everything that shredding, assembling and the RecordFSM need to know about the fields of a schema.
+/// The fields, including the groups and nested messages, are numbered in depth-first order.
+/// For every field we keep its parent, its levels and the lowest common ancestor with every other field.
+///
+/// The metadata is computed once per schema (see Of()) and is immutable afterwards,
+/// so any number of threads can read it without synchronization.
+///
+/// Columns are identified by their fields, so every message type may be the type of one field only.
+/// Schemas that use a message type for several fields, including recursive schemas, are rejected.
+class SchemaMetadata {
+ public:
+    /// The index of "no field", i.e. the root message.
+    static constexpr uint32_t kRoot = std::numeric_limits<uint32_t>::max();
+
+    /// Computes the metadata for the schema of a root message.
+    /// Throws a SchemaCompilationError if a message type is used by several fields or contains itself.
+    explicit SchemaMetadata(const Descriptor* root) : _root(root) {
+        AddFields(root, kRoot);
+        _common_ancestors.resize(_fields.size() * _fields.size());
+        for (uint32_t field1 = 0; field1 < _fields.size(); field1++) {
+            for (uint32_t field2 = 0; field2 < _fields.size(); field2++) {
+                _common_ancestors[field1 * _fields.size() + field2] = ComputeCommonAncestor(field1, field2);
+            }
+        }
+    }
+
+    /// Gets the metadata for the schema that a message belongs to. It is computed on the first call.
+    /// Looking up a schema that is already known does not take a lock.
+    ///
+    /// A message that no known schema contains is taken to belong to the schema of its outermost containing type.
+    /// Message types that are not nested in their root (e.g. a top-level message type that a field of the root
+    /// refers to) are therefore only found once the metadata of the root was computed with Of(root).
+    static const SchemaMetadata& Of(const Descriptor* message) {
+        auto& registry = GetRegistry();
+        if (auto* entry = Find(registry.head.load(std::memory_order_acquire), message)) {
+            return *entry->metadata;
+        }
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        if (auto* entry = Find(registry.head.load(std::memory_order_relaxed), message)) {
+            return *entry->metadata;
+        }
+        while (message->containing_type() != nullptr) {
+            message = message->containing_type();
+        }
+        registry.entries.push_back(std::make_unique<Entry>(
+            Entry{std::make_unique<SchemaMetadata>(message), registry.head.load(std::memory_order_relaxed)}));
+        registry.head.store(registry.entries.back().get(), std::memory_order_release);
+        return *registry.entries.back()->metadata;
+    }
+    /// Gets the metadata for the schema that a field belongs to.
+    static const SchemaMetadata& Of(const FieldDescriptor* field) { return Of(field->containing_type()); }
+
+    /// The root message of the schema.
+    const Descriptor* root() const { return _root; }
+    /// The number of fields in the schema.
+    uint32_t field_count() const { return _fields.size(); }
+    /// The field with an index, nullptr for kRoot.
+    const FieldDescriptor* field(uint32_t index) const { return index == kRoot ? nullptr : _fields[index].field; }
+
+    /// The index of a field, kRoot for nullptr.
+    uint32_t IndexOf(const FieldDescriptor* field) const {
+        return field == nullptr ? kRoot : _field_indexes.at(field);
+    }
+    /// The index of the field that has a nested message as its type, kRoot for the root message.
+    uint32_t IndexOf(const Descriptor* message) const {
+        return message == _root ? kRoot : _message_indexes.at(message);
+    }
+    /// Whether a message type is the root or the type of a field of the schema.
+    bool Contains(const Descriptor* message) const {
+        return message == _root || _message_indexes.count(message) != 0;
+    }
+
+    /// The index of the group or message that contains a field, kRoot for top-level fields.
+    uint32_t parent(uint32_t index) const { return index == kRoot ? kRoot : _fields[index].parent; }
+    /// The number of repeated fields in the path.
+    unsigned max_repetition_level(uint32_t index) const {
+        return index == kRoot ? 0 : _fields[index].max_repetition_level;
+    }
+    /// The number of optional and repeated fields in the path.
+    unsigned definition_level(uint32_t index) const { return index == kRoot ? 0 : _fields[index].definition_level; }
+    /// The number of fields in the path.
+    unsigned full_definition_level(uint32_t index) const {
+        return index == kRoot ? 0 : _fields[index].full_definition_level;
+    }
+    /// The lowest common ancestor of two fields (see GetCommonAncestor()).
+    uint32_t common_ancestor(uint32_t field1, uint32_t field2) const {
+        if (field1 == kRoot || field2 == kRoot) {
+            return kRoot;
+        }
+        return _common_ancestors[field1 * _fields.size() + field2];
+    }
+
+ protected:
+    struct FieldInfo {
+        const FieldDescriptor* field;
+        uint32_t parent;
+        unsigned max_repetition_level;
+        unsigned definition_level;
+        unsigned full_definition_level;
+    };
+
+    /// Numbers the fields of a message and of all messages nested in it.
+    void AddFields(const Descriptor* message, uint32_t parent) {
+        for (int i = 0; i < message->field_count(); i++) {
+            const auto* field = message->field(i);
+            uint32_t index = _fields.size();
+            _fields.push_back({
+                field, parent,
+                max_repetition_level(parent) + field->is_repeated(),
+                definition_level(parent) + (field->is_repeated() || field->is_optional()),
+                full_definition_level(parent) + 1
+            });
+            _field_indexes.emplace(field, index);
+            if (field->message_type() != nullptr) {
+                const auto* type = field->message_type();
+                for (uint32_t ancestor = parent; ancestor != kRoot; ancestor = this->parent(ancestor)) {
+                    if (_fields[ancestor].field->message_type() == type) {
+                        throw SchemaCompilationError("recursive schema: " + field->full_name() + " contains itself");
+                    }
+                }
+                if (type == _root) {
+                    throw SchemaCompilationError("recursive schema: " + field->full_name() + " contains the root");
+                }
+                auto [other, inserted] = _message_indexes.emplace(type, index);
+                if (!inserted) {
+                    throw SchemaCompilationError("the message type " + type->full_name() + " is used by both "
+                                                 + _fields[other->second].field->full_name() + " and " + field->full_name());
+                }
+                AddFields(type, index);
+            }
+        }
+    }
+
+    /// The fields on the path from the root to a field, starting with kRoot.
+    std::vector<uint32_t> PathTo(uint32_t index) const {
+        std::vector<uint32_t> path {};
+        for (; index != kRoot; index = parent(index)) {
+            path.push_back(index);
+        }
+        path.push_back(kRoot);
+        std::reverse(path.begin(), path.end());
+        return path;
+    }
+
+    /// Computes the lowest common ancestor of two fields.
+    uint32_t ComputeCommonAncestor(uint32_t field1, uint32_t field2) const {
+        auto field1_path = PathTo(field1);
+        auto field2_path = PathTo(field2);
+
+        // Depth of the lowest common ancestor in both paths.
+        size_t common = 0;
+        while (common + 1 < std::min(field1_path.size(), field2_path.size())
+               && field1_path[common + 1] == field2_path[common + 1]) {
+            common++;
+        }
+
+        // Edge case:
+        // When field1 is a parent node of field2, return the parent (field1).
+        if (field1_path[common] == field1 && field1 != field2) {
+            return field1;
+        }
+
+        // Edge case:
+        // When both fields are equal, we need to go up the tree until we find a repeated field and return the field above.
+        // Same happens when field1 and field2 are in reverse order as they were declared in the message schema.
+        // The latter happens either for the trivial case of two (atomic) fields or if field2 is parent of field1.
+        bool field2_is_parent_of_field1 = field2_path[common] == field2 && field1 != field2;
+        if (field1 == field2 || field2_is_parent_of_field1
+            || field(field1_path[common + 1])->index() >= field(field2_path[common + 1])->index()) {
+            size_t depth = common;  // the common ancestor could also be the field itself if fields are equal.
+            while (depth != 0 && !field(field1_path[depth])->is_repeated()) {
+                depth--;
+            }
+            if (depth == 0) {
+                // Both fields need to be in different messages because there is no repeated field above.
+                return kRoot;
+            }
+            return field1_path[depth - 1];  // the field above the repeated field.
+        }
+
+        // Normal case:
+        return field1_path[common];
+    }
+
+ private:
+    struct Entry {
+        std::unique_ptr<const SchemaMetadata> metadata;
+        const Entry* next;
+    };
+    /// The metadata of all schemas that have been used, a list that is only ever prepended to.
+    struct Registry {
+        std::mutex mutex;
+        std::atomic<const Entry*> head {nullptr};
+        std::vector<std::unique_ptr<Entry>> entries;
+    };
+
+    static Registry& GetRegistry() {
+        static Registry registry;
+        return registry;
+    }
+    static const Entry* Find(const Entry* entry, const Descriptor* message) {
+        while (entry != nullptr && !entry->metadata->Contains(message)) {
+            entry = entry->next;
+        }
+        return entry;
+    }
+
+    /// The root message.
+    const Descriptor* _root;
+    /// The fields in depth-first order.
+    std::vector<FieldInfo> _fields {};
+    /// The indexes of the fields.
+    std::unordered_map<const FieldDescriptor*, uint32_t> _field_indexes {};
+    /// The indexes of the fields by their message types, which are unique within a schema.
+    std::unordered_map<const Descriptor*, uint32_t> _message_indexes {};
+    /// The lowest common ancestor of every pair of fields (row-major).
+    std::vector<uint32_t> _common_ancestors {};
+};
+
+//---------------------------------------------------------------------------
+}  // namespace dremel
+}  // namespace imlab
+//---------------------------------------------------------------------------
+#endif  // INCLUDE_IMLAB_DREMEL_SCHEMA_METADATA_H_
+//---------------------------------------------------------------------------
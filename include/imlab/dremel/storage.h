@@ -4,12 +4,22 @@
 #ifndef INCLUDE_IMLAB_DREMEL_STORAGE_H_
 #define INCLUDE_IMLAB_DREMEL_STORAGE_H_
 //---------------------------------------------------------------------------
+#include <algorithm>
+#include <cassert>
+#include <memory>
 #include <optional>
 #include <vector>
 #include <tuple>
 #include <string>
 #include <google/protobuf/descriptor.h>
+#include <google/protobuf/descriptor.pb.h>
+#include <tbb/concurrent_vector.h>
+#include "../infra/binary_file.h"
+#include "../infra/buffer.h"
 #include "./schema_helper.h"
+#include "./level_stream.h"
+#include "./value_store.h"
+#include "./zone_map.h"
 //---------------------------------------------------------------------------
 namespace imlab {
 namespace dremel {
@@ -24,8 +34,98 @@ class TableBase {
     uint64_t size() { return _size; }
 
     virtual FieldWriter* record_writer() = 0;
+
+    /// Splits the records of the table into morsels for a parallel scan.
+    /// The morsels are aligned to the segments of the column with the most rows, which has the finest segments.
+    virtual std::vector<RecordRange> morsels() = 0;
+
+    /// Returns the records that might contain a value that satisfies the predicate, according to the zone maps
+    /// of the predicate's column. All other records are guaranteed not to satisfy it.
+    virtual std::vector<RecordRange> candidate_records(const RangePredicate& predicate) = 0;
+
+    /// Splits only those records into morsels that might satisfy all of the given predicates.
+    /// Records in segments that can't contain a qualifying value are skipped entirely.
+    std::vector<RecordRange> morsels(const std::vector<RangePredicate>& predicates) {
+        auto morsels = this->morsels();
+        for (auto& predicate : predicates) {
+            morsels = IntersectRecordRanges(morsels, candidate_records(predicate));
+        }
+        return morsels;
+    }
+
+    /// Writes all records of the table to a file that can be opened with open().
+    /// The source identifies the data that the records were loaded from, e.g. a file and its modification time.
+    virtual void save(const std::string& path, const std::string& source = "") = 0;
+
+    /// Replaces all records of the table with those in a file that was written with save() from the same source.
+    /// The file is mapped into memory: Opening it only reads the metadata and the levels of every column segment,
+    /// values are paged in when a query accesses them for the first time.
+    /// If the file can't be opened, was written from another source or is invalid, a FileFormatError is thrown
+    /// and the table is left empty.
+    virtual void open(const std::string& path, const std::string& source = "") = 0;
+
  protected:
+    /// Identifies a file written by save() and the version of its format.
+    static constexpr uint64_t kFileMagic = 0x334C4D4552444D49;  // "IMDREML3" in little endian
+
     uint64_t _size = 0;
+
+    /// Writes the header of a table file: The schema of the records, their source and the number of records.
+    /// The columns follow in the order of the fields of the table.
+    void WriteHeader(BinaryWriter& writer, const Descriptor* descriptor, const std::string& source) {
+        FileDescriptorProto schema;
+        descriptor->file()->CopyTo(&schema);
+        writer.write<uint64_t>(kFileMagic);
+        writer.write_string(schema.SerializeAsString());
+        writer.write_string(descriptor->full_name());
+        writer.write_string(source);
+        writer.write<uint64_t>(_size);
+    }
+
+    /// Reads the header of a table file and checks that the file contains records of the given message
+    /// that were loaded from the given source.
+    void ReadHeader(BinaryReader& reader, const Descriptor* descriptor, const std::string& source) {
+        if (reader.read<uint64_t>() != kFileMagic) {
+            throw FileFormatError("not a table file");
+        }
+        FileDescriptorProto schema;
+        descriptor->file()->CopyTo(&schema);
+        if (reader.read_string() != schema.SerializeAsString() || reader.read_string() != descriptor->full_name()) {
+            throw FileFormatError("the file was written with a different schema");
+        }
+        if (reader.read_string() != source) {
+            throw FileFormatError("the file was written from a different source");
+        }
+        _size = reader.read<uint64_t>();
+    }
+
+    /// Returns morsels that are aligned to the segments of the given column.
+    template<class Column>
+    std::vector<RecordRange> AlignMorsels(Column& column) {
+        std::vector<RecordRange> morsels {};
+        uint64_t begin = 0;
+        for (uint64_t i = 1; i < column.segment_count(); i++) {
+            uint64_t end = std::min(column.segment(i).first_record(), _size);
+            if (end > begin) {
+                morsels.push_back({ begin, end });
+                begin = end;
+            }
+        }
+        if (_size > begin) {
+            morsels.push_back({ begin, _size });
+        }
+        return morsels;
+    }
+
+    /// Returns the candidate records of a column for a predicate.
+    template<class Column>
+    std::vector<RecordRange> CandidateRecords(Column& column, const RangePredicate& predicate) {
+        typename Column::Bound lower, upper;
+        if (!ParseBound(predicate.lower, &lower) || !ParseBound(predicate.upper, &upper)) {
+            return { { 0, _size } };  // The bounds don't fit the column, so we can't tell anything.
+        }
+        return column.candidate_records(lower, upper);
+    }
 };
 
 /// A row in Dremel consists of
@@ -46,57 +146,592 @@ inline bool operator==(const DremelRow<T>& lhs, const DremelRow<T>& rhs){
         && lhs.definition_level == rhs.definition_level;
 }
 
+/// A segment of a DremelColumn: a fixed number of consecutive rows that are stored and encoded
+/// independently of all other segments.
+///
+/// Repetition and definition levels are stored in two separate LevelStreams: Runs of equal levels
+/// are run-length encoded, everything else is bit-packed with as many bits as the maximum level needs.
+/// A stream is omitted entirely if the maximum level is 0 (e.g. the repetition levels of a non-repeated field).
+/// Values are stored densely in a ValueStore: NULLs are only implied by a definition level that is smaller
+/// than the maximum definition level and don't occupy a slot in the value vector.
+/// String segments with a low cardinality are dictionary-encoded automatically (see ValueStore<std::string>).
+/// When a segment is sealed, its values are compressed with a codec that is chosen based on the data:
+/// integers with frame of reference or delta bit-packing, plain strings with an LZ block codec.
+///
+/// All positions (rows and values) within a segment are relative to the beginning of the segment.
+///
+/// \tparam T The type of the values stored in the segment.
+template<typename T>
+class ColumnSegment {
+ public:
+    /// Creates an empty segment that starts at the given TID of the column.
+    ColumnSegment(unsigned max_repetition_level, unsigned max_definition_level,
+                  TID first_tid, uint64_t first_value, uint64_t first_record)
+        : _max_repetition_level(max_repetition_level), _max_definition_level(max_definition_level),
+          _first_tid(first_tid), _first_value(first_value), _first_record(first_record),
+          _repetition_levels(max_repetition_level),
+          _definition_levels(max_definition_level) {
+        _zone_map.first_record = _zone_map.end_record = first_record;
+    }
+
+    /// Reads a segment that was written with write(). Levels and values are not copied, but stay in the file.
+    /// The levels are checked against the values and indexes, so that a corrupt file is rejected here
+    /// instead of making later accesses read out of bounds.
+    ColumnSegment(unsigned max_repetition_level, unsigned max_definition_level, BinaryReader& reader)
+        : _max_repetition_level(max_repetition_level), _max_definition_level(max_definition_level),
+          _first_tid(reader.read<uint64_t>()), _first_value(reader.read<uint64_t>()),
+          _first_record(reader.read<uint64_t>()),
+          _size(reader.read<uint64_t>()), _record_count(reader.read<uint64_t>()), _sealed(reader.read<bool>()),
+          _repetition_levels(max_repetition_level, reader), _definition_levels(max_definition_level, reader),
+          _values(reader), _value_index(reader.read_buffer<uint64_t>()), _record_index(reader.read_buffer<uint32_t>()),
+          _zone_map(ZoneMap<T>::read(reader)) {
+        if (_repetition_levels.size() != _size || _definition_levels.size() != _size || !HasValidIndexes()) {
+            throw FileFormatError("invalid column segment");
+        }
+    }
+
+    /// Appends the levels of a new row (and its value if it is not NULL).
+    void append(unsigned repetition_level, unsigned definition_level) {
+        if (_max_definition_level > 0 && _size % kValueIndexInterval == 0) {
+            _value_index.push_back(_values.size());
+        }
+        if (_max_repetition_level > 0 && repetition_level == 0 && _record_count % kRecordIndexInterval == 0) {
+            _record_index.push_back(_size);
+        }
+        _repetition_levels.push_back(repetition_level);
+        _definition_levels.push_back(definition_level);
+        _record_count += (repetition_level == 0);
+
+        // Maintain the zone map. A segment that starts in the middle of a record also contains a part of it.
+        if (_size == 0 && repetition_level > 0) {
+            _zone_map.first_record--;
+        }
+        _zone_map.end_record = _first_record + _record_count;
+        _zone_map.max_repetition_level = std::max(_zone_map.max_repetition_level, repetition_level);
+        _zone_map.null_count += (definition_level < _max_definition_level);
+        _size++;
+    }
+
+    /// Appends a non-NULL value; must be called right after append() with the maximum definition level.
+    void append_value(typename ValueStore<T>::const_reference value) {
+        _zone_map.add_value(value);
+        _values.push_back(value);
+    }
+
+    /// Returns the position of the value of the given row in the dense value vector of the segment.
+    /// If the row is NULL, this is the position of the next non-NULL value.
+    uint64_t value_index(uint64_t row) const {
+        if (_max_definition_level == 0) {
+            return row;  // There are no NULLs in this column.
+        }
+        if (row >= _size) {
+            return _values.size();
+        }
+        // Start at the closest checkpoint and count the non-NULL values from there.
+        uint64_t checkpoint = row - row % kValueIndexInterval;
+        auto cursor = _definition_levels.cursor(checkpoint);
+        return _value_index[row / kValueIndexInterval] + cursor.Count(_max_definition_level, row - checkpoint);
+    }
+
+    /// Returns the row at which the given record starts; records are counted from the first record that
+    /// starts in this segment (see first_record()). The record must start in this segment.
+    uint64_t record_start(uint64_t record) const {
+        assert(record < _record_count);
+        if (_max_repetition_level == 0) {
+            return record;
+        }
+        // Start at the closest indexed record and count record boundaries (r=0) from there.
+        uint64_t checkpoint = _record_index[record / kRecordIndexInterval];
+        auto cursor = _repetition_levels.cursor(checkpoint);
+        return checkpoint + cursor.SkipToOccurrence(0, record % kRecordIndexInterval);
+    }
+
+    /// Moves the segment to another position in a column, e.g. when the segments of a fragment are appended to a table.
+    /// Positions within the segment are relative to its beginning, so only the zone map has to follow.
+    void rebase(TID first_tid, uint64_t first_value, uint64_t first_record) {
+        _zone_map.first_record = _zone_map.first_record - _first_record + first_record;
+        _zone_map.end_record = _zone_map.end_record - _first_record + first_record;
+        _first_tid = first_tid;
+        _first_value = first_value;
+        _first_record = first_record;
+    }
+
+    /// Marks the segment as complete; no more rows will be appended.
+    void seal() {
+        _sealed = true;
+        _values.seal();
+        _value_index.shrink_to_fit();
+        _record_index.shrink_to_fit();
+    }
+
+    /// The TID of the first row of the segment in the column.
+    TID first_tid() const { return _first_tid; }
+    /// The position of the first value of the segment in the dense value vector of the whole column.
+    uint64_t first_value() const { return _first_value; }
+    /// The number of records that started before this segment, i.e. the index of the first record that starts in it.
+    uint64_t first_record() const { return _first_record; }
+    /// The number of records that start in this segment (rows with repetition level 0).
+    uint64_t record_count() const { return _record_count; }
+    /// The number of rows in the segment (including NULLs).
+    uint64_t size() const { return _size; }
+    /// Whether the segment is complete.
+    bool sealed() const { return _sealed; }
+
+    /// Returns the stream of repetition levels of all rows in the segment.
+    const LevelStream& repetition_levels() const { return _repetition_levels; }
+    /// Returns the stream of definition levels of all rows in the segment.
+    const LevelStream& definition_levels() const { return _definition_levels; }
+    /// Returns the non-NULL values of the segment.
+    const ValueStore<T>& values() const { return _values; }
+    /// Returns the statistics of the segment.
+    const ZoneMap<T>& zone_map() const { return _zone_map; }
+
+    /// Writes the segment to a file.
+    void write(BinaryWriter& writer) const {
+        writer.write<uint64_t>(_first_tid);
+        writer.write<uint64_t>(_first_value);
+        writer.write<uint64_t>(_first_record);
+        writer.write<uint64_t>(_size);
+        writer.write<uint64_t>(_record_count);
+        writer.write<bool>(_sealed);
+        _repetition_levels.write(writer);
+        _definition_levels.write(writer);
+        _values.write(writer);
+        writer.write_buffer(_value_index);
+        writer.write_buffer(_record_index);
+        _zone_map.write(writer);
+    }
+
+    /// Returns the number of bytes allocated for the segment.
+    uint64_t memory_usage() const {
+        return _repetition_levels.memory_usage() + _definition_levels.memory_usage()
+             + _value_index.capacity() * sizeof(uint64_t) + _record_index.capacity() * sizeof(uint32_t)
+             + _values.memory_usage();
+    }
+
+ protected:
+    /// Every kValueIndexInterval rows, the position in the value vector is remembered.
+    static constexpr uint64_t kValueIndexInterval = 64;
+    /// Every kRecordIndexInterval records, the row at which the record starts is remembered.
+    static constexpr uint64_t kRecordIndexInterval = 64;
+
+    const unsigned _max_repetition_level;
+    const unsigned _max_definition_level;
+    TID _first_tid;
+    uint64_t _first_value;
+    uint64_t _first_record;
+
+    /// Number of rows in this segment (including NULLs).
+    uint64_t _size = 0;
+    /// Number of rows with repetition level 0.
+    uint64_t _record_count = 0;
+    bool _sealed = false;
+
+    /// Repetition levels of all rows.
+    LevelStream _repetition_levels;
+    /// Definition levels of all rows.
+    LevelStream _definition_levels;
+    /// The non-NULL values.
+    ValueStore<T> _values;
+    /// Number of non-NULL values before every kValueIndexInterval-th row.
+    Buffer<uint64_t> _value_index;
+    /// The row of every kRecordIndexInterval-th record that starts in this segment.
+    Buffer<uint32_t> _record_index;
+    /// Statistics about all rows.
+    ZoneMap<T> _zone_map;
+
+    /// Whether the number of values, the number of records and both indexes match the levels of a segment
+    /// that was read from a file.
+    bool HasValidIndexes() const {
+        if (_max_definition_level == 0) {
+            if (_values.size() != _size || !_value_index.empty()) {
+                return false;
+            }
+        } else {
+            if (_value_index.size() != (_size + kValueIndexInterval - 1) / kValueIndexInterval) {
+                return false;
+            }
+            auto cursor = _definition_levels.cursor(0);
+            uint64_t values = 0;
+            for (uint64_t i = 0; i < _value_index.size(); i++) {
+                if (_value_index[i] != values) {
+                    return false;
+                }
+                values += cursor.Count(_max_definition_level, kValueIndexInterval);
+            }
+            if (_values.size() != values) {
+                return false;
+            }
+        }
+        if (_max_repetition_level == 0) {
+            if (_record_count != _size || !_record_index.empty()) {
+                return false;
+            }
+        } else {
+            if (_record_index.size() != (_record_count + kRecordIndexInterval - 1) / kRecordIndexInterval) {
+                return false;
+            }
+            auto cursor = _repetition_levels.cursor(0);
+            for (uint64_t i = 0; i < _record_index.size(); i++) {
+                cursor.SkipToOccurrence(0, (i == 0) ? 0 : kRecordIndexInterval);
+                if (cursor.at_end() || _record_index[i] != cursor.position()) {
+                    return false;
+                }
+            }
+            if (_repetition_levels.cursor(0).Count(0, _size) != _record_count) {
+                return false;
+            }
+        }
+        return _zone_map.end_record == _first_record + _record_count;
+    }
+};
+
 /// A column in the Dremel format.
 /// What's special about a Dremel column is that not only values are stored,
 /// but also repetition and definition levels for every value.
 /// Values can also be NULL.
 ///
-/// Usually, a column is stored a little more efficient in Dremel,
-/// e.g. only required repetition and definition levels are stored while others
-/// are inferred. Also, r and d levels only take up as many bits as they actually
-/// need.
+/// The rows of a column are split into ColumnSegments of at most segment_size() rows.
+/// A new segment is started whenever the last one is full, so appending never moves any existing segment
+/// and memory grows segment by segment. Once a segment is full, it is sealed and never changes again,
+/// so sealed segments can safely be read while new rows are appended.
+/// Appending another column takes over its segments as they are, so the segment before them is sealed early.
+/// Note that a record might span multiple segments.
 ///
 /// \tparam T The type of the values stored in the column.
 template<typename T>
 class DremelColumn {
  public:
+    /// The default number of rows per segment.
+    static constexpr uint64_t kDefaultSegmentSize = 1 << 16;
+    /// The type of the bounds of a range predicate on this column.
+    using Bound = std::optional<T>;
+
     /// Creates a new column in the Dremel format.
     ///
     /// \tparam field The field of the message that is stored in this column.
-    explicit DremelColumn(const FieldDescriptor* field)
-        : _field(field), _max_definition_level(GetDefinitionLevel(field)) {}
+    /// \tparam segment_size The number of rows per segment; must be a power of two.
+    explicit DremelColumn(const FieldDescriptor* field, uint64_t segment_size = kDefaultSegmentSize)
+        : _field(field),
+          _max_repetition_level(GetMaxRepetitionLevel(field)),
+          _max_definition_level(GetDefinitionLevel(field)),
+          _segment_shift(BitWidth(segment_size) - 1) {
+        assert(segment_size > 0 && (segment_size & (segment_size - 1)) == 0);
+    }
 
     /// Returns the field of the record which is stored in this column.
     const FieldDescriptor* field() { return _field; }
 
     /// Insert a new value into the column with a given repetition and definition level.
     /// Returns the TID of the inserted value.
-    TID insert(DremelRow<T> row) {
-        _rows.push_back({ row.value.value_or(T{}), row.repetition_level, row.definition_level });
-        return _rows.size() - 1;
+    TID insert(const DremelRow<T>& row) {
+        if (row.definition_level == _max_definition_level) {
+            assert(row.value.has_value());
+            return insert_value(*row.value, row.repetition_level);
+        }
+        return insert_null(row.repetition_level, row.definition_level);
+    }
+
+    /// Insert a new non-NULL value into the column with a given repetition level.
+    /// Strings are only copied once, directly into the column's storage.
+    /// Returns the TID of the inserted value.
+    TID insert_value(typename ValueStore<T>::const_reference value, unsigned repetition_level) {
+        TID tid = append_levels(repetition_level, _max_definition_level);
+        _segments.back()->append_value(value);
+        _value_count++;
+        return tid;
+    }
+
+    /// Insert a NULL into the column with a given repetition and definition level.
+    /// Returns the TID of the inserted NULL.
+    TID insert_null(unsigned repetition_level, unsigned definition_level) {
+        assert(definition_level < _max_definition_level);
+        return append_levels(repetition_level, definition_level);
+    }
+
+    /// Appends all rows of another column of the same field, e.g. a fragment that another thread has shredded.
+    /// The segments of the other column are moved behind the last segment, which is sealed early if it isn't full;
+    /// only their positions in the column are adjusted. Just a small partial segment that still fits into the last
+    /// segment is re-inserted row by row, and so is a column with a different segment size.
+    /// The other column is empty afterwards.
+    void append(DremelColumn& other) {
+        assert(other._field == _field);
+        uint64_t first = 0;
+        if (other._segment_shift != _segment_shift) {
+            first = other._segments.size();
+            for (auto& segment : other._segments) {
+                AppendRows(*segment);
+            }
+        } else if (!_segments.empty() && !other._segments.empty()
+                && _segments.back()->size() + other._segments[0]->size() <= segment_size()) {
+            first = 1;
+            AppendRows(*other._segments[0]);
+        }
+        for (uint64_t i = first; i < other._segments.size(); i++) {
+            auto& segment = other._segments[i];
+            if (!_segments.empty() && !_segments.back()->sealed()) {
+                _segments.back()->seal();
+            }
+            segment->rebase(_size, _value_count, _record_count);
+            _size += segment->size();
+            _value_count += segment->values().size();
+            _record_count += segment->record_count();
+            _segments.push_back(std::move(segment));
+        }
+        other.clear();
     }
 
     /// Retrieves a value together with its repetition and definition levels for a given TID.
     DremelRow<T> get(TID tid) {
-        auto& [value, r, d] = _rows[tid];
+        auto r = repetition_level(tid);
+        auto d = definition_level(tid);
         // Null values are stored implicitly if the definition
         // level is smaller than the maximum definition level.
         if (d < _max_definition_level) {
-            return { std::nullopt, r, d};
+            return { std::nullopt, r, d };
         } else {
-            return { value, r, d};
+            auto& segment = segment_of(tid);
+            return { T(segment.values()[segment.value_index(tid - segment.first_tid())]), r, d };
+        }
+    }
+
+    /// Returns the repetition level of the row with the given TID.
+    unsigned repetition_level(TID tid) {
+        auto& segment = segment_of(tid);
+        return segment.repetition_levels()[tid - segment.first_tid()];
+    }
+
+    /// Returns the definition level of the row with the given TID.
+    unsigned definition_level(TID tid) {
+        auto& segment = segment_of(tid);
+        return segment.definition_levels()[tid - segment.first_tid()];
+    }
+
+    /// Returns the position of the value of the row with the given TID in the dense value vector of the column.
+    /// If the row is NULL, this is the position of the next non-NULL value.
+    uint64_t value_index(TID tid) {
+        if (tid >= _size) {
+            return _value_count;
+        }
+        auto& segment = segment_of(tid);
+        return segment.first_value() + segment.value_index(tid - segment.first_tid());
+    }
+
+    /// Returns the TID of the first row of the given record (or the size of the column if there is no such record).
+    /// Only every kRecordIndexInterval-th record start is indexed per segment, the rest is found by
+    /// counting record boundaries (rows with repetition level 0) in the repetition levels.
+    TID record_start(uint64_t record) {
+        if (record >= _record_count) {
+            return _size;
+        }
+        if (_max_repetition_level == 0) {
+            return record;  // Every row is a record of its own.
+        }
+        // The last segment that starts at or before the record contains the start of the record.
+        auto& segment = *_segments[FindSegment(record, &ColumnSegment<T>::first_record)];
+        return segment.first_tid() + segment.record_start(record - segment.first_record());
+    }
+
+    /// Returns the number of records in this column.
+    uint64_t record_count() { return _record_count; }
+
+    /// Returns a non-NULL value by its position in the dense value vector of the column.
+    /// Strings are returned as a std::string_view into the column that is invalidated by the next insert.
+    typename ValueStore<T>::const_reference value(uint64_t value_index) {
+        auto& segment = *_segments[FindSegment(value_index, &ColumnSegment<T>::first_value)];
+        return segment.values()[value_index - segment.first_value()];
+    }
+
+    /// Returns the records that have a row in a segment that might contain a value within [lower, upper],
+    /// according to the zone maps. The returned ranges are sorted and don't overlap.
+    std::vector<RecordRange> candidate_records(const Bound& lower, const Bound& upper) {
+        std::vector<RecordRange> ranges {};
+        for (auto& segment : _segments) {
+            auto& zone_map = segment->zone_map();
+            if (!zone_map.may_contain(lower, upper)) {
+                continue;
+            }
+            if (!ranges.empty() && ranges.back().end >= zone_map.first_record) {
+                ranges.back().end = std::max(ranges.back().end, zone_map.end_record);
+            } else {
+                ranges.push_back({ zone_map.first_record, zone_map.end_record });
+            }
+        }
+        return ranges;
+    }
+
+    /// Returns the number of segments.
+    uint64_t segment_count() { return _segments.size(); }
+
+    /// Returns the segment with the given number.
+    ColumnSegment<T>& segment(uint64_t i) { return *_segments[i]; }
+
+    /// Returns the segment that contains the given TID.
+    ColumnSegment<T>& segment_of(TID tid) {
+        // Segments are full unless a column was appended behind them, so the segment is usually found right away.
+        uint64_t i = tid >> _segment_shift;
+        if (i < _segments.size() && _segments[i]->first_tid() <= tid
+                && tid - _segments[i]->first_tid() < _segments[i]->size()) {
+            return *_segments[i];
         }
+        return *_segments[FindSegment(tid, &ColumnSegment<T>::first_tid)];
     }
 
+    /// Returns the maximum number of rows per segment.
+    uint64_t segment_size() { return 1ull << _segment_shift; }
+
+    /// Returns the maximum repetition level of the stored field.
+    unsigned max_repetition_level() { return _max_repetition_level; }
+
+    /// Returns the maximum definition level of the stored field.
+    unsigned max_definition_level() { return _max_definition_level; }
+
     /// Returns the number of elements in this column.
-    uint64_t size() { return _rows.size(); }
+    uint64_t size() { return _size; }
+
+    /// Writes all rows of the column to a file.
+    void write(BinaryWriter& writer) {
+        writer.write_string(_field->full_name());
+        writer.write<uint32_t>(_max_repetition_level);
+        writer.write<uint32_t>(_max_definition_level);
+        writer.write<uint64_t>(segment_size());
+        writer.write<uint64_t>(_size);
+        writer.write<uint64_t>(_value_count);
+        writer.write<uint64_t>(_record_count);
+        writer.write<uint64_t>(_segments.size());
+        for (auto& segment : _segments) {
+            segment->write(writer);
+        }
+    }
+
+    /// Replaces all rows of the column with those that were written to a file with write().
+    /// Only the metadata and the levels of the segments are read, values are read from the file when they are accessed.
+    /// If the file is invalid, a FileFormatError is thrown and the column is left unchanged.
+    void read(BinaryReader& reader) {
+        if (reader.read_string() != _field->full_name()
+                || reader.read<uint32_t>() != _max_repetition_level
+                || reader.read<uint32_t>() != _max_definition_level
+                || reader.read<uint64_t>() != segment_size()) {
+            throw FileFormatError("column " + _field->full_name() + " does not match the file");
+        }
+        uint64_t size = reader.read<uint64_t>();
+        uint64_t value_count = reader.read<uint64_t>();
+        uint64_t record_count = reader.read<uint64_t>();
+        uint64_t segment_count = reader.read<uint64_t>();
+        if (segment_count > size) {
+            throw FileFormatError("column " + _field->full_name() + " has an invalid number of segments");
+        }
+
+        // Every segment has to continue exactly where the previous one ended.
+        std::vector<std::unique_ptr<ColumnSegment<T>>> segments;
+        uint64_t rows = 0, values = 0, records = 0;
+        for (uint64_t i = 0; i < segment_count; i++) {
+            auto segment = std::make_unique<ColumnSegment<T>>(_max_repetition_level, _max_definition_level, reader);
+            if (segment->first_tid() != rows || segment->first_value() != values
+                    || segment->first_record() != records
+                    || segment->size() == 0 || segment->size() > std::min(segment_size(), size - rows)) {
+                throw FileFormatError("column " + _field->full_name() + " has an invalid segment");
+            }
+            rows += segment->size();
+            values += segment->values().size();
+            records += segment->record_count();
+            segments.push_back(std::move(segment));
+        }
+        if (rows != size || values != value_count || records != record_count) {
+            throw FileFormatError("column " + _field->full_name() + " has an invalid number of values or records");
+        }
+
+        _size = size;
+        _value_count = value_count;
+        _record_count = record_count;
+        _segments.clear();
+        for (auto& segment : segments) {
+            _segments.push_back(std::move(segment));
+        }
+    }
+
+    /// Removes all rows of the column.
+    void clear() {
+        _segments.clear();
+        _size = _value_count = _record_count = 0;
+    }
+
+    /// Returns the number of bytes allocated for levels and values.
+    uint64_t memory_usage() {
+        uint64_t bytes = 0;
+        for (auto& segment : _segments) {
+            bytes += sizeof(ColumnSegment<T>) + segment->memory_usage();
+        }
+        return bytes;
+    }
 
  protected:
     const FieldDescriptor* _field;
 
-    const std::size_t _max_definition_level;
+    const unsigned _max_repetition_level;
+    const unsigned _max_definition_level;
+
+    /// log2 of the number of rows per segment.
+    const unsigned _segment_shift;
+
+    /// Number of rows in this column (including NULLs).
+    uint64_t _size = 0;
+    /// Number of non-NULL values in this column.
+    uint64_t _value_count = 0;
+    /// Number of records (rows with repetition level 0) in this column.
+    uint64_t _record_count = 0;
+    /// The segments; a concurrent_vector never moves its elements when it grows.
+    tbb::concurrent_vector<std::unique_ptr<ColumnSegment<T>>> _segments;
 
-    std::vector<std::tuple<T, unsigned, unsigned>> _rows;
+    /// Appends the levels of a new row and returns its TID.
+    TID append_levels(unsigned repetition_level, unsigned definition_level) {
+        assert(repetition_level <= _max_repetition_level && definition_level <= _max_definition_level);
+        if (_segments.empty() || _segments.back()->sealed() || _segments.back()->size() == segment_size()) {
+            if (!_segments.empty() && !_segments.back()->sealed()) {
+                _segments.back()->seal();
+            }
+            _segments.push_back(std::make_unique<ColumnSegment<T>>(
+                _max_repetition_level, _max_definition_level, _size, _value_count, _record_count));
+        }
+        _segments.back()->append(repetition_level, definition_level);
+        _record_count += (repetition_level == 0);
+        return _size++;
+    }
+
+    /// Appends the rows of a segment of another column one by one.
+    void AppendRows(const ColumnSegment<T>& segment) {
+        constexpr uint64_t kBatchSize = 1024;
+        uint8_t repetition_levels[kBatchSize];
+        uint8_t definition_levels[kBatchSize];
+        auto repetition_cursor = segment.repetition_levels().cursor(0);
+        auto definition_cursor = segment.definition_levels().cursor(0);
+        uint64_t value_index = 0;
+        for (uint64_t row = 0; row < segment.size(); row += kBatchSize) {
+            uint64_t n = repetition_cursor.Decode(repetition_levels, kBatchSize);
+            definition_cursor.Decode(definition_levels, n);
+            for (uint64_t i = 0; i < n; i++) {
+                if (definition_levels[i] == _max_definition_level) {
+                    insert_value(segment.values()[value_index++], repetition_levels[i]);
+                } else {
+                    insert_null(repetition_levels[i], definition_levels[i]);
+                }
+            }
+        }
+    }
+
+    /// Returns the index of the last segment whose first TID, value or record (selected by first) is at most position.
+    uint64_t FindSegment(uint64_t position, uint64_t (ColumnSegment<T>::*first)() const) const {
+        uint64_t lower = 0, upper = _segments.size();
+        while (upper - lower > 1) {
+            uint64_t middle = (lower + upper) / 2;
+            if (((*_segments[middle]).*first)() <= position) {
+                lower = middle;
+            } else {
+                upper = middle;
+            }
+        }
+        return lower;
+    }
 };
 
 //---------------------------------------------------------------------------
@@ -0,0 +1,445 @@
+// ---------------------------------------------------------------------------
+// IMLAB
+// ---------------------------------------------------------------------------
+#ifndef INCLUDE_IMLAB_DREMEL_VALUE_STORE_H_
+#define INCLUDE_IMLAB_DREMEL_VALUE_STORE_H_
+//---------------------------------------------------------------------------
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include "../infra/binary_file.h"
+#include "../infra/bit_packed_vector.h"
+#include "../infra/bits.h"
+#include "../infra/buffer.h"
+#include "../infra/compressed_string_arena.h"
+#include "../infra/error.h"
+#include "../infra/integer_encoding.h"
+#include "../infra/string_arena.h"
+//---------------------------------------------------------------------------
+namespace imlab {
+namespace dremel {
+//---------------------------------------------------------------------------
+
+/// Stores the non-NULL values of a DremelColumn densely, addressed by their value index.
+/// Values are appended until the segment of the store is sealed, after which the store never changes again
+/// and may compress its values (see the specializations below). Floating point values are stored plain.
+///
+/// \tparam T The type of the values.
+template<typename T>
+class ValueStore {
+ public:
+    /// The type through which stored values are accessed.
+    using const_reference = const T&;
+
+    ValueStore() = default;
+    /// Reads a store that was written with write(). The values are not copied.
+    explicit ValueStore(BinaryReader& reader) : _values(reader.read_buffer<T>()) {}
+
+    /// Appends a value.
+    void push_back(const_reference value) { _values.push_back(value); }
+
+    /// Returns the value at the given value index.
+    const_reference operator[](uint64_t value_index) const { return _values[value_index]; }
+
+    /// Copies the values [first, first + n) to out.
+    void decode(uint64_t first, uint64_t n, T* out) const {
+        std::copy(_values.begin() + first, _values.begin() + first + n, out);
+    }
+
+    /// Returns the number of stored values.
+    uint64_t size() const { return _values.size(); }
+
+    /// Marks the store as complete.
+    void seal() { _values.shrink_to_fit(); }
+
+    /// Returns the number of bytes allocated for the values.
+    uint64_t memory_usage() const { return _values.capacity() * sizeof(T); }
+
+    /// Writes the values to a file.
+    void write(BinaryWriter& writer) const { writer.write_buffer(_values); }
+
+ protected:
+    Buffer<T> _values;
+};
+
+/// Integers are appended plain and compressed with the cheapest lightweight encoding when the store is sealed
+/// (frame of reference or delta, see EncodedIntegers), so only the segment that is still growing stores them plain.
+template<typename T>
+class IntegerValueStore {
+ public:
+    /// The type through which stored values are accessed; encoded values can't be referenced.
+    using const_reference = T;
+
+    IntegerValueStore() = default;
+    /// Reads a store that was written with write(). The values are not copied.
+    explicit IntegerValueStore(BinaryReader& reader)
+        : _sealed(reader.read<bool>()), _values(reader.read_buffer<T>()), _encoded(reader) {
+        if (_sealed ? !_values.empty() : _encoded.size() != 0) {
+            throw FileFormatError("invalid integer values");
+        }
+    }
+
+    /// Appends a value.
+    void push_back(T value) {
+        assert(!_sealed);
+        _values.push_back(value);
+    }
+
+    /// Returns the value at the given value index.
+    T operator[](uint64_t value_index) const { return _sealed ? _encoded[value_index] : _values[value_index]; }
+
+    /// Decodes the values [first, first + n) to out, which is much faster than accessing them one by one.
+    void decode(uint64_t first, uint64_t n, T* out) const {
+        if (_sealed) {
+            _encoded.decode(first, n, out);
+        } else {
+            std::copy(_values.begin() + first, _values.begin() + first + n, out);
+        }
+    }
+
+    /// Returns the number of stored values.
+    uint64_t size() const { return _sealed ? _encoded.size() : _values.size(); }
+
+    /// Marks the store as complete and compresses the values.
+    void seal() {
+        _encoded = EncodedIntegers<T>::Encode(_values.data(), _values.size());
+        _values.clear();
+        _sealed = true;
+    }
+
+    /// Returns the encoding of the values (plain until the store is sealed).
+    IntegerEncoding encoding() const { return _sealed ? _encoded.encoding() : IntegerEncoding::kPlain; }
+
+    /// Returns the number of bytes allocated for the values.
+    uint64_t memory_usage() const { return _values.capacity() * sizeof(T) + _encoded.memory_usage(); }
+
+    /// Writes the values to a file.
+    void write(BinaryWriter& writer) const {
+        writer.write<bool>(_sealed);
+        writer.write_buffer(_values);
+        _encoded.write(writer);
+    }
+
+ protected:
+    bool _sealed = false;
+    /// The values until the store is sealed.
+    Buffer<T> _values;
+    /// The values once the store is sealed.
+    EncodedIntegers<T> _encoded;
+};
+
+template<> class ValueStore<int32_t> : public IntegerValueStore<int32_t> { using IntegerValueStore::IntegerValueStore; };
+template<> class ValueStore<uint32_t> : public IntegerValueStore<uint32_t> { using IntegerValueStore::IntegerValueStore; };
+template<> class ValueStore<int64_t> : public IntegerValueStore<int64_t> { using IntegerValueStore::IntegerValueStore; };
+template<> class ValueStore<uint64_t> : public IntegerValueStore<uint64_t> { using IntegerValueStore::IntegerValueStore; };
+
+/// Booleans are bit-packed.
+template<>
+class ValueStore<bool> {
+ public:
+    /// The type through which stored values are accessed.
+    using const_reference = bool;
+
+    ValueStore() : _values(1) {}
+    /// Reads a store that was written with write(). The values are not copied.
+    explicit ValueStore(BinaryReader& reader) : _values(reader) {}
+
+    /// Appends a value.
+    void push_back(bool value) { _values.push_back(value); }
+
+    /// Returns the value at the given value index.
+    bool operator[](uint64_t value_index) const { return _values[value_index]; }
+
+    /// Decodes the values [first, first + n) to out.
+    void decode(uint64_t first, uint64_t n, bool* out) const {
+        for (uint64_t i = 0; i < n; i++) {
+            out[i] = _values[first + i];
+        }
+    }
+
+    /// Returns the number of stored values.
+    uint64_t size() const { return _values.size(); }
+
+    /// Marks the store as complete; the values are already as small as they get.
+    void seal() {}
+
+    /// Returns the number of bytes allocated for the values.
+    uint64_t memory_usage() const { return _values.memory_usage(); }
+
+    /// Writes the values to a file.
+    void write(BinaryWriter& writer) const { _values.write(writer); }
+
+ protected:
+    BitPackedVector _values;
+};
+
+/// Stores strings either dictionary-encoded or plain.
+///
+/// A store starts out with a dictionary: every distinct string is stored only once and values are
+/// bit-packed codes into the dictionary. The codes grow by one bit whenever the dictionary outgrows them.
+/// As soon as the dictionary turns out to be too large (too many distinct strings overall or compared to
+/// the number of values), all values are decoded once and the store continues with plain strings.
+/// This decision is only ever made in that direction, so a dictionary-encoded store always has a low cardinality.
+///
+/// Both the dictionary and the plain strings live in a StringArena, so appending a string copies its bytes
+/// into one growing buffer and reading it returns a std::string_view without any copy.
+/// These views are invalidated by push_back.
+///
+/// When the store is sealed, plain strings are compressed in blocks (see CompressedStringArena) if that saves
+/// at least a quarter of their memory. Reading a compressed string decompresses its block into a cache of
+/// the calling thread, so its view is only valid until the thread has read a few other blocks.
+template<>
+class ValueStore<std::string> {
+ public:
+    /// The type through which stored values are accessed.
+    using const_reference = std::string_view;
+
+    /// The dictionary is abandoned once it holds more than this many strings.
+    static constexpr uint64_t kMaxDictionarySize = 1 << 12;
+    /// The dictionary is also abandoned if more than every kMinValuesPerEntry-th value is a new string ...
+    static constexpr uint64_t kMinValuesPerEntry = 2;
+    /// ... but this is only checked once the dictionary has this many entries.
+    static constexpr uint64_t kMinDictionarySizeForCheck = 64;
+
+    ValueStore() : _codes(0) {}
+
+    /// Reads a store that was written with write(). Strings and codes are not copied,
+    /// only the hash table of the dictionary is rebuilt.
+    explicit ValueStore(BinaryReader& reader)
+        : _dictionary_encoded(reader.read<bool>()), _dictionary(reader), _codes(reader), _values(reader),
+          _compressed(reader.read<bool>()), _compressed_values(reader) {
+        // Only one representation holds values, and every code has to refer to a string of the dictionary.
+        bool valid = _dictionary_encoded
+            ? !_compressed && _values.size() == 0 && _compressed_values.size() == 0
+            : _dictionary.size() == 0 && _codes.size() == 0 && (_compressed ? _values.size() : _compressed_values.size()) == 0;
+        uint32_t codes[256];
+        for (uint64_t i = 0; valid && i < _codes.size(); i += 256) {
+            uint64_t n = std::min<uint64_t>(256, _codes.size() - i);
+            _codes.decode(i, n, codes);
+            valid = *std::max_element(codes, codes + n) < _dictionary.size();
+        }
+        if (!valid) {
+            throw FileFormatError("invalid string values");
+        }
+        for (uint32_t code = 0; code < _dictionary.size(); code++) {
+            _dictionary_lookup.emplace(std::hash<std::string_view>{}(_dictionary[code]), code);
+        }
+    }
+
+    /// Appends a value.
+    void push_back(std::string_view value) {
+        assert(!_compressed);
+        if (!_dictionary_encoded) {
+            _values.push_back(value);
+            return;
+        }
+        // Runs of the same string are common, and comparing with the previous string is cheaper than hashing.
+        if (_codes.size() > 0) {
+            uint32_t previous = _codes[_codes.size() - 1];
+            if (_dictionary[previous] == value) {
+                _codes.push_back(previous);
+                return;
+            }
+        }
+        uint64_t hash = std::hash<std::string_view>{}(value);
+        if (auto code = Find(value, hash)) {
+            _codes.push_back(*code);
+            return;
+        }
+
+        // A new string: Check whether the dictionary still pays off.
+        uint64_t entries = _dictionary.size() + 1;
+        if (entries > kMaxDictionarySize
+                || (entries >= kMinDictionarySizeForCheck && entries * kMinValuesPerEntry > _codes.size() + 1)) {
+            DecodeDictionary();
+            _values.push_back(value);
+            return;
+        }
+
+        uint32_t code = _dictionary.size();
+        if (BitWidth(code) > _codes.bit_width()) {
+            WidenCodes(BitWidth(code));
+        }
+        _dictionary.push_back(value);
+        _dictionary_lookup.emplace(hash, code);
+        _codes.push_back(code);
+    }
+
+    /// Returns the value at the given value index.
+    std::string_view operator[](uint64_t value_index) const {
+        if (_dictionary_encoded) {
+            return _dictionary[_codes[value_index]];
+        }
+        if (_compressed) {
+            return _compressed_values[value_index];
+        }
+        return _values[value_index];
+    }
+
+    /// Returns the number of stored values.
+    uint64_t size() const {
+        return _dictionary_encoded ? _codes.size() : (_compressed ? _compressed_values.size() : _values.size());
+    }
+
+    /// Marks the store as complete and compresses plain strings if that pays off.
+    void seal() {
+        if (_dictionary_encoded || _values.size() == 0) {
+            return;
+        }
+        CompressedStringArena compressed(_values);
+        if (compressed.memory_usage() * 4 <= _values.memory_usage() * 3) {
+            _compressed_values = std::move(compressed);
+            _compressed = true;
+            _values.clear();
+        }
+    }
+
+    /// Whether the values are dictionary-encoded.
+    bool dictionary_encoded() const { return _dictionary_encoded; }
+
+    /// Whether the values are plain strings that are compressed.
+    bool compressed() const { return _compressed; }
+
+    /// Returns the dictionary code of the value at the given value index.
+    /// Only valid if the values are dictionary-encoded.
+    uint32_t code(uint64_t value_index) const {
+        assert(_dictionary_encoded);
+        return _codes[value_index];
+    }
+
+    /// Returns the dictionary code of a string or nothing if the string does not occur in the store.
+    /// Only valid if the values are dictionary-encoded.
+    std::optional<uint32_t> lookup(std::string_view value) const {
+        assert(_dictionary_encoded);
+        return Find(value, std::hash<std::string_view>{}(value));
+    }
+
+    /// Returns the string behind a dictionary code.
+    std::string_view decode(uint32_t code) const { return _dictionary[code]; }
+
+    /// Returns the number of distinct strings in the dictionary.
+    uint64_t dictionary_size() const { return _dictionary.size(); }
+
+    /// Returns the number of bytes allocated for the values.
+    uint64_t memory_usage() const {
+        return _codes.memory_usage() + _dictionary.memory_usage() + _values.memory_usage()
+             + _compressed_values.memory_usage() + _dictionary_lookup.size() * (sizeof(uint64_t) + sizeof(uint32_t));
+    }
+
+    /// Writes the values to a file.
+    void write(BinaryWriter& writer) const {
+        writer.write<bool>(_dictionary_encoded);
+        _dictionary.write(writer);
+        _codes.write(writer);
+        _values.write(writer);
+        writer.write<bool>(_compressed);
+        _compressed_values.write(writer);
+    }
+
+ protected:
+    bool _dictionary_encoded = true;
+    /// The distinct strings, the position of a string is its code.
+    StringArena _dictionary;
+    /// Maps the hash of every string in the dictionary to its code.
+    /// The arena may move its bytes, so the strings themselves can't be keys.
+    std::unordered_multimap<uint64_t, uint32_t> _dictionary_lookup;
+    /// Bit-packed dictionary codes of all values.
+    BitPackedVector _codes;
+    /// All values if they are neither dictionary-encoded nor compressed.
+    StringArena _values;
+    bool _compressed = false;
+    /// All values if they are compressed.
+    CompressedStringArena _compressed_values;
+
+    /// Returns the code of a string in the dictionary.
+    std::optional<uint32_t> Find(std::string_view value, uint64_t hash) const {
+        auto [begin, end] = _dictionary_lookup.equal_range(hash);
+        for (auto it = begin; it != end; ++it) {
+            if (_dictionary[it->second] == value) {
+                return it->second;
+            }
+        }
+        return std::nullopt;
+    }
+
+    /// Re-packs the codes with a larger bit width.
+    void WidenCodes(unsigned bit_width) {
+        BitPackedVector codes(bit_width);
+        for (uint64_t i = 0; i < _codes.size(); i++) {
+            codes.push_back(_codes[i]);
+        }
+        _codes = std::move(codes);
+    }
+
+    /// Switches to plain storage.
+    void DecodeDictionary() {
+        uint64_t bytes = 0;
+        for (uint64_t i = 0; i < _codes.size(); i++) {
+            bytes += _dictionary[_codes[i]].size();
+        }
+        _values.reserve(_codes.size() + 1, bytes);
+        for (uint64_t i = 0; i < _codes.size(); i++) {
+            _values.push_back(_dictionary[_codes[i]]);
+        }
+        _dictionary_encoded = false;
+        _dictionary_lookup.clear();
+        _dictionary.clear();
+        _codes = BitPackedVector(0);
+    }
+};
+
+/// Compares values of a ValueStore to a constant.
+/// The constant is prepared once, so that the comparisons themselves are as cheap as possible.
+/// The matcher must not outlive the store and is invalidated by inserting into the store.
+template<typename T>
+class EqualityMatcher {
+ public:
+    EqualityMatcher(const ValueStore<T>& store, T constant) : _store(store), _constant(std::move(constant)) {}
+
+    /// Whether the value at the given value index equals the constant.
+    bool matches(uint64_t value_index) const { return _store[value_index] == _constant; }
+
+ protected:
+    const ValueStore<T>& _store;
+    const T _constant;
+};
+
+/// On dictionary-encoded strings, the constant is translated into a code and equality becomes an integer compare.
+/// If the constant does not occur in the dictionary at all, nothing can match.
+template<>
+class EqualityMatcher<std::string> {
+ public:
+    EqualityMatcher(const ValueStore<std::string>& store, std::string constant)
+        : _store(store), _constant(std::move(constant)) {
+        if (_store.dictionary_encoded()) {
+            _code = _store.lookup(_constant);
+        }
+    }
+
+    /// Whether the value at the given value index equals the constant.
+    bool matches(uint64_t value_index) const {
+        if (_store.dictionary_encoded()) {
+            return _code.has_value() && _store.code(value_index) == *_code;
+        }
+        return _store[value_index] == _constant;
+    }
+
+ protected:
+    const ValueStore<std::string>& _store;
+    const std::string _constant;
+    /// The code of the constant if the store is dictionary-encoded.
+    std::optional<uint32_t> _code;
+};
+
+//---------------------------------------------------------------------------
+}  // namespace dremel
+}  // namespace imlab
+//---------------------------------------------------------------------------
+#endif  // INCLUDE_IMLAB_DREMEL_VALUE_STORE_H_
+//---------------------------------------------------------------------------
@@ -0,0 +1,215 @@
+// ---------------------------------------------------------------------------
+// IMLAB
+// ---------------------------------------------------------------------------
+#ifndef INCLUDE_IMLAB_DREMEL_WIRE_SHREDDING_H_
+#define INCLUDE_IMLAB_DREMEL_WIRE_SHREDDING_H_
+//---------------------------------------------------------------------------
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include "../infra/error.h"
+//---------------------------------------------------------------------------
+namespace imlab {
+namespace dremel {
+//---------------------------------------------------------------------------
+
+/// The wire types of the Protobuf encoding, the lowest three bits of a tag.
+enum class WireType : uint32_t {
+    kVarint = 0,
+    kFixed64 = 1,
+    kLengthDelimited = 2,
+    kStartGroup = 3,
+    kEndGroup = 4,
+    kFixed32 = 5,
+};
+
+/// Reads serialized Protobuf messages without parsing them into message objects.
+/// The generated tables walk the fields of a record with it and write the values straight into their columns
+/// (see Table::insert_serialized()), so a record is shredded in a single pass over its bytes.
+///
+/// A reader covers the fields of one message: a whole record, the bytes of a length-delimited nested message
+/// or everything up to the end tag of a group. Strings point into the serialized bytes.
+/// Malformed input throws a FileFormatError.
+class WireReader {
+ public:
+    /// Creates a reader for the fields of a serialized message.
+    explicit WireReader(std::string_view bytes)
+        : _current(bytes.data()), _end(bytes.data() + bytes.size()) {}
+
+    /// Reads the tag of the next field. Returns false at the end of the message.
+    bool next_tag(uint32_t* tag) {
+        if (_current == _end) {
+            if (_group != 0) {
+                throw FileFormatError("unterminated Protobuf group");
+            }
+            return false;
+        }
+        uint64_t value = read_varint<uint64_t>();
+        if (value > UINT32_MAX || (value >> 3) == 0) {
+            throw FileFormatError("invalid Protobuf tag");
+        }
+        *tag = static_cast<uint32_t>(value);
+        if (TypeOf(*tag) == WireType::kEndGroup) {
+            if (_group == 0 || NumberOf(*tag) != _group) {
+                throw FileFormatError("unexpected end of Protobuf group");
+            }
+            return false;
+        }
+        return true;
+    }
+
+    /// The field number of a tag.
+    static uint32_t NumberOf(uint32_t tag) { return tag >> 3; }
+    /// The wire type of a tag.
+    static WireType TypeOf(uint32_t tag) { return static_cast<WireType>(tag & 7); }
+
+    /// Checks that the value of a field has the wire type that its type in the schema is encoded with.
+    static void Expect(uint32_t tag, WireType type) {
+        if (TypeOf(tag) != type) {
+            throw FileFormatError("unexpected wire type for the Protobuf field " + std::to_string(NumberOf(tag)));
+        }
+    }
+
+    /// Reads a varint; negative int32 and int64 values are encoded as ten byte varints.
+    template<typename T>
+    T read_varint() {
+        if (_current != _end && static_cast<uint8_t>(*_current) < 0x80) {
+            return static_cast<T>(static_cast<uint8_t>(*_current++));
+        }
+        uint64_t value = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7) {
+            if (_current == _end) {
+                throw FileFormatError("truncated Protobuf message");
+            }
+            auto byte = static_cast<uint8_t>(*_current++);
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (byte < 0x80) {
+                return static_cast<T>(value);
+            }
+        }
+        throw FileFormatError("invalid Protobuf varint");
+    }
+    /// Reads a zigzag-encoded varint of a sint32 or sint64 field.
+    template<typename T>
+    T read_zigzag() {
+        auto value = read_varint<uint64_t>();
+        return static_cast<T>((value >> 1) ^ (~(value & 1) + 1));
+    }
+    /// Reads a little-endian value of a fixed32, fixed64, sfixed32, sfixed64, float or double field.
+    template<typename T>
+    T read_fixed() {
+        static_assert(sizeof(T) == 4 || sizeof(T) == 8);
+        Need(sizeof(T));
+        T value;
+        std::memcpy(&value, _current, sizeof(T));
+        _current += sizeof(T);
+        return value;
+    }
+    /// Reads the bytes of a string or bytes field.
+    std::string_view read_string() {
+        auto length = read_varint<uint64_t>();
+        Need(length);
+        std::string_view value(_current, length);
+        _current += length;
+        return value;
+    }
+    /// Reads the values of a packed repeated field; the values are read from the returned reader.
+    WireReader read_packed() {
+        return WireReader(read_string());
+    }
+
+    /// Starts reading a nested message, either a group or a length-delimited message.
+    /// The fields of the nested message are read from the returned reader, then end_nested() has to be called.
+    WireReader begin_nested(uint32_t tag) {
+        switch (TypeOf(tag)) {
+            case WireType::kLengthDelimited:
+                return WireReader(read_string());
+            case WireType::kStartGroup: {
+                WireReader group(std::string_view(_current, _end - _current));
+                group._group = NumberOf(tag);
+                return group;
+            }
+            default:
+                throw FileFormatError("unexpected wire type for the Protobuf field " + std::to_string(NumberOf(tag)));
+        }
+    }
+    /// Continues after a nested message whose fields have all been read.
+    void end_nested(const WireReader& nested) {
+        if (nested._group != 0) {
+            // A group is read from the bytes of its parent, up to its end tag.
+            _current = nested._current;
+        }
+    }
+
+    /// Skips the value of a field that is not in the schema.
+    void skip(uint32_t tag) {
+        switch (TypeOf(tag)) {
+            case WireType::kVarint: read_varint<uint64_t>(); break;
+            case WireType::kFixed64: Need(8); _current += 8; break;
+            case WireType::kLengthDelimited: read_string(); break;
+            case WireType::kFixed32: Need(4); _current += 4; break;
+            case WireType::kStartGroup: {
+                WireReader group = begin_nested(tag);
+                for (uint32_t group_tag; group.next_tag(&group_tag);) {
+                    group.skip(group_tag);
+                }
+                end_nested(group);
+                break;
+            }
+            default:
+                throw FileFormatError("invalid Protobuf wire type");
+        }
+    }
+
+    /// Whether all bytes have been read.
+    bool done() const { return _current == _end; }
+    /// The number of bytes that have not been read yet.
+    size_t remaining() const { return _end - _current; }
+
+ protected:
+    const char* _current;
+    const char* _end;
+    /// The field number of the group that the reader is in, 0 for length-delimited messages.
+    uint32_t _group = 0;
+
+    /// Checks that the message has n more bytes.
+    void Need(uint64_t n) const {
+        if (n > static_cast<uint64_t>(_end - _current)) {
+            throw FileFormatError("truncated Protobuf message");
+        }
+    }
+};
+
+
+/// Splits the next chunk off a stream of length-delimited records: about chunk_size bytes up to the end of a record.
+/// Every record is preceded by its length as a varint, the format of writeDelimitedTo() and
+/// google::protobuf::util::SerializeDelimitedToOstream(). The chunk is a view into the stream.
+/// Returns false if the stream is exhausted.
+inline bool SplitDelimitedRecords(std::string_view* stream, std::string_view* chunk, size_t chunk_size) {
+    if (stream->empty()) {
+        return false;
+    }
+    WireReader records(*stream);
+    while (!records.done() && stream->size() - records.remaining() < chunk_size) {
+        records.read_string();
+    }
+    *chunk = stream->substr(0, stream->size() - records.remaining());
+    stream->remove_prefix(chunk->size());
+    return true;
+}
+
+/// Calls insert(std::string_view record) with the bytes of every record in a stream of length-delimited records.
+template<typename Insert>
+void ForEachDelimitedRecord(std::string_view stream, Insert&& insert) {
+    for (WireReader records(stream); !records.done();) {
+        insert(records.read_string());
+    }
+}
+
+//---------------------------------------------------------------------------
+}  // namespace dremel
+}  // namespace imlab
+//---------------------------------------------------------------------------
+#endif  // INCLUDE_IMLAB_DREMEL_WIRE_SHREDDING_H_
+//---------------------------------------------------------------------------
@@ -0,0 +1,173 @@
+// ---------------------------------------------------------------------------
+// IMLAB
+// ---------------------------------------------------------------------------
+#ifndef INCLUDE_IMLAB_DREMEL_ZONE_MAP_H_
+#define INCLUDE_IMLAB_DREMEL_ZONE_MAP_H_
+//---------------------------------------------------------------------------
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include <google/protobuf/descriptor.h>
+#include "../infra/binary_file.h"
+//---------------------------------------------------------------------------
+namespace imlab {
+namespace dremel {
+//---------------------------------------------------------------------------
+using namespace google::protobuf;
+
+/// A range of records [begin, end) of a table.
+struct RecordRange {
+    uint64_t begin;
+    uint64_t end;
+};
+
+inline bool operator==(const RecordRange& lhs, const RecordRange& rhs) {
+    return lhs.begin == rhs.begin && lhs.end == rhs.end;
+}
+
+/// Returns the records that are contained in both lists of sorted, non-overlapping ranges.
+inline std::vector<RecordRange> IntersectRecordRanges(const std::vector<RecordRange>& lhs, const std::vector<RecordRange>& rhs) {
+    std::vector<RecordRange> result {};
+    auto l = lhs.begin(), r = rhs.begin();
+    while (l != lhs.end() && r != rhs.end()) {
+        uint64_t begin = std::max(l->begin, r->begin);
+        uint64_t end = std::min(l->end, r->end);
+        if (begin < end) {
+            result.push_back({ begin, end });
+        }
+        // Advance the range that ends first.
+        if (l->end < r->end) {
+            ++l;
+        } else {
+            ++r;
+        }
+    }
+    return result;
+}
+
+/// A predicate on the values of a field that can be checked against zone maps:
+/// A record qualifies if at least one value of the field lies within [lower, upper].
+/// A missing bound means that the range is unbounded in this direction.
+/// Bounds are given as strings and converted to the type of the field (see ParseBound()).
+struct RangePredicate {
+    const FieldDescriptor* field;
+    std::optional<std::string> lower;
+    std::optional<std::string> upper;
+};
+
+/// Converts the bound of a RangePredicate into the type of a column.
+/// Returns false if the bound is not a valid value of that type.
+template<typename T>
+inline bool ParseBound(const std::optional<std::string>& bound, std::optional<T>* result) {
+    if (!bound.has_value()) {
+        *result = std::nullopt;
+        return true;
+    }
+    T value {};
+    auto [end, error] = std::from_chars(bound->data(), bound->data() + bound->size(), value);
+    if (error != std::errc() || end != bound->data() + bound->size()) {
+        return false;
+    }
+    *result = value;
+    return true;
+}
+
+template<>
+inline bool ParseBound(const std::optional<std::string>& bound, std::optional<std::string>* result) {
+    *result = bound;
+    return true;
+}
+
+/// Statistics about the rows of one segment of a column.
+/// They allow to decide whether a segment can contain a value that satisfies a predicate without looking at it.
+///
+/// \tparam T The type of the values of the column.
+template<typename T>
+struct ZoneMap {
+    /// The smallest and the largest non-NULL value (if there are any).
+    std::optional<T> min;
+    std::optional<T> max;
+    /// The number of NULLs.
+    uint64_t null_count = 0;
+    /// The largest repetition level of any row.
+    unsigned max_repetition_level = 0;
+    /// The records that have at least one row in the segment: [first_record, end_record).
+    uint64_t first_record = 0;
+    uint64_t end_record = 0;
+
+    /// Includes a non-NULL value in the statistics.
+    template<typename V>
+    void add_value(const V& value) {
+        if (!min.has_value() || value < *min) {
+            min = T(value);
+        }
+        if (!max.has_value() || *max < value) {
+            max = T(value);
+        }
+    }
+
+    /// Whether the segment might contain a value within [lower, upper].
+    bool may_contain(const std::optional<T>& lower, const std::optional<T>& upper) const {
+        if (!min.has_value()) {
+            return false;  // There are only NULLs.
+        }
+        return !(lower.has_value() && *max < *lower) && !(upper.has_value() && *upper < *min);
+    }
+
+    /// Writes the statistics to a file.
+    void write(BinaryWriter& writer) const {
+        WriteValue(writer, min);
+        WriteValue(writer, max);
+        writer.write<uint64_t>(null_count);
+        writer.write<uint32_t>(max_repetition_level);
+        writer.write<uint64_t>(first_record);
+        writer.write<uint64_t>(end_record);
+    }
+
+    /// Reads statistics that were written with write().
+    static ZoneMap read(BinaryReader& reader) {
+        ZoneMap zone_map;
+        zone_map.min = ReadValue(reader);
+        zone_map.max = ReadValue(reader);
+        zone_map.null_count = reader.read<uint64_t>();
+        zone_map.max_repetition_level = reader.read<uint32_t>();
+        zone_map.first_record = reader.read<uint64_t>();
+        zone_map.end_record = reader.read<uint64_t>();
+        return zone_map;
+    }
+
+ private:
+    static void WriteValue(BinaryWriter& writer, const std::optional<T>& value) {
+        writer.write<bool>(value.has_value());
+        if (!value.has_value()) {
+            return;
+        }
+        if constexpr (std::is_same_v<T, std::string>) {
+            writer.write_string(*value);
+        } else {
+            writer.write<T>(*value);
+        }
+    }
+
+    static std::optional<T> ReadValue(BinaryReader& reader) {
+        if (!reader.read<bool>()) {
+            return std::nullopt;
+        }
+        if constexpr (std::is_same_v<T, std::string>) {
+            return std::string(reader.read_string());
+        } else {
+            return reader.read<T>();
+        }
+    }
+};
+
+//---------------------------------------------------------------------------
+}  // namespace dremel
+}  // namespace imlab
+//---------------------------------------------------------------------------
+#endif  // INCLUDE_IMLAB_DREMEL_ZONE_MAP_H_
+//---------------------------------------------------------------------------
@@ -0,0 +1,180 @@
+// ---------------------------------------------------------------------------
+// IMLAB
+// ---------------------------------------------------------------------------
+#ifndef INCLUDE_IMLAB_INFRA_BINARY_FILE_H_
+#define INCLUDE_IMLAB_INFRA_BINARY_FILE_H_
+//---------------------------------------------------------------------------
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include "./buffer.h"
+#include "./error.h"
+//---------------------------------------------------------------------------
+namespace imlab {
+//---------------------------------------------------------------------------
+// A file that is mapped read-only into memory.
+// Pages are only read from disk when they are accessed for the first time.
+class MappedFile {
+ public:
+    // Constructor
+    explicit MappedFile(const std::string &path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw FileFormatError("cannot open " + path + ": " + std::strerror(errno));
+        }
+        struct stat status;
+        if (::fstat(fd, &status) < 0) {
+            ::close(fd);
+            throw FileFormatError("cannot stat " + path + ": " + std::strerror(errno));
+        }
+        size_ = status.st_size;
+        if (size_ > 0) {
+            void *data = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data == MAP_FAILED) {
+                ::close(fd);
+                throw FileFormatError("cannot map " + path + ": " + std::strerror(errno));
+            }
+            data_ = static_cast<const char*>(data);
+        }
+        ::close(fd);
+    }
+    // Destructor
+    ~MappedFile() {
+        if (data_ != nullptr) {
+            ::munmap(const_cast<char*>(data_), size_);
+        }
+    }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile &operator=(const MappedFile&) = delete;
+
+    // Pointer to the first byte of the file
+    const char *data() const { return data_; }
+    // Size of the file in bytes
+    uint64_t size() const { return size_; }
+
+ protected:
+    // The mapped bytes
+    const char *data_ = nullptr;
+    // The number of mapped bytes
+    uint64_t size_ = 0;
+};
+//---------------------------------------------------------------------------
+// Writes trivially copyable values, strings and buffers to a stream in native byte order.
+// Buffers are aligned to 8 bytes, so that BinaryReader can hand them out without copying.
+class BinaryWriter {
+ public:
+    // Constructor
+    explicit BinaryWriter(std::ostream &out) : out_(out) {}
+
+    // Write a single value
+    template<typename T>
+    void write(const T &value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        WriteBytes(&value, sizeof(T));
+    }
+    // Write a string
+    void write_string(std::string_view value) {
+        write<uint64_t>(value.size());
+        WriteBytes(value.data(), value.size());
+    }
+    // Write the elements of a buffer
+    template<typename T>
+    void write_buffer(const Buffer<T> &buffer) {
+        write<uint64_t>(buffer.size());
+        Align();
+        WriteBytes(buffer.data(), buffer.size() * sizeof(T));
+    }
+
+    // Number of bytes written so far
+    uint64_t offset() const { return offset_; }
+
+ protected:
+    // The output stream
+    std::ostream &out_;
+    // The number of bytes written so far
+    uint64_t offset_ = 0;
+
+    // Write raw bytes
+    void WriteBytes(const void *data, uint64_t size) {
+        out_.write(static_cast<const char*>(data), size);
+        offset_ += size;
+    }
+    // Pad the output to a multiple of 8 bytes
+    void Align() {
+        static const char padding[8] = {};
+        WriteBytes(padding, (8 - offset_ % 8) % 8);
+    }
+};
+//---------------------------------------------------------------------------
+// Reads what a BinaryWriter wrote from a MappedFile.
+// Strings and buffers refer directly to the mapped bytes, buffers keep the file mapped as long as they live.
+class BinaryReader {
+ public:
+    // Constructor
+    explicit BinaryReader(std::shared_ptr<const MappedFile> file) : file_(std::move(file)) {}
+
+    // Read a single value
+    template<typename T>
+    T read() {
+        static_assert(std::is_trivially_copyable_v<T>);
+        T value;
+        std::memcpy(&value, ReadBytes(sizeof(T)), sizeof(T));
+        return value;
+    }
+    // Read a string; the view is valid as long as the file is mapped
+    std::string_view read_string() {
+        uint64_t size = read<uint64_t>();
+        return { ReadBytes(size), size };
+    }
+    // Read the elements of a buffer without copying them
+    template<typename T>
+    Buffer<T> read_buffer() {
+        uint64_t size = read<uint64_t>();
+        Align();
+        if (size > (file_->size() - offset_) / sizeof(T)) {
+            throw FileFormatError("unexpected end of file");
+        }
+        if (size == 0) {
+            return {};
+        }
+        auto data = reinterpret_cast<const T*>(ReadBytes(size * sizeof(T)));
+        return { data, size, file_ };
+    }
+
+    // Number of bytes read so far
+    uint64_t offset() const { return offset_; }
+
+ protected:
+    // The file
+    std::shared_ptr<const MappedFile> file_;
+    // The number of bytes read so far
+    uint64_t offset_ = 0;
+
+    // Read raw bytes
+    const char *ReadBytes(uint64_t size) {
+        if (size > file_->size() - offset_) {
+            throw FileFormatError("unexpected end of file");
+        }
+        const char *data = file_->data() + offset_;
+        offset_ += size;
+        return data;
+    }
+    // Skip the padding of BinaryWriter::Align()
+    void Align() {
+        ReadBytes((8 - offset_ % 8) % 8);
+    }
+};
+//---------------------------------------------------------------------------
+}  // namespace imlab
+//---------------------------------------------------------------------------
+#endif  // INCLUDE_IMLAB_INFRA_BINARY_FILE_H_
+//---------------------------------------------------------------------------
@@ -0,0 +1,152 @@
+// ---------------------------------------------------------------------------
+// IMLAB
+// ---------------------------------------------------------------------------
+#ifndef INCLUDE_IMLAB_INFRA_BIT_PACKED_VECTOR_H_
+#define INCLUDE_IMLAB_INFRA_BIT_PACKED_VECTOR_H_
+//---------------------------------------------------------------------------
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include "./binary_file.h"
+#include "./bits.h"
+#include "./buffer.h"
+//---------------------------------------------------------------------------
+namespace imlab {
+//---------------------------------------------------------------------------
+// An append-only vector of unsigned integers that are stored with a fixed number of bits each.
+// Values are packed back to back into 64 bit words, so a value might span two words.
+// A bit width of 0 is valid: nothing is stored at all and every element reads as 0.
+class BitPackedVector {
+ public:
+    // Constructor
+    explicit BitPackedVector(unsigned bit_width)
+        : bit_width_(bit_width), mask_(bit_width == 64 ? ~0ull : (1ull << bit_width) - 1) {
+        assert(bit_width <= 64);
+    }
+    // Constructor for a vector that was written with write()
+    explicit BitPackedVector(BinaryReader &reader) : BitPackedVector(ReadBitWidth(reader)) {
+        size_ = reader.read<uint64_t>();
+        words_ = reader.read_buffer<uint64_t>();
+        if (bit_width_ != 0 && size_ > words_.size() * 64 / bit_width_) {
+            throw FileFormatError("invalid bit-packed vector");
+        }
+    }
+
+    // Append a value; it must fit into bit_width bits.
+    void push_back(uint64_t value) {
+        assert((value & ~mask_) == 0);
+        if (bit_width_ != 0) {
+            const uint64_t bit = size_ * bit_width_;
+            const uint64_t word = bit >> 6;
+            const unsigned offset = bit & 63;
+            if (words_.size() < word + 2) {
+                words_.resize(word + 2, 0);
+            }
+            uint64_t *words = words_.mutable_data();
+            words[word] |= value << offset;
+            if (offset + bit_width_ > 64) {
+                words[word + 1] |= value >> (64 - offset);
+            }
+        }
+        size_++;
+    }
+
+    // Shrink the vector to the given number of values
+    void truncate(uint64_t size) {
+        assert(size <= size_);
+        size_ = size;
+        if (bit_width_ == 0) {
+            return;
+        }
+        // Clear the bits of all removed values, so that push_back can simply OR new values in.
+        const uint64_t bit = size * bit_width_;
+        const uint64_t word = bit >> 6;
+        const unsigned offset = bit & 63;
+        if (word < words_.size()) {
+            uint64_t *words = words_.mutable_data();
+            words[word] &= (offset == 0) ? 0 : (1ull << offset) - 1;
+            std::fill(words + word + 1, words + words_.size(), 0);
+        }
+    }
+
+    // Release unused memory
+    void shrink_to_fit() { words_.shrink_to_fit(); }
+
+    // Get the value at a given position
+    uint64_t operator[](uint64_t index) const {
+        assert(index < size_);
+        if (bit_width_ == 0) {
+            return 0;
+        }
+        const uint64_t bit = index * bit_width_;
+        const uint64_t word = bit >> 6;
+        const unsigned offset = bit & 63;
+        uint64_t value = words_[word] >> offset;
+        if (offset + bit_width_ > 64) {
+            value |= words_[word + 1] << (64 - offset);
+        }
+        return value & mask_;
+    }
+
+    // Decode n consecutive values starting at a given position; out may be any integer type the values fit into.
+    // Walks the words sequentially, which is much cheaper than n random accesses.
+    template<typename Out>
+    void decode(uint64_t first, uint64_t n, Out *out) const {
+        assert(first + n <= size_);
+        if (bit_width_ == 0) {
+            std::fill(out, out + n, Out(0));
+            return;
+        }
+        const uint64_t bit = first * bit_width_;
+        const uint64_t *word = words_.data() + (bit >> 6);
+        unsigned offset = bit & 63;
+        for (uint64_t i = 0; i < n; i++) {
+            uint64_t value = *word >> offset;
+            if (offset + bit_width_ > 64) {
+                value |= word[1] << (64 - offset);
+            }
+            out[i] = static_cast<Out>(value & mask_);
+            offset += bit_width_;
+            word += offset >> 6;
+            offset &= 63;
+        }
+    }
+
+    // Number of stored values
+    uint64_t size() const { return size_; }
+    // Number of bits per value
+    unsigned bit_width() const { return bit_width_; }
+    // Number of bytes allocated for the packed values
+    uint64_t memory_usage() const { return words_.capacity() * sizeof(uint64_t); }
+
+    // Write the vector to a file
+    void write(BinaryWriter &writer) const {
+        writer.write<uint32_t>(bit_width_);
+        writer.write<uint64_t>(size_);
+        writer.write_buffer(words_);
+    }
+
+ protected:
+    // The bits per value
+    unsigned bit_width_;
+    // Mask with the lowest bit_width_ bits set
+    uint64_t mask_;
+    // Number of values
+    uint64_t size_ = 0;
+    // The packed values
+    Buffer<uint64_t> words_;
+
+    // Read and check the bit width of a written vector
+    static unsigned ReadBitWidth(BinaryReader &reader) {
+        uint32_t bit_width = reader.read<uint32_t>();
+        if (bit_width > 64) {
+            throw FileFormatError("invalid bit width");
+        }
+        return bit_width;
+    }
+};
+//---------------------------------------------------------------------------
+}  // namespace imlab
+//---------------------------------------------------------------------------
+#endif  // INCLUDE_IMLAB_INFRA_BIT_PACKED_VECTOR_H_
+//---------------------------------------------------------------------------
@@ -4,6 +4,8 @@
 #ifndef INCLUDE_IMLAB_INFRA_BITS_H_
 #define INCLUDE_IMLAB_INFRA_BITS_H_
 // ---------------------------------------------------------------------------
+#include <cstdint>
+// ---------------------------------------------------------------------------
 namespace imlab {
 //---------------------------------------------------------------------------
 // Bit Twiddling Hacks:
@@ -32,6 +34,12 @@ inline uint64_t NextPow2_64(uint64_t v) {
     return v;
 }
 //---------------------------------------------------------------------------
+// Number of bits that are needed to represent every value in [0, max_value].
+// Returns 0 for max_value == 0.
+inline unsigned BitWidth(uint64_t max_value) {
+    return (max_value == 0) ? 0 : 64 - __builtin_clzll(max_value);
+}
+//---------------------------------------------------------------------------
 }  // namespace imlab
 //---------------------------------------------------------------------------
 #endif  // INCLUDE_IMLAB_INFRA_BITS_H_
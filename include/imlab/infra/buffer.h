@@ -0,0 +1,126 @@
+// ---------------------------------------------------------------------------
+// IMLAB
+// ---------------------------------------------------------------------------
+#ifndef INCLUDE_IMLAB_INFRA_BUFFER_H_
+#define INCLUDE_IMLAB_INFRA_BUFFER_H_
+//---------------------------------------------------------------------------
+#include <cassert>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+//---------------------------------------------------------------------------
+namespace imlab {
+//---------------------------------------------------------------------------
+// A vector of trivially copyable elements that either owns its elements or refers to
+// read-only elements somewhere else (usually in a memory-mapped file, see BinaryReader).
+// A referring buffer keeps the memory alive through a shared owner and copies the elements
+// into its own storage on the first modification, so readers never pay for a copy.
+template<typename T>
+class Buffer {
+    static_assert(std::is_trivially_copyable_v<T>, "Buffers can only hold trivially copyable elements");
+
+ public:
+    // Constructor
+    Buffer() = default;
+    // Constructor
+    Buffer(std::initializer_list<T> values) : owned_(values) {}
+    // Constructor for a buffer that refers to size elements at data, which are kept alive by owner
+    Buffer(const T* data, uint64_t size, std::shared_ptr<const void> owner)
+        : mapped_data_(data), mapped_size_(size), owner_(std::move(owner)) {}
+
+    // Whether the elements are stored elsewhere
+    bool mapped() const { return owner_ != nullptr; }
+
+    // Pointer to the first element
+    const T* data() const { return mapped() ? mapped_data_ : owned_.data(); }
+    // Number of elements
+    uint64_t size() const { return mapped() ? mapped_size_ : owned_.size(); }
+    // Whether there are no elements
+    bool empty() const { return size() == 0; }
+    // Number of elements that memory is allocated or mapped for
+    uint64_t capacity() const { return mapped() ? mapped_size_ : owned_.capacity(); }
+
+    // Get the element at a given position
+    const T& operator[](uint64_t index) const {
+        assert(index < size());
+        return data()[index];
+    }
+    // Get the last element
+    const T& back() const { return (*this)[size() - 1]; }
+    // Iterators
+    const T* begin() const { return data(); }
+    const T* end() const { return data() + size(); }
+
+    // Get a pointer to the first element for modification
+    T* mutable_data() {
+        Own();
+        return owned_.data();
+    }
+    // Get the last element for modification
+    T& mutable_back() {
+        Own();
+        return owned_.back();
+    }
+    // Append an element
+    void push_back(const T& value) {
+        Own();
+        owned_.push_back(value);
+    }
+    // Append a range of elements
+    void append(const T* first, const T* last) {
+        Own();
+        owned_.insert(owned_.end(), first, last);
+    }
+    // Remove the last element
+    void pop_back() {
+        Own();
+        owned_.pop_back();
+    }
+    // Change the number of elements; new elements are set to value
+    void resize(uint64_t size, const T& value = T()) {
+        Own();
+        owned_.resize(size, value);
+    }
+    // Reserve memory for a number of elements
+    void reserve(uint64_t size) {
+        Own();
+        owned_.reserve(size);
+    }
+    // Release unused memory
+    void shrink_to_fit() {
+        if (!mapped()) {
+            owned_.shrink_to_fit();
+        }
+    }
+    // Remove all elements and release the memory
+    void clear() {
+        *this = Buffer();
+    }
+
+ protected:
+    // The elements if the buffer owns them
+    std::vector<T> owned_;
+    // The elements if the buffer refers to them
+    const T* mapped_data_ = nullptr;
+    uint64_t mapped_size_ = 0;
+    // Keeps referred elements alive
+    std::shared_ptr<const void> owner_;
+
+    // Copy referred elements into the buffer
+    void Own() {
+        if (mapped()) {
+            owned_.assign(mapped_data_, mapped_data_ + mapped_size_);
+            mapped_data_ = nullptr;
+            mapped_size_ = 0;
+            owner_.reset();
+        }
+    }
+};
+//---------------------------------------------------------------------------
+}  // namespace imlab
+//---------------------------------------------------------------------------
+#endif  // INCLUDE_IMLAB_INFRA_BUFFER_H_
+//---------------------------------------------------------------------------
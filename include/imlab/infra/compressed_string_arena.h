@@ -0,0 +1,149 @@
+// ---------------------------------------------------------------------------
+// IMLAB
+// ---------------------------------------------------------------------------
+#ifndef INCLUDE_IMLAB_INFRA_COMPRESSED_STRING_ARENA_H_
+#define INCLUDE_IMLAB_INFRA_COMPRESSED_STRING_ARENA_H_
+//---------------------------------------------------------------------------
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "./binary_file.h"
+#include "./buffer.h"
+#include "./error.h"
+#include "./integer_encoding.h"
+#include "./lz_block.h"
+#include "./string_arena.h"
+//---------------------------------------------------------------------------
+namespace imlab {
+//---------------------------------------------------------------------------
+// An immutable sequence of strings whose bytes are compressed in blocks of kStringsPerBlock strings (see lz::Compress).
+// The start of every string within its block is stored as EncodedIntegers.
+//
+// Reading a string decompresses its whole block into a small cache of the calling thread,
+// so reading the strings one after the other decompresses every block only once.
+// The returned views are valid until the same thread has decompressed kCachedBlocks other blocks.
+class CompressedStringArena {
+ public:
+    // Number of strings that are compressed together
+    static constexpr uint64_t kStringsPerBlock = 128;
+    // Number of decompressed blocks that every thread keeps
+    static constexpr unsigned kCachedBlocks = 4;
+
+    // Constructor
+    CompressedStringArena() : block_offsets_({ 0 }), id_(NextId()) {}
+    // Constructor that compresses the strings of an arena
+    explicit CompressedStringArena(const StringArena &strings) : CompressedStringArena() {
+        std::vector<uint32_t> starts;
+        starts.reserve(strings.size());
+        std::string block, compressed;
+        for (uint64_t first = 0; first < strings.size(); first += kStringsPerBlock) {
+            block.clear();
+            for (uint64_t i = first; i < std::min(first + kStringsPerBlock, strings.size()); i++) {
+                starts.push_back(block.size());
+                block += strings[i];
+            }
+            compressed.clear();
+            lz::Compress(block.data(), block.size(), &compressed);
+            blocks_.append(compressed.data(), compressed.data() + compressed.size());
+            block_offsets_.push_back(blocks_.size());
+            block_sizes_.push_back(block.size());
+        }
+        starts_ = EncodedIntegers<uint32_t>::Encode(starts.data(), starts.size());
+        blocks_.shrink_to_fit();
+    }
+    // Constructor for an arena that was written with write()
+    explicit CompressedStringArena(BinaryReader &reader)
+        : starts_(reader), block_offsets_(reader.read_buffer<uint64_t>()), block_sizes_(reader.read_buffer<uint32_t>()),
+          blocks_(reader.read_buffer<char>()), id_(NextId()) {
+        uint64_t blocks = (starts_.size() + kStringsPerBlock - 1) / kStringsPerBlock;
+        if (block_offsets_.size() != blocks + 1 || block_sizes_.size() != blocks
+                || block_offsets_[0] != 0 || block_offsets_.back() != blocks_.size()) {
+            throw FileFormatError("invalid compressed string arena");
+        }
+        for (uint64_t block = 0; block < blocks; block++) {
+            if (block_offsets_[block] > block_offsets_[block + 1]) {
+                throw FileFormatError("invalid compressed string arena");
+            }
+        }
+    }
+
+    // Get the string at a given position
+    std::string_view operator[](uint64_t index) const {
+        assert(index < size());
+        uint64_t block = index / kStringsPerBlock;
+        const std::string &bytes = Decompress(block);
+        uint64_t begin = starts_[index];
+        uint64_t end = (index + 1) % kStringsPerBlock == 0 || index + 1 == size() ? bytes.size() : starts_[index + 1];
+        if (begin > end || end > bytes.size()) {
+            throw FileFormatError("invalid compressed string arena");
+        }
+        return { bytes.data() + begin, end - begin };
+    }
+
+    // Number of stored strings
+    uint64_t size() const { return starts_.size(); }
+    // Number of bytes allocated for the compressed strings
+    uint64_t memory_usage() const {
+        return starts_.memory_usage() + block_offsets_.capacity() * sizeof(uint64_t)
+             + block_sizes_.capacity() * sizeof(uint32_t) + blocks_.capacity();
+    }
+
+    // Write the arena to a file
+    void write(BinaryWriter &writer) const {
+        starts_.write(writer);
+        writer.write_buffer(block_offsets_);
+        writer.write_buffer(block_sizes_);
+        writer.write_buffer(blocks_);
+    }
+
+ protected:
+    // The start of every string within its decompressed block
+    EncodedIntegers<uint32_t> starts_;
+    // The offset of every compressed block in blocks_ (plus the end of the last block)
+    Buffer<uint64_t> block_offsets_;
+    // The decompressed size of every block
+    Buffer<uint32_t> block_sizes_;
+    // The compressed blocks
+    Buffer<char> blocks_;
+    // Identifies the arena in the caches of decompressed blocks; ids are never reused
+    uint64_t id_;
+
+    // Get a new id
+    static uint64_t NextId() {
+        static std::atomic<uint64_t> next_id { 1 };
+        return next_id++;
+    }
+    // Get the decompressed bytes of a block from the cache of the calling thread
+    const std::string &Decompress(uint64_t block) const {
+        struct CachedBlock {
+            uint64_t arena = 0;
+            uint64_t block = 0;
+            std::string bytes;
+        };
+        thread_local CachedBlock cache[kCachedBlocks];
+        thread_local unsigned next_victim = 0;
+        for (auto &cached : cache) {
+            if (cached.arena == id_ && cached.block == block) {
+                return cached.bytes;
+            }
+        }
+        CachedBlock &cached = cache[next_victim];
+        next_victim = (next_victim + 1) % kCachedBlocks;
+        cached.arena = 0;  // Invalid until the block was decompressed successfully.
+        cached.bytes.resize(block_sizes_[block]);
+        lz::Decompress(blocks_.data() + block_offsets_[block], block_offsets_[block + 1] - block_offsets_[block],
+                       cached.bytes.data(), cached.bytes.size());
+        cached.arena = id_;
+        cached.block = block;
+        return cached.bytes;
+    }
+};
+//---------------------------------------------------------------------------
+}  // namespace imlab
+//---------------------------------------------------------------------------
+#endif  // INCLUDE_IMLAB_INFRA_COMPRESSED_STRING_ARENA_H_
+//---------------------------------------------------------------------------
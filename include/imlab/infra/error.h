@@ -15,6 +15,12 @@ struct TransactionRollback: std::runtime_error {
         : std::runtime_error(what) {}
 };
 //---------------------------------------------------------------------------
+struct FileFormatError: std::runtime_error {
+    // Constructor
+    explicit FileFormatError(const std::string &what)
+        : std::runtime_error(what) {}
+};
+//---------------------------------------------------------------------------
 struct SchemaCompilationError: std::exception {
     // Constructor
     explicit SchemaCompilationError(const char *what): message_(what) {}
@@ -4,17 +4,31 @@
 #ifndef INCLUDE_IMLAB_INFRA_HASH_H_
 #define INCLUDE_IMLAB_INFRA_HASH_H_
 //---------------------------------------------------------------------------
+#include <array>
+#include <functional>
 #include <tuple>
 #include "./template.h"
 //---------------------------------------------------------------------------
+// Hash a key component: the types in types.h hash themselves, all others (e.g. the
+// column values of generated queries) use std::hash
+template<typename T>
+inline auto HashValue(const T& value, int) -> decltype(static_cast<uint64_t>(value.hash())) {
+    return value.hash();
+}
+template<typename T>
+inline uint64_t HashValue(const T& value, ...) {
+    return std::hash<T>()(value);
+}
+//---------------------------------------------------------------------------
 // Hash a tuple with an index sequence
 template<typename... Types, std::size_t... Indexes>
 inline uint64_t HashTuple(const std::tuple<Types...>& tuple, std::index_sequence<Indexes... >) {
     std::array<uint64_t, std::index_sequence<Indexes... >::size()> results {
-        std::get<Indexes>(tuple).hash()...
+        HashValue(std::get<Indexes>(tuple), 0)...
     };
     auto combine_hashes = [](uint64_t l, uint64_t r) { return r + 0x9e3779b9 + (l << 6) + (l >> 2); };
-    return std::accumulate(results.begin(), results.end(), 0, combine_hashes);
+    // Accumulate in 64 bits; with an int as initial value, the hashes would be truncated to 32 bits
+    return std::accumulate(results.begin(), results.end(), uint64_t{0}, combine_hashes);
 }
 //---------------------------------------------------------------------------
 // Hash a tuple
@@ -60,7 +74,9 @@ struct hash<Key<Types...>> {
 template <class T1, class T2>
 struct hash<std::pair<T1, T2>> {
     std::size_t operator() (const std::pair<T1, T2> &pair) const {
-        return std::hash<T1>()(pair.first) ^ std::hash<T2>()(pair.second);
+        // Combine the hashes like HashTuple; a plain XOR maps (a, b) and (b, a) to the same value
+        std::size_t l = std::hash<T1>()(pair.first);
+        return std::hash<T2>()(pair.second) + 0x9e3779b9 + (l << 6) + (l >> 2);
     }
 };
 //---------------------------------------------------------------------------
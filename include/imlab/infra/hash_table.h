@@ -5,6 +5,8 @@
 #define INCLUDE_IMLAB_INFRA_HASH_TABLE_H_
 //---------------------------------------------------------------------------
 #include <algorithm>
+#include <array>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 #include <iterator>
@@ -161,5 +163,85 @@ class LazyMultiMap {
     uint32_t hash_table_mask_;
 };
 //---------------------------------------------------------------------------
+template <typename KeyT, typename ValueT>
+class PartitionedAggregationMap {
+    // Check key type
+    static_assert(IsKey<KeyT>::value, "The key of PartitionedAggregationMap must be a Key<T>");
+
+ public:
+    // Number of partitions
+    static constexpr unsigned kPartitionBits = 6;
+    static constexpr size_t kPartitions = size_t{1} << kPartitionBits;
+    // A partition of the groups
+    using Partition = std::unordered_map<KeyT, ValueT>;
+
+    // Partial aggregates of a thread, split into partitions by the hash of their keys
+    class LocalMap {
+        friend PartitionedAggregationMap;
+
+     public:
+        // Find the aggregates of a group or insert default ones; returns whether the group was inserted
+        std::pair<ValueT&, bool> try_emplace(const KeyT& key) {
+            auto [it, inserted] = partitions_[PartitionOf(key)].try_emplace(key);
+            return { it->second, inserted };
+        }
+
+     protected:
+        // Partitions
+        std::array<Partition, kPartitions> partitions_;
+    };
+
+    // Get the partial aggregates of the current thread
+    //  * Every thread aggregates into its own hash tables, so the threads don't have to lock.
+    LocalMap& local() { return locals_.local(); }
+
+    // Merge the partial aggregates of all threads
+    //  * Every partition is merged by a single task, so high-cardinality groups need no global lock either.
+    //  * The nodes of groups that only one thread has seen are moved, not copied (std::unordered_map::merge).
+    //  * The aggregates of groups that several threads have seen are combined with ValueT::Merge.
+    //  * The partitions of the threads are released, including their bucket arrays.
+    void finalize() {
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, kPartitions, 1), [&](const tbb::blocked_range<size_t>& range) {
+            for (size_t p = range.begin(); p != range.end(); ++p) {
+                auto& partition = partitions_[p];
+                for (auto& local : locals_) {
+                    auto& local_partition = local.partitions_[p];
+                    partition.merge(local_partition);
+                    for (auto& [key, value] : local_partition) {
+                        partition.find(key)->second.Merge(value);
+                    }
+                    // clear() would keep the buckets of every partition of every thread until the map is gone.
+                    Partition {}.swap(local_partition);
+                }
+            }
+        });
+    }
+
+    // The partitions of the merged groups (after finalize)
+    const std::array<Partition, kPartitions>& partitions() const { return partitions_; }
+
+    // Number of groups (after finalize)
+    size_t size() const {
+        size_t groups = 0;
+        for (auto& partition : partitions_) {
+            groups += partition.size();
+        }
+        return groups;
+    }
+
+ protected:
+    // The partition of a key
+    //  * Fibonacci hashing spreads the high bits of keys with weak hashes (e.g. small integers), so that the
+    //    groups are distributed evenly over the partitions.
+    static size_t PartitionOf(const KeyT& key) {
+        return (key.Hash() * 0x9e3779b97f4a7c15ull) >> (64 - kPartitionBits);
+    }
+
+    // Partial aggregates of the threads
+    tbb::enumerable_thread_specific<LocalMap> locals_;
+    // Merged groups
+    std::array<Partition, kPartitions> partitions_;
+};
+//---------------------------------------------------------------------------
 #endif  // INCLUDE_IMLAB_INFRA_HASH_TABLE_H_
 //---------------------------------------------------------------------------
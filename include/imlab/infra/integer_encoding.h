@@ -0,0 +1,224 @@
+// ---------------------------------------------------------------------------
+// IMLAB
+// ---------------------------------------------------------------------------
+#ifndef INCLUDE_IMLAB_INFRA_INTEGER_ENCODING_H_
+#define INCLUDE_IMLAB_INFRA_INTEGER_ENCODING_H_
+//---------------------------------------------------------------------------
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <type_traits>
+#include "./binary_file.h"
+#include "./bit_packed_vector.h"
+#include "./bits.h"
+#include "./buffer.h"
+#include "./error.h"
+//---------------------------------------------------------------------------
+namespace imlab {
+//---------------------------------------------------------------------------
+// The lightweight encodings of EncodedIntegers
+enum class IntegerEncoding : uint8_t {
+    // The values as they are
+    kPlain = 0,
+    // The difference of every value to the minimum, bit-packed
+    kFrameOfReference = 1,
+    // The difference of every value to its predecessor, bit-packed relative to the smallest difference
+    kDelta = 2,
+};
+//---------------------------------------------------------------------------
+// An immutable sequence of integers that is compressed with the cheapest of a few lightweight encodings.
+// All encodings support random access and decoding batches of consecutive values.
+//
+// Differences are computed modulo 2^64, so they never overflow and every value range can be encoded.
+// Delta encoding keeps the absolute value of every kDeltaBlockSize-th value as a checkpoint,
+// so a random access sums at most kDeltaBlockSize - 1 differences.
+template<typename T>
+class EncodedIntegers {
+    static_assert(std::is_integral_v<T> && !std::is_same_v<T, bool>, "only integers can be encoded");
+
+ public:
+    // Number of values per checkpoint of the delta encoding
+    static constexpr uint64_t kDeltaBlockSize = 64;
+
+    // Constructor
+    EncodedIntegers() : packed_(0) {}
+    // Constructor for a sequence that was written with write()
+    explicit EncodedIntegers(BinaryReader &reader)
+        : encoding_(ReadEncoding(reader)), size_(reader.read<uint64_t>()), base_(reader.read<uint64_t>()),
+          plain_(reader.read_buffer<T>()), checkpoints_(reader.read_buffer<uint64_t>()), packed_(reader) {
+        bool valid = false;
+        switch (encoding_) {
+            case IntegerEncoding::kPlain: valid = plain_.size() == size_; break;
+            case IntegerEncoding::kFrameOfReference: valid = packed_.size() == size_; break;
+            case IntegerEncoding::kDelta:
+                valid = packed_.size() == size_ && checkpoints_.size() == (size_ + kDeltaBlockSize - 1) / kDeltaBlockSize;
+                break;
+        }
+        if (!valid) {
+            throw FileFormatError("invalid encoded integers");
+        }
+    }
+
+    // Encode values with the encoding that needs the least memory
+    static EncodedIntegers Encode(const T *values, uint64_t size) {
+        EncodedIntegers encoded;
+        encoded.size_ = size;
+        if (size == 0) {
+            return encoded;
+        }
+        // Frame of reference needs as many bits as the largest difference to the minimum.
+        auto [min, max] = std::minmax_element(values, values + size);
+        unsigned for_width = BitWidth(ToUnsigned(*max) - ToUnsigned(*min));
+        // Delta needs as many bits as the largest difference between two deltas, plus the checkpoints.
+        int64_t min_delta = 0, max_delta = 0;
+        for (uint64_t i = 1; i < size; i++) {
+            auto delta = static_cast<int64_t>(ToUnsigned(values[i]) - ToUnsigned(values[i - 1]));
+            min_delta = (i == 1) ? delta : std::min(min_delta, delta);
+            max_delta = (i == 1) ? delta : std::max(max_delta, delta);
+        }
+        unsigned delta_width = BitWidth(static_cast<uint64_t>(max_delta) - static_cast<uint64_t>(min_delta));
+
+        uint64_t plain_bits = size * sizeof(T) * 8;
+        uint64_t for_bits = size * for_width + 64;
+        uint64_t delta_bits = size * delta_width + (size + kDeltaBlockSize - 1) / kDeltaBlockSize * 64 + 64;
+        // Random accesses are more expensive with delta encoding, so it has to save a lot.
+        if (delta_bits * 2 < for_bits && delta_bits < plain_bits) {
+            encoded.encoding_ = IntegerEncoding::kDelta;
+            encoded.base_ = static_cast<uint64_t>(min_delta);
+            encoded.packed_ = BitPackedVector(delta_width);
+            for (uint64_t i = 0; i < size; i++) {
+                if (i % kDeltaBlockSize == 0) {
+                    encoded.checkpoints_.push_back(ToUnsigned(values[i]));
+                    encoded.packed_.push_back(0);
+                } else {
+                    encoded.packed_.push_back(ToUnsigned(values[i]) - ToUnsigned(values[i - 1]) - encoded.base_);
+                }
+            }
+        } else if (for_bits < plain_bits) {
+            encoded.encoding_ = IntegerEncoding::kFrameOfReference;
+            encoded.base_ = ToUnsigned(*min);
+            encoded.packed_ = BitPackedVector(for_width);
+            for (uint64_t i = 0; i < size; i++) {
+                encoded.packed_.push_back(ToUnsigned(values[i]) - encoded.base_);
+            }
+        } else {
+            encoded.plain_.append(values, values + size);
+        }
+        encoded.checkpoints_.shrink_to_fit();
+        encoded.packed_.shrink_to_fit();
+        return encoded;
+    }
+
+    // Get the value at a given position
+    T operator[](uint64_t index) const {
+        assert(index < size_);
+        switch (encoding_) {
+            case IntegerEncoding::kPlain:
+                return plain_[index];
+            case IntegerEncoding::kFrameOfReference:
+                return static_cast<T>(base_ + packed_[index]);
+            case IntegerEncoding::kDelta: {
+                uint64_t block = index / kDeltaBlockSize;
+                uint64_t steps = index % kDeltaBlockSize;
+                uint64_t value = checkpoints_[block] + steps * base_;
+                if (packed_.bit_width() > 0) {
+                    for (uint64_t i = index - steps + 1; i <= index; i++) {
+                        value += packed_[i];
+                    }
+                }
+                return static_cast<T>(value);
+            }
+        }
+        return T();
+    }
+
+    // Decode n consecutive values starting at a given position
+    void decode(uint64_t first, uint64_t n, T *out) const {
+        assert(first + n <= size_);
+        if (n == 0) {
+            return;
+        }
+        if (encoding_ == IntegerEncoding::kPlain) {
+            std::copy(plain_.data() + first, plain_.data() + first + n, out);
+            return;
+        }
+        // Unpack in chunks that fit into the L1 cache.
+        uint64_t chunk[kDecodeChunkSize];
+        uint64_t value = encoding_ == IntegerEncoding::kDelta ? ToUnsigned((*this)[first]) : 0;
+        for (uint64_t begin = 0; begin < n; begin += kDecodeChunkSize) {
+            uint64_t count = std::min(kDecodeChunkSize, n - begin);
+            packed_.decode(first + begin, count, chunk);
+            if (encoding_ == IntegerEncoding::kFrameOfReference) {
+                for (uint64_t i = 0; i < count; i++) {
+                    out[begin + i] = static_cast<T>(base_ + chunk[i]);
+                }
+                continue;
+            }
+            for (uint64_t i = 0; i < count; i++) {
+                uint64_t index = first + begin + i;
+                if (index % kDeltaBlockSize == 0) {
+                    value = checkpoints_[index / kDeltaBlockSize];
+                } else if (index != first) {
+                    value += chunk[i] + base_;
+                }
+                out[begin + i] = static_cast<T>(value);
+            }
+        }
+    }
+
+    // Number of values
+    uint64_t size() const { return size_; }
+    // The chosen encoding
+    IntegerEncoding encoding() const { return encoding_; }
+    // Number of bits per packed value (0 for plain values)
+    unsigned bit_width() const { return encoding_ == IntegerEncoding::kPlain ? 0 : packed_.bit_width(); }
+    // Number of bytes allocated for the encoded values
+    uint64_t memory_usage() const {
+        return plain_.capacity() * sizeof(T) + checkpoints_.capacity() * sizeof(uint64_t) + packed_.memory_usage();
+    }
+
+    // Write the values to a file
+    void write(BinaryWriter &writer) const {
+        writer.write<uint8_t>(static_cast<uint8_t>(encoding_));
+        writer.write<uint64_t>(size_);
+        writer.write<uint64_t>(base_);
+        writer.write_buffer(plain_);
+        writer.write_buffer(checkpoints_);
+        packed_.write(writer);
+    }
+
+ protected:
+    // Number of values that decode() unpacks at once
+    static constexpr uint64_t kDecodeChunkSize = 256;
+
+    // The encoding
+    IntegerEncoding encoding_ = IntegerEncoding::kPlain;
+    // Number of values
+    uint64_t size_ = 0;
+    // The minimum (frame of reference) or the smallest difference (delta)
+    uint64_t base_ = 0;
+    // The values if they are not encoded
+    Buffer<T> plain_;
+    // Every kDeltaBlockSize-th value (delta)
+    Buffer<uint64_t> checkpoints_;
+    // The packed differences (frame of reference and delta)
+    BitPackedVector packed_;
+
+    // Map a value to 64 bits; signed values are sign-extended, so that differences are the same as for T
+    static uint64_t ToUnsigned(T value) {
+        return static_cast<uint64_t>(static_cast<std::conditional_t<std::is_signed_v<T>, int64_t, uint64_t>>(value));
+    }
+    // Read and check the encoding of written values
+    static IntegerEncoding ReadEncoding(BinaryReader &reader) {
+        uint8_t encoding = reader.read<uint8_t>();
+        if (encoding > static_cast<uint8_t>(IntegerEncoding::kDelta)) {
+            throw FileFormatError("invalid integer encoding");
+        }
+        return static_cast<IntegerEncoding>(encoding);
+    }
+};
+//---------------------------------------------------------------------------
+}  // namespace imlab
+//---------------------------------------------------------------------------
+#endif  // INCLUDE_IMLAB_INFRA_INTEGER_ENCODING_H_
+//---------------------------------------------------------------------------
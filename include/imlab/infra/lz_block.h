@@ -0,0 +1,168 @@
+// ---------------------------------------------------------------------------
+// IMLAB
+// ---------------------------------------------------------------------------
+#ifndef INCLUDE_IMLAB_INFRA_LZ_BLOCK_H_
+#define INCLUDE_IMLAB_INFRA_LZ_BLOCK_H_
+//---------------------------------------------------------------------------
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include "./error.h"
+//---------------------------------------------------------------------------
+namespace imlab {
+namespace lz {
+//---------------------------------------------------------------------------
+// A byte-oriented LZ77 block codec in the LZ4 block format.
+// A block is a sequence of (literals, match) pairs: Every token holds the number of literals and the
+// length of the following match (minus 4) in one nibble each, longer lengths continue in extra bytes.
+// A match copies bytes from up to 64 KiB back in the output. The last sequence only has literals.
+// Compression finds matches through a small hash table of 4-byte prefixes and is greedy, which is
+// fast and good enough for the repetitive strings (URLs, names, codes) of a column segment.
+//---------------------------------------------------------------------------
+// The minimum length of a match
+constexpr uint64_t kMinMatch = 4;
+// The largest distance of a match
+constexpr uint64_t kMaxOffset = 65535;
+// The last match has to start this many bytes before the end of the block ...
+constexpr uint64_t kMatchStartLimit = 12;
+// ... and the last bytes are always literals
+constexpr uint64_t kLastLiterals = 5;
+//---------------------------------------------------------------------------
+namespace detail {
+// Append a length that didn't fit into its nibble
+inline void WriteLength(uint64_t length, std::string *out) {
+    for (; length >= 255; length -= 255) {
+        out->push_back(static_cast<char>(255));
+    }
+    out->push_back(static_cast<char>(length));
+}
+// Read the extra bytes of a length
+inline uint64_t ReadLength(const uint8_t **in, const uint8_t *end) {
+    uint64_t length = 0;
+    uint8_t byte;
+    do {
+        if (*in == end) {
+            throw FileFormatError("truncated compressed block");
+        }
+        byte = *(*in)++;
+        length += byte;
+    } while (byte == 255);
+    return length;
+}
+// Append a sequence; a match length of 0 marks the last sequence
+inline void WriteSequence(const char *literals, uint64_t literal_length, uint64_t offset, uint64_t match_length,
+                          std::string *out) {
+    uint64_t match_nibble = match_length == 0 ? 0 : match_length - kMinMatch;
+    out->push_back(static_cast<char>((std::min<uint64_t>(literal_length, 15) << 4) | std::min<uint64_t>(match_nibble, 15)));
+    if (literal_length >= 15) {
+        WriteLength(literal_length - 15, out);
+    }
+    out->append(literals, literal_length);
+    if (match_length == 0) {
+        return;
+    }
+    out->push_back(static_cast<char>(offset & 0xFF));
+    out->push_back(static_cast<char>(offset >> 8));
+    if (match_nibble >= 15) {
+        WriteLength(match_nibble - 15, out);
+    }
+}
+// Load 4 bytes
+inline uint32_t Load32(const char *data) {
+    uint32_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+}  // namespace detail
+//---------------------------------------------------------------------------
+// Compress size bytes and append the block to out
+inline void Compress(const char *data, uint64_t size, std::string *out) {
+    constexpr unsigned kHashBits = 12;
+    assert(size < (1ull << 32));
+    // Position + 1 of the last occurrence of every hashed 4-byte prefix (0 if there is none)
+    uint32_t last[1 << kHashBits] = {};
+    uint64_t anchor = 0;
+    if (size > kMatchStartLimit) {
+        for (uint64_t pos = 0; pos < size - kMatchStartLimit;) {
+            uint32_t prefix = detail::Load32(data + pos);
+            uint32_t hash = (prefix * 2654435761u) >> (32 - kHashBits);
+            uint64_t candidate = last[hash];
+            last[hash] = pos + 1;
+            if (candidate == 0 || pos - (candidate - 1) > kMaxOffset || detail::Load32(data + candidate - 1) != prefix) {
+                pos++;
+                continue;
+            }
+            candidate--;
+            // Extend the match in both directions.
+            while (pos > anchor && candidate > 0 && data[pos - 1] == data[candidate - 1]) {
+                pos--;
+                candidate--;
+            }
+            uint64_t length = kMinMatch;
+            while (pos + length < size - kLastLiterals && data[pos + length] == data[candidate + length]) {
+                length++;
+            }
+            detail::WriteSequence(data + anchor, pos - anchor, pos - candidate, length, out);
+            pos += length;
+            anchor = pos;
+        }
+    }
+    detail::WriteSequence(data + anchor, size - anchor, 0, 0, out);
+}
+//---------------------------------------------------------------------------
+// Decompress a block into exactly size bytes at out.
+// Blocks may come from files, so malformed blocks throw a FileFormatError instead of writing out of bounds.
+inline void Decompress(const char *block, uint64_t block_size, char *out, uint64_t size) {
+    auto in = reinterpret_cast<const uint8_t*>(block);
+    const uint8_t *in_end = in + block_size;
+    uint64_t written = 0;
+    while (true) {
+        if (in == in_end) {
+            throw FileFormatError("truncated compressed block");
+        }
+        uint8_t token = *in++;
+        uint64_t literal_length = token >> 4;
+        if (literal_length == 15) {
+            literal_length += detail::ReadLength(&in, in_end);
+        }
+        if (literal_length > static_cast<uint64_t>(in_end - in) || literal_length > size - written) {
+            throw FileFormatError("invalid compressed block");
+        }
+        std::memcpy(out + written, in, literal_length);
+        in += literal_length;
+        written += literal_length;
+        if (in == in_end) {
+            break;
+        }
+        if (in_end - in < 2) {
+            throw FileFormatError("truncated compressed block");
+        }
+        uint64_t offset = in[0] | (static_cast<uint64_t>(in[1]) << 8);
+        in += 2;
+        uint64_t match_length = token & 0x0F;
+        if (match_length == 15) {
+            match_length += detail::ReadLength(&in, in_end);
+        }
+        match_length += kMinMatch;
+        if (offset == 0 || offset > written || match_length > size - written) {
+            throw FileFormatError("invalid compressed block");
+        }
+        // Matches may overlap their own output (e.g. runs), so bytes are copied one by one.
+        const char *match = out + written - offset;
+        for (uint64_t i = 0; i < match_length; i++) {
+            out[written + i] = match[i];
+        }
+        written += match_length;
+    }
+    if (written != size) {
+        throw FileFormatError("invalid compressed block");
+    }
+}
+//---------------------------------------------------------------------------
+}  // namespace lz
+}  // namespace imlab
+//---------------------------------------------------------------------------
+#endif  // INCLUDE_IMLAB_INFRA_LZ_BLOCK_H_
+//---------------------------------------------------------------------------
@@ -0,0 +1,104 @@
+// ---------------------------------------------------------------------------
+// IMLAB
+// ---------------------------------------------------------------------------
+#ifndef INCLUDE_IMLAB_INFRA_SIMD_H_
+#define INCLUDE_IMLAB_INFRA_SIMD_H_
+//---------------------------------------------------------------------------
+#include <cassert>
+#include <cstdint>
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+//---------------------------------------------------------------------------
+namespace imlab {
+//---------------------------------------------------------------------------
+// Kernels that turn 64 bytes at a time into a 64 bit mask.
+// The instruction set is chosen at compile time: AVX2 if the compiler targets it (e.g. with -march=native,
+// see the IMLAB_NATIVE option), SSE2 on every other x86-64 machine and a scalar loop everywhere else.
+//---------------------------------------------------------------------------
+// The name of the instruction set that the kernels use
+inline const char *SimdInstructionSet() {
+#if defined(__AVX2__)
+    return "AVX2";
+#elif defined(__SSE2__)
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
+//---------------------------------------------------------------------------
+// Bit i of the result is set if bytes[i] == value; all 64 bytes must be readable
+inline uint64_t EqualMask64(const uint8_t *bytes, uint8_t value) {
+#if defined(__AVX2__)
+    const __m256i needle = _mm256_set1_epi8(static_cast<char>(value));
+    auto low = static_cast<uint32_t>(_mm256_movemask_epi8(
+        _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes)), needle)));
+    auto high = static_cast<uint32_t>(_mm256_movemask_epi8(
+        _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes + 32)), needle)));
+    return low | (static_cast<uint64_t>(high) << 32);
+#elif defined(__SSE2__)
+    const __m128i needle = _mm_set1_epi8(static_cast<char>(value));
+    uint64_t mask = 0;
+    for (unsigned i = 0; i < 4; i++) {
+        auto part = static_cast<uint16_t>(_mm_movemask_epi8(
+            _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + 16 * i)), needle)));
+        mask |= static_cast<uint64_t>(part) << (16 * i);
+    }
+    return mask;
+#else
+    uint64_t mask = 0;
+    for (unsigned i = 0; i < 64; i++) {
+        mask |= static_cast<uint64_t>(bytes[i] == value) << i;
+    }
+    return mask;
+#endif
+}
+//---------------------------------------------------------------------------
+// Bit i of the result is set if bytes[i] == value, for the first n <= 64 bytes; all other bits are 0
+inline uint64_t EqualMask(const uint8_t *bytes, uint64_t n, uint8_t value) {
+    assert(n <= 64);
+    if (n == 64) {
+        return EqualMask64(bytes, value);
+    }
+    uint64_t mask = 0;
+    for (uint64_t i = 0; i < n; i++) {
+        mask |= static_cast<uint64_t>(bytes[i] == value) << i;
+    }
+    return mask;
+}
+//---------------------------------------------------------------------------
+// A mask with the lowest n bits set
+inline uint64_t LowBits(uint64_t n) {
+    return n >= 64 ? ~0ull : (1ull << n) - 1;
+}
+//---------------------------------------------------------------------------
+// The number of set bits among the bits [begin, begin + n) of masks (64 bits per word)
+inline uint64_t CountSetBits(const uint64_t *masks, uint64_t begin, uint64_t n) {
+    uint64_t count = 0;
+    while (n > 0) {
+        uint64_t bit = begin & 63;
+        uint64_t step = n < 64 - bit ? n : 64 - bit;
+        count += __builtin_popcountll((masks[begin >> 6] >> bit) & LowBits(step));
+        begin += step;
+        n -= step;
+    }
+    return count;
+}
+//---------------------------------------------------------------------------
+// The position of the n-th (counting from 0) set bit of a mask; the mask must have more than n bits set
+inline unsigned NthSetBit(uint64_t mask, uint64_t n) {
+    assert(static_cast<uint64_t>(__builtin_popcountll(mask)) > n);
+#if defined(__BMI2__)
+    return __builtin_ctzll(_pdep_u64(1ull << n, mask));
+#else
+    for (; n > 0; n--) {
+        mask &= mask - 1;
+    }
+    return __builtin_ctzll(mask);
+#endif
+}
+//---------------------------------------------------------------------------
+}  // namespace imlab
+//---------------------------------------------------------------------------
+#endif  // INCLUDE_IMLAB_INFRA_SIMD_H_
+//---------------------------------------------------------------------------
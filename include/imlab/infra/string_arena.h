@@ -0,0 +1,80 @@
+// ---------------------------------------------------------------------------
+// IMLAB
+// ---------------------------------------------------------------------------
+#ifndef INCLUDE_IMLAB_INFRA_STRING_ARENA_H_
+#define INCLUDE_IMLAB_INFRA_STRING_ARENA_H_
+//---------------------------------------------------------------------------
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <string_view>
+#include "./binary_file.h"
+#include "./buffer.h"
+#include "./error.h"
+//---------------------------------------------------------------------------
+namespace imlab {
+//---------------------------------------------------------------------------
+// An append-only sequence of strings that are stored back to back in one contiguous byte heap.
+// The i-th string spans the bytes [offsets_[i], offsets_[i + 1]), so there is no allocation per string.
+// Views returned by operator[] are invalidated by push_back.
+class StringArena {
+ public:
+    // Constructor
+    StringArena() : offsets_({ 0 }) {}
+    // Constructor for an arena that was written with write()
+    explicit StringArena(BinaryReader &reader)
+        : offsets_(reader.read_buffer<uint64_t>()), bytes_(reader.read_buffer<char>()) {
+        if (offsets_.empty() || offsets_[0] != 0 || offsets_.back() != bytes_.size()
+                || !std::is_sorted(offsets_.begin(), offsets_.end())) {
+            throw FileFormatError("invalid string arena");
+        }
+    }
+
+    // Append a string; its bytes are copied into the heap
+    void push_back(std::string_view value) {
+        bytes_.append(value.data(), value.data() + value.size());
+        offsets_.push_back(bytes_.size());
+    }
+
+    // Get the string at a given position
+    std::string_view operator[](uint64_t index) const {
+        assert(index + 1 < offsets_.size());
+        return { bytes_.data() + offsets_[index], offsets_[index + 1] - offsets_[index] };
+    }
+
+    // Remove all strings and release the memory
+    void clear() {
+        offsets_ = { 0 };
+        bytes_.clear();
+    }
+
+    // Reserve memory for a number of strings with a total number of bytes
+    void reserve(uint64_t strings, uint64_t bytes) {
+        offsets_.reserve(strings + 1);
+        bytes_.reserve(bytes);
+    }
+
+    // Number of stored strings
+    uint64_t size() const { return offsets_.size() - 1; }
+    // Total number of bytes of all strings
+    uint64_t byte_size() const { return bytes_.size(); }
+    // Number of bytes allocated for offsets and bytes
+    uint64_t memory_usage() const { return offsets_.capacity() * sizeof(uint64_t) + bytes_.capacity(); }
+
+    // Write the arena to a file
+    void write(BinaryWriter &writer) const {
+        writer.write_buffer(offsets_);
+        writer.write_buffer(bytes_);
+    }
+
+ protected:
+    // The offsets of all strings in the heap (plus the end of the last string)
+    Buffer<uint64_t> offsets_;
+    // The heap
+    Buffer<char> bytes_;
+};
+//---------------------------------------------------------------------------
+}  // namespace imlab
+//---------------------------------------------------------------------------
+#endif  // INCLUDE_IMLAB_INFRA_STRING_ARENA_H_
+//---------------------------------------------------------------------------
@@ -0,0 +1,266 @@
+// ---------------------------------------------------------------------------
+// IMLAB
+// ---------------------------------------------------------------------------
+#ifndef INCLUDE_IMLAB_INFRA_THRIFT_COMPACT_H_
+#define INCLUDE_IMLAB_INFRA_THRIFT_COMPACT_H_
+//---------------------------------------------------------------------------
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "./error.h"
+//---------------------------------------------------------------------------
+namespace imlab {
+namespace thrift {
+//---------------------------------------------------------------------------
+// The types of the Thrift compact protocol as they appear in field and list headers
+enum Type : uint8_t {
+    kStop = 0,
+    kBoolTrue = 1,
+    kBoolFalse = 2,
+    kByte = 3,
+    kI16 = 4,
+    kI32 = 5,
+    kI64 = 6,
+    kDouble = 7,
+    kBinary = 8,
+    kList = 9,
+    kSet = 10,
+    kMap = 11,
+    kStruct = 12,
+};
+//---------------------------------------------------------------------------
+// Serializes structs with the Thrift compact protocol without any generated code.
+// Fields must be written in increasing order of their ids within a struct.
+class CompactWriter {
+ public:
+    // Constructor
+    explicit CompactWriter(std::string *out) : out_(out) {}
+
+    // Write an integer field (i16, i32 and i64 are all encoded the same way)
+    void field_i32(int16_t id, int32_t value) {
+        FieldHeader(id, kI32);
+        Varint(ZigZag(value));
+    }
+    void field_i64(int16_t id, int64_t value) {
+        FieldHeader(id, kI64);
+        Varint(ZigZag(value));
+    }
+    // Write a boolean field
+    void field_bool(int16_t id, bool value) { FieldHeader(id, value ? kBoolTrue : kBoolFalse); }
+    // Write a string field
+    void field_binary(int16_t id, std::string_view value) {
+        FieldHeader(id, kBinary);
+        element_binary(value);
+    }
+    // Start a struct field; its fields follow and it ends with end_struct()
+    void begin_struct(int16_t id) {
+        FieldHeader(id, kStruct);
+        begin_element_struct();
+    }
+    // Start a list field; its elements follow
+    void begin_list(int16_t id, Type element_type, uint64_t size) {
+        FieldHeader(id, kList);
+        if (size < 15) {
+            out_->push_back(static_cast<char>((size << 4) | element_type));
+        } else {
+            out_->push_back(static_cast<char>(0xF0 | element_type));
+            Varint(size);
+        }
+    }
+
+    // Write list elements
+    void element_i32(int32_t value) { Varint(ZigZag(value)); }
+    void element_binary(std::string_view value) {
+        Varint(value.size());
+        out_->append(value.data(), value.size());
+    }
+    // Start a struct in a list (or the top-level struct)
+    void begin_element_struct() {
+        last_ids_.push_back(0);
+    }
+    // End the current struct
+    void end_struct() {
+        out_->push_back(kStop);
+        last_ids_.pop_back();
+    }
+
+ protected:
+    // The output
+    std::string *out_;
+    // The id of the last field of every open struct
+    std::vector<int16_t> last_ids_;
+
+    // Write the header of a field
+    void FieldHeader(int16_t id, Type type) {
+        int16_t &last_id = last_ids_.back();
+        if (id > last_id && id - last_id <= 15) {
+            out_->push_back(static_cast<char>(((id - last_id) << 4) | type));
+        } else {
+            out_->push_back(static_cast<char>(type));
+            Varint(ZigZag(id));
+        }
+        last_id = id;
+    }
+    // Write an unsigned LEB128 integer
+    void Varint(uint64_t value) {
+        while (value >= 0x80) {
+            out_->push_back(static_cast<char>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        out_->push_back(static_cast<char>(value));
+    }
+    // Map signed to unsigned integers, so that small absolute values have short encodings
+    static uint64_t ZigZag(int64_t value) {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+};
+//---------------------------------------------------------------------------
+// Deserializes structs that were written with the Thrift compact protocol.
+// The caller drives the parsing: It iterates the fields of a struct with next_field()
+// and either reads or skips every field. Malformed input throws a FileFormatError.
+class CompactReader {
+ public:
+    // Constructor
+    CompactReader(const char *data, uint64_t size) : data_(data), end_(data + size) {}
+
+    // Start reading a struct (also the top-level struct)
+    void begin_struct() { last_ids_.push_back(0); }
+    // Read the header of the next field of the current struct; returns false at the end of the struct
+    bool next_field(int16_t *id, Type *type) {
+        uint8_t header = Byte();
+        if (header == kStop) {
+            last_ids_.pop_back();
+            return false;
+        }
+        *type = static_cast<Type>(header & 0x0F);
+        *id = (header >> 4) != 0 ? last_ids_.back() + (header >> 4) : static_cast<int16_t>(UnZigZag(Varint()));
+        last_ids_.back() = *id;
+        return true;
+    }
+
+    // Read an integer (i16, i32 or i64)
+    int64_t read_int() { return UnZigZag(Varint()); }
+    // Read the value of a boolean field
+    static bool read_bool(Type type) { return type == kBoolTrue; }
+    // Read a string; the view points into the input
+    std::string_view read_binary() {
+        uint64_t size = Varint();
+        if (size > static_cast<uint64_t>(end_ - data_)) {
+            throw FileFormatError("unexpected end of thrift data");
+        }
+        std::string_view value(data_, size);
+        data_ += size;
+        return value;
+    }
+    // Read the header of a list; its elements follow
+    uint64_t read_list_header(Type *element_type) {
+        uint8_t header = Byte();
+        *element_type = static_cast<Type>(header & 0x0F);
+        return (header >> 4) == 0x0F ? Varint() : (header >> 4);
+    }
+
+    // Skip a value of the given type
+    void skip(Type type) {
+        switch (type) {
+            case kBoolTrue:
+            case kBoolFalse:
+                break;
+            case kByte:
+                Byte();
+                break;
+            case kI16:
+            case kI32:
+            case kI64:
+                Varint();
+                break;
+            case kDouble:
+                Bytes(8);
+                break;
+            case kBinary:
+                read_binary();
+                break;
+            case kList:
+            case kSet: {
+                Type element_type;
+                uint64_t size = read_list_header(&element_type);
+                for (uint64_t i = 0; i < size; i++) {
+                    if (element_type == kBoolTrue || element_type == kBoolFalse) {
+                        Byte();  // Booleans in lists take one byte.
+                    } else {
+                        skip(element_type);
+                    }
+                }
+                break;
+            }
+            case kMap: {
+                uint64_t size = Varint();
+                if (size > 0) {
+                    uint8_t types = Byte();
+                    for (uint64_t i = 0; i < size; i++) {
+                        skip(static_cast<Type>(types >> 4));
+                        skip(static_cast<Type>(types & 0x0F));
+                    }
+                }
+                break;
+            }
+            case kStruct: {
+                begin_struct();
+                int16_t id;
+                Type field_type;
+                while (next_field(&id, &field_type)) {
+                    skip(field_type);
+                }
+                break;
+            }
+            default:
+                throw FileFormatError("invalid thrift type");
+        }
+    }
+
+    // Pointer to the next unread byte
+    const char *position() const { return data_; }
+
+ protected:
+    // The next unread byte
+    const char *data_;
+    // The end of the input
+    const char *end_;
+    // The id of the last field of every open struct
+    std::vector<int16_t> last_ids_;
+
+    // Read one byte
+    uint8_t Byte() { return static_cast<uint8_t>(*Bytes(1)); }
+    // Read raw bytes
+    const char *Bytes(uint64_t size) {
+        if (size > static_cast<uint64_t>(end_ - data_)) {
+            throw FileFormatError("unexpected end of thrift data");
+        }
+        const char *bytes = data_;
+        data_ += size;
+        return bytes;
+    }
+    // Read an unsigned LEB128 integer
+    uint64_t Varint() {
+        uint64_t value = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7) {
+            uint8_t byte = Byte();
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                return value;
+            }
+        }
+        throw FileFormatError("invalid thrift varint");
+    }
+    // Inverse of CompactWriter::ZigZag()
+    static int64_t UnZigZag(uint64_t value) {
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+};
+//---------------------------------------------------------------------------
+}  // namespace thrift
+}  // namespace imlab
+//---------------------------------------------------------------------------
+#endif  // INCLUDE_IMLAB_INFRA_THRIFT_COMPACT_H_
+//---------------------------------------------------------------------------
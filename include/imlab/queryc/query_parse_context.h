@@ -21,6 +21,30 @@ namespace queryc {
 struct QueryParser;
 struct QueryCompiler;
 // ---------------------------------------------------------------------------------------------------
+// A condition of the where clause, e.g. Name.Url like 'http%'
+struct Condition {
+    // Column on the left side
+    std::string column;
+    // Comparison: "=", "<>", "<", ">", "between" or "like"
+    std::string comparison;
+    // Right side: a column (only for "=") or a constant
+    std::string value;
+    // Whether the right side is a constant
+    bool constant = true;
+    // Upper bound of "between"
+    std::string upper = {};
+};
+// ---------------------------------------------------------------------------------------------------
+// An item of the select clause: a column or an aggregate, e.g. COUNT(Name.Language.Code) WITHIN RECORD
+struct SelectItem {
+    // Column ("*" for COUNT(*))
+    std::string column;
+    // Aggregate function, e.g. "count"; empty for a plain column
+    std::string function = {};
+    // Whether the aggregate is computed per record
+    bool within_record = false;
+};
+// ---------------------------------------------------------------------------------------------------
 // Query parse context
 class QueryParseContext {
     friend QueryParser;
@@ -52,9 +76,10 @@ class QueryParseContext {
     schemac::Schema schema;
 
     // create a table
-    void CreateSqlQuery(const std::vector<std::string> &select_columns,
+    void CreateSqlQuery(const std::vector<SelectItem> &select_items,
                         const std::vector<std::string> &relations,
-                        const std::vector<std::pair<std::string, std::string>> &where_predicates = {});
+                        const std::vector<Condition> &where_predicates = {},
+                        const std::vector<std::string> &group_by_columns = {});
 
     // Trace the scanning
     bool trace_scanning_;
@@ -77,7 +77,15 @@ void Database::DecodeJson(std::istream& in, const std::function<void (Document&)
 
 /// Executes a compiled query.
 void Database::LoadDocumentTable(std::istream &in) {
-    DecodeJson(in, [&](auto& d) { DocumentTable.insert(d); });
+    DocumentTable.load_json(in);
+}
+
+void Database::LoadDocumentTableJsonLines(std::istream &in) {
+    DocumentTable.load_json_lines(in);
+}
+
+void Database::LoadDocumentTableProtobuf(const std::string &path) {
+    DocumentTable.load_protobuf_file(path);
 }
 
 void ExecuteQuery(imlab::Database &db, const std::string &dylib_path) {
@@ -0,0 +1,503 @@
+// ---------------------------------------------------------------------------
+// IMLAB
+// ---------------------------------------------------------------------------
+
+#include "imlab/algebra/aggregation.h"
+#include <algorithm>
+#include "imlab/dremel/schema_helper.h"
+#include "imlab/infra/error.h"
+
+namespace imlab {
+
+    namespace {
+
+        bool IsNumeric(const google::protobuf::FieldDescriptor* field) {
+            switch (field->cpp_type()) {
+                case google::protobuf::FieldDescriptor::CPPTYPE_INT32:
+                case google::protobuf::FieldDescriptor::CPPTYPE_INT64:
+                case google::protobuf::FieldDescriptor::CPPTYPE_UINT32:
+                case google::protobuf::FieldDescriptor::CPPTYPE_UINT64:
+                case google::protobuf::FieldDescriptor::CPPTYPE_DOUBLE:
+                case google::protobuf::FieldDescriptor::CPPTYPE_FLOAT:
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+        // Type of the sum of a field's values, wide enough for the sum of many values
+        std::string SumType(const google::protobuf::FieldDescriptor* field) {
+            switch (field->cpp_type()) {
+                case google::protobuf::FieldDescriptor::CPPTYPE_UINT32:
+                case google::protobuf::FieldDescriptor::CPPTYPE_UINT64:
+                    return "uint64_t";
+                case google::protobuf::FieldDescriptor::CPPTYPE_DOUBLE:
+                case google::protobuf::FieldDescriptor::CPPTYPE_FLOAT:
+                    return "double";
+                default:
+                    return "int64_t";
+            }
+        }
+
+        // Name of a field below its table, e.g. Name.Language.Code
+        std::string ColumnName(const google::protobuf::FieldDescriptor* field) {
+            const auto& full_name = field->full_name();
+            return full_name.substr(full_name.find('.') + 1);
+        }
+
+        // Code that writes a value to the stream `out` like the text format of Protobuf
+        std::string WriteValue(const google::protobuf::FieldDescriptor* field, const std::string& value) {
+            if (field->cpp_type() == google::protobuf::FieldDescriptor::CPPTYPE_STRING) {
+                return "out << '\"' << " + value + " << '\"';";
+            }
+            return "out << " + value + ";";
+        }
+
+        // The repeated fields on the path from the root to a field, including the field itself
+        std::vector<const google::protobuf::FieldDescriptor*> RepeatedPath(const google::protobuf::FieldDescriptor* field) {
+            std::vector<const google::protobuf::FieldDescriptor*> path {};
+            for (; field != nullptr; field = dremel::GetParentField(field)) {
+                if (field->is_repeated()) {
+                    path.insert(path.begin(), field);
+                }
+            }
+            return path;
+        }
+
+    }  // namespace
+
+    std::string Aggregate::Name() const {
+        static const char* names[] = { "COUNT", "SUM", "MIN", "MAX", "AVG" };
+        return std::string(names[static_cast<int>(function)]) + "(" + (field ? ColumnName(field) : "*") + ")";
+    }
+
+    Aggregation::Aggregation(std::unique_ptr<Operator> child, std::vector<Aggregate> aggregates, bool within_record,
+                             std::vector<const google::protobuf::FieldDescriptor*> fields)
+        : child_(std::move(child)), aggregates_(std::move(aggregates)), within_record_(within_record), fields_(std::move(fields)) {
+        for (auto& aggregate : aggregates_) {
+            if (aggregate.field == nullptr) {
+                if (aggregate.function != Aggregate::Function::kCount) {
+                    throw QueryCompilationError("Only COUNT can be applied to *.");
+                }
+            } else if (FieldValueType(aggregate.field).empty()) {
+                throw QueryCompilationError("Aggregates need a leaf field, not " + aggregate.field->full_name() + ".");
+            } else if ((aggregate.function == Aggregate::Function::kSum || aggregate.function == Aggregate::Function::kAvg)
+                       && !IsNumeric(aggregate.field)) {
+                throw QueryCompilationError(aggregate.Name() + " needs a numeric field.");
+            }
+        }
+        for (auto* field : fields_) {
+            if (FieldValueType(field).empty()) {
+                throw QueryCompilationError("Only leaf fields can be passed on with aggregates, not " + field->full_name() + ".");
+            }
+        }
+    }
+
+    std::vector<const google::protobuf::FieldDescriptor*> Aggregation::CollectFields() {
+        return fields_;
+    }
+
+    void Aggregation::Prepare(const std::vector<const google::protobuf::FieldDescriptor*> &required, Operator* consumer) {
+        required_fields_ = required;
+        consumer_ = consumer;
+
+        // The child has to provide the aggregated fields and the fields that are passed on.
+        std::vector<const google::protobuf::FieldDescriptor*> required_from_child = fields_;
+        for (auto& aggregate : aggregates_) {
+            if (aggregate.field != nullptr
+                && std::find(required_from_child.begin(), required_from_child.end(), aggregate.field) == required_from_child.end()) {
+                required_from_child.push_back(aggregate.field);
+            }
+        }
+        child_->Prepare(required_from_child, this);
+    }
+
+    void Aggregation::GenerateState(std::ostream& _o) {
+        // Print:
+        // struct aggregation_State {
+        //     [count_k, sum_k, min_k, max_k, or sum_k and count_k for AVG]
+        //     [field_j for the fields that are passed on, or group_j for the fields to group by]
+        //     void Reset() { ... }
+        //     void Merge(const aggregation_State& other) { ... }
+        //     std::string DebugString() const { ... }
+        // };
+
+        _o << "struct aggregation_State {" << std::endl;
+        for (size_t k = 0; k < aggregates_.size(); k++) {
+            auto& aggregate = aggregates_[k];
+            auto k_ = std::to_string(k);
+            switch (aggregate.function) {
+                case Aggregate::Function::kCount:
+                    _o << "    uint64_t count_" << k_ << " = 0;" << std::endl;
+                    break;
+                case Aggregate::Function::kSum:
+                    _o << "    " << SumType(aggregate.field) << " sum_" << k_ << " = 0;" << std::endl;
+                    break;
+                case Aggregate::Function::kMin:
+                    _o << "    std::optional<" << FieldValueType(aggregate.field) << "> min_" << k_ << " {};" << std::endl;
+                    break;
+                case Aggregate::Function::kMax:
+                    _o << "    std::optional<" << FieldValueType(aggregate.field) << "> max_" << k_ << " {};" << std::endl;
+                    break;
+                case Aggregate::Function::kAvg:
+                    _o << "    double sum_" << k_ << " = 0;" << std::endl;
+                    _o << "    uint64_t count_" << k_ << " = 0;" << std::endl;
+                    break;
+            }
+        }
+        for (size_t j = 0; j < fields_.size(); j++) {
+            if (Grouped()) {
+                _o << "    std::optional<" << FieldValueType(fields_[j]) << "> group_" << j << " {};" << std::endl;
+            } else {
+                _o << "    std::vector<" << FieldValueType(fields_[j]) << "> field_" << j << " {};" << std::endl;
+            }
+        }
+
+        // Reset the aggregates for the next record; the fields keep their memory.
+        _o << "    void Reset() {" << std::endl;
+        for (size_t k = 0; k < aggregates_.size(); k++) {
+            auto k_ = std::to_string(k);
+            switch (aggregates_[k].function) {
+                case Aggregate::Function::kCount: _o << "        count_" << k_ << " = 0;" << std::endl; break;
+                case Aggregate::Function::kSum: _o << "        sum_" << k_ << " = 0;" << std::endl; break;
+                case Aggregate::Function::kMin: _o << "        min_" << k_ << ".reset();" << std::endl; break;
+                case Aggregate::Function::kMax: _o << "        max_" << k_ << ".reset();" << std::endl; break;
+                case Aggregate::Function::kAvg:
+                    _o << "        sum_" << k_ << " = 0;" << std::endl;
+                    _o << "        count_" << k_ << " = 0;" << std::endl;
+                    break;
+            }
+        }
+        for (size_t j = 0; j < fields_.size() && !Grouped(); j++) {
+            _o << "        field_" << j << ".clear();" << std::endl;
+        }
+        _o << "    }" << std::endl;
+
+        // Merge the partial aggregates of another thread (of the same group).
+        _o << "    void Merge(const aggregation_State& other) {" << std::endl;
+        for (size_t k = 0; k < aggregates_.size(); k++) {
+            auto k_ = std::to_string(k);
+            switch (aggregates_[k].function) {
+                case Aggregate::Function::kCount:
+                    _o << "        count_" << k_ << " += other.count_" << k_ << ";" << std::endl;
+                    break;
+                case Aggregate::Function::kSum:
+                    _o << "        sum_" << k_ << " += other.sum_" << k_ << ";" << std::endl;
+                    break;
+                case Aggregate::Function::kMin:
+                    _o << "        if (other.min_" << k_ << " && (!min_" << k_ << " || *other.min_" << k_ << " < *min_" << k_
+                       << ")) min_" << k_ << " = other.min_" << k_ << ";" << std::endl;
+                    break;
+                case Aggregate::Function::kMax:
+                    _o << "        if (other.max_" << k_ << " && (!max_" << k_ << " || *other.max_" << k_ << " > *max_" << k_
+                       << ")) max_" << k_ << " = other.max_" << k_ << ";" << std::endl;
+                    break;
+                case Aggregate::Function::kAvg:
+                    _o << "        sum_" << k_ << " += other.sum_" << k_ << ";" << std::endl;
+                    _o << "        count_" << k_ << " += other.count_" << k_ << ";" << std::endl;
+                    break;
+            }
+        }
+        _o << "    }" << std::endl;
+
+        // Print the fields and the aggregates like the text format of Protobuf; empty MIN, MAX and AVG are NULL.
+        _o << "    std::string DebugString() const {" << std::endl;
+        _o << "        std::stringstream out {};" << std::endl;
+        for (size_t j = 0; j < fields_.size(); j++) {
+            if (Grouped()) {
+                // A group of the records without a value of the field
+                _o << "        out << \"" << ColumnName(fields_[j]) << ": \"; if (group_" << j << ") { "
+                   << WriteValue(fields_[j], "*group_" + std::to_string(j)) << " } else { out << \"NULL\"; } out << std::endl;" << std::endl;
+            } else {
+                _o << "        for (const auto& value : field_" << j << ") { out << \"" << ColumnName(fields_[j]) << ": \"; "
+                   << WriteValue(fields_[j], "value") << " out << std::endl; }" << std::endl;
+            }
+        }
+        for (size_t k = 0; k < aggregates_.size(); k++) {
+            auto& aggregate = aggregates_[k];
+            auto k_ = std::to_string(k);
+            _o << "        out << \"" << aggregate.Name() << ": \";" << std::endl;
+            switch (aggregate.function) {
+                case Aggregate::Function::kCount: _o << "        out << count_" << k_ << ";" << std::endl; break;
+                case Aggregate::Function::kSum: _o << "        out << sum_" << k_ << ";" << std::endl; break;
+                case Aggregate::Function::kMin:
+                    _o << "        if (min_" << k_ << ") { " << WriteValue(aggregate.field, "*min_" + k_) << " } else { out << \"NULL\"; }" << std::endl;
+                    break;
+                case Aggregate::Function::kMax:
+                    _o << "        if (max_" << k_ << ") { " << WriteValue(aggregate.field, "*max_" + k_) << " } else { out << \"NULL\"; }" << std::endl;
+                    break;
+                case Aggregate::Function::kAvg:
+                    _o << "        if (count_" << k_ << " > 0) { out << sum_" << k_ << " / count_" << k_ << "; } else { out << \"NULL\"; }" << std::endl;
+                    break;
+            }
+            _o << "        out << std::endl;" << std::endl;
+        }
+        _o << "        return out.str();" << std::endl;
+        _o << "    }" << std::endl;
+        _o << "};" << std::endl;
+    }
+
+    void Aggregation::Produce(std::ostream& _o) {
+        // Print:
+        // [aggregation_State]
+        // tbb::enumerable_thread_specific<aggregation_State> aggregation_states;
+        // [child.produce()]
+        // aggregation_State aggregation_result {};
+        // for (auto& state : aggregation_states) aggregation_result.Merge(state);
+        // {
+        //     auto record = [&]() -> const aggregation_State& { return aggregation_result; };
+        //     [parent.consume()]
+        // }
+        //
+        // Every thread aggregates the records of its morsels into a state of its own, so the scan needs no
+        // synchronization. The partial aggregates are merged after the scan.
+        // WITHIN RECORD, the aggregates of every record are passed on right away, nothing needs to be merged.
+        //
+        // With GROUP BY, we emit instead:
+        // using aggregation_Key = Key<std::optional<[type]>, ...>;
+        // PartitionedAggregationMap<aggregation_Key, aggregation_State> aggregation_groups;
+        // [child.produce()]
+        // aggregation_groups.finalize();
+        // tbb::parallel_for(tbb::blocked_range<size_t>(0, aggregation_groups.partitions().size(), 1), [&](const tbb::blocked_range<size_t>& partition_range) {
+        //     [parent.begin_task()]
+        //     for (size_t p = partition_range.begin(); p != partition_range.end(); ++p) {
+        //     for (auto& aggregation_group : aggregation_groups.partitions()[p]) {
+        //         auto record = [&]() -> const aggregation_State& { return aggregation_group.second; };
+        //         [parent.consume()]
+        //     }
+        //     }
+        // });
+        //
+        // Every thread aggregates into hash tables of its own that are partitioned by the hash of the groups.
+        // The partitions are merged in parallel, so many groups need neither a global lock nor a sequential merge.
+
+        GenerateState(_o);
+        if (within_record_) {
+            child_->Produce(_o);
+            return;
+        }
+
+        if (Grouped()) {
+            _o << "using aggregation_Key = Key<";
+            for (size_t j = 0; j < fields_.size(); j++) {
+                _o << (j > 0 ? ", " : "") << "std::optional<" << FieldValueType(fields_[j]) << ">";
+            }
+            _o << ">;" << std::endl;
+            _o << "PartitionedAggregationMap<aggregation_Key, aggregation_State> aggregation_groups;" << std::endl;
+            child_->Produce(_o);
+            _o << "aggregation_groups.finalize();" << std::endl;
+            _o << "tbb::parallel_for(tbb::blocked_range<size_t>(0, aggregation_groups.partitions().size(), 1), [&](const tbb::blocked_range<size_t>& partition_range) {" << std::endl;
+            consumer_->BeginTask(_o, this);
+            _o << "    for (size_t p = partition_range.begin(); p != partition_range.end(); ++p) {" << std::endl;
+            _o << "    for (auto& aggregation_group : aggregation_groups.partitions()[p]) {" << std::endl;
+            _o << "        [[maybe_unused]] auto record = [&]() -> const aggregation_State& { return aggregation_group.second; };" << std::endl;
+            consumer_->Consume(_o, this);
+            _o << "    }" << std::endl;
+            _o << "    }" << std::endl;
+            _o << "});" << std::endl;
+            return;
+        }
+
+        _o << "tbb::enumerable_thread_specific<aggregation_State> aggregation_states;" << std::endl;
+        child_->Produce(_o);
+        _o << "aggregation_State aggregation_result {};" << std::endl;
+        _o << "for (auto& state : aggregation_states) {" << std::endl;
+        _o << "    aggregation_result.Merge(state);" << std::endl;
+        _o << "}" << std::endl;
+        _o << "{" << std::endl;
+        _o << "[[maybe_unused]] auto record = [&]() -> const aggregation_State& { return aggregation_result; };" << std::endl;
+        consumer_->Consume(_o, this);
+        _o << "}" << std::endl;
+    }
+
+    void Aggregation::BeginTask(std::ostream& _o, const Operator* child) {
+        // Print (once per task of the scan):
+        // auto& aggregation_state = aggregation_states.local();
+        //
+        // WITHIN RECORD, the state is reused for all records of the task instead:
+        // aggregation_State aggregation_state {};
+        // [parent.begin_task()]
+        //
+        // With GROUP BY, the thread's hash tables are looked up:
+        // auto& aggregation_local = aggregation_groups.local();
+        // dremel::RecordFlattener aggregation_flattener { { [repeated path of every field] }, [fields to group by] };
+        //
+        // The flattener walks the fields to group by and the aggregated fields, the repeated fields on their paths
+        // are numbered in the order in which they occur.
+
+        if (within_record_) {
+            _o << "    aggregation_State aggregation_state {};" << std::endl;
+            consumer_->BeginTask(_o, this);
+        } else if (Grouped()) {
+            _o << "    auto& aggregation_local = aggregation_groups.local();" << std::endl;
+            std::vector<const google::protobuf::FieldDescriptor*> repeated_fields {};
+            _o << "    dremel::RecordFlattener aggregation_flattener { {";
+            for (auto* field : FlattenedFields()) {
+                std::string separator = " ";
+                _o << " {";
+                for (auto* repeated : RepeatedPath(field)) {
+                    size_t id = std::find(repeated_fields.begin(), repeated_fields.end(), repeated) - repeated_fields.begin();
+                    if (id == repeated_fields.size()) {
+                        repeated_fields.push_back(repeated);
+                    }
+                    _o << separator << id;
+                    separator = ", ";
+                }
+                _o << " },";
+            }
+            _o << " }, " << fields_.size() << " };" << std::endl;
+        } else {
+            _o << "    auto& aggregation_state = aggregation_states.local();" << std::endl;
+        }
+    }
+
+    std::vector<const google::protobuf::FieldDescriptor*> Aggregation::AggregatedFields() const {
+        std::vector<const google::protobuf::FieldDescriptor*> aggregated_fields {};
+        for (auto& aggregate : aggregates_) {
+            if (std::find(aggregated_fields.begin(), aggregated_fields.end(), aggregate.field) == aggregated_fields.end()) {
+                aggregated_fields.push_back(aggregate.field);
+            }
+        }
+        return aggregated_fields;
+    }
+
+    std::vector<const google::protobuf::FieldDescriptor*> Aggregation::FlattenedFields() const {
+        std::vector<const google::protobuf::FieldDescriptor*> flattened_fields = fields_;
+        for (auto* field : AggregatedFields()) {
+            if (field != nullptr) {
+                flattened_fields.push_back(field);
+            }
+        }
+        return flattened_fields;
+    }
+
+    void Aggregation::GenerateUpdate(std::ostream& _o) {
+        // Print:
+        // for (const auto& value : [field]()) {
+        //     aggregation_state.count_k++;  (or sum_k, min_k, max_k)
+        //     [repeat for every aggregate of the field]
+        // }
+        // [repeat for every aggregated field]
+        //
+        // The values of a field are read once for all of its aggregates, straight from the column.
+        // With GROUP BY, only the values of the current tuple are aggregated (see Consume), so we emit instead:
+        // for (size_t row = begin[i]; row != end[i]; ++row) {
+        //     const auto* aggregation_value = aggregation_rows_i.value(row);
+        //     if (aggregation_value == nullptr) continue;
+        //     const auto& value = *aggregation_value;
+        //     [aggregates of the field]
+        // }
+
+        size_t row_index = fields_.size();
+        for (auto* field : AggregatedFields()) {
+            std::string indent = "";
+            if (field != nullptr && Grouped()) {
+                auto i = std::to_string(row_index++);
+                _o << "for (size_t row = begin[" << i << "]; row != end[" << i << "]; ++row) {" << std::endl;
+                _o << "    const auto* aggregation_value = aggregation_rows_" << i << ".value(row);" << std::endl;
+                _o << "    if (aggregation_value == nullptr) continue;" << std::endl;
+                _o << "    [[maybe_unused]] const auto& value = *aggregation_value;" << std::endl;
+                indent = "    ";
+            } else if (field != nullptr) {
+                _o << "for ([[maybe_unused]] const auto& value : " << FieldVariable(field) << "()) {" << std::endl;
+                indent = "    ";
+            }
+            for (size_t k = 0; k < aggregates_.size(); k++) {
+                if (aggregates_[k].field != field) {
+                    continue;
+                }
+                auto min = "aggregation_state.min_" + std::to_string(k);
+                auto max = "aggregation_state.max_" + std::to_string(k);
+                switch (aggregates_[k].function) {
+                    case Aggregate::Function::kCount:
+                        _o << indent << "aggregation_state.count_" << k << "++;" << std::endl;
+                        break;
+                    case Aggregate::Function::kSum:
+                        _o << indent << "aggregation_state.sum_" << k << " += value;" << std::endl;
+                        break;
+                    case Aggregate::Function::kMin:
+                        _o << indent << "if (!" << min << " || value < *" << min << ") " << min << " = value;" << std::endl;
+                        break;
+                    case Aggregate::Function::kMax:
+                        _o << indent << "if (!" << max << " || value > *" << max << ") " << max << " = value;" << std::endl;
+                        break;
+                    case Aggregate::Function::kAvg:
+                        _o << indent << "aggregation_state.sum_" << k << " += value;" << std::endl;
+                        _o << indent << "aggregation_state.count_" << k << "++;" << std::endl;
+                        break;
+                }
+            }
+            if (field != nullptr) {
+                _o << "}" << std::endl;
+            }
+        }
+    }
+
+    void Aggregation::Consume(std::ostream& _o, const Operator* child) {
+        if (within_record_) {
+            // Print:
+            // aggregation_state.Reset();
+            // [update]
+            // aggregation_state.field_j.push_back(value);  (for every value of every field that is passed on)
+            // {
+            //     auto record = [&]() -> const aggregation_State& { return aggregation_state; };
+            //     [parent.consume()]
+            // }
+
+            _o << "aggregation_state.Reset();" << std::endl;
+            GenerateUpdate(_o);
+            for (size_t j = 0; j < fields_.size(); j++) {
+                _o << "for (const auto& value : " << FieldVariable(fields_[j]) << "()) {" << std::endl;
+                _o << "    aggregation_state.field_" << j << ".push_back(value);" << std::endl;
+                _o << "}" << std::endl;
+            }
+            _o << "{" << std::endl;
+            _o << "[[maybe_unused]] auto record = [&]() -> const aggregation_State& { return aggregation_state; };" << std::endl;
+            consumer_->Consume(_o, this);
+            _o << "}" << std::endl;
+            return;
+        }
+
+        if (!Grouped()) {
+            GenerateUpdate(_o);
+            return;
+        }
+
+        // Print:
+        // const auto aggregation_rows_0 = [field]_rows();
+        // [repeat for every field to group by, then for every aggregated field]
+        // aggregation_flattener.Flatten([&](const size_t* begin, const size_t* end) {
+        //     auto [aggregation_state, inserted] = aggregation_local.try_emplace(aggregation_Key(aggregation_rows_0.Get(begin[0]), ...));
+        //     if (inserted) { aggregation_state.group_0 = aggregation_rows_0.Get(begin[0]); ... }
+        //     [update]
+        // }, aggregation_rows_0, ...);
+        //
+        // The record is flattened into tuples of the fields to group by, which belong to a group each: Fields in the
+        // same repeated group pair up, independently repeated fields form the cross product, and a missing field
+        // is NULL. Every tuple aggregates the values of the aggregated fields in the repeated groups it shares with
+        // the fields to group by (the whole record for the others), and COUNT(*) counts the tuples.
+
+        auto flattened_fields = FlattenedFields();
+        for (size_t i = 0; i < flattened_fields.size(); i++) {
+            _o << "const auto aggregation_rows_" << i << " = " << FieldVariable(flattened_fields[i]) << "_rows();" << std::endl;
+        }
+        _o << "aggregation_flattener.Flatten([&]([[maybe_unused]] const size_t* begin, [[maybe_unused]] const size_t* end) {" << std::endl;
+        _o << "auto [aggregation_state, inserted] = aggregation_local.try_emplace(aggregation_Key(";
+        for (size_t j = 0; j < fields_.size(); j++) {
+            _o << (j > 0 ? ", " : "") << "aggregation_rows_" << j << ".Get(begin[" << j << "])";
+        }
+        _o << "));" << std::endl;
+        _o << "if (inserted) {" << std::endl;
+        for (size_t j = 0; j < fields_.size(); j++) {
+            _o << "    aggregation_state.group_" << j << " = aggregation_rows_" << j << ".Get(begin[" << j << "]);" << std::endl;
+        }
+        _o << "}" << std::endl;
+        GenerateUpdate(_o);
+        _o << "}";
+        for (size_t i = 0; i < flattened_fields.size(); i++) {
+            _o << ", aggregation_rows_" << i;
+        }
+        _o << ");" << std::endl;
+    }
+
+}  // namespace imlab
@@ -0,0 +1,173 @@
+// ---------------------------------------------------------------------------
+// IMLAB
+// ---------------------------------------------------------------------------
+
+#include "imlab/algebra/predicate.h"
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include "imlab/infra/error.h"
+
+namespace imlab {
+
+    namespace {
+
+        // Check that a constant is a complete integer of type T
+        template<typename T>
+        bool IsInteger(const std::string& value) {
+            T result {};
+            auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), result);
+            return error == std::errc() && end == value.data() + value.size();
+        }
+
+    }  // namespace
+
+    Predicate::Predicate(const google::protobuf::FieldDescriptor* field, Type type, std::string value, std::string upper)
+        : field_(field), type_(type), value_(std::move(value)), upper_(std::move(upper)) {
+        if (FieldValueType(field_).empty()) {
+            throw QueryCompilationError("Predicates are only supported on leaf fields, not on " + field_->full_name() + ".");
+        }
+
+        if (type_ == Type::kLike) {
+            if (field_->cpp_type() != google::protobuf::FieldDescriptor::CPPTYPE_STRING) {
+                throw QueryCompilationError("LIKE is only supported on string fields, not on " + field_->full_name() + ".");
+            }
+            // Only a prefix followed by '%' is supported; a pattern without wildcards is an equality.
+            auto wildcard = value_.find_first_of("%_");
+            if (wildcard == std::string::npos) {
+                type_ = Type::kEqual;
+            } else if (wildcard == value_.size() - 1 && value_[wildcard] == '%') {
+                value_.pop_back();
+            } else {
+                throw QueryCompilationError("Only prefix patterns ('abc%') are supported for LIKE, not '" + value_ + "'.");
+            }
+        }
+
+        // Check the constants now, so that the generated code compiles.
+        for (auto* constant : { &value_, &upper_ }) {
+            if (constant == &upper_ && type_ != Type::kBetween) {
+                continue;
+            }
+            bool valid = true;
+            switch (field_->cpp_type()) {
+                case google::protobuf::FieldDescriptor::CPPTYPE_INT32: valid = IsInteger<int32_t>(*constant); break;
+                case google::protobuf::FieldDescriptor::CPPTYPE_INT64: valid = IsInteger<int64_t>(*constant); break;
+                case google::protobuf::FieldDescriptor::CPPTYPE_UINT32: valid = IsInteger<uint32_t>(*constant); break;
+                case google::protobuf::FieldDescriptor::CPPTYPE_UINT64: valid = IsInteger<uint64_t>(*constant); break;
+                case google::protobuf::FieldDescriptor::CPPTYPE_DOUBLE:
+                case google::protobuf::FieldDescriptor::CPPTYPE_FLOAT: {
+                    char* end = nullptr;
+                    double result = std::strtod(constant->c_str(), &end);
+                    valid = !constant->empty() && end == constant->c_str() + constant->size() && std::isfinite(result);
+                    break;
+                }
+                case google::protobuf::FieldDescriptor::CPPTYPE_BOOL:
+                    valid = *constant == "true" || *constant == "false" || *constant == "1" || *constant == "0";
+                    break;
+                default: break;
+            }
+            if (!valid) {
+                throw QueryCompilationError("'" + *constant + "' is not a valid value of " + field_->full_name() + ".");
+            }
+        }
+    }
+
+    std::string Predicate::GenerateConstant(const std::string& value) const {
+        auto type = FieldValueType(field_);
+        switch (field_->cpp_type()) {
+            case google::protobuf::FieldDescriptor::CPPTYPE_STRING:
+                return "std::string_view(" + StringLiteral(value) + ", " + std::to_string(value.size()) + ")";
+            case google::protobuf::FieldDescriptor::CPPTYPE_DOUBLE:
+            case google::protobuf::FieldDescriptor::CPPTYPE_FLOAT: {
+                char buffer[32];
+                std::snprintf(buffer, sizeof(buffer), "%.17g", std::strtod(value.c_str(), nullptr));
+                return "static_cast<" + type + ">(" + buffer + ")";
+            }
+            case google::protobuf::FieldDescriptor::CPPTYPE_BOOL:
+                return (value == "true" || value == "1") ? "true" : "false";
+            case google::protobuf::FieldDescriptor::CPPTYPE_UINT32:
+            case google::protobuf::FieldDescriptor::CPPTYPE_UINT64:
+                return "static_cast<" + type + ">(" + value + "ull)";
+            default: {
+                // 9223372036854775808ll does not fit into a long long, so the smallest value cannot be negated.
+                int64_t result {};
+                std::from_chars(value.data(), value.data() + value.size(), result);
+                if (result == INT64_MIN) {
+                    return "static_cast<" + type + ">(" + std::to_string(INT64_MIN + 1) + "ll - 1)";
+                }
+                return "static_cast<" + type + ">(" + value + "ll)";
+            }
+        }
+    }
+
+    std::string Predicate::GenerateCode() const {
+        // Print:
+        // [&] { for (const auto& value : [field]()) { if ([condition]) return true; } return false; }()
+
+        std::string value = "value";
+        if (field_->cpp_type() == google::protobuf::FieldDescriptor::CPPTYPE_STRING) {
+            value = "std::string_view(value)";
+        }
+
+        std::stringstream condition {};
+        switch (type_) {
+            case Type::kEqual: condition << value << " == " << GenerateConstant(value_); break;
+            case Type::kNotEqual: condition << value << " != " << GenerateConstant(value_); break;
+            case Type::kLess: condition << value << " < " << GenerateConstant(value_); break;
+            case Type::kGreater: condition << value << " > " << GenerateConstant(value_); break;
+            case Type::kBetween:
+                condition << value << " >= " << GenerateConstant(value_) << " && "
+                          << value << " <= " << GenerateConstant(upper_);
+                break;
+            case Type::kLike:
+                condition << value << ".substr(0, " << value_.size() << ") == " << GenerateConstant(value_);
+                break;
+        }
+
+        return "[&] { for (const auto& value : " + FieldVariable(field_) + "()) { if (" + condition.str()
+               + ") return true; } return false; }()";
+    }
+
+    bool Predicate::MatchesInColumn() const {
+        return type_ == Type::kEqual && field_->cpp_type() == google::protobuf::FieldDescriptor::CPPTYPE_STRING;
+    }
+
+    std::string Predicate::GenerateMatcher(const std::string& matcher) const {
+        // Print:
+        // dremel::ColumnMatcher<std::string> [matcher] { std::string([value]) };
+
+        return "dremel::ColumnMatcher<std::string> " + matcher + " { std::string(" + GenerateConstant(value_) + ") };";
+    }
+
+    bool Predicate::GetRange(std::optional<std::string>* lower, std::optional<std::string>* upper) const {
+        // The bounds are inclusive, so < and > are widened to <= and >=; the zone maps only need to be conservative.
+        *lower = std::nullopt;
+        *upper = std::nullopt;
+        switch (type_) {
+            case Type::kEqual: *lower = value_; *upper = value_; return true;
+            case Type::kNotEqual: return false;
+            case Type::kLess: *upper = value_; return true;
+            case Type::kGreater: *lower = value_; return true;
+            case Type::kBetween: *lower = value_; *upper = upper_; return true;
+            case Type::kLike: {
+                // All strings with the prefix are within [prefix, prefix with its last character incremented].
+                *lower = value_;
+                std::string successor = value_;
+                while (!successor.empty() && static_cast<unsigned char>(successor.back()) == 0xff) {
+                    successor.pop_back();
+                }
+                if (!successor.empty()) {
+                    successor.back()++;
+                    *upper = successor;
+                }
+                return true;
+            }
+        }
+        return false;
+    }
+
+}  // namespace imlab
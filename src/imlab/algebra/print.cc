@@ -27,11 +27,13 @@ namespace imlab {
     void Print::Consume(std::ostream& _o, const Operator* child) {
         // Print:
         // cout_lock.lock();
-        // out_ << record.DebugString();
+        // out_ << record().DebugString();
         // cout_lock.unlock();
+        //
+        // This is the only place where the scanned records are assembled into Protobuf messages.
 
         _o << "cout_lock.lock();" << std::endl;
-        _o << "std::cout << record.DebugString() << std::endl;" << std::endl;
+        _o << "std::cout << record().DebugString() << std::endl;" << std::endl;
         _o << "cout_lock.unlock();" << std::endl;
     }
 
@@ -3,6 +3,7 @@
 // ---------------------------------------------------------------------------
 
 #include "imlab/algebra/selection.h"
+#include "imlab/algebra/table_scan.h"
 #include <algorithm>
 
 namespace imlab {
@@ -18,11 +19,19 @@ namespace imlab {
 
         std::vector<const google::protobuf::FieldDescriptor*>& required_from_child = required_fields_;
         for (auto& p : predicates_) {
-            if (std::find(required_from_child.begin(), required_from_child.end(), p.first) == required_from_child.end()) {
-                required_from_child.push_back(p.first);
+            if (std::find(required_from_child.begin(), required_from_child.end(), p.field()) == required_from_child.end()) {
+                required_from_child.push_back(p.field());
             }
         }
         child_->Prepare(required_from_child, this);
+
+        // Predicates directly on a table scan are evaluated by the scan (see TableScan::PushDownPredicate()).
+        if (auto* scan = dynamic_cast<TableScan*>(child_.get())) {
+            for (auto& predicate : predicates_) {
+                scan->PushDownPredicate(predicate);
+            }
+            pushed_down_ = true;
+        }
     }
 
     void Selection::Produce(std::ostream& _o) {
@@ -31,15 +40,22 @@ namespace imlab {
 
     void Selection::Consume(std::ostream& _o, const Operator* child) {
         // print:
-        // if (predicate == "..." && ...) {
+        // if ([predicate] && ...) {
         //     [parent.consume()]
         // }
+        //
+        // If the predicates were pushed down into the scan, only qualifying records arrive here.
+
+        if (pushed_down_ || predicates_.empty()) {
+            consumer_->Consume(_o, this);
+            return;
+        }
 
         _o << "if (";
-        for (auto& [IU, p] : predicates_) {
-           // _o << IU->table << "_" << IU->column << " == " << p << " && ";
+        for (auto& predicate : predicates_) {
+            _o << (&predicate != &predicates_.front() ? " && " : "") << predicate.GenerateCode();
         }
-        _o << "true) {" << std::endl;
+        _o << ") {" << std::endl;
 
         consumer_->Consume(_o, this);
 
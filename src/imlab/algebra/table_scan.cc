@@ -6,6 +6,7 @@
 #include "imlab/schemac/schema_compiler.h"
 #include "imlab/infra/types.h"
 #include "../tools/protobuf/gen/schema.h"
+#include <sstream>
 
 namespace imlab {
 
@@ -22,31 +23,120 @@ namespace imlab {
         consumer_ = consumer;
     }
 
+    std::string TableScan::GenerateBound(const std::optional<std::string>& bound) {
+        if (!bound.has_value()) {
+            return "std::nullopt";
+        }
+        return "std::string(" + StringLiteral(*bound) + ", " + std::to_string(bound->size()) + ")";
+    }
+
     void TableScan::Produce(std::ostream &_o) {
         // With TBB, we will actually emit:
         //
-        // tbb::parallel_for(tbb::blocked_range<size_t>(0, [table].size()), [&](const tbb::blocked_range<size_t>& index_range) {
-        //     for(size_t i=r.begin(); i!=r.end(); ++i, ++tuple_it) {
-        //         auto& record = [table].get(i, required_ius);
+        // {
+        // const auto morsels = [table].morsels({ [field, lower, upper], ... });
+        // const std::vector<const FieldDescriptor*> [table]_fields { [required_fields] };
+        // struct [table]_Worker { schema::[table]Table::Cursor cursor; [table] record; };
+        // tbb::enumerable_thread_specific<[table]_Worker> [table]_workers([&] { return [table]_Worker { { [table], [table]_fields }, {} }; });
+        // tbb::parallel_for(tbb::blocked_range<size_t>(0, morsels.size()), [&](const tbb::blocked_range<size_t>& morsel_range) {
+        //     auto& [table]_worker = [table]_workers.local();
+        //     dremel::ColumnMatcher<std::string> predicate_[p]_matcher { [value] };
+        //     [repeat for every string equality]
+        //     [parent.begin_task(_o, this)]
+        //     for (size_t m = morsel_range.begin(); m != morsel_range.end(); ++m) {
+        //     dremel::RecordValueReader<[type]> [field]_reader { [table].column<[type]>([table]_fields[k]), morsels[m].begin };
+        //     [repeat for every required field]
+        //     for (size_t i = morsels[m].begin; i != morsels[m].end; ++i) {
+        //         auto [field] = [&] { return [field]_reader.Read(i); };
+        //         auto [field]_rows = [&] { return [field]_reader.ReadRows(i); };
+        //         [repeat for every required field]
+        //         if (!([predicate] && ...)) continue;
+        //         auto record = [&]() -> const [table]& { [assemble record i with the worker's cursor]; return [table]_worker.record; };
         //
         //         [parent.consume(_o, this)]
         //     }
+        //     }
         // });
+        // }
+        //
+        // Morsels are aligned to the segments of the table's largest column (see TableBase::morsels()).
+        // Segments whose zone maps rule out the pushed-down ranges are skipped entirely.
+        //
+        // The consumers work on the columns directly: The values of a field in the current record are read
+        // when an operator calls [field](), records that no operator asks about are skipped in its column.
+        // [field]_rows() also has the NULLs and repetition levels, to walk several fields of a record together.
+        // Pushed-down predicates are checked first, so the columns that only the consumers need are read for
+        // qualifying records alone (late materialization). The column of a predicate is only read if the
+        // predicates before it hold. String equalities are checked in the column with a matcher instead:
+        // [field]_reader.Contains(i, predicate_[p]_matcher) compares dictionary codes on dictionary-encoded segments,
+        // the constant is looked up once per segment.
+        // A record is only assembled into a Protobuf message if an operator calls record() (e.g. a print).
+        // Like in scan_morsels(), every worker thread keeps one cursor and one message, which are set up on its first
+        // task and reused for all morsels of the scan that it takes on.
 
-        _o << "tbb::parallel_for(tbb::blocked_range<size_t>(0, db." << table_ << "Table.size()), [&](const tbb::blocked_range<size_t>& index_range) {" << std::endl;
-        _o << "    for(size_t i = index_range.begin(); i != index_range.end(); ++i) {" << std::endl;
-        _o << "        const auto& record = db." << table_ << "Table.get(i, {" << std::endl;
+        const std::string table = table_;
+        const std::string table_object = "db." + table + "Table";
+
+        _o << "{" << std::endl;
+        _o << "const auto morsels = " << table_object << ".morsels({" << std::endl;
+        for (auto& [field, lower, upper] : ranges_) {
+            _o << "    { " << FieldDescriptorCode(field) << ", "
+               << GenerateBound(lower) << ", " << GenerateBound(upper) << " }," << std::endl;
+        }
+        _o << "});" << std::endl;
+        _o << "const std::vector<const google::protobuf::FieldDescriptor*> " << table << "_fields {" << std::endl;
         for (auto& field : required_fields_) {
-            auto field_name = field->containing_type()->full_name();
-            std::replace(field_name.begin(), field_name.end(), '.', '_');
-            _o << "            " << field_name << "::descriptor()->FindFieldByName(\"" << field->name() << "\")," << std::endl;
+            _o << "    " << FieldDescriptorCode(field) << "," << std::endl;
+        }
+        _o << "};" << std::endl;
+        _o << "struct " << table << "_Worker { schema::" << table << "Table::Cursor cursor; " << table << " record; };" << std::endl;
+        _o << "tbb::enumerable_thread_specific<" << table << "_Worker> " << table << "_workers([&] { return " << table
+           << "_Worker { { " << table_object << ", " << table << "_fields }, {} }; });" << std::endl;
+        _o << "tbb::parallel_for(tbb::blocked_range<size_t>(0, morsels.size()), [&](const tbb::blocked_range<size_t>& morsel_range) {" << std::endl;
+        _o << "    auto& " << table << "_worker = " << table << "_workers.local();" << std::endl;
+        for (size_t p = 0; p < predicates_.size(); p++) {
+            if (predicates_[p].MatchesInColumn()) {
+                _o << "    " << predicates_[p].GenerateMatcher("predicate_" + std::to_string(p) + "_matcher") << std::endl;
+            }
         }
-        _o << "        });" << std::endl;
+        consumer_->BeginTask(_o, this);
+        _o << "    for (size_t m = morsel_range.begin(); m != morsel_range.end(); ++m) {" << std::endl;
+        for (size_t k = 0; k < required_fields_.size(); k++) {
+            auto* field = required_fields_[k];
+            auto type = FieldValueType(field);
+            _o << "    dremel::RecordValueReader<" << type << "> " << FieldVariable(field) << "_reader { "
+               << table_object << ".column<" << type << ">(" << table << "_fields[" << k << "]), morsels[m].begin };" << std::endl;
+        }
+        _o << "    for (size_t i = morsels[m].begin; i != morsels[m].end; ++i) {" << std::endl;
+        for (auto& field : required_fields_) {
+            _o << "        [[maybe_unused]] auto " << FieldVariable(field) << " = [&] { return " << FieldVariable(field) << "_reader.Read(i); };" << std::endl;
+            _o << "        [[maybe_unused]] auto " << FieldVariable(field) << "_rows = [&] { return " << FieldVariable(field) << "_reader.ReadRows(i); };" << std::endl;
+        }
+        if (!predicates_.empty()) {
+            _o << "        if (!(";
+            for (size_t p = 0; p < predicates_.size(); p++) {
+                _o << (p > 0 ? " && " : "");
+                if (predicates_[p].MatchesInColumn()) {
+                    _o << FieldVariable(predicates_[p].field()) << "_reader.Contains(i, predicate_" << p << "_matcher)";
+                } else {
+                    _o << predicates_[p].GenerateCode();
+                }
+            }
+            _o << ")) continue;" << std::endl;
+        }
+        _o << "        [[maybe_unused]] auto record = [&]() -> const " << table << "& {" << std::endl;
+        _o << "            " << table << "_worker.cursor.Seek(i);" << std::endl;
+        _o << "            " << table << "_worker.record.Clear();" << std::endl;
+        _o << "            " << table << "_worker.cursor.AssembleNext(&" << table << "_worker.record);" << std::endl;
+        _o << "            return " << table << "_worker.record;" << std::endl;
+        _o << "        };" << std::endl;
 
         consumer_->Consume(_o, this);
 
+        _o << "    }" << std::endl;
         _o << "    }" << std::endl;
         _o << "});" << std::endl;
+        _o << "}" << std::endl;
     }
 
 }  // namespace imlab
@@ -3,18 +3,96 @@
 // ---------------------------------------------------------------------------
 
 #include <sstream>
+#include "database.h"
+#include "imlab/algebra/aggregation.h"
+#include "imlab/algebra/predicate.h"
 #include "imlab/algebra/table_scan.h"
 #include "imlab/algebra/inner_join.h"
 #include "imlab/algebra/selection.h"
 #include "imlab/algebra/print.h"
+#include "imlab/infra/error.h"
 #include "gtest/gtest.h"
 
 using TableScan = imlab::TableScan;
 using Selection = imlab::Selection;
 using InnerJoin = imlab::InnerJoin;
 using Print = imlab::Print;
+using Predicate = imlab::Predicate;
+using Aggregate = imlab::Aggregate;
+using Aggregation = imlab::Aggregation;
 
 namespace {
+
+const auto* DocId_Field = Document::descriptor()->FindFieldByName("DocId");
+const auto* Name_Url_Field = Document_Name::descriptor()->FindFieldByName("Url");
+
+TEST(PredicateTest, ValueRanges) {
+    std::optional<std::string> lower, upper;
+    ASSERT_TRUE(Predicate(DocId_Field, Predicate::Type::kBetween, "10", "20").GetRange(&lower, &upper));
+    ASSERT_EQ(lower, "10");
+    ASSERT_EQ(upper, "20");
+    ASSERT_TRUE(Predicate(DocId_Field, Predicate::Type::kLess, "10").GetRange(&lower, &upper));
+    ASSERT_EQ(lower, std::nullopt);
+    ASSERT_EQ(upper, "10");
+    ASSERT_FALSE(Predicate(DocId_Field, Predicate::Type::kNotEqual, "10").GetRange(&lower, &upper));
+
+    // A prefix covers all strings up to the prefix with its last character incremented.
+    Predicate like(Name_Url_Field, Predicate::Type::kLike, "http://%");
+    ASSERT_EQ(like.type(), Predicate::Type::kLike);
+    ASSERT_TRUE(like.GetRange(&lower, &upper));
+    ASSERT_EQ(lower, "http://");
+    ASSERT_EQ(upper, "http:/0");
+    // Without wildcards, LIKE is an equality.
+    ASSERT_EQ(Predicate(Name_Url_Field, Predicate::Type::kLike, "http://a").type(), Predicate::Type::kEqual);
+}
+
+TEST(PredicateTest, MatchesInColumn) {
+    ASSERT_TRUE(Predicate(Name_Url_Field, Predicate::Type::kEqual, "http://a").MatchesInColumn());
+    ASSERT_TRUE(Predicate(Name_Url_Field, Predicate::Type::kLike, "http://a").MatchesInColumn());
+    ASSERT_FALSE(Predicate(Name_Url_Field, Predicate::Type::kLike, "http://%").MatchesInColumn());
+    ASSERT_FALSE(Predicate(Name_Url_Field, Predicate::Type::kNotEqual, "http://a").MatchesInColumn());
+    ASSERT_FALSE(Predicate(DocId_Field, Predicate::Type::kEqual, "10").MatchesInColumn());
+}
+
+TEST(PredicateTest, InvalidConstants) {
+    ASSERT_THROW(Predicate(DocId_Field, Predicate::Type::kEqual, "abc"), imlab::QueryCompilationError);
+    ASSERT_THROW(Predicate(DocId_Field, Predicate::Type::kBetween, "1", "x"), imlab::QueryCompilationError);
+    ASSERT_THROW(Predicate(DocId_Field, Predicate::Type::kLike, "1%"), imlab::QueryCompilationError);
+    ASSERT_THROW(Predicate(Name_Url_Field, Predicate::Type::kLike, "%.com"), imlab::QueryCompilationError);
+    ASSERT_THROW(Predicate(Document::descriptor()->FindFieldByName("name"), Predicate::Type::kEqual, "x"),
+                 imlab::QueryCompilationError);
+}
+
+TEST(PredicateTest, SmallestInteger) {
+    // -9223372036854775808ll is the negation of a literal that does not fit into a long long.
+    auto code = Predicate(DocId_Field, Predicate::Type::kGreater, "-9223372036854775808").GenerateCode();
+    ASSERT_NE(code.find("(-9223372036854775807ll - 1)"), std::string::npos) << code;
+    ASSERT_EQ(code.find("9223372036854775808"), std::string::npos) << code;
+}
+
+TEST(AggregationTest, Names) {
+    ASSERT_EQ((Aggregate {Aggregate::Function::kCount, nullptr}).Name(), "COUNT(*)");
+    ASSERT_EQ((Aggregate {Aggregate::Function::kMin, Name_Url_Field}).Name(), "MIN(Name.Url)");
+    ASSERT_EQ((Aggregate {Aggregate::Function::kAvg, DocId_Field}).Name(), "AVG(DocId)");
+}
+
+TEST(AggregationTest, InvalidAggregates) {
+    auto aggregation = [](std::vector<Aggregate> aggregates, bool within_record = false,
+                          std::vector<const google::protobuf::FieldDescriptor*> fields = {}) {
+        return Aggregation(std::make_unique<TableScan>("Document"), std::move(aggregates), within_record, std::move(fields));
+    };
+    ASSERT_NO_THROW(aggregation({{Aggregate::Function::kCount, nullptr}, {Aggregate::Function::kMax, Name_Url_Field}}));
+    ASSERT_NO_THROW(aggregation({{Aggregate::Function::kSum, DocId_Field}}, true, {Name_Url_Field}));
+    ASSERT_THROW(aggregation({{Aggregate::Function::kSum, nullptr}}), imlab::QueryCompilationError);
+    ASSERT_THROW(aggregation({{Aggregate::Function::kAvg, Name_Url_Field}}), imlab::QueryCompilationError);
+    ASSERT_THROW(aggregation({{Aggregate::Function::kCount, Document::descriptor()->FindFieldByName("name")}}),
+                 imlab::QueryCompilationError);
+    // Over all records, the fields are grouped by.
+    ASSERT_NO_THROW(aggregation({{Aggregate::Function::kCount, nullptr}}, false, {Name_Url_Field, DocId_Field}));
+    ASSERT_THROW(aggregation({{Aggregate::Function::kCount, nullptr}}, false, {Document::descriptor()->FindFieldByName("name")}),
+                 imlab::QueryCompilationError);
+}
+
 /*
 TEST(IUPropagation, CollectIUsTableScan) {
     TableScan s("Document");
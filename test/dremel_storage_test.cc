@@ -0,0 +1,1031 @@
+// ---------------------------------------------------------------------------
+// IMLAB
+// ---------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "imlab/infra/binary_file.h"
+#include "imlab/infra/bit_packed_vector.h"
+#include "imlab/infra/buffer.h"
+#include "imlab/infra/compressed_string_arena.h"
+#include "imlab/infra/integer_encoding.h"
+#include "imlab/infra/lz_block.h"
+#include "imlab/infra/string_arena.h"
+#include "imlab/dremel/level_stream.h"
+#include "imlab/dremel/value_store.h"
+#include "imlab/dremel/storage.h"
+#include "imlab/dremel/field_reader.h"
+#include "imlab/dremel/parquet.h"
+#include "../tools/protobuf/gen/schema.pb.h"
+#include "gtest/gtest.h"
+
+namespace {
+using namespace imlab::dremel;
+using BitPackedVector = imlab::BitPackedVector;
+using StringArena = imlab::StringArena;
+using BinaryReader = imlab::BinaryReader;
+using BinaryWriter = imlab::BinaryWriter;
+using MappedFile = imlab::MappedFile;
+using IntegerEncoding = imlab::IntegerEncoding;
+template<typename T> using EncodedIntegers = imlab::EncodedIntegers<T>;
+
+const auto* DocId_Field = Document::descriptor()->FindFieldByName("DocId");
+const auto* Links_Forward_Field = Document_Links::descriptor()->FindFieldByName("Forward");
+const auto* Name_Language_Code_Field = Document_Name_Language::descriptor()->FindFieldByName("Code");
+const auto* Name_Language_Country_Field = Document_Name_Language::descriptor()->FindFieldByName("Country");
+
+// ---------------------------------------------------------------------------
+
+TEST(BitPackedVectorTest, BitWidth) {
+    ASSERT_EQ(imlab::BitWidth(0), 0);
+    ASSERT_EQ(imlab::BitWidth(1), 1);
+    ASSERT_EQ(imlab::BitWidth(2), 2);
+    ASSERT_EQ(imlab::BitWidth(3), 2);
+    ASSERT_EQ(imlab::BitWidth(4), 3);
+    ASSERT_EQ(imlab::BitWidth(~0ull), 64);
+}
+
+TEST(BitPackedVectorTest, RoundtripAllWidths) {
+    for (unsigned width = 0; width <= 64; width++) {
+        BitPackedVector v(width);
+        const uint64_t mask = (width == 64) ? ~0ull : (1ull << width) - 1;
+        for (uint64_t i = 0; i < 1000; i++) {
+            v.push_back((i * 0x9e3779b97f4a7c15ull) & mask);
+        }
+        ASSERT_EQ(v.size(), 1000);
+        for (uint64_t i = 0; i < 1000; i++) {
+            ASSERT_EQ(v[i], (i * 0x9e3779b97f4a7c15ull) & mask) << "width " << width << ", index " << i;
+        }
+    }
+}
+
+TEST(BitPackedVectorTest, ZeroWidthAllocatesNothing) {
+    BitPackedVector v(0);
+    for (unsigned i = 0; i < 1000; i++) {
+        v.push_back(0);
+    }
+    ASSERT_EQ(v.size(), 1000);
+    ASSERT_EQ(v[999], 0);
+    ASSERT_EQ(v.memory_usage(), 0);
+}
+
+// ---------------------------------------------------------------------------
+
+// Levels with long runs of equal values, interrupted by short noisy stretches.
+std::vector<unsigned> MixedLevels(unsigned max_level) {
+    std::vector<unsigned> levels;
+    for (unsigned i = 0; i < 5000; i++) {
+        if ((i / 100) % 2 == 0) {
+            levels.push_back(max_level);
+        } else {
+            levels.push_back((i * 7 + i / 3) % (max_level + 1));
+        }
+    }
+    return levels;
+}
+
+TEST(LevelStreamTest, Roundtrip) {
+    for (unsigned max_level = 0; max_level <= 5; max_level++) {
+        LevelStream stream(max_level);
+        auto levels = MixedLevels(max_level);
+        for (auto level : levels) {
+            stream.push_back(level);
+        }
+        ASSERT_EQ(stream.size(), levels.size());
+        auto cursor = stream.cursor(0);
+        for (uint64_t i = 0; i < levels.size(); i++) {
+            ASSERT_EQ(stream[i], levels[i]) << "max level " << max_level << ", index " << i;
+            ASSERT_EQ(cursor.Get(), levels[i]) << "max level " << max_level << ", index " << i;
+            cursor.Next();
+        }
+        ASSERT_TRUE(cursor.at_end());
+    }
+}
+
+TEST(LevelStreamTest, RunsAreRunLengthEncoded) {
+    LevelStream stream(3);
+    for (unsigned i = 0; i < 100000; i++) {
+        stream.push_back(3);
+    }
+    ASSERT_EQ(stream.runs().size(), 1);
+    ASSERT_FALSE(stream.runs()[0].bit_packed);
+    ASSERT_LE(stream.memory_usage(), 1024);
+
+    // Short sequences of equal levels stay bit-packed.
+    LevelStream alternating(1);
+    for (unsigned i = 0; i < 1000; i++) {
+        alternating.push_back((i / 4) % 2);
+    }
+    ASSERT_EQ(alternating.runs().size(), 1);
+    ASSERT_TRUE(alternating.runs()[0].bit_packed);
+
+    // The runs are written as they are, so no uninitialized bytes may end up in the files.
+    LevelStream mixed(4);
+    for (auto level : MixedLevels(4)) {
+        mixed.push_back(level);
+    }
+    for (const auto& run : mixed.runs()) {
+        ASSERT_EQ(std::count(std::begin(run.padding), std::end(run.padding), 0), sizeof(run.padding));
+    }
+}
+
+TEST(LevelStreamTest, BulkOperations) {
+    LevelStream stream(2);
+    auto levels = MixedLevels(2);
+    for (auto level : levels) {
+        stream.push_back(level);
+    }
+
+    // Decode all levels in chunks that don't align with the runs.
+    std::vector<uint8_t> buffer(levels.size() + 100);
+    auto cursor = stream.cursor(0);
+    uint64_t decoded = 0;
+    while (!cursor.at_end()) {
+        decoded += cursor.Decode(buffer.data() + decoded, 37);
+    }
+    ASSERT_EQ(decoded, levels.size());
+    for (uint64_t i = 0; i < levels.size(); i++) {
+        ASSERT_EQ(buffer[i], levels[i]);
+    }
+
+    // Count and skip from arbitrary positions.
+    for (uint64_t begin = 0; begin < levels.size(); begin += 97) {
+        for (uint64_t n : { 0, 1, 50, 333, 5000 }) {
+            auto count_cursor = stream.cursor(begin);
+            uint64_t expected = 0;
+            for (uint64_t i = begin; i < std::min<uint64_t>(begin + n, levels.size()); i++) {
+                expected += (levels[i] == 2);
+            }
+            ASSERT_EQ(count_cursor.Count(2, n), expected);
+            ASSERT_EQ(count_cursor.position(), std::min<uint64_t>(begin + n, levels.size()));
+
+            auto skip_cursor = stream.cursor(begin);
+            uint64_t position = begin;
+            for (uint64_t seen = 0; position < levels.size(); position++) {
+                if (levels[position] == 0 && seen++ == n) {
+                    break;
+                }
+            }
+            ASSERT_EQ(skip_cursor.SkipToOccurrence(0, n), position - begin);
+            ASSERT_EQ(skip_cursor.position(), position);
+        }
+    }
+}
+
+TEST(LevelStreamTest, DecodeMask) {
+    LevelStream stream(2);
+    auto levels = MixedLevels(2);
+    for (auto level : levels) {
+        stream.push_back(level);
+    }
+
+    // Decode into masks in chunks that neither align with the runs nor with the mask words.
+    for (unsigned level = 0; level <= 2; level++) {
+        std::vector<uint64_t> masks((levels.size() + 5 + 63) / 64, 0);
+        auto cursor = stream.cursor(0);
+        uint64_t decoded = 0;
+        while (!cursor.at_end()) {
+            decoded += cursor.DecodeMask(level, 37, masks.data(), 5 + decoded);
+        }
+        ASSERT_EQ(decoded, levels.size());
+        ASSERT_EQ(masks[0] & 0x1F, 0);
+        for (uint64_t i = 0; i < levels.size(); i++) {
+            ASSERT_EQ((masks[(i + 5) / 64] >> ((i + 5) % 64)) & 1, levels[i] == level) << i;
+        }
+    }
+
+    // Without stored levels, every level is 0.
+    LevelStream zeros(0);
+    for (unsigned i = 0; i < 100; i++) {
+        zeros.push_back(0);
+    }
+    std::vector<uint64_t> masks(2, 0);
+    ASSERT_EQ(zeros.cursor(10).DecodeMask(0, 1000, masks.data()), 90);
+    ASSERT_EQ(masks[0], ~0ull);
+    ASSERT_EQ(masks[1], (1ull << 26) - 1);
+}
+
+TEST(SimdTest, Masks) {
+    std::vector<uint8_t> bytes(64 * 10);
+    for (uint64_t i = 0; i < bytes.size(); i++) {
+        bytes[i] = (i * 7 + i / 5) % 4;
+    }
+    for (uint64_t begin = 0; begin < bytes.size() - 64; begin += 13) {
+        for (uint8_t value = 0; value < 4; value++) {
+            uint64_t expected = 0;
+            for (unsigned i = 0; i < 64; i++) {
+                expected |= static_cast<uint64_t>(bytes[begin + i] == value) << i;
+            }
+            ASSERT_EQ(imlab::EqualMask64(bytes.data() + begin, value), expected);
+            ASSERT_EQ(imlab::EqualMask(bytes.data() + begin, 20, value), expected & imlab::LowBits(20));
+        }
+    }
+
+    uint64_t mask = 0x8000000100000F01ull;
+    ASSERT_EQ(imlab::NthSetBit(mask, 0), 0);
+    ASSERT_EQ(imlab::NthSetBit(mask, 1), 8);
+    ASSERT_EQ(imlab::NthSetBit(mask, 4), 11);
+    ASSERT_EQ(imlab::NthSetBit(mask, 6), 63);
+    uint64_t masks[2] = { mask, mask };
+    ASSERT_EQ(imlab::CountSetBits(masks, 0, 128), 14);
+    ASSERT_EQ(imlab::CountSetBits(masks, 8, 56), 6);
+    ASSERT_EQ(imlab::CountSetBits(masks, 63, 2), 2);
+}
+
+// ---------------------------------------------------------------------------
+
+TEST(DremelColumnTest, NullsAreNotStored) {
+    DremelColumn<std::string> column { Name_Language_Country_Field };
+    ASSERT_EQ(column.max_repetition_level(), 2);
+    ASSERT_EQ(column.max_definition_level(), 3);
+
+    for (unsigned i = 0; i < 1000; i++) {
+        if (i % 3 == 0) {
+            column.insert({ std::to_string(i), i % 3, 3 });
+        } else {
+            column.insert({ std::nullopt, i % 3, i % 3 });
+        }
+    }
+
+    ASSERT_EQ(column.size(), 1000);
+    for (unsigned i = 0; i < 1000; i++) {
+        if (i % 3 == 0) {
+            ASSERT_EQ(column.get(i), (DremelRow<std::string>{ std::to_string(i), i % 3, 3 }));
+        } else {
+            ASSERT_EQ(column.get(i), (DremelRow<std::string>{ std::nullopt, i % 3, i % 3 }));
+        }
+        ASSERT_EQ(column.value_index(i), (i + 2) / 3);
+    }
+}
+
+TEST(DremelColumnTest, RequiredFieldHasNoLevels) {
+    DremelColumn<int64_t> column { DocId_Field };
+    for (int64_t i = 0; i < 1000; i++) {
+        column.insert({ i, 0, 0 });
+    }
+    // Only the (over-allocated) value vector of the single segment needs memory; there are no levels and no NULLs.
+    ASSERT_EQ(column.segment_count(), 1);
+    ASSERT_LE(column.memory_usage(), sizeof(ColumnSegment<int64_t>) + 1024 * sizeof(int64_t));
+    ASSERT_EQ(column.get(500), (DremelRow<int64_t>{ 500, 0, 0 }));
+}
+
+TEST(DremelColumnTest, ReaderTracksValueIndex) {
+    DremelColumn<int64_t> column { Links_Forward_Field };
+    for (int64_t i = 0; i < 200; i++) {
+        if (i % 5 == 0) {
+            column.insert({ std::nullopt, 0, 1 });
+        } else {
+            column.insert({ i, 1, 2 });
+        }
+    }
+
+    // Start reading somewhere in the middle of a checkpoint interval.
+    FieldReader<int64_t> reader { &column, 101 };
+    for (int64_t i = 101; i < 200; i++) {
+        auto value = reader.ReadNext();
+        ASSERT_EQ(value.index(), i);
+        ASSERT_EQ(value.is_null(), i % 5 == 0);
+        if (!value.is_null()) {
+            ASSERT_EQ(column.value(value.value_index()), i);
+        }
+    }
+    ASSERT_TRUE(reader.Peek().is_null());
+}
+
+TEST(DremelColumnTest, ReaderSkipsRecords) {
+    // Record i has (i % 4) forward links; records without links have a single NULL row.
+    DremelColumn<int64_t> column { Links_Forward_Field };
+    std::vector<uint64_t> record_starts;
+    for (int64_t i = 0; i < 1000; i++) {
+        record_starts.push_back(column.size());
+        if (i % 4 == 0) {
+            column.insert({ std::nullopt, 0, 1 });
+        }
+        for (int64_t j = 0; j < i % 4; j++) {
+            column.insert({ i * 10 + j, j == 0 ? 0u : 1u, 2 });
+        }
+    }
+
+    FieldReader<int64_t> reader { &column, 0 };
+    reader.SkipRecords(0);
+    ASSERT_EQ(reader.Peek().index(), 0);
+    uint64_t record = 0;
+    for (uint64_t n : { 1, 2, 3, 10, 100, 7 }) {
+        reader.SkipRecords(n);
+        record += n;
+        auto value = reader.Peek();
+        ASSERT_EQ(value.index(), record_starts[record]);
+        ASSERT_EQ(value.repetition_level(), 0);
+        if (record % 4 == 0) {
+            ASSERT_TRUE(value.is_null());
+        } else {
+            ASSERT_EQ(column.value(value.value_index()), record * 10);
+        }
+    }
+
+    // Skipping rows and decoding levels in bulk keeps the value index intact.
+    reader.SkipRows(123);
+    std::vector<uint8_t> r(64), d(64);
+    ASSERT_EQ(reader.ReadLevels(64, r.data(), d.data()), 64);
+    auto value = reader.Peek();
+    ASSERT_EQ(value.value_index(), column.value_index(value.index()));
+
+    reader.SkipRecords(10000);
+    ASSERT_TRUE(reader.Peek().is_null());
+    ASSERT_EQ(reader.Peek().index(), column.size());
+}
+
+TEST(DremelColumnTest, ReaderDecodesMasks) {
+    // Small segments, so that the masks of one call span several segments.
+    DremelColumn<int64_t> column { Links_Forward_Field, 64 };
+    for (int64_t i = 0; i < 1000; i++) {
+        if (i % 4 == 0) {
+            column.insert({ std::nullopt, 0, i % 8 == 0 ? 0u : 1u });
+        }
+        for (int64_t j = 0; j < i % 4; j++) {
+            column.insert({ i * 10 + j, j == 0 ? 0u : 1u, 2 });
+        }
+    }
+
+    FieldReader<int64_t> level_reader { &column, 37 };
+    FieldReader<int64_t> mask_reader { &column, 37 };
+    std::vector<uint8_t> r(300), d(300);
+    std::vector<uint64_t> record_starts(5), present(5);
+    for (uint64_t rows = 300; rows == 300;) {
+        rows = level_reader.ReadLevels(300, r.data(), d.data());
+        ASSERT_EQ(mask_reader.ReadMasks(300, record_starts.data(), present.data()), rows);
+        for (uint64_t i = 0; i < 300; i++) {
+            ASSERT_EQ((record_starts[i / 64] >> (i % 64)) & 1, i < rows && r[i] == 0);
+            ASSERT_EQ((present[i / 64] >> (i % 64)) & 1, i < rows && d[i] == 2);
+        }
+        ASSERT_EQ(mask_reader.Peek().index(), level_reader.Peek().index());
+        ASSERT_EQ(mask_reader.Peek().value_index(), level_reader.Peek().value_index());
+    }
+    ASSERT_EQ(mask_reader.Peek().index(), column.size());
+}
+
+TEST(DremelColumnTest, RecordValueReaderSkipsAcrossMasks) {
+    // Records of up to 150 rows in small segments, so that records span several masks and segments.
+    DremelColumn<int64_t> column { Links_Forward_Field, 64 };
+    std::vector<std::vector<std::optional<int64_t>>> records {};
+    for (int64_t i = 0; i < 500; i++) {
+        auto& record = records.emplace_back();
+        if (i % 5 == 0) {
+            column.insert({ std::nullopt, 0, i % 10 == 0 ? 0u : 1u });
+            record.push_back(std::nullopt);
+        }
+        for (int64_t j = 0; j < (i * 7) % 150 && i % 5 != 0; j++) {
+            column.insert({ i * 1000 + j, j == 0 ? 0u : 1u, 2 });
+            record.push_back(i * 1000 + j);
+        }
+    }
+
+    // Gaps between the records that are read range from none to several masks.
+    RecordValueReader<int64_t> reader { column, 3 };
+    for (uint64_t i = 3; i < records.size(); i += 1 + (i * i) % 23) {
+        auto rows = reader.ReadRows(i);
+        ASSERT_EQ(rows.size(), records[i].size()) << i;
+        for (size_t row = 0; row < rows.size(); row++) {
+            ASSERT_EQ(rows.Get(row), records[i][row]) << i;
+            ASSERT_EQ(rows.repetition_levels()[row], row == 0 ? 0u : 1u) << i;
+        }
+        ASSERT_EQ(reader.Read(i).size(), records[i].size() - (i % 5 == 0)) << i;
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+TEST(StringArenaTest, Roundtrip) {
+    StringArena arena;
+    uint64_t bytes = 0;
+    for (unsigned i = 0; i < 1000; i++) {
+        arena.push_back(std::string(i % 50, 'a' + i % 26));
+        bytes += i % 50;
+    }
+    arena.push_back("");
+    ASSERT_EQ(arena.size(), 1001);
+    ASSERT_EQ(arena.byte_size(), bytes);
+    for (unsigned i = 0; i < 1000; i++) {
+        ASSERT_EQ(arena[i], std::string(i % 50, 'a' + i % 26));
+    }
+    ASSERT_TRUE(arena[1000].empty());
+
+    arena.clear();
+    ASSERT_EQ(arena.size(), 0);
+    ASSERT_EQ(arena.byte_size(), 0);
+}
+
+// Every encoding returns the same values through random access and batch decoding.
+template<typename T>
+void ExpectEncoding(const std::vector<T>& values, IntegerEncoding encoding) {
+    auto encoded = EncodedIntegers<T>::Encode(values.data(), values.size());
+    ASSERT_EQ(encoded.encoding(), encoding);
+    ASSERT_EQ(encoded.size(), values.size());
+    for (uint64_t i = 0; i < values.size(); i++) {
+        ASSERT_EQ(encoded[i], values[i]) << i;
+    }
+    for (uint64_t first : { 0ul, 1ul, 63ul, 64ul, 100ul }) {
+        if (first > values.size()) {
+            continue;
+        }
+        std::vector<T> decoded(values.size() - first);
+        encoded.decode(first, decoded.size(), decoded.data());
+        ASSERT_TRUE(std::equal(decoded.begin(), decoded.end(), values.begin() + first)) << first;
+    }
+}
+
+TEST(IntegerEncodingTest, ChoosesCheapestEncoding) {
+    std::mt19937_64 random(42);
+    std::vector<int64_t> ids, small, wide, negative;
+    for (int64_t i = 0; i < 1000; i++) {
+        ids.push_back(1000000 + 3 * i + (i % 2));
+        small.push_back(5000 + random() % 1000);
+        wide.push_back(static_cast<int64_t>(random()));
+        negative.push_back(-static_cast<int64_t>(random() % 100));
+    }
+    wide.push_back(std::numeric_limits<int64_t>::min());
+    wide.push_back(std::numeric_limits<int64_t>::max());
+    ASSERT_NO_FATAL_FAILURE(ExpectEncoding(ids, IntegerEncoding::kDelta));
+    ASSERT_NO_FATAL_FAILURE(ExpectEncoding(small, IntegerEncoding::kFrameOfReference));
+    ASSERT_NO_FATAL_FAILURE(ExpectEncoding(negative, IntegerEncoding::kFrameOfReference));
+    ASSERT_NO_FATAL_FAILURE(ExpectEncoding(wide, IntegerEncoding::kPlain));
+    ASSERT_NO_FATAL_FAILURE(ExpectEncoding(std::vector<uint32_t>(200, 7u), IntegerEncoding::kFrameOfReference));
+    ASSERT_NO_FATAL_FAILURE(ExpectEncoding(std::vector<uint64_t>{ 0, std::numeric_limits<uint64_t>::max() },
+                                           IntegerEncoding::kPlain));
+
+    auto encoded = EncodedIntegers<int64_t>::Encode(small.data(), small.size());
+    ASSERT_EQ(encoded.bit_width(), 10);
+    ASSERT_LT(encoded.memory_usage(), small.size() * 2);
+}
+
+TEST(LzBlockTest, Roundtrip) {
+    std::mt19937 random(42);
+    std::string urls, noise, run(10000, 'x'), empty, short_string("short");
+    for (unsigned i = 0; i < 500; i++) {
+        urls += "http://www.example.com/" + std::to_string(random() % 100);
+        noise.push_back(static_cast<char>(random()));
+    }
+    for (const std::string* data : { &urls, &noise, &run, &empty, &short_string }) {
+        std::string compressed;
+        imlab::lz::Compress(data->data(), data->size(), &compressed);
+        std::string decompressed(data->size(), '\0');
+        imlab::lz::Decompress(compressed.data(), compressed.size(), decompressed.data(), decompressed.size());
+        ASSERT_EQ(decompressed, *data);
+        // Repetitive data shrinks a lot.
+        if (data == &urls || data == &run) {
+            ASSERT_LT(compressed.size(), data->size() / 4);
+        }
+    }
+
+    // Malformed blocks are rejected.
+    std::string compressed;
+    imlab::lz::Compress(urls.data(), urls.size(), &compressed);
+    std::string decompressed(urls.size(), '\0');
+    ASSERT_THROW(imlab::lz::Decompress(compressed.data(), compressed.size() / 2, decompressed.data(), decompressed.size()),
+                 imlab::FileFormatError);
+    ASSERT_THROW(imlab::lz::Decompress(compressed.data(), compressed.size(), decompressed.data(), decompressed.size() - 1),
+                 imlab::FileFormatError);
+}
+
+TEST(CompressedStringArenaTest, Roundtrip) {
+    StringArena arena;
+    for (unsigned i = 0; i < 1000; i++) {
+        arena.push_back(i % 10 == 0 ? "" : "http://www.example.com/" + std::to_string(i));
+    }
+    imlab::CompressedStringArena compressed { arena };
+    ASSERT_EQ(compressed.size(), arena.size());
+    ASSERT_LT(compressed.memory_usage(), arena.memory_usage() / 2);
+    // Strings can be read in any order, also from other blocks.
+    for (unsigned i = 0; i < 1000; i++) {
+        ASSERT_EQ(compressed[i], arena[i]);
+        ASSERT_EQ(compressed[999 - i], arena[999 - i]);
+    }
+}
+
+TEST(ValueStoreTest, SealedIntegersAreEncoded) {
+    ValueStore<int64_t> store;
+    for (int64_t i = 0; i < 10000; i++) {
+        store.push_back(i * 2);
+    }
+    ASSERT_EQ(store.encoding(), IntegerEncoding::kPlain);
+    uint64_t plain_memory = store.memory_usage();
+    store.seal();
+    ASSERT_EQ(store.encoding(), IntegerEncoding::kDelta);
+    ASSERT_LT(store.memory_usage() * 8, plain_memory);
+    ASSERT_EQ(store.size(), 10000);
+    std::vector<int64_t> decoded(100);
+    store.decode(5000, 100, decoded.data());
+    for (int64_t i = 0; i < 100; i++) {
+        ASSERT_EQ(store[5000 + i], (5000 + i) * 2);
+        ASSERT_EQ(decoded[i], (5000 + i) * 2);
+    }
+}
+
+TEST(ValueStoreTest, SealedPlainStringsAreCompressed) {
+    ValueStore<std::string> store;
+    for (unsigned i = 0; i < 10000; i++) {
+        store.push_back("http://www.example.com/" + std::to_string(i));
+    }
+    ASSERT_FALSE(store.dictionary_encoded());
+    uint64_t plain_memory = store.memory_usage();
+    store.seal();
+    ASSERT_TRUE(store.compressed());
+    ASSERT_LT(store.memory_usage() * 2, plain_memory);
+    ASSERT_EQ(store.size(), 10000);
+    for (unsigned i = 0; i < 10000; i++) {
+        ASSERT_EQ(store[i], "http://www.example.com/" + std::to_string(i));
+    }
+
+    // Dictionary-encoded strings are left alone.
+    ValueStore<std::string> codes;
+    codes.push_back("en-us");
+    codes.seal();
+    ASSERT_TRUE(codes.dictionary_encoded());
+    ASSERT_FALSE(codes.compressed());
+}
+
+TEST(ValueStoreTest, LowCardinalityStringsAreDictionaryEncoded) {
+    const char* codes[] = { "en-us", "en-gb", "de-de" };
+    ValueStore<std::string> store;
+    for (unsigned i = 0; i < 10000; i++) {
+        store.push_back(codes[i % 3]);
+    }
+    ASSERT_TRUE(store.dictionary_encoded());
+    ASSERT_EQ(store.dictionary_size(), 3);
+    ASSERT_EQ(store.size(), 10000);
+    for (unsigned i = 0; i < 10000; i++) {
+        ASSERT_EQ(store[i], codes[i % 3]);
+        ASSERT_EQ(store.decode(store.code(i)), codes[i % 3]);
+    }
+    // Two bits per value, far less than one std::string per value.
+    ASSERT_LT(store.memory_usage(), 10000 / 2);
+    ASSERT_FALSE(store.lookup("fr-fr").has_value());
+}
+
+TEST(ValueStoreTest, CodesGrowWithDictionary) {
+    ValueStore<std::string> store;
+    for (unsigned i = 0; i < 20000; i++) {
+        store.push_back(std::to_string(i / 4 % 1000));
+    }
+    ASSERT_TRUE(store.dictionary_encoded());
+    ASSERT_EQ(store.dictionary_size(), 1000);
+    for (unsigned i = 0; i < 20000; i++) {
+        ASSERT_EQ(store[i], std::to_string(i / 4 % 1000));
+    }
+}
+
+TEST(ValueStoreTest, HighCardinalityStringsAreStoredPlain) {
+    ValueStore<std::string> store;
+    for (unsigned i = 0; i < 10000; i++) {
+        store.push_back("http://" + std::to_string(i));
+    }
+    ASSERT_FALSE(store.dictionary_encoded());
+    ASSERT_EQ(store.size(), 10000);
+    uint64_t bytes = 0;
+    for (unsigned i = 0; i < 10000; i++) {
+        ASSERT_EQ(store[i], "http://" + std::to_string(i));
+        bytes += store[i].size();
+    }
+    // Offsets plus the bytes of the strings (with some slack for over-allocation), but no std::string objects.
+    ASSERT_LE(store.memory_usage(), 2 * (bytes + 10000 * sizeof(uint64_t)));
+}
+
+TEST(ValueStoreTest, EqualityMatcher) {
+    for (unsigned distinct : { 3, 100000 }) {
+        ValueStore<std::string> store;
+        for (unsigned i = 0; i < 10000; i++) {
+            store.push_back(std::to_string(i % distinct));
+        }
+        ASSERT_EQ(store.dictionary_encoded(), distinct == 3);
+
+        EqualityMatcher<std::string> matcher { store, "2" };
+        EqualityMatcher<std::string> no_match { store, "unknown" };
+        for (unsigned i = 0; i < 10000; i++) {
+            ASSERT_EQ(matcher.matches(i), i % distinct == 2);
+            ASSERT_FALSE(no_match.matches(i));
+        }
+    }
+}
+
+TEST(DremelColumnTest, RecordValueReaderMatchesInColumn) {
+    // The first segments are dictionary-encoded, the later ones with a new string in most rows are plain.
+    DremelColumn<std::string> column { Name_Language_Code_Field, 512 };
+    for (unsigned i = 0; i < 1000; i++) {
+        std::string code = i < 500 ? ((i % 3 == 0) ? "en-us" : "en-gb") : (i % 3 == 0) ? "en-us" : std::to_string(i);
+        column.insert({ code, 0, 2 });
+        column.insert({ std::nullopt, 1, 1 });
+    }
+    ASSERT_TRUE(column.segment(0).values().dictionary_encoded());
+    ASSERT_FALSE(column.segment(column.segment_count() - 1).values().dictionary_encoded());
+
+    ColumnMatcher<std::string> en_us { "en-us" };
+    ColumnMatcher<std::string> unknown { "unknown" };
+    RecordValueReader<std::string> reader { column, 0 };
+    for (unsigned i = 0; i < 1000; i += 1 + i % 2) {
+        ASSERT_EQ(reader.Contains(i, en_us), i % 3 == 0) << i;
+        ASSERT_FALSE(reader.Contains(i, unknown)) << i;
+        // The record can still be read, and checked again once it is read.
+        if (i % 4 == 0) {
+            ASSERT_EQ(reader.Read(i).size(), 1);
+            ASSERT_EQ(reader.Contains(i, en_us), i % 3 == 0) << i;
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+TEST(DremelColumnTest, SegmentsHaveFixedSize) {
+    DremelColumn<int64_t> column { Links_Forward_Field, 64 };
+    std::vector<const ColumnSegment<int64_t>*> segments;
+    for (int64_t i = 0; i < 1000; i++) {
+        column.insert({ i, (i % 3 == 0) ? 0u : 1u, 2 });
+        if (column.segment_count() > segments.size()) {
+            segments.push_back(&column.segment(column.segment_count() - 1));
+        }
+    }
+    ASSERT_EQ(column.segment_count(), (1000 + 63) / 64);
+    for (uint64_t i = 0; i < column.segment_count(); i++) {
+        // Segments never move once they are created.
+        ASSERT_EQ(&column.segment(i), segments[i]);
+        ASSERT_EQ(column.segment(i).first_tid(), i * 64);
+        ASSERT_EQ(column.segment(i).first_record(), (i * 64 + 2) / 3);
+        ASSERT_EQ(column.segment(i).sealed(), i + 1 < column.segment_count());
+    }
+    ASSERT_EQ(column.segment(0).size(), 64);
+    ASSERT_EQ(column.segment(column.segment_count() - 1).size(), 1000 % 64);
+    for (int64_t i = 0; i < 1000; i++) {
+        ASSERT_EQ(column.get(i), (DremelRow<int64_t>{ i, (i % 3 == 0) ? 0u : 1u, 2 }));
+    }
+}
+
+TEST(DremelColumnTest, ReaderCrossesSegments) {
+    // Same layout as in ReaderSkipsRecords, but with tiny segments.
+    DremelColumn<int64_t> column { Links_Forward_Field, 16 };
+    std::vector<uint64_t> record_starts;
+    for (int64_t i = 0; i < 1000; i++) {
+        record_starts.push_back(column.size());
+        if (i % 4 == 0) {
+            column.insert({ std::nullopt, 0, 1 });
+        }
+        for (int64_t j = 0; j < i % 4; j++) {
+            column.insert({ i * 10 + j, j == 0 ? 0u : 1u, 2 });
+        }
+    }
+
+    // Read everything sequentially, starting in the middle of a segment.
+    FieldReader<int64_t> reader { &column, 5 };
+    for (TID tid = 5; tid < column.size(); tid++) {
+        auto value = reader.ReadNext();
+        ASSERT_EQ(value.index(), tid);
+        ASSERT_EQ(value.value_index(), column.value_index(tid));
+        auto row = column.get(tid);
+        ASSERT_EQ(value.repetition_level(), row.repetition_level);
+        ASSERT_EQ(value.definition_level(), row.definition_level);
+        if (!value.is_null()) {
+            ASSERT_EQ(column.value(value.value_index()), *row.value);
+        }
+    }
+    ASSERT_TRUE(reader.Peek().is_null());
+
+    // Skip records across segment boundaries.
+    FieldReader<int64_t> skipping_reader { &column, 0 };
+    uint64_t record = 0;
+    for (uint64_t n : { 1, 2, 3, 10, 100, 7, 1, 1, 50 }) {
+        skipping_reader.SkipRecords(n);
+        record += n;
+        auto value = skipping_reader.Peek();
+        ASSERT_EQ(value.index(), record_starts[record]);
+        ASSERT_EQ(value.value_index(), column.value_index(value.index()));
+    }
+
+    // Decode levels across segment boundaries.
+    FieldReader<int64_t> level_reader { &column, 3 };
+    std::vector<uint8_t> r(column.size()), d(column.size());
+    ASSERT_EQ(level_reader.ReadLevels(column.size(), r.data(), d.data()), column.size() - 3);
+    for (TID tid = 3; tid < column.size(); tid++) {
+        ASSERT_EQ(r[tid - 3], column.repetition_level(tid));
+        ASSERT_EQ(d[tid - 3], column.definition_level(tid));
+    }
+    ASSERT_TRUE(level_reader.Peek().is_null());
+}
+
+TEST(DremelColumnTest, ZoneMaps) {
+    // Record i has the forward links 10 * i, 10 * i + 1 and 10 * i + 2, except for every 5th record which has none.
+    DremelColumn<int64_t> column { Links_Forward_Field, 16 };
+    for (int64_t i = 0; i < 100; i++) {
+        if (i % 5 == 0) {
+            column.insert({ std::nullopt, 0, 1 });
+            continue;
+        }
+        for (int64_t j = 0; j < 3; j++) {
+            column.insert({ 10 * i + j, j == 0 ? 0u : 1u, 2 });
+        }
+    }
+
+    // The second segment starts with the rows 16 to 31, i.e. in the middle of record 6.
+    auto& zone_map = column.segment(1).zone_map();
+    ASSERT_EQ(*zone_map.min, 62);
+    ASSERT_EQ(*zone_map.max, 121);
+    ASSERT_EQ(zone_map.null_count, 1);
+    ASSERT_EQ(zone_map.max_repetition_level, 1);
+    ASSERT_EQ(zone_map.first_record, 6);
+    ASSERT_EQ(zone_map.end_record, 13);
+
+    ASSERT_EQ(column.candidate_records(100, 100), (std::vector<RecordRange>{ { 6, 13 } }));
+    ASSERT_EQ(column.candidate_records(std::nullopt, 61), (std::vector<RecordRange>{ { 0, 7 } }));
+    ASSERT_EQ(column.candidate_records(5, 10), (std::vector<RecordRange>{ { 0, 7 } }));
+    ASSERT_EQ(column.candidate_records(5, 9), (std::vector<RecordRange>{}));
+    ASSERT_EQ(column.candidate_records(1000, std::nullopt), (std::vector<RecordRange>{}));
+    ASSERT_EQ(column.candidate_records(std::nullopt, std::nullopt), (std::vector<RecordRange>{ { 0, 100 } }));
+}
+
+TEST(DremelColumnTest, AppendColumn) {
+    // Appending fragments with a different segment size must give the same column as inserting all rows.
+    DremelColumn<std::string> expected { Name_Language_Code_Field, 16 };
+    DremelColumn<std::string> column { Name_Language_Code_Field, 16 };
+    for (int64_t fragment = 0; fragment < 5; fragment++) {
+        DremelColumn<std::string> rows { Name_Language_Code_Field, 64 };
+        for (int64_t i = 0; i < 37 * fragment; i++) {
+            DremelRow<std::string> row { std::nullopt, static_cast<unsigned>(i % 7 == 0 ? 0 : 1 + i % 2), static_cast<unsigned>(i % 3) };
+            if (row.definition_level == 2) {
+                row.value = std::to_string(i % 11);
+            }
+            expected.insert(row);
+            rows.insert(row);
+        }
+        column.append(rows);
+    }
+
+    ASSERT_EQ(column.size(), expected.size());
+    ASSERT_EQ(column.record_count(), expected.record_count());
+    ASSERT_EQ(column.segment_count(), expected.segment_count());
+    for (TID tid = 0; tid < expected.size(); tid++) {
+        ASSERT_EQ(column.get(tid), expected.get(tid)) << tid;
+    }
+    for (uint64_t record = 0; record < expected.record_count(); record++) {
+        ASSERT_EQ(column.record_start(record), expected.record_start(record)) << record;
+    }
+    for (uint64_t segment = 0; segment < expected.segment_count(); segment++) {
+        ASSERT_EQ(column.segment(segment).zone_map().first_record, expected.segment(segment).zone_map().first_record);
+        ASSERT_EQ(column.segment(segment).zone_map().end_record, expected.segment(segment).zone_map().end_record);
+    }
+}
+
+TEST(DremelColumnTest, AppendSegments) {
+    // Fragments with the same segment size are moved segment by segment behind the last segment.
+    DremelColumn<int64_t> expected { Links_Forward_Field, 16 };
+    DremelColumn<int64_t> column { Links_Forward_Field, 16 };
+    int64_t i = 0;
+    for (uint64_t fragment_size : { 5, 40, 3, 70, 16, 9 }) {
+        DremelColumn<int64_t> fragment { Links_Forward_Field, 16 };
+        while (fragment.size() < fragment_size) {
+            DremelRow<int64_t> row { i, i % 3 == 0 ? 0u : 1u, 2 };
+            if (fragment.size() == 0) {
+                row.repetition_level = 0;
+            }
+            if (i % 7 == 0) {
+                row = { std::nullopt, row.repetition_level, 1 };
+            }
+            expected.insert(row);
+            fragment.insert(row);
+            i++;
+        }
+        std::vector<const ColumnSegment<int64_t>*> sealed;
+        for (uint64_t s = 0; s + 1 < fragment.segment_count(); s++) {
+            sealed.push_back(&fragment.segment(s));
+        }
+        uint64_t segments = column.segment_count();
+        column.append(fragment);
+        ASSERT_EQ(fragment.size(), 0);
+        for (uint64_t s = 0; s < sealed.size(); s++) {
+            ASSERT_EQ(&column.segment(column.segment_count() - 1 - sealed.size() + s), sealed[s]);
+        }
+        // Only a fragment that fits into the last segment is inserted again.
+        if (segments > 0 && fragment_size <= 5) {
+            ASSERT_EQ(column.segment_count(), segments);
+        }
+    }
+    column.insert({ 1000, 0, 2 });
+    expected.insert({ 1000, 0, 2 });
+
+    ASSERT_EQ(column.size(), expected.size());
+    ASSERT_EQ(column.record_count(), expected.record_count());
+    for (TID tid = 0; tid < expected.size(); tid++) {
+        ASSERT_EQ(column.get(tid), expected.get(tid)) << tid;
+        ASSERT_EQ(column.value_index(tid), expected.value_index(tid)) << tid;
+    }
+    for (uint64_t record = 0; record < expected.record_count(); record++) {
+        ASSERT_EQ(column.record_start(record), expected.record_start(record)) << record;
+    }
+    for (uint64_t v = 0; v < column.value_index(column.size()); v++) {
+        ASSERT_EQ(column.value(v), expected.value(v));
+    }
+    // The zone maps of moved segments cover the records at their new position.
+    for (uint64_t s = 0; s < column.segment_count(); s++) {
+        auto& segment = column.segment(s);
+        ASSERT_EQ(segment.zone_map().end_record, segment.first_record() + segment.record_count());
+        ASSERT_LE(column.record_start(segment.zone_map().first_record), segment.first_tid());
+    }
+    ASSERT_EQ(column.candidate_records(std::nullopt, std::nullopt),
+              (std::vector<RecordRange>{ { 0, column.record_count() } }));
+    ASSERT_EQ(column.candidate_records(2000, 3000), (std::vector<RecordRange>{}));
+    ASSERT_EQ(column.candidate_records(1000, 1000).back().end, column.record_count());
+
+    // Segments that were sealed early are written and read like any other.
+    const std::string path = testing::TempDir() + "dremel_storage_test_appended.imlab";
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        BinaryWriter writer { out };
+        column.write(writer);
+    }
+    DremelColumn<int64_t> column_read { Links_Forward_Field, 16 };
+    BinaryReader reader { std::make_shared<const MappedFile>(path) };
+    column_read.read(reader);
+    std::remove(path.c_str());
+    ASSERT_EQ(column_read.segment_count(), column.segment_count());
+    for (TID tid = 0; tid < expected.size(); tid++) {
+        ASSERT_EQ(column_read.get(tid), expected.get(tid)) << tid;
+    }
+}
+
+TEST(DremelColumnTest, RecordStarts) {
+    // Records of very different lengths, some of them spanning several segments.
+    DremelColumn<int64_t> column { Links_Forward_Field, 16 };
+    std::vector<uint64_t> record_starts;
+    for (int64_t i = 0; i < 2000; i++) {
+        record_starts.push_back(column.size());
+        int64_t length = (i % 100 == 0) ? 40 : i % 3;
+        if (length == 0) {
+            column.insert({ std::nullopt, 0, 1 });
+        }
+        for (int64_t j = 0; j < length; j++) {
+            column.insert({ i, j == 0 ? 0u : 1u, 2 });
+        }
+    }
+    ASSERT_EQ(column.record_count(), record_starts.size());
+    for (uint64_t record = 0; record < record_starts.size(); record++) {
+        ASSERT_EQ(column.record_start(record), record_starts[record]);
+    }
+    ASSERT_EQ(column.record_start(record_starts.size()), column.size());
+
+    // Without repetition, every row is a record.
+    DremelColumn<int64_t> doc_ids { DocId_Field, 16 };
+    for (int64_t i = 0; i < 100; i++) {
+        doc_ids.insert({ i, 0, 0 });
+    }
+    for (uint64_t record = 0; record <= 100; record++) {
+        ASSERT_EQ(doc_ids.record_start(record), record);
+    }
+}
+
+TEST(BufferTest, MappedBufferIsCopiedOnWrite) {
+    auto owner = std::make_shared<std::vector<uint32_t>>(std::vector<uint32_t>{ 1, 2, 3 });
+    imlab::Buffer<uint32_t> buffer { owner->data(), owner->size(), owner };
+    ASSERT_TRUE(buffer.mapped());
+    ASSERT_EQ(buffer.data(), owner->data());
+    ASSERT_EQ(buffer.back(), 3);
+
+    buffer.push_back(4);
+    ASSERT_FALSE(buffer.mapped());
+    ASSERT_EQ(buffer.size(), 4);
+    ASSERT_EQ(buffer[0], 1);
+    ASSERT_EQ(buffer[3], 4);
+    ASSERT_EQ(owner->size(), 3);
+}
+
+TEST(DremelColumnTest, WriteAndReadFile) {
+    // One dictionary-encoded and one plain string column, with segments of different states.
+    DremelColumn<std::string> codes { Name_Language_Code_Field, 16 };
+    DremelColumn<std::string> countries { Name_Language_Country_Field, 16 };
+    DremelColumn<int64_t> links { Links_Forward_Field, 16 };
+    for (int64_t i = 0; i < 1000; i++) {
+        codes.insert({ "code" + std::to_string(i % 10), i % 3 == 0 ? 0u : 2u, 2 });
+        if (i % 7 == 0) {
+            countries.insert({ std::nullopt, 0, 1 });
+        } else {
+            countries.insert({ "country" + std::to_string(i), i % 3 == 0 ? 0u : 2u, 3 });
+        }
+        links.insert({ i, i % 5 == 0 ? 0u : 1u, 2 });
+    }
+    const std::string path = testing::TempDir() + "dremel_storage_test_column.imlab";
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        BinaryWriter writer { out };
+        codes.write(writer);
+        countries.write(writer);
+        links.write(writer);
+    }
+
+    DremelColumn<std::string> codes_read { Name_Language_Code_Field, 16 };
+    DremelColumn<std::string> countries_read { Name_Language_Country_Field, 16 };
+    DremelColumn<int64_t> links_read { Links_Forward_Field, 16 };
+    BinaryReader reader { std::make_shared<const MappedFile>(path) };
+    codes_read.read(reader);
+    countries_read.read(reader);
+    links_read.read(reader);
+    // A column of another field can't be read from the file.
+    DremelColumn<int64_t> doc_ids { DocId_Field, 16 };
+    BinaryReader other_reader { std::make_shared<const MappedFile>(path) };
+    ASSERT_THROW(doc_ids.read(other_reader), imlab::FileFormatError);
+    std::remove(path.c_str());  // The mapping stays valid.
+
+    ASSERT_TRUE(codes_read.segment(0).values().dictionary_encoded());
+    ASSERT_TRUE(codes_read.segment(0).values().lookup("code3").has_value());
+    ASSERT_EQ(codes_read.segment_count(), codes.segment_count());
+    for (TID tid = 0; tid < 1000; tid++) {
+        ASSERT_EQ(codes_read.get(tid), codes.get(tid));
+        ASSERT_EQ(countries_read.get(tid), countries.get(tid));
+        ASSERT_EQ(links_read.get(tid), links.get(tid));
+    }
+    ASSERT_EQ(links_read.record_start(100), links.record_start(100));
+    ASSERT_EQ(links_read.candidate_records(500, 600), links.candidate_records(500, 600));
+
+    // The last segment continues where it stopped.
+    links_read.insert({ 1000, 0, 2 });
+    links_read.insert({ std::nullopt, 0, 0 });
+    ASSERT_EQ(links_read.size(), 1002);
+    ASSERT_EQ(links_read.get(999), links.get(999));
+    ASSERT_EQ(links_read.get(1000), (DremelRow<int64_t>{ 1000, 0, 2 }));
+    ASSERT_EQ(links_read.value(links_read.value_index(1000)), 1000);
+}
+
+// Files that don't match what was written are rejected before anything is read out of bounds,
+// and a column that fails to read keeps its rows.
+TEST(DremelColumnTest, ReadRejectsCorruptFiles) {
+    const std::string path = testing::TempDir() + "dremel_storage_test_corrupt.imlab";
+    LevelStream levels { 3 };
+    for (unsigned i = 0; i < 100; i++) {
+        levels.push_back(i % 4);
+    }
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        BinaryWriter writer { out };
+        levels.write(writer);
+    }
+    // Levels up to 3 exceed a maximum of 2 although both need two bits, and a maximum of 1 needs fewer bits.
+    BinaryReader reader { std::make_shared<const MappedFile>(path) };
+    ASSERT_NO_THROW(LevelStream(3, reader));
+    BinaryReader smaller_reader { std::make_shared<const MappedFile>(path) };
+    ASSERT_THROW(LevelStream(2, smaller_reader), imlab::FileFormatError);
+    BinaryReader narrower_reader { std::make_shared<const MappedFile>(path) };
+    ASSERT_THROW(LevelStream(1, narrower_reader), imlab::FileFormatError);
+
+    DremelColumn<int64_t> links { Links_Forward_Field, 16 };
+    for (int64_t i = 0; i < 100; i++) {
+        links.insert({ i, i % 5 == 0 ? 0u : 1u, 2 });
+    }
+    std::string contents;
+    {
+        std::ostringstream out;
+        BinaryWriter writer { out };
+        links.write(writer);
+        contents = out.str();
+    }
+    DremelColumn<int64_t> links_read { Links_Forward_Field, 16 };
+    links_read.insert({ 42, 0, 2 });
+    for (uint64_t size : { contents.size() / 2, contents.size() - 1 }) {
+        {
+            std::ofstream file(path, std::ios::binary | std::ios::trunc);
+            file.write(contents.data(), size);
+        }
+        BinaryReader truncated_reader { std::make_shared<const MappedFile>(path) };
+        ASSERT_THROW(links_read.read(truncated_reader), imlab::FileFormatError);
+        ASSERT_EQ(links_read.size(), 1);
+        ASSERT_EQ(links_read.get(0), (DremelRow<int64_t>{ 42, 0, 2 }));
+    }
+    std::remove(path.c_str());
+}
+
+// The RLE/bit-packing hybrid of Parquet levels mixes runs and literal groups.
+TEST(ParquetTest, RleRoundtrip) {
+    std::vector<uint32_t> values;
+    for (uint32_t i = 0; i < 100; i++) values.push_back(i % 5);
+    values.insert(values.end(), 1000, 3);
+    values.insert(values.end(), 3, 1);
+    for (uint32_t i = 0; i < 13; i++) values.push_back(i % 2);
+    values.insert(values.end(), 20, 0);
+
+    parquet::RleEncoder encoder { 3 };
+    for (auto value : values) {
+        encoder.put(value);
+    }
+    std::string encoded = encoder.finish();
+    ASSERT_LT(encoded.size(), values.size() / 4);
+
+    std::vector<uint32_t> decoded(values.size());
+    parquet::RleDecoder decoder { encoded.data(), encoded.size(), 3 };
+    decoder.decode(decoded.data(), 600);
+    decoder.decode(decoded.data() + 600, values.size() - 600);
+    ASSERT_EQ(decoded, values);
+    ASSERT_THROW(decoder.decode(decoded.data(), 8), imlab::FileFormatError);
+}
+
+}  // namespace
@@ -2,14 +2,23 @@
 // IMLAB
 // ---------------------------------------------------------------------------
 
+#include <atomic>
+#include <cstdio>
+#include <iterator>
 #include <sstream>
 #include <fstream>
+#include <string>
 #include "imlab/test/data.h"
 #include "database.h"
+#include "imlab/dremel/field_reader.h"
 #include "imlab/dremel/record_fsm.h"
 #include "imlab/dremel/schema_helper.h"
 #include "gtest/gtest.h"
 #include "gtest/gtest_prod.h"
+#include <tbb/parallel_for.h>
+#include <google/protobuf/descriptor.pb.h>
+#include <google/protobuf/text_format.h>
+#include <google/protobuf/util/delimited_message_util.h>
 #include <google/protobuf/util/message_differencer.h>
 
 namespace {
@@ -31,9 +40,13 @@ const auto* Name_Url_Field = Document_Name::descriptor()->FindFieldByName("Url")
 class TestClass : public imlab::schema::DocumentTable {
     FRIEND_TEST(DremelTest, ShreddingDocumentRecordSmall);
     FRIEND_TEST(DremelTest, ShreddingDocumentRecordLarge);
+    FRIEND_TEST(DremelTest, GeneratedShredderMatchesReflection);
+    FRIEND_TEST(DremelTest, SerializedShredderMatchesGenerated);
+    FRIEND_TEST(DremelTest, SerializedShredderRejectsInvalidRecords);
+    FRIEND_TEST(DremelTest, LoadProtobufFileInParallel);
 
     template<typename T>
-    void _print(DremelColumn<T> column) {
+    void _print(DremelColumn<T>& column) {
         std::cout << column.field()->full_name() << std::endl;
         for (uint64_t tid = 0; tid < column.size(); tid++) {
             const auto& row = column.get(tid);
@@ -152,6 +165,116 @@ TEST(DremelSchemaHelperTest, CommonRepetitionLevelRoot) {
     ASSERT_EQ(common_ancestor, nullptr);
 }
 
+// The fields of a schema are numbered in depth-first order; there is one metadata object per schema.
+TEST(DremelSchemaHelperTest, SchemaMetadata) {
+    const auto& schema = SchemaMetadata::Of(Document::descriptor());
+    ASSERT_EQ(&SchemaMetadata::Of(Name_Language_Code_Field), &schema);
+    ASSERT_EQ(schema.root(), Document::descriptor());
+    ASSERT_EQ(schema.field_count(), 9);
+
+    auto name = schema.IndexOf(Name_Field);
+    auto language = schema.IndexOf(Name_Language_Field);
+    auto code = schema.IndexOf(Name_Language_Code_Field);
+    ASSERT_EQ(schema.field(code), Name_Language_Code_Field);
+    ASSERT_EQ(schema.IndexOf(Document_Name_Language::descriptor()), language);
+    ASSERT_EQ(schema.IndexOf(Document::descriptor()), SchemaMetadata::kRoot);
+    ASSERT_EQ(schema.parent(code), language);
+    ASSERT_EQ(schema.parent(name), SchemaMetadata::kRoot);
+    ASSERT_EQ(schema.max_repetition_level(code), 2);
+    ASSERT_EQ(schema.definition_level(code), 2);
+    ASSERT_EQ(schema.full_definition_level(code), 3);
+    ASSERT_EQ(schema.common_ancestor(code, schema.IndexOf(Name_Language_Country_Field)), language);
+    ASSERT_EQ(schema.common_ancestor(schema.IndexOf(Name_Url_Field), code), SchemaMetadata::kRoot);
+    ASSERT_EQ(schema.common_ancestor(code, SchemaMetadata::kRoot), SchemaMetadata::kRoot);
+}
+
+// Builds the message types of a .proto file, given as a FileDescriptorProto in text format.
+const FileDescriptor* BuildSchema(DescriptorPool* pool, const std::string& text) {
+    FileDescriptorProto file {};
+    EXPECT_TRUE(TextFormat::ParseFromString(text, &file));
+    return pool->BuildFile(file);
+}
+
+// Columns are identified by their fields, so a message type must not be used twice, neither by two fields
+// nor by a field inside of itself.
+TEST(DremelSchemaHelperTest, SchemaMetadataRejectsSharedMessageTypes) {
+    DescriptorPool pool {};
+    const auto* file = BuildSchema(&pool, R"(
+        name: "shared.proto"
+        message_type {
+            name: "Shared"
+            field { name: "a" number: 1 label: LABEL_OPTIONAL type: TYPE_MESSAGE type_name: ".Shared.A" }
+            field { name: "b" number: 2 label: LABEL_REPEATED type: TYPE_MESSAGE type_name: ".Shared.A" }
+            nested_type { name: "A" field { name: "x" number: 1 label: LABEL_OPTIONAL type: TYPE_INT64 } }
+        }
+        message_type {
+            name: "Recursive"
+            field { name: "child" number: 1 label: LABEL_OPTIONAL type: TYPE_MESSAGE type_name: ".Recursive.Child" }
+            nested_type {
+                name: "Child"
+                field { name: "child" number: 1 label: LABEL_REPEATED type: TYPE_MESSAGE type_name: ".Recursive.Child" }
+            }
+        }
+        message_type {
+            name: "RecursiveRoot"
+            field { name: "root" number: 1 label: LABEL_OPTIONAL type: TYPE_MESSAGE type_name: ".RecursiveRoot" }
+        }
+    )");
+    ASSERT_NE(file, nullptr);
+    ASSERT_THROW(SchemaMetadata::Of(file->FindMessageTypeByName("Shared")), imlab::SchemaCompilationError);
+    ASSERT_THROW(SchemaMetadata::Of(file->FindMessageTypeByName("Recursive")), imlab::SchemaCompilationError);
+    ASSERT_THROW(SchemaMetadata::Of(file->FindMessageTypeByName("RecursiveRoot")), imlab::SchemaCompilationError);
+}
+
+// A top-level message type that a field refers to belongs to the schema of the root once that is known.
+TEST(DremelSchemaHelperTest, SchemaMetadataOfTopLevelFieldTypes) {
+    DescriptorPool pool {};
+    const auto* file = BuildSchema(&pool, R"(
+        name: "top_level.proto"
+        message_type {
+            name: "Root"
+            field { name: "item" number: 1 label: LABEL_REPEATED type: TYPE_MESSAGE type_name: ".Item" }
+        }
+        message_type { name: "Item" field { name: "x" number: 1 label: LABEL_OPTIONAL type: TYPE_INT64 } }
+    )");
+    ASSERT_NE(file, nullptr);
+    const auto* root = file->FindMessageTypeByName("Root");
+    const auto* item = root->FindFieldByName("item");
+    const auto* x = file->FindMessageTypeByName("Item")->FindFieldByName("x");
+
+    const auto& schema = SchemaMetadata::Of(root);
+    ASSERT_EQ(&SchemaMetadata::Of(x), &schema);
+    ASSERT_EQ(GetParentField(x), item);
+    ASSERT_EQ(GetFieldDescriptor(item->message_type()), item);
+    ASSERT_EQ(GetMaxRepetitionLevel(x), 1);
+    ASSERT_EQ(GetDefinitionLevel(x), 2);
+}
+
+// The metadata is shared by all threads, e.g. by the workers of a parallel scan.
+TEST(DremelSchemaHelperTest, SchemaMetadataFromManyThreads) {
+    const std::vector<const FieldDescriptor*> fields {
+        DocId_Field, Links_Backward_Field, Links_Forward_Field, Name_Field, Name_Language_Field,
+        Name_Language_Code_Field, Name_Language_Country_Field, Name_Url_Field
+    };
+    std::vector<const FieldDescriptor*> expected {};
+    for (auto* field1 : fields) {
+        for (auto* field2 : fields) {
+            expected.push_back(GetCommonAncestor(field1, field2));
+        }
+    }
+    std::atomic<size_t> mismatches {0};
+    tbb::parallel_for(size_t(0), size_t(1000), [&](size_t) {
+        for (size_t i = 0; i < expected.size(); i++) {
+            auto* field1 = fields[i / fields.size()];
+            auto* field2 = fields[i % fields.size()];
+            if (GetCommonAncestor(field1, field2) != expected[i]) {
+                mismatches++;
+            }
+        }
+    });
+    ASSERT_EQ(mismatches, 0);
+}
+
 // ---------------------------------------------------------------------------
 
 // This test corresponds to the example from the Dremel paper in Figure 2 and Figure 3.
@@ -215,6 +338,238 @@ TEST(DremelTest, ShreddingDocumentRecordLarge) {
     ASSERT_EQ(tc->Name_Url_Column.get(2), (DremelRow<std::string>{std::nullopt, 1, 1}));
 }
 
+template<typename T>
+void ExpectEqualColumns(DremelColumn<T>& expected, DremelColumn<T>& actual) {
+    ASSERT_EQ(actual.size(), expected.size()) << expected.field()->full_name();
+    for (uint64_t tid = 0; tid < expected.size(); tid++) {
+        ASSERT_EQ(actual.get(tid), expected.get(tid)) << expected.field()->full_name() << " " << tid;
+    }
+}
+
+// Records with empty, missing and repeated fields at every level.
+std::vector<Document> MixedDocuments() {
+    std::vector<Document> documents;
+    for (int64_t i = 0; i < 200; i++) {
+        Document document {};
+        document.set_docid(i);
+        if (i % 3 != 0) {
+            auto* links = document.mutable_links();  // Might stay empty.
+            for (int64_t j = 0; j < i % 4; j++) {
+                links->add_backward(i + j);
+            }
+            for (int64_t j = 0; j < i % 5; j++) {
+                links->add_forward(i - j);
+            }
+        }
+        for (int64_t j = 0; j < i % 3; j++) {
+            auto* name = document.add_name();
+            for (int64_t k = 0; k < (i + j) % 4; k++) {
+                auto* language = name->add_language();
+                language->set_code(k % 2 == 0 ? "en-us" : "de");
+                if ((i + k) % 3 == 0) {
+                    language->set_country("us");
+                }
+            }
+            if ((i + j) % 2 == 0) {
+                name->set_url("http://" + std::to_string(i));
+            }
+        }
+        documents.push_back(document);
+    }
+    return documents;
+}
+
+// The generated shredder has to produce exactly the same rows as the one that walks records via reflection.
+TEST(DremelTest, GeneratedShredderMatchesReflection) {
+    auto documents = MixedDocuments();
+    TestClass reflection, generated;
+    for (auto& document : documents) {
+        reflection.insert_reflection(document);
+        generated.insert(document);
+    }
+    ASSERT_EQ(generated.size(), documents.size());
+    ExpectEqualColumns(reflection.DocId_Column, generated.DocId_Column);
+    ExpectEqualColumns(reflection.Links_Backward_Column, generated.Links_Backward_Column);
+    ExpectEqualColumns(reflection.Links_Forward_Column, generated.Links_Forward_Column);
+    ExpectEqualColumns(reflection.Name_Language_Code_Column, generated.Name_Language_Code_Column);
+    ExpectEqualColumns(reflection.Name_Language_Country_Column, generated.Name_Language_Country_Column);
+    ExpectEqualColumns(reflection.Name_Url_Column, generated.Name_Url_Column);
+}
+
+// The generated assembler has to produce the same records as the one that is driven by a RecordFSM, for any projection.
+TEST(DremelTest, GeneratedAssemblerMatchesReflection) {
+    auto documents = MixedDocuments();
+    imlab::schema::DocumentTable table;
+    for (auto& document : documents) {
+        table.insert(document);
+    }
+    std::vector<std::vector<const FieldDescriptor*>> projections {
+        imlab::schema::DocumentTable::fields(),
+        { DocId_Field, Name_Url_Field },
+        { Name_Language_Country_Field },
+        { Links_Forward_Field, Name_Language_Code_Field },
+        { DocId_Field, Links_Backward_Field, Name_Language_Country_Field, Name_Url_Field },
+    };
+    for (auto& fields : projections) {
+        auto expected = table.get_range_reflection(0, documents.size(), fields);
+        auto records = table.get_range(0, documents.size(), fields);
+        for (size_t i = 0; i < documents.size(); i++) {
+            ASSERT_TRUE(google::protobuf::util::MessageDifferencer::Equals(expected[i], records[i]))
+                << "\nExpected:\n\n" << expected[i].DebugString() << "\nBut got:\n\n" << records[i].DebugString();
+        }
+    }
+    // All fields give back the original records, also from the middle of the table.
+    auto records = table.get_range(50, documents.size(), imlab::schema::DocumentTable::fields());
+    for (size_t i = 50; i < documents.size(); i++) {
+        ASSERT_TRUE(google::protobuf::util::MessageDifferencer::Equals(documents[i], records[i - 50]))
+            << "\nExpected:\n\n" << documents[i].DebugString() << "\nBut got:\n\n" << records[i - 50].DebugString();
+    }
+}
+
+// Records can also be assembled on an arena or into a message that is reused.
+TEST(DremelTest, AssembleIntoArenaAndReusedMessages) {
+    auto documents = MixedDocuments();
+    imlab::schema::DocumentTable table;
+    for (auto& document : documents) {
+        table.insert(document);
+    }
+    auto fields = imlab::schema::DocumentTable::fields();
+
+    auto batch = table.get_batch(20, documents.size(), fields);
+    ASSERT_EQ(batch.size(), documents.size() - 20);
+    for (size_t i = 0; i < batch.size(); i++) {
+        ASSERT_EQ(batch[i].GetArena(), batch.arena());
+        ASSERT_TRUE(google::protobuf::util::MessageDifferencer::Equals(documents[i + 20], batch[i]))
+            << "\nExpected:\n\n" << documents[i + 20].DebugString() << "\nBut got:\n\n" << batch[i].DebugString();
+    }
+
+    // The reused message must not keep anything of the previous record, also with fewer fields.
+    Document record {};
+    std::vector<const FieldDescriptor*> projection { DocId_Field, Name_Language_Country_Field };
+    auto expected = table.get_range_reflection(0, documents.size(), projection);
+    for (size_t i = 0; i < documents.size(); i++) {
+        table.get(i, fields, &record);
+        ASSERT_TRUE(google::protobuf::util::MessageDifferencer::Equals(documents[i], record));
+        table.get(i, projection, &record);
+        ASSERT_TRUE(google::protobuf::util::MessageDifferencer::Equals(expected[i], record));
+    }
+}
+
+TEST(DremelTest, ScanMorselsWithPersistentCursors) {
+    auto documents = MixedDocuments();
+    imlab::schema::DocumentTable table;
+    const uint64_t records = 200 * documents.size();
+    for (uint64_t i = 0; i < records; i++) {
+        table.insert(documents[i % documents.size()]);
+    }
+    ASSERT_GT(table.morsels().size(), 1);
+
+    // Every record is assembled exactly once.
+    std::vector<std::atomic<unsigned>> calls(records);
+    std::atomic<uint64_t> mismatches = 0;
+    table.scan_morsels(imlab::schema::DocumentTable::fields(), [&](uint64_t tid, const Document& record) {
+        calls[tid]++;
+        if (!google::protobuf::util::MessageDifferencer::Equals(documents[tid % documents.size()], record)) {
+            mismatches++;
+        }
+    });
+    ASSERT_EQ(mismatches, 0);
+    for (auto& count : calls) {
+        ASSERT_EQ(count, 1);
+    }
+
+    // A cursor can be moved back and forth between records, also across segments.
+    std::vector<const FieldDescriptor*> projection { Links_Forward_Field, Name_Language_Country_Field };
+    auto expected = table.get_range_reflection(0, documents.size(), projection);
+    imlab::schema::DocumentTable::Cursor cursor { table, projection };
+    for (uint64_t tid : { 0ul, 1ul, 170ul, records - 1, 5ul, 30005ul, 30006ul, 3ul }) {
+        Document record {};
+        cursor.Seek(tid);
+        cursor.AssembleNext(&record);
+        ASSERT_EQ(cursor.tid(), tid + 1);
+        ASSERT_TRUE(google::protobuf::util::MessageDifferencer::Equals(expected[tid % documents.size()], record))
+            << "Record " << tid << ":\n" << record.DebugString();
+    }
+}
+
+// Shredding the wire format has to produce the same rows as shredding the parsed records.
+TEST(DremelTest, SerializedShredderMatchesGenerated) {
+    auto documents = MixedDocuments();
+    TestClass generated, serialized;
+    for (auto& document : documents) {
+        generated.insert(document);
+        // Fields that are not in the schema are skipped: a varint, a string and a group.
+        std::string bytes = document.SerializeAsString() + std::string("\x50\x01\x5a\x02hi\x63\x68\x07\x64", 10);
+        serialized.insert_serialized(bytes);
+    }
+    ASSERT_EQ(serialized.size(), documents.size());
+    ExpectEqualColumns(generated.DocId_Column, serialized.DocId_Column);
+    ExpectEqualColumns(generated.Links_Backward_Column, serialized.Links_Backward_Column);
+    ExpectEqualColumns(generated.Links_Forward_Column, serialized.Links_Forward_Column);
+    ExpectEqualColumns(generated.Name_Language_Code_Column, serialized.Name_Language_Code_Column);
+    ExpectEqualColumns(generated.Name_Language_Country_Column, serialized.Name_Language_Country_Column);
+    ExpectEqualColumns(generated.Name_Url_Column, serialized.Name_Url_Column);
+}
+
+TEST(DremelTest, SerializedShredderReadsPackedFields) {
+    imlab::schema::DocumentTable table;
+    // DocId 1, Links { Backward packed [1, 2, 300], Forward 4 }
+    table.insert_serialized(std::string("\x08\x01\x13\x1a\x04\x01\x02\xac\x02\x20\x04\x14", 12));
+    Document expected {};
+    expected.set_docid(1);
+    expected.mutable_links()->add_backward(1);
+    expected.mutable_links()->add_backward(2);
+    expected.mutable_links()->add_backward(300);
+    expected.mutable_links()->add_forward(4);
+    auto record = table.get(0, imlab::schema::DocumentTable::fields());
+    ASSERT_TRUE(google::protobuf::util::MessageDifferencer::Equals(expected, record)) << record.DebugString();
+}
+
+TEST(DremelTest, SerializedShredderRejectsInvalidRecords) {
+    Document valid {};
+    valid.set_docid(7);
+    valid.mutable_links()->add_forward(8);
+    auto* language = valid.add_name()->add_language();
+    language->set_code("en");
+    language->set_country("us");
+    for (auto bytes : {
+            std::string(""),                         // required field is missing
+            std::string("\x0a\x01\x01", 3),         // wrong wire type
+            std::string("\x08\x81", 2),             // truncated varint
+            std::string("\x08\x01\x13\x18\x01", 5), // unterminated group
+            std::string("\x08\x01\x13\x18\x01\x14\x2b\x33\x34\x2c", 10),  // a group without the required Code
+            std::string("\x08\x01\x14", 3)}) {     // end of a group that was never started
+        // A rejected record leaves no rows behind, so the records around it are not affected.
+        TestClass table;
+        table.insert_serialized(valid.SerializeAsString());
+        ASSERT_THROW(table.insert_serialized(bytes), imlab::FileFormatError);
+        table.insert_serialized(valid.SerializeAsString());
+        ASSERT_EQ(table.size(), 2);
+        ASSERT_EQ(table.Name_Language_Country_Column.size(), 2);
+        for (uint64_t tid = 0; tid < table.size(); tid++) {
+            auto record = table.get(tid, imlab::schema::DocumentTable::fields());
+            ASSERT_TRUE(google::protobuf::util::MessageDifferencer::Equals(valid, record)) << record.DebugString();
+        }
+    }
+}
+
+TEST(DremelTest, SerializedShredderMergesRepeatedOccurrences) {
+    // Fields that are not repeated may occur more than once: The last value wins and messages are merged.
+    for (auto bytes : {
+            std::string("\x08\x01\x08\x02", 4),                      // DocId 1, DocId 2
+            std::string("\x08\x01\x13\x18\x01\x14\x13\x18\x02\x20\x03\x14", 12),  // Links twice
+            std::string("\x08\x01\x2b\x4a\x01\x61\x4a\x01\x62\x2c", 10),  // Url "a", Url "b"
+            std::string("\x08\x01\x2b\x33\x3a\x01\x61\x3a\x01\x62\x34\x2c", 12)}) {  // Code "a", Code "b"
+        Document expected {};
+        ASSERT_TRUE(expected.ParseFromString(bytes));
+        imlab::schema::DocumentTable table;
+        table.insert_serialized(bytes);
+        auto record = table.get(0, imlab::schema::DocumentTable::fields());
+        ASSERT_TRUE(google::protobuf::util::MessageDifferencer::Equals(expected, record))
+            << "\nExpected:\n\n" << expected.DebugString() << "\nBut got:\n\n" << record.DebugString();
+    }
+}
+
 // ---------------------------------------------------------------------------
 
 // This test corresponds to the example from the Dremel paper in Figure 4.
@@ -260,6 +615,32 @@ TEST(DremelTest, ConstructPartialFSM) {
     ASSERT_EQ(fsm.NextField(Name_Language_Country_Field, 0), nullptr);  // end state
 }
 
+// The states are numbered in the order of the fields, the end state is field_count().
+TEST(DremelTest, NavigateFSMByIndex) {
+    RecordFSM fsm {{
+        DocId_Field,
+        Links_Forward_Field,
+        Name_Language_Code_Field,
+        Name_Url_Field
+    }};
+
+    ASSERT_EQ(fsm.field_count(), 4);
+    ASSERT_EQ(fsm.field(2), Name_Language_Code_Field);
+    ASSERT_EQ(fsm.IndexOf(Name_Url_Field), 3);
+    ASSERT_EQ(fsm.IndexOf(Links_Backward_Field), fsm.field_count());  // not part of the FSM
+
+    ASSERT_EQ(fsm.NextIndex(0, 0), 1);
+    ASSERT_EQ(fsm.NextIndex(1, 1), 1);
+    ASSERT_EQ(fsm.NextIndex(1, 0), 2);
+    ASSERT_EQ(fsm.NextIndex(2, 2), 2);
+    ASSERT_EQ(fsm.NextIndex(2, 1), 3);
+    ASSERT_EQ(fsm.NextIndex(3, 1), 2);
+    ASSERT_EQ(fsm.NextIndex(3, 0), fsm.field_count());  // end state
+    // Repetition levels that a field cannot have end the record.
+    ASSERT_EQ(fsm.NextIndex(0, 1), fsm.field_count());
+    ASSERT_EQ(fsm.NextField(Links_Backward_Field, 0), nullptr);
+}
+
 // Tests another example from the paper (Figure 5)
 TEST(DremelTest, InsertAndGetLargeRecordWithPartialFSM) {
     imlab::Database db {};
@@ -278,8 +659,10 @@ TEST(DremelTest, InsertAndGetLargeRecordWithPartialFSM) {
     auto* lang_1 = name_1->add_language();
     lang_1->set_country("us");
     auto* lang_2 = name_1->add_language();
-    auto* name_2 = document.add_name();
-    auto* lang_3 = name_2->add_language();
+    // The second Name has no Language, but it is still there (see Figure 6 of the paper).
+    document.add_name();
+    auto* name_3 = document.add_name();
+    auto* lang_3 = name_3->add_language();
     lang_3->set_country("gb");
 
     ASSERT_TRUE(google::protobuf::util::MessageDifferencer::Equals(document, record))
@@ -387,6 +770,133 @@ TEST(DremelTest, InsertAndGetEmptyRecordRoundtrip) {
         << "\nExpected:\n\n" << document.DebugString() << "\nBut got:\n\n" << record.DebugString();
 }
 
+TEST(DremelTest, LoadJsonSkipsUnknownFieldsAndNulls) {
+    imlab::Database db {};
+    std::stringstream in(R"([
+        { "DocId": 1, "Links": null, "Rank": { "Score": [1, 2], "Url": "x" }, "Name": [ { "Url": null, "Language": [] } ] },
+        { "DocId": 2, "Links": { "Forward": [] }, "Name": [] }
+    ])");
+    db.LoadDocumentTable(in);
+    ASSERT_EQ(db.DocumentTable.size(), 2);
+
+    auto records = db.DocumentTable.get_range(0, 2, {
+        DocId_Field,
+        Links_Backward_Field,
+        Links_Forward_Field,
+        Name_Language_Code_Field,
+        Name_Language_Country_Field,
+        Name_Url_Field
+    });
+    Document first {};
+    first.set_docid(1);
+    first.add_name();
+    Document second {};
+    second.set_docid(2);
+    second.mutable_links();
+    ASSERT_TRUE(google::protobuf::util::MessageDifferencer::Equals(first, records[0])) << records[0].DebugString();
+    ASSERT_TRUE(google::protobuf::util::MessageDifferencer::Equals(second, records[1])) << records[1].DebugString();
+}
+
+TEST(DremelTest, LoadJsonRejectsInvalidRecords) {
+    for (const char* json : {
+            R"({ "DocId": 1 })",                                                  // not an array of records
+            R"([ { "Links": {} } ])",                                             // required field is missing
+            R"([ { "DocId": 1, "DocId": 2 } ])",                                  // duplicate field
+            R"([ { "DocId": "1" } ])",                                            // wrong type
+            R"([ { "DocId": 1, "Links": [] } ])",                                 // array for a non-repeated field
+            R"([ { "DocId": 1, "Links": { "Forward": [1, null] } } ])",           // null in a repeated field
+            R"([ { "DocId": 1, "Name": [ { "Language": [ { "Country": "us" } ] } ] } ])",
+            R"([ { "DocId": 1 )"}) {
+        imlab::Database db {};
+        std::stringstream in(json);
+        ASSERT_THROW(db.LoadDocumentTable(in), imlab::FileFormatError) << json;
+    }
+}
+
+TEST(DremelTest, LoadJsonLinesInParallel) {
+    // The same records as a JSON array and as newline-delimited JSON.
+    std::stringstream array, lines;
+    array << "[";
+    for (int i = 0; i < 3000; i++) {
+        std::stringstream record;
+        record << R"({ "DocId": )" << i << R"(, "Links": { "Forward": [)";
+        for (int j = 0; j < i % 4; j++) {
+            record << (j > 0 ? ", " : "") << i + j;
+        }
+        record << R"(] }, "Name": [ { "Language": [ { "Code": "en-us" } ], "Url": "http://)" << i << R"(" } ] })";
+        array << (i > 0 ? ",\n" : "") << record.str();
+        lines << record.str() << "\n";
+    }
+    array << "]";
+
+    imlab::Database db {}, parallel_db {};
+    db.LoadDocumentTable(array);
+    // Tiny chunks, so that there are many fragments and rounds.
+    parallel_db.DocumentTable.load_json_lines(lines, 1024);
+    ASSERT_EQ(parallel_db.DocumentTable.size(), db.DocumentTable.size());
+
+    std::vector<const FieldDescriptor*> fields {
+        DocId_Field,
+        Links_Backward_Field,
+        Links_Forward_Field,
+        Name_Language_Code_Field,
+        Name_Language_Country_Field,
+        Name_Url_Field
+    };
+    auto expected = db.DocumentTable.get_range(0, db.DocumentTable.size(), fields);
+    auto records = parallel_db.DocumentTable.get_range(0, parallel_db.DocumentTable.size(), fields);
+    for (size_t i = 0; i < expected.size(); i++) {
+        ASSERT_TRUE(google::protobuf::util::MessageDifferencer::Equals(expected[i], records[i]))
+            << "\nExpected:\n\n" << expected[i].DebugString() << "\nBut got:\n\n" << records[i].DebugString();
+    }
+}
+
+TEST(DremelTest, LoadProtobufFileInParallel) {
+    auto documents = MixedDocuments();
+    const std::string path = testing::TempDir() + "dremel_test_documents.pb";
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        for (auto& document : documents) {
+            ASSERT_TRUE(google::protobuf::util::SerializeDelimitedToOstream(document, &file));
+        }
+    }
+
+    TestClass expected, chunked;
+    for (auto& document : documents) {
+        expected.insert(document);
+    }
+    // Tiny chunks, so that there are many fragments and rounds.
+    chunked.load_protobuf_file(path, 256);
+    ASSERT_EQ(chunked.size(), documents.size());
+    ExpectEqualColumns(expected.DocId_Column, chunked.DocId_Column);
+    ExpectEqualColumns(expected.Links_Backward_Column, chunked.Links_Backward_Column);
+    ExpectEqualColumns(expected.Links_Forward_Column, chunked.Links_Forward_Column);
+    ExpectEqualColumns(expected.Name_Language_Code_Column, chunked.Name_Language_Code_Column);
+    ExpectEqualColumns(expected.Name_Language_Country_Column, chunked.Name_Language_Country_Column);
+    ExpectEqualColumns(expected.Name_Url_Column, chunked.Name_Url_Column);
+
+    imlab::Database db {};
+    db.LoadDocumentTableProtobuf(path);
+    ASSERT_EQ(db.DocumentTable.size(), documents.size());
+    auto fields = imlab::schema::DocumentTable::fields();
+    auto expected_records = expected.get_range(0, documents.size(), fields);
+    auto records = db.DocumentTable.get_range(0, documents.size(), fields);
+    for (size_t i = 0; i < documents.size(); i++) {
+        ASSERT_TRUE(google::protobuf::util::MessageDifferencer::Equals(expected_records[i], records[i]))
+            << "\nExpected:\n\n" << expected_records[i].DebugString() << "\nBut got:\n\n" << records[i].DebugString();
+    }
+
+    // A stream that ends within a record is rejected.
+    std::string contents;
+    {
+        std::ifstream file(path, std::ios::binary);
+        contents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    imlab::schema::DocumentTable truncated {};
+    ASSERT_THROW(truncated.load_protobuf(std::string_view(contents).substr(0, contents.size() - 1)), imlab::FileFormatError);
+    std::remove(path.c_str());
+}
+
 // Load a bunch of randomly generated record into the DB and retrieve them individually.
 TEST(DremelTest, InsertAndGetIndividual) {
     imlab::Database db {};
@@ -443,4 +953,229 @@ TEST(DremelTest, InsertAndGetFullRange) {
     }
 }
 
+// A table that was saved to a file and opened again contains the same records and can still grow.
+TEST(DremelTest, SaveAndOpenTable) {
+    imlab::Database db {};
+    std::vector<Document> documents {};
+
+    system("cd ../data/dremel && python3 generate_dremel_data.py 500 500");
+    std::fstream dremel_file("../data/dremel/generated_data_500_500.json", std::fstream::in);
+    imlab::Database::DecodeJson(dremel_file, [&](auto& d) {
+        db.DocumentTable.insert(d);
+        documents.push_back(d);
+    });
+    const std::string path = testing::TempDir() + "dremel_test_table.imlab";
+    db.DocumentTable.save(path, "generated_data_500_500");
+
+    imlab::Database opened {};
+    opened.DocumentTable.open(path, "generated_data_500_500");
+    ASSERT_EQ(opened.DocumentTable.size(), documents.size());
+    ASSERT_EQ(opened.DocumentTable.morsels(), db.DocumentTable.morsels());
+
+    Document document {};
+    document.set_docid(12345);
+    document.mutable_links()->add_forward(1);
+    document.add_name()->set_url("http://opened");
+    opened.DocumentTable.insert(document);
+    documents.push_back(document);
+
+    const auto& documents_read = opened.DocumentTable.get_range(0, documents.size(), {
+        DocId_Field,
+        Links_Backward_Field,
+        Links_Forward_Field,
+        Name_Language_Code_Field,
+        Name_Language_Country_Field,
+        Name_Url_Field
+    });
+    ASSERT_EQ(documents.size(), documents_read.size());
+    for (unsigned i = 0; i < documents.size(); i++) {
+        ASSERT_TRUE(google::protobuf::util::MessageDifferencer::Equals(documents[i], documents_read[i]))
+            << "\nExpected (" << i + 1 << "):\n\n" << documents[i].DebugString() << "\nBut got:\n\n" << documents_read[i].DebugString();
+    }
+
+    // Files that are missing, were written from another source or are truncated are rejected,
+    // and leave the table empty instead of partly replaced.
+    imlab::Database broken {};
+    ASSERT_THROW(broken.DocumentTable.open(path + ".missing"), imlab::FileFormatError);
+    ASSERT_THROW(broken.DocumentTable.open(path), imlab::FileFormatError);
+    ASSERT_THROW(broken.DocumentTable.open(path, "generated_data_500_501"), imlab::FileFormatError);
+    broken.DocumentTable.open(path, "generated_data_500_500");
+    ASSERT_EQ(broken.DocumentTable.size(), documents.size() - 1);
+    std::string contents;
+    {
+        std::ifstream file(path, std::ios::binary);
+        contents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(contents.data(), contents.size() / 2);
+    }
+    ASSERT_THROW(broken.DocumentTable.open(path, "generated_data_500_500"), imlab::FileFormatError);
+    ASSERT_EQ(broken.DocumentTable.size(), 0);
+    ASSERT_TRUE(broken.DocumentTable.morsels().empty());
+    std::remove(path.c_str());
+}
+
+TEST(DremelTest, ExportAndImportParquet) {
+    imlab::Database db {};
+    std::vector<Document> documents {};
+
+    system("cd ../data/dremel && python3 generate_dremel_data.py 500 500");
+    std::fstream dremel_file("../data/dremel/generated_data_500_500.json", std::fstream::in);
+    imlab::Database::DecodeJson(dremel_file, [&](auto& d) {
+        db.DocumentTable.insert(d);
+        documents.push_back(d);
+    });
+    const std::string path = testing::TempDir() + "dremel_test_table.parquet";
+    db.DocumentTable.export_parquet(path);
+
+    // Importing appends to the records of the table.
+    imlab::Database imported {};
+    Document document {};
+    document.set_docid(12345);
+    document.add_name()->set_url("http://imported");
+    imported.DocumentTable.insert(document);
+    documents.insert(documents.begin(), document);
+    imported.DocumentTable.import_parquet(path);
+    ASSERT_EQ(imported.DocumentTable.size(), documents.size());
+
+    const auto& documents_read = imported.DocumentTable.get_range(0, documents.size(), {
+        DocId_Field,
+        Links_Backward_Field,
+        Links_Forward_Field,
+        Name_Language_Code_Field,
+        Name_Language_Country_Field,
+        Name_Url_Field
+    });
+    ASSERT_EQ(documents.size(), documents_read.size());
+    for (unsigned i = 0; i < documents.size(); i++) {
+        ASSERT_TRUE(google::protobuf::util::MessageDifferencer::Equals(documents[i], documents_read[i]))
+            << "\nExpected (" << i + 1 << "):\n\n" << documents[i].DebugString() << "\nBut got:\n\n" << documents_read[i].DebugString();
+    }
+
+    // Files that are missing or no Parquet files are rejected.
+    imlab::Database broken {};
+    ASSERT_THROW(broken.DocumentTable.import_parquet(path + ".missing"), imlab::FileFormatError);
+    broken.DocumentTable.save(path);
+    ASSERT_THROW(broken.DocumentTable.import_parquet(path), imlab::FileFormatError);
+    std::remove(path.c_str());
+}
+
+// Morsels cover all records and start at segment boundaries of the largest column.
+TEST(DremelTest, MorselsAreAlignedToSegments) {
+    imlab::Database db {};
+    ASSERT_TRUE(db.DocumentTable.morsels().empty());
+
+    // Every document has two forward links, so Links.Forward is the largest column with one segment per 2^15 records.
+    const uint64_t records = 3 * (1 << 15) + 100;
+    for (uint64_t i = 0; i < records; i++) {
+        Document document {};
+        document.set_docid(i);
+        document.mutable_links()->add_forward(i);
+        document.mutable_links()->add_forward(i + 1);
+        db.DocumentTable.insert(document);
+    }
+
+    ASSERT_EQ(db.DocumentTable.morsels(), (std::vector<RecordRange>{
+        { 0, 1 << 15 }, { 1 << 15, 2 << 15 }, { 2 << 15, 3 << 15 }, { 3 << 15, records } }));
+
+    // Zone maps of DocId (one segment per 2^16 records) and Links.Forward rule out segments.
+    ASSERT_EQ(db.DocumentTable.morsels({ { DocId_Field, "70000", "70001" } }), (std::vector<RecordRange>{
+        { 1 << 16, 3 << 15 }, { 3 << 15, records } }));
+    ASSERT_EQ(db.DocumentTable.morsels({ { Links_Forward_Field, "10", "10" } }), (std::vector<RecordRange>{
+        { 0, 1 << 15 } }));
+    ASSERT_EQ(db.DocumentTable.morsels({ { Links_Forward_Field, "32768", std::nullopt } }), (std::vector<RecordRange>{
+        { 0, 1 << 15 }, { 1 << 15, 2 << 15 }, { 2 << 15, 3 << 15 }, { 3 << 15, records } }));
+    ASSERT_EQ(db.DocumentTable.morsels({ { DocId_Field, std::nullopt, "-1" } }), (std::vector<RecordRange>{}));
+    // Predicates are combined.
+    ASSERT_EQ(db.DocumentTable.morsels({ { DocId_Field, "10", "70000" }, { Links_Forward_Field, "65536", "65536" } }),
+        (std::vector<RecordRange>{ { 1 << 15, 2 << 15 }, { 2 << 15, 3 << 15 } }));
+    // Bounds that don't fit the column don't rule anything out.
+    ASSERT_EQ(db.DocumentTable.morsels({ { DocId_Field, "abc", std::nullopt } }).size(), 4);
+}
+
+// Scans read the values of a record straight from the columns; records in between are skipped.
+TEST(DremelTest, ReadColumnValuesRecordByRecord) {
+    auto documents = MixedDocuments();
+    imlab::schema::DocumentTable table;
+    for (auto& document : documents) {
+        table.insert(document);
+    }
+
+    RecordValueReader<int64_t> docid { table.column<int64_t>(DocId_Field), 10 };
+    RecordValueReader<std::string> code { table.column<std::string>(Name_Language_Code_Field), 10 };
+    RecordValueReader<std::string> url { table.column<std::string>(Name_Url_Field), 10 };
+    for (size_t i = 10; i < documents.size(); i += 1 + i % 3) {
+        auto& document = documents[i];
+        auto docids = docid.Read(i);
+        ASSERT_EQ(docids.size(), 1);
+        ASSERT_EQ(docids[0], document.docid());
+
+        // Only every other record is read from these columns.
+        if (i % 2 == 1) {
+            continue;
+        }
+        std::vector<std::string> expected_codes {}, expected_urls {};
+        for (auto& name : document.name()) {
+            for (auto& language : name.language()) {
+                expected_codes.push_back(language.code());
+            }
+            if (name.has_url()) {
+                expected_urls.push_back(name.url());
+            }
+        }
+        auto codes = code.Read(i);
+        ASSERT_EQ(std::vector<std::string>(codes.begin(), codes.end()), expected_codes);
+        auto urls = url.Read(i);
+        ASSERT_EQ(std::vector<std::string>(urls.begin(), urls.end()), expected_urls);
+        // Reading the same record again does not advance the reader.
+        ASSERT_EQ(url.Read(i).size(), expected_urls.size());
+    }
+
+    ASSERT_THROW(table.column<std::string>(DocId_Field), std::invalid_argument);
+}
+
+// The rows of several fields are walked together like in the flattened record r1 of the Dremel paper (Figure 2).
+TEST(DremelTest, FlattenRecordRows) {
+    imlab::Database db {};
+    std::stringstream in(imlab_test::kTestDocumentPaperLarge);
+    db.LoadDocumentTable(in);
+    auto& table = db.DocumentTable;
+
+    RecordValueReader<int64_t> forward { table.column<int64_t>(Links_Forward_Field), 0 };
+    RecordValueReader<std::string> code { table.column<std::string>(Name_Language_Code_Field), 0 };
+    RecordValueReader<std::string> country { table.column<std::string>(Name_Language_Country_Field), 0 };
+    RecordValueReader<std::string> url { table.column<std::string>(Name_Url_Field), 0 };
+    auto forwards = forward.ReadRows(0);
+    auto codes = code.ReadRows(0);
+    auto countries = country.ReadRows(0);
+    auto urls = url.ReadRows(0);
+    ASSERT_EQ(codes.size(), 4);
+    ASSERT_EQ(codes.Get(2), std::nullopt);
+    auto text = [](const std::optional<std::string>& value) { return value.value_or("NULL"); };
+
+    // Code and Country are in the same repeated group (Name is 0, Language is 1), Url is in the Name above it.
+    std::vector<std::string> tuples {};
+    RecordFlattener languages { { { 0, 1 }, { 0, 1 }, { 0 } }, 3 };
+    languages.Flatten([&](const size_t* begin, const size_t*) {
+        tuples.push_back(text(codes.Get(begin[0])) + " " + text(countries.Get(begin[1])) + " " + text(urls.Get(begin[2])));
+    }, codes, countries, urls);
+    ASSERT_EQ(tuples, (std::vector<std::string> {
+        "en-us us http://A", "en NULL http://A", "NULL NULL http://B", "en-gb gb NULL" }));
+
+    // Independently repeated fields form the cross product.
+    // The codes are not flattened, they only keep the rows of the current name.
+    tuples.clear();
+    RecordFlattener links { { { 2 }, { 0 }, { 0, 1 } }, 2 };
+    links.Flatten([&](const size_t* begin, const size_t* end) {
+        tuples.push_back(std::to_string(*forwards.value(begin[0])) + " " + text(urls.Get(begin[1])) + " "
+                         + std::to_string(end[2] - begin[2]));
+    }, forwards, urls, codes);
+    ASSERT_EQ(tuples, (std::vector<std::string> {
+        "20 http://A 2", "40 http://A 2", "60 http://A 2",
+        "20 http://B 1", "40 http://B 1", "60 http://B 1",
+        "20 NULL 1", "40 NULL 1", "60 NULL 1" }));
+}
+
 }  // namespace
+
@@ -2,6 +2,8 @@
 // IMLAB
 // ---------------------------------------------------------------------------
 
+#include <optional>
+#include <string>
 #include "gtest/gtest.h"
 #include "imlab/infra/hash_table.h"
 #include "imlab/infra/types.h"
@@ -69,4 +71,53 @@ TEST(LazyHashTableTest, EmptyGet) {
     ASSERT_EQ(it_begin, it_end);
 }
 
+TEST(HashTupleTest, PlainValues) {
+    // Keys of plain values use std::hash; the hashes of all keys keep their 64 bits.
+    ASSERT_EQ(Key(std::string("gb"), 1l), Key(std::string("gb"), 1l));
+    ASSERT_EQ(Key(std::string("gb"), 1l).Hash(), Key(std::string("gb"), 1l).Hash());
+    ASSERT_NE(Key(std::string("gb"), 1l).Hash(), Key(std::string("us"), 1l).Hash());
+    ASSERT_EQ(Key(Integer(7)).Hash(), Integer(7).hash() + 0x9e3779b9);
+}
+
+struct Count {
+    uint64_t count = 0;
+    void Merge(const Count& other) { count += other.count; }
+};
+
+TEST(PartitionedAggregationMapTest, MergeThreads) {
+    PartitionedAggregationMap<Key<int64_t>, Count> groups;
+    constexpr int64_t kGroups = 100000;
+    constexpr int64_t kRecords = 4 * kGroups;
+    tbb::parallel_for(tbb::blocked_range<int64_t>(0, kRecords), [&](const tbb::blocked_range<int64_t>& range) {
+        auto& local = groups.local();
+        for (int64_t i = range.begin(); i != range.end(); ++i) {
+            auto [count, inserted] = local.try_emplace(Key<int64_t>(i % kGroups));
+            count.count++;
+        }
+    });
+    groups.finalize();
+
+    ASSERT_EQ(groups.size(), kGroups);
+    size_t empty_partitions = 0;
+    for (auto& partition : groups.partitions()) {
+        empty_partitions += partition.empty();
+        for (auto& [key, count] : partition) {
+            ASSERT_EQ(count.count, 4u);
+        }
+    }
+    // Consecutive integers are spread over all partitions.
+    ASSERT_EQ(empty_partitions, 0u);
+}
+
+TEST(PartitionedAggregationMapTest, InsertOnce) {
+    PartitionedAggregationMap<Key<std::optional<std::string>>, Count> groups;
+    auto& local = groups.local();
+    ASSERT_TRUE(local.try_emplace(Key<std::optional<std::string>>("gb")).second);
+    ASSERT_FALSE(local.try_emplace(Key<std::optional<std::string>>("gb")).second);
+    ASSERT_TRUE(local.try_emplace(Key<std::optional<std::string>>(std::nullopt)).second);
+    groups.finalize();
+
+    ASSERT_EQ(groups.size(), 2u);
+}
+
 }  // namespace
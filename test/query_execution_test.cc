@@ -2,18 +2,135 @@
 // IMLAB
 // ---------------------------------------------------------------------------
 
+#include <algorithm>
+#include <map>
+#include <optional>
 #include <sstream>
 #include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
 #include "database.h"
 #include "gtest/gtest.h"
 #include "gtest/gtest_prod.h"
+#include "imlab/algebra/aggregation.h"
 #include <imlab/algebra/selection.h>
 #include "imlab/algebra/table_scan.h"
+#include "imlab/test/data.h"
 
 namespace {
     using namespace imlab;
     using namespace imlab::dremel;
 
+const auto* DocId_Field = Document::descriptor()->FindFieldByName("DocId");
+const auto* Links_Backward_Field = Document_Links::descriptor()->FindFieldByName("Backward");
+const auto* Links_Forward_Field = Document_Links::descriptor()->FindFieldByName("Forward");
+const auto* Url_Field = Document_Name::descriptor()->FindFieldByName("Url");
+const auto* Code_Field = Document_Name_Language::descriptor()->FindFieldByName("Code");
+const auto* Country_Field = Document_Name_Language::descriptor()->FindFieldByName("Country");
+
+// Runs a query and returns the records that it printed, sorted, e.g. "DocId: 10\nCOUNT(*): 1\n"
+std::vector<std::string> RunAndCapture(imlab::Database& db, Query& query) {
+    testing::internal::CaptureStdout();
+    db.RunQuery(query);
+    std::stringstream out(testing::internal::GetCapturedStdout());
+    std::vector<std::string> records {};
+    std::string record, line;
+    while (std::getline(out, line)) {
+        if (line.empty()) {
+            if (!record.empty()) {
+                records.push_back(record);
+            }
+            record.clear();
+        } else {
+            record += line + "\n";
+        }
+    }
+    if (!record.empty()) {
+        records.push_back(record);
+    }
+    std::sort(records.begin(), records.end());
+    return records;
+}
+
+// Aggregates the documents and prints the aggregates.
+// The operators point to their consumers, so the query is prepared where it stays.
+void AggregateDocuments(Query* query, std::vector<Aggregate> aggregates, bool within_record,
+                        std::vector<const google::protobuf::FieldDescriptor*> fields) {
+    Aggregation aggregation(std::make_unique<TableScan>("Document"), std::move(aggregates), within_record, fields);
+    query->op = Print(std::make_unique<Aggregation>(std::move(aggregation)));
+    query->op->Prepare(fields, nullptr);
+}
+
+// Counts the records that satisfy a predicate and their language codes, with the predicate pushed into the scan
+void CountMatches(Query* query, Predicate predicate) {
+    Selection selection(std::make_unique<TableScan>("Document"), {std::move(predicate)});
+    Aggregation aggregation(std::make_unique<Selection>(std::move(selection)),
+                            {{Aggregate::Function::kCount, nullptr}, {Aggregate::Function::kCount, Code_Field}});
+    query->op = Print(std::make_unique<Aggregation>(std::move(aggregation)));
+    query->op->Prepare({}, nullptr);
+}
+
+// Groups the records by the language codes and countries and counts the records per group
+void CountLanguages(Query* query) {
+    AggregateDocuments(query, {{Aggregate::Function::kCount, nullptr}}, false, {Code_Field, Country_Field});
+}
+
+// The aggregates of the tests: COUNT(*), COUNT(Name.Language.Code), SUM(Links.Forward), MIN(Name.Url),
+// MAX(Links.Backward) and AVG(Links.Forward)
+const std::vector<Aggregate> kAggregates {
+    {Aggregate::Function::kCount, nullptr},
+    {Aggregate::Function::kCount, Code_Field},
+    {Aggregate::Function::kSum, Links_Forward_Field},
+    {Aggregate::Function::kMin, Url_Field},
+    {Aggregate::Function::kMax, Links_Backward_Field},
+    {Aggregate::Function::kAvg, Links_Forward_Field},
+};
+
+// Computes kAggregates over the documents and prints them like the query
+std::string ComputeAggregates(const std::vector<const Document*>& documents) {
+    uint64_t codes = 0, forwards = 0;
+    int64_t forward_sum = 0;
+    std::optional<std::string> min_url {};
+    std::optional<int64_t> max_backward {};
+    for (auto* document : documents) {
+        for (auto& name : document->name()) {
+            codes += name.language_size();
+            if (name.has_url() && (!min_url || name.url() < *min_url)) {
+                min_url = name.url();
+            }
+        }
+        for (auto forward : document->links().forward()) {
+            forward_sum += forward;
+            forwards++;
+        }
+        for (auto backward : document->links().backward()) {
+            max_backward = std::max(max_backward.value_or(backward), backward);
+        }
+    }
+    std::stringstream out {};
+    out << "COUNT(*): " << documents.size() << std::endl;
+    out << "COUNT(Name.Language.Code): " << codes << std::endl;
+    out << "SUM(Links.Forward): " << forward_sum << std::endl;
+    out << "MIN(Name.Url): " << (min_url ? "\"" + *min_url + "\"" : "NULL") << std::endl;
+    out << "MAX(Links.Backward): " << (max_backward ? std::to_string(*max_backward) : "NULL") << std::endl;
+    out << "AVG(Links.Forward): ";
+    if (forwards > 0) {
+        out << static_cast<double>(forward_sum) / forwards;
+    } else {
+        out << "NULL";
+    }
+    out << std::endl;
+    return out.str();
+}
+
+// The output of CountLanguages() for a group
+std::string LanguageGroup(std::optional<std::string> code, std::optional<std::string> country, uint64_t count) {
+    return "Name.Language.Code: " + (code ? "\"" + *code + "\"" : "NULL") + "\n"
+           + "Name.Language.Country: " + (country ? "\"" + *country + "\"" : "NULL") + "\n"
+           + "COUNT(*): " + std::to_string(count) + "\n";
+}
+
 class QueryExecutionTest : public ::testing::Test {
  protected:
     void SetUp() override {
@@ -44,7 +161,10 @@ TEST_F(QueryExecutionTest, FullScan) {
 
 TEST_F(QueryExecutionTest, Selection) {
     TableScan scan("Document");
-    Selection sel(std::make_unique<TableScan>(std::move(scan)), {});  // TODO: some IUs
+    Selection sel(std::make_unique<TableScan>(std::move(scan)), {
+        Predicate(Document::descriptor()->FindFieldByName("DocId"), Predicate::Type::kLess, "100"),
+        Predicate(Document_Name::descriptor()->FindFieldByName("Url"), Predicate::Type::kLike, "http://%"),
+    });
     Print print(std::make_unique<Selection>(std::move(sel)));
     print.Prepare({imlab::schema::DocumentTable::fields()}, nullptr);
     Query query {std::move(print)};
@@ -52,4 +172,117 @@ TEST_F(QueryExecutionTest, Selection) {
     db.RunQuery(query);
 }
 
+TEST_F(QueryExecutionTest, Aggregates) {
+    Query query {};
+    AggregateDocuments(&query, kAggregates, false, {});
+
+    std::vector<const Document*> all {};
+    for (auto& document : documents) {
+        all.push_back(&document);
+    }
+    ASSERT_EQ(RunAndCapture(db, query), std::vector<std::string> {ComputeAggregates(all)});
+}
+
+TEST_F(QueryExecutionTest, AggregatesWithinRecord) {
+    Query query {};
+    AggregateDocuments(&query, kAggregates, true, {DocId_Field});
+
+    std::vector<std::string> expected {};
+    for (auto& document : documents) {
+        expected.push_back("DocId: " + std::to_string(document.docid()) + "\n" + ComputeAggregates({&document}));
+    }
+    std::sort(expected.begin(), expected.end());
+    ASSERT_EQ(RunAndCapture(db, query), expected);
+}
+
+// String equalities compare dictionary codes on dictionary-encoded segments and strings on plain ones.
+TEST_F(QueryExecutionTest, StringEqualityOnDictionaryColumn) {
+    auto& codes = db.DocumentTable.column<std::string>(Code_Field);
+    auto& urls = db.DocumentTable.column<std::string>(Url_Field);
+    ASSERT_TRUE(codes.segment(0).values().dictionary_encoded());
+    ASSERT_FALSE(urls.segment(0).values().dictionary_encoded());
+
+    std::string url {};
+    for (auto& document : documents) {
+        for (auto& name : document.name()) {
+            if (url.empty() && name.has_url()) {
+                url = name.url();
+            }
+        }
+    }
+    for (auto [field, value] : {std::pair(Code_Field, std::string("de-de")), std::pair(Code_Field, std::string("xx")),
+                                std::pair(Url_Field, url)}) {
+        uint64_t records = 0, record_codes = 0;
+        for (auto& document : documents) {
+            bool match = false;
+            uint64_t count = 0;
+            for (auto& name : document.name()) {
+                match |= field == Url_Field && name.url() == value;
+                for (auto& language : name.language()) {
+                    match |= field == Code_Field && language.code() == value;
+                    count++;
+                }
+            }
+            records += match;
+            record_codes += match ? count : 0;
+        }
+
+        Query query {};
+        CountMatches(&query, Predicate(field, Predicate::Type::kEqual, value));
+        ASSERT_EQ(RunAndCapture(db, query), std::vector<std::string> {
+            "COUNT(*): " + std::to_string(records) + "\nCOUNT(Name.Language.Code): " + std::to_string(record_codes) + "\n"})
+            << value;
+    }
+}
+
+// The records of the Dremel paper in Figure 2.
+TEST_F(QueryExecutionTest, GroupByFlattensRecords) {
+    imlab::Database paper {};
+    for (auto* json : {imlab_test::kTestDocumentPaperLarge, imlab_test::kTestDocumentPaperSmall}) {
+        std::stringstream in(json);
+        paper.LoadDocumentTable(in);
+    }
+    ASSERT_EQ(paper.DocumentTable.size(), 2);
+
+    Query query {};
+    CountLanguages(&query);
+
+    // The codes pair up with the countries of their languages; r1's name without languages and r2 are NULL.
+    std::vector<std::string> expected {
+        LanguageGroup(std::nullopt, std::nullopt, 2),
+        LanguageGroup("en", std::nullopt, 1),
+        LanguageGroup("en-gb", "gb", 1),
+        LanguageGroup("en-us", "us", 1),
+    };
+    std::sort(expected.begin(), expected.end());
+    ASSERT_EQ(RunAndCapture(paper, query), expected);
+}
+
+TEST_F(QueryExecutionTest, GroupByMatchesDocuments) {
+    // Every language is a tuple of the flattened records, as is every name without languages and every record without names.
+    std::map<std::pair<std::optional<std::string>, std::optional<std::string>>, uint64_t> groups {};
+    for (auto& document : documents) {
+        if (document.name().empty()) {
+            groups[{std::nullopt, std::nullopt}]++;
+        }
+        for (auto& name : document.name()) {
+            if (name.language().empty()) {
+                groups[{std::nullopt, std::nullopt}]++;
+            }
+            for (auto& language : name.language()) {
+                groups[{language.code(), language.has_country() ? std::optional(language.country()) : std::nullopt}]++;
+            }
+        }
+    }
+    std::vector<std::string> expected {};
+    for (auto& [group, count] : groups) {
+        expected.push_back(LanguageGroup(group.first, group.second, count));
+    }
+    std::sort(expected.begin(), expected.end());
+
+    Query query {};
+    CountLanguages(&query);
+    ASSERT_EQ(RunAndCapture(db, query), expected);
+}
+
 }  // namespace
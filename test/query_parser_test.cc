@@ -3,6 +3,7 @@
 // ---------------------------------------------------------------------------
 
 #include <sstream>
+#include "imlab/infra/error.h"
 #include "imlab/queryc/query_parse_context.h"
 #include "imlab/schemac/default_schema.h"
 #include "gtest/gtest.h"
@@ -18,4 +19,76 @@ TEST(QueryParseContextTest, ParseSimpleSelect) {
     auto& print = *query.op;
 }
 
+TEST(QueryParseContextTest, ParseComparisonsOnNestedFields) {
+    std::istringstream in("select DocId, Name.Url from Document"
+                          " where Name.Url like 'http://%' and DocId between 10 and 20"
+                          " and Name.Language.Code <> 'en' and Links.Forward > 5 and Document.Links.Backward < 100;");
+    QueryParseContext qpc {imlab::schemac::defaultSchema};
+    auto& query = qpc.Parse(in);
+    ASSERT_TRUE(query.op.has_value());
+}
+
+TEST(QueryParseContextTest, RejectInvalidPredicates) {
+    for (auto* sql : {
+            "select DocId from Document where Name.Url like '%.com';",
+            "select DocId from Document where DocId = 'abc';",
+            "select DocId from Document where Name.Unknown = 'abc';" }) {
+        std::istringstream in(sql);
+        QueryParseContext qpc {imlab::schemac::defaultSchema};
+        ASSERT_THROW(qpc.Parse(in), imlab::QueryCompilationError) << sql;
+    }
+}
+
+TEST(QueryParseContextTest, UnescapeStringLiterals) {
+    // The pattern is rejected, so the error shows how the literal was read.
+    std::istringstream in("select DocId from Document where Name.Url like 'it\\'s \\\\%a';");
+    QueryParseContext qpc {imlab::schemac::defaultSchema};
+    try {
+        qpc.Parse(in);
+        FAIL() << "the pattern is not a prefix";
+    } catch (imlab::QueryCompilationError& e) {
+        ASSERT_NE(std::string(e.what()).find("not 'it's \\%a'"), std::string::npos) << e.what();
+    }
+}
+
+TEST(QueryParseContextTest, ParseAggregates) {
+    for (auto* sql : {
+            "select count(*), count(Name.Language.Code), sum(Links.Forward), min(Name.Url), avg(DocId) from Document;",
+            "select DocId, count(Name.Language.Code) within record, max(Links.Backward) within record from Document"
+            " where DocId < 10;" }) {
+        std::istringstream in(sql);
+        QueryParseContext qpc {imlab::schemac::defaultSchema};
+        auto& query = qpc.Parse(in);
+        ASSERT_TRUE(query.op.has_value()) << sql;
+    }
+}
+
+TEST(QueryParseContextTest, ParseGroupBy) {
+    for (auto* sql : {
+            "select Name.Language.Country, count(*) from Document group by Name.Language.Country;",
+            "select count(Name.Url), Name.Language.Code from Document where DocId > 10"
+            " group by Name.Language.Code, Name.Language.Country",
+            "select DocId from Document group by DocId;" }) {
+        std::istringstream in(sql);
+        QueryParseContext qpc {imlab::schemac::defaultSchema};
+        auto& query = qpc.Parse(in);
+        ASSERT_TRUE(query.op.has_value()) << sql;
+    }
+}
+
+TEST(QueryParseContextTest, RejectInvalidAggregates) {
+    for (auto* sql : {
+            "select DocId, count(*) from Document;",
+            "select count(*) within record, count(DocId) from Document;",
+            "select sum(Name.Url) from Document;",
+            "select median(DocId) from Document;",
+            "select Name.Url, count(*) from Document group by DocId;",
+            "select count(*) within record from Document group by DocId;",
+            "select count(*) from Document group by Name.Unknown;" }) {
+        std::istringstream in(sql);
+        QueryParseContext qpc {imlab::schemac::defaultSchema};
+        ASSERT_THROW(qpc.Parse(in), imlab::QueryCompilationError) << sql;
+    }
+}
+
 }  // namespace
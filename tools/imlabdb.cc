@@ -3,9 +3,14 @@
 // ---------------------------------------------------------------------------
 #include <chrono>  // NOLINT
 #include <iostream>
+#include <filesystem>
 #include <fstream>
 #include <cstdlib>
+#include <string>
+#include <system_error>
 #include "database.h"
+#include "gflags/gflags.h"
+#include "imlab/infra/error.h"
 #include "imlab/schemac/schema_parse_context.h"
 #include "imlab/queryc/query_parse_context.h"
 #include "imlab/queryc/query_compiler.h"
@@ -15,17 +20,66 @@ using QueryParseContext = imlab::queryc::QueryParseContext;
 using QueryCompiler = imlab::queryc::QueryCompiler;
 // ---------------------------------------------------------------------------
 
+DEFINE_string(protobuf, "", "File of length-delimited serialized Documents that is loaded instead of the generated data");
+
+// The columns of the generated data are kept in this file across restarts
+const char *kDocumentTableFile = "../data/dremel/generated_data_10240_1024.imlab";
+// The generated data
+const char *kDocumentJsonFile = "../data/dremel/generated_data_10240_1024.json";
+
+// Identifies the generated data by its file and modification time, so that the kept columns are replaced
+// once the data was generated again. The schema and the version of the file format are checked by open().
+std::string documentSource() {
+    std::error_code error;
+    auto modified = std::filesystem::last_write_time(kDocumentJsonFile, error);
+    if (error) {
+        return "";
+    }
+    return std::string(kDocumentJsonFile) + "@" + std::to_string(modified.time_since_epoch().count());
+}
+
 imlab::Database loadDatabase() {
-    imlab::Database database{};
+    if (!FLAGS_protobuf.empty()) {
+        imlab::Database database{};
+        try {
+            database.LoadDocumentTableProtobuf(FLAGS_protobuf);
+        } catch (imlab::FileFormatError &e) {
+            // There is nothing to fall back to, the user asked for this file
+            std::cerr << std::endl << "error: " << e.what() << std::endl;
+            exit(1);
+        }
+        return database;
+    }
+
+    // Mapping the columns of an earlier run is much faster than generating and shredding the data again
+    if (std::ifstream(kDocumentTableFile).good()) {
+        try {
+            imlab::Database database{};
+            database.DocumentTable.open(kDocumentTableFile, documentSource());
+            return database;
+        } catch (imlab::FileFormatError &e) {
+            std::cerr << " [" << e.what() << ", reloading]" << std::flush;
+        }
+    }
 
+    imlab::Database database{};
     system("cd ../data/dremel && python3 generate_dremel_data.py 10240 1024");  // ~ 10 MiB
-    std::fstream dremel_file("../data/dremel/generated_data_10240_1024.json", std::fstream::in);
+    std::fstream dremel_file(kDocumentJsonFile, std::fstream::in);
     database.LoadDocumentTable(dremel_file);
+    try {
+        database.DocumentTable.save(kDocumentTableFile, documentSource());
+    } catch (imlab::FileFormatError &e) {
+        // The columns are loaded anyway, they just have to be shredded again next time.
+        std::cerr << " [" << e.what() << ", not kept]" << std::flush;
+    }
 
     return database;
 }
 
 int main(int argc, char *argv[]) {
+    gflags::SetUsageMessage("imlabdb [--protobuf <FILE>]");
+    gflags::ParseCommandLineFlags(&argc, &argv, true);
+
     // Load schema and database content
 
     auto load_schema_begin = std::chrono::steady_clock::now();
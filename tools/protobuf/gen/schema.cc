@@ -3,7 +3,13 @@
 // Do not edit this file directly.
 // ---------------------------------------------------------------------------
 #include "./schema.h"
+#include <fstream>
+#include <memory>
+#include <tbb/task_group.h>
+#include "../../../include/imlab/dremel/json_shredding.h"
+#include "../../../include/imlab/dremel/parquet.h"
 #include "../../../include/imlab/dremel/shredding.h"
+#include "../../../include/imlab/dremel/wire_shredding.h"
 #include "../../../include/imlab/dremel/assembling.h"
 #include "../../../include/imlab/dremel/record_fsm.h"
 // ---------------------------------------------------------------------------
@@ -15,39 +21,612 @@ std::vector<const FieldDescriptor*> DocumentTable::fields() {
     return { DocId_Descriptor, Links_Backward_Descriptor, Links_Forward_Descriptor, Name_Language_Code_Descriptor, Name_Language_Country_Descriptor, Name_Url_Descriptor, };
 }
 
+std::vector<RecordRange> DocumentTable::morsels() {
+    // The column with the most rows has the finest segments.
+    uint64_t rows = std::max({ DocId_Column.size(), Links_Backward_Column.size(), Links_Forward_Column.size(), Name_Language_Code_Column.size(), Name_Language_Country_Column.size(), Name_Url_Column.size(), });
+    if (DocId_Column.size() == rows) return AlignMorsels(DocId_Column);
+    if (Links_Backward_Column.size() == rows) return AlignMorsels(Links_Backward_Column);
+    if (Links_Forward_Column.size() == rows) return AlignMorsels(Links_Forward_Column);
+    if (Name_Language_Code_Column.size() == rows) return AlignMorsels(Name_Language_Code_Column);
+    if (Name_Language_Country_Column.size() == rows) return AlignMorsels(Name_Language_Country_Column);
+    if (Name_Url_Column.size() == rows) return AlignMorsels(Name_Url_Column);
+    return {};
+}
+
+std::vector<RecordRange> DocumentTable::candidate_records(const RangePredicate& predicate) {
+    if (predicate.field == DocId_Descriptor) return CandidateRecords(DocId_Column, predicate);
+    if (predicate.field == Links_Backward_Descriptor) return CandidateRecords(Links_Backward_Column, predicate);
+    if (predicate.field == Links_Forward_Descriptor) return CandidateRecords(Links_Forward_Column, predicate);
+    if (predicate.field == Name_Language_Code_Descriptor) return CandidateRecords(Name_Language_Code_Column, predicate);
+    if (predicate.field == Name_Language_Country_Descriptor) return CandidateRecords(Name_Language_Country_Column, predicate);
+    if (predicate.field == Name_Url_Descriptor) return CandidateRecords(Name_Url_Column, predicate);
+    return { { 0, size() } };
+}
+
+void DocumentTable::save(const std::string& path, const std::string& source) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    BinaryWriter writer { out };
+    WriteHeader(writer, Document::descriptor(), source);
+    DocId_Column.write(writer);
+    Links_Backward_Column.write(writer);
+    Links_Forward_Column.write(writer);
+    Name_Language_Code_Column.write(writer);
+    Name_Language_Country_Column.write(writer);
+    Name_Url_Column.write(writer);
+    if (!out.flush()) {
+        throw FileFormatError("cannot write " + path);
+    }
+}
+
+void DocumentTable::open(const std::string& path, const std::string& source) {
+    // A table whose columns were only partly replaced would be inconsistent, so it is emptied instead.
+    try {
+        BinaryReader reader { std::make_shared<const MappedFile>(path) };
+        ReadHeader(reader, Document::descriptor(), source);
+        DocId_Column.read(reader);
+        Links_Backward_Column.read(reader);
+        Links_Forward_Column.read(reader);
+        Name_Language_Code_Column.read(reader);
+        Name_Language_Country_Column.read(reader);
+        Name_Url_Column.read(reader);
+        // Every record has at least one row in every column.
+        if (DocId_Column.record_count() != _size
+                || Links_Backward_Column.record_count() != _size
+                || Links_Forward_Column.record_count() != _size
+                || Name_Language_Code_Column.record_count() != _size
+                || Name_Language_Country_Column.record_count() != _size
+                || Name_Url_Column.record_count() != _size) {
+            throw FileFormatError("the columns of " + path + " have different numbers of records");
+        }
+    } catch (...) {
+        clear();
+        throw;
+    }
+}
+
+void DocumentTable::clear() {
+    _size = 0;
+    DocId_Column.clear();
+    Links_Backward_Column.clear();
+    Links_Forward_Column.clear();
+    Name_Language_Code_Column.clear();
+    Name_Language_Country_Column.clear();
+    Name_Url_Column.clear();
+}
+
+void DocumentTable::export_parquet(const std::string& path) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    ExportParquet(*this, Document::descriptor(), out);
+}
+
+void DocumentTable::import_parquet(const std::string& path) {
+    _size += ImportParquet(*this, path);
+}
+
+void DocumentTable::load_json(std::istream& in) {
+    _size += ShredJson(*this, Document::descriptor(), in);
+}
+
+void DocumentTable::load_json_lines(std::istream& in, size_t chunk_size) {
+    BulkLoad(*this, [&](std::string* chunk) { return ReadJsonLines(in, chunk, chunk_size); },
+             [](DocumentTable& fragment, const std::string& chunk) {
+                 fragment._size += ShredJsonLines(fragment, Document::descriptor(), chunk);
+             });
+}
+
+void DocumentTable::load_protobuf(std::string_view stream, size_t chunk_size) {
+    BulkLoad<DocumentTable, std::string_view>(*this,
+        [&](std::string_view* chunk) { return SplitDelimitedRecords(&stream, chunk, chunk_size); },
+        [](DocumentTable& fragment, std::string_view chunk) {
+            ForEachDelimitedRecord(chunk, [&](std::string_view record) { fragment.insert_serialized(record); });
+        });
+}
+
+void DocumentTable::load_protobuf_file(const std::string& path, size_t chunk_size) {
+    MappedFile file { path };
+    load_protobuf(std::string_view(file.data(), file.size()), chunk_size);
+}
+
+void DocumentTable::append(DocumentTable& other) {
+    tbb::task_group columns;
+    columns.run([&] { DocId_Column.append(other.DocId_Column); });
+    columns.run([&] { Links_Backward_Column.append(other.Links_Backward_Column); });
+    columns.run([&] { Links_Forward_Column.append(other.Links_Forward_Column); });
+    columns.run([&] { Name_Language_Code_Column.append(other.Name_Language_Code_Column); });
+    columns.run([&] { Name_Language_Country_Column.append(other.Name_Language_Country_Column); });
+    columns.run([&] { Name_Url_Column.append(other.Name_Url_Column); });
+    columns.wait();
+    _size += other.size();
+    other.clear();
+}
+
 uint64_t DocumentTable::insert(Document& record) {
-    // Before we insert records with DissectRecord, we need to remember the last indices in each column.
-    // They will be the starting points of the fields of the dissected record.
-    DocId_Record_TIDs.push_back(DocId_Column.size());
-    Links_Backward_Record_TIDs.push_back(Links_Backward_Column.size());
-    Links_Forward_Record_TIDs.push_back(Links_Forward_Column.size());
-    Name_Language_Code_Record_TIDs.push_back(Name_Language_Code_Column.size());
-    Name_Language_Country_Record_TIDs.push_back(Name_Language_Country_Column.size());
-    Name_Url_Record_TIDs.push_back(Name_Url_Column.size());
+    Shred(record);
 
+    // Now the table contains one more record
+    return _size++;
+}
+
+uint64_t DocumentTable::insert_reflection(Document& record) {
     Shredder::DissectRecord(dynamic_cast<TableBase&>(*this), record);
 
     // Now the table contains one more record
     return _size++;
 }
 
+uint64_t DocumentTable::insert_serialized(std::string_view bytes) {
+    ShredSerialized(bytes);
+
+    // Now the table contains one more record
+    return _size++;
+}
+
+void DocumentTable::Shred(const Document& record) {
+    DocId_Column.insert_value(record.docid(), 0);
+    if (record.has_links()) {
+        const auto& links = record.links();
+        if (links.backward_size() == 0) {
+            Links_Backward_Column.insert_null(0, 1);
+        }
+        for (int links_backward_index = 0; links_backward_index < links.backward_size(); links_backward_index++) {
+            Links_Backward_Column.insert_value(links.backward(links_backward_index), links_backward_index == 0 ? 0 : 1);
+        }
+        if (links.forward_size() == 0) {
+            Links_Forward_Column.insert_null(0, 1);
+        }
+        for (int links_forward_index = 0; links_forward_index < links.forward_size(); links_forward_index++) {
+            Links_Forward_Column.insert_value(links.forward(links_forward_index), links_forward_index == 0 ? 0 : 1);
+        }
+    } else {
+        Links_Backward_Column.insert_null(0, 0);
+        Links_Forward_Column.insert_null(0, 0);
+    }
+    if (record.name_size() == 0) {
+        Name_Language_Code_Column.insert_null(0, 0);
+        Name_Language_Country_Column.insert_null(0, 0);
+        Name_Url_Column.insert_null(0, 0);
+    }
+    for (int name_index = 0; name_index < record.name_size(); name_index++) {
+        const auto& name = record.name(name_index);
+        const unsigned name_r = name_index == 0 ? 0 : 1;
+        if (name.language_size() == 0) {
+            Name_Language_Code_Column.insert_null(name_r, 1);
+            Name_Language_Country_Column.insert_null(name_r, 1);
+        }
+        for (int name_language_index = 0; name_language_index < name.language_size(); name_language_index++) {
+            const auto& name_language = name.language(name_language_index);
+            const unsigned name_language_r = name_language_index == 0 ? name_r : 2;
+            Name_Language_Code_Column.insert_value(name_language.code(), name_language_r);
+            if (name_language.has_country()) {
+                Name_Language_Country_Column.insert_value(name_language.country(), name_language_r);
+            } else {
+                Name_Language_Country_Column.insert_null(name_language_r, 2);
+            }
+        }
+        if (name.has_url()) {
+            Name_Url_Column.insert_value(name.url(), name_r);
+        } else {
+            Name_Url_Column.insert_null(name_r, 1);
+        }
+    }
+}
+
+void DocumentTable::ShredSerialized(std::string_view bytes) {
+    // Nothing is written before the whole record was checked.
+    if (!CheckSerialized(bytes)) {
+        Document parsed;
+        if (!parsed.ParseFromArray(bytes.data(), static_cast<int>(bytes.size()))) {
+            throw FileFormatError("invalid serialized Document");
+        }
+        Shred(parsed);
+        return;
+    }
+    WireReader record { bytes };
+    bool links_seen = false;
+    bool name_seen = false;
+    for (uint32_t record_tag; record.next_tag(&record_tag);) {
+        switch (WireReader::NumberOf(record_tag)) {
+            case 1: {
+                WireReader::Expect(record_tag, WireType::kVarint);
+                DocId_Column.insert_value(record.read_varint<int64_t>(), 0);
+                break;
+            }
+            case 2: {
+                WireReader links = record.begin_nested(record_tag);
+                links_seen = true;
+                bool links_backward_seen = false;
+                bool links_forward_seen = false;
+                for (uint32_t links_tag; links.next_tag(&links_tag);) {
+                    switch (WireReader::NumberOf(links_tag)) {
+                        case 3: {
+                            if (WireReader::TypeOf(links_tag) == WireType::kLengthDelimited) {
+                                for (WireReader packed = links.read_packed(); !packed.done(); links_backward_seen = true) {
+                                    Links_Backward_Column.insert_value(packed.read_varint<int64_t>(), links_backward_seen ? 1 : 0);
+                                }
+                                break;
+                            }
+                            WireReader::Expect(links_tag, WireType::kVarint);
+                            Links_Backward_Column.insert_value(links.read_varint<int64_t>(), links_backward_seen ? 1 : 0);
+                            links_backward_seen = true;
+                            break;
+                        }
+                        case 4: {
+                            if (WireReader::TypeOf(links_tag) == WireType::kLengthDelimited) {
+                                for (WireReader packed = links.read_packed(); !packed.done(); links_forward_seen = true) {
+                                    Links_Forward_Column.insert_value(packed.read_varint<int64_t>(), links_forward_seen ? 1 : 0);
+                                }
+                                break;
+                            }
+                            WireReader::Expect(links_tag, WireType::kVarint);
+                            Links_Forward_Column.insert_value(links.read_varint<int64_t>(), links_forward_seen ? 1 : 0);
+                            links_forward_seen = true;
+                            break;
+                        }
+                        default:
+                            links.skip(links_tag);
+                    }
+                }
+                if (!links_backward_seen) {
+                    Links_Backward_Column.insert_null(0, 1);
+                }
+                if (!links_forward_seen) {
+                    Links_Forward_Column.insert_null(0, 1);
+                }
+                record.end_nested(links);
+                break;
+            }
+            case 5: {
+                WireReader name = record.begin_nested(record_tag);
+                const unsigned name_r = name_seen ? 1 : 0;
+                name_seen = true;
+                bool name_language_seen = false;
+                bool name_url_seen = false;
+                for (uint32_t name_tag; name.next_tag(&name_tag);) {
+                    switch (WireReader::NumberOf(name_tag)) {
+                        case 6: {
+                            WireReader name_language = name.begin_nested(name_tag);
+                            const unsigned name_language_r = name_language_seen ? 2 : name_r;
+                            name_language_seen = true;
+                            bool name_language_country_seen = false;
+                            for (uint32_t name_language_tag; name_language.next_tag(&name_language_tag);) {
+                                switch (WireReader::NumberOf(name_language_tag)) {
+                                    case 7: {
+                                        WireReader::Expect(name_language_tag, WireType::kLengthDelimited);
+                                        Name_Language_Code_Column.insert_value(name_language.read_string(), name_language_r);
+                                        break;
+                                    }
+                                    case 8: {
+                                        WireReader::Expect(name_language_tag, WireType::kLengthDelimited);
+                                        Name_Language_Country_Column.insert_value(name_language.read_string(), name_language_r);
+                                        name_language_country_seen = true;
+                                        break;
+                                    }
+                                    default:
+                                        name_language.skip(name_language_tag);
+                                }
+                            }
+                            if (!name_language_country_seen) {
+                                Name_Language_Country_Column.insert_null(name_language_r, 2);
+                            }
+                            name.end_nested(name_language);
+                            break;
+                        }
+                        case 9: {
+                            WireReader::Expect(name_tag, WireType::kLengthDelimited);
+                            Name_Url_Column.insert_value(name.read_string(), name_r);
+                            name_url_seen = true;
+                            break;
+                        }
+                        default:
+                            name.skip(name_tag);
+                    }
+                }
+                if (!name_language_seen) {
+                    Name_Language_Code_Column.insert_null(name_r, 1);
+                    Name_Language_Country_Column.insert_null(name_r, 1);
+                }
+                if (!name_url_seen) {
+                    Name_Url_Column.insert_null(name_r, 1);
+                }
+                record.end_nested(name);
+                break;
+            }
+            default:
+                record.skip(record_tag);
+        }
+    }
+    if (!links_seen) {
+        Links_Backward_Column.insert_null(0, 0);
+        Links_Forward_Column.insert_null(0, 0);
+    }
+    if (!name_seen) {
+        Name_Language_Code_Column.insert_null(0, 0);
+        Name_Language_Country_Column.insert_null(0, 0);
+        Name_Url_Column.insert_null(0, 0);
+    }
+}
+
+bool DocumentTable::CheckSerialized(std::string_view bytes) {
+    WireReader record { bytes };
+    bool docid_seen = false;
+    bool links_seen = false;
+    for (uint32_t record_tag; record.next_tag(&record_tag);) {
+        switch (WireReader::NumberOf(record_tag)) {
+            case 1: {
+                if (docid_seen) {
+                    return false;
+                }
+                WireReader::Expect(record_tag, WireType::kVarint);
+                record.read_varint<int64_t>();
+                docid_seen = true;
+                break;
+            }
+            case 2: {
+                if (links_seen) {
+                    return false;
+                }
+                WireReader links = record.begin_nested(record_tag);
+                links_seen = true;
+                for (uint32_t links_tag; links.next_tag(&links_tag);) {
+                    switch (WireReader::NumberOf(links_tag)) {
+                        case 3: {
+                            if (WireReader::TypeOf(links_tag) == WireType::kLengthDelimited) {
+                                for (WireReader packed = links.read_packed(); !packed.done();) {
+                                    packed.read_varint<int64_t>();
+                                }
+                                break;
+                            }
+                            WireReader::Expect(links_tag, WireType::kVarint);
+                            links.read_varint<int64_t>();
+                            break;
+                        }
+                        case 4: {
+                            if (WireReader::TypeOf(links_tag) == WireType::kLengthDelimited) {
+                                for (WireReader packed = links.read_packed(); !packed.done();) {
+                                    packed.read_varint<int64_t>();
+                                }
+                                break;
+                            }
+                            WireReader::Expect(links_tag, WireType::kVarint);
+                            links.read_varint<int64_t>();
+                            break;
+                        }
+                        default:
+                            links.skip(links_tag);
+                    }
+                }
+                record.end_nested(links);
+                break;
+            }
+            case 5: {
+                WireReader name = record.begin_nested(record_tag);
+                bool name_url_seen = false;
+                for (uint32_t name_tag; name.next_tag(&name_tag);) {
+                    switch (WireReader::NumberOf(name_tag)) {
+                        case 6: {
+                            WireReader name_language = name.begin_nested(name_tag);
+                            bool name_language_code_seen = false;
+                            bool name_language_country_seen = false;
+                            for (uint32_t name_language_tag; name_language.next_tag(&name_language_tag);) {
+                                switch (WireReader::NumberOf(name_language_tag)) {
+                                    case 7: {
+                                        if (name_language_code_seen) {
+                                            return false;
+                                        }
+                                        WireReader::Expect(name_language_tag, WireType::kLengthDelimited);
+                                        name_language.read_string();
+                                        name_language_code_seen = true;
+                                        break;
+                                    }
+                                    case 8: {
+                                        if (name_language_country_seen) {
+                                            return false;
+                                        }
+                                        WireReader::Expect(name_language_tag, WireType::kLengthDelimited);
+                                        name_language.read_string();
+                                        name_language_country_seen = true;
+                                        break;
+                                    }
+                                    default:
+                                        name_language.skip(name_language_tag);
+                                }
+                            }
+                            if (!name_language_code_seen) {
+                                throw FileFormatError("the required field Code is missing");
+                            }
+                            name.end_nested(name_language);
+                            break;
+                        }
+                        case 9: {
+                            if (name_url_seen) {
+                                return false;
+                            }
+                            WireReader::Expect(name_tag, WireType::kLengthDelimited);
+                            name.read_string();
+                            name_url_seen = true;
+                            break;
+                        }
+                        default:
+                            name.skip(name_tag);
+                    }
+                }
+                record.end_nested(name);
+                break;
+            }
+            default:
+                record.skip(record_tag);
+        }
+    }
+    if (!docid_seen) {
+        throw FileFormatError("the required field DocId is missing");
+    }
+    return true;
+}
+
+void DocumentTable::AssembleRange(uint64_t from_tid, uint64_t to_tid, const std::vector<const FieldDescriptor*>& fields, Document* const* records) {
+    assert(from_tid >= 0 && from_tid <= to_tid && to_tid <= size());
+    Cursor cursor { *this, fields, from_tid };
+    for (uint64_t i = 0; i < to_tid - from_tid; i++) {
+        cursor.AssembleNext(records[i]);
+    }
+}
+
+DocumentTable::Cursor::Cursor(DocumentTable& table, const std::vector<const FieldDescriptor*>& fields, uint64_t tid)
+    : _table(table), _tid(tid),
+      DocId_Reader { &table.DocId_Column, 0 },
+      Links_Backward_Reader { &table.Links_Backward_Column, 0 },
+      Links_Forward_Reader { &table.Links_Forward_Column, 0 },
+      Name_Language_Code_Reader { &table.Name_Language_Code_Column, 0 },
+      Name_Language_Country_Reader { &table.Name_Language_Country_Column, 0 },
+      Name_Url_Reader { &table.Name_Url_Column, 0 } {
+    for (auto& field : fields) {
+        if (field == DocId_Descriptor) {
+            DocId_selected = true;
+        } else
+        if (field == Links_Backward_Descriptor) {
+            Links_Backward_selected = true;
+        } else
+        if (field == Links_Forward_Descriptor) {
+            Links_Forward_selected = true;
+        } else
+        if (field == Name_Language_Code_Descriptor) {
+            Name_Language_Code_selected = true;
+        } else
+        if (field == Name_Language_Country_Descriptor) {
+            Name_Language_Country_selected = true;
+        } else
+        if (field == Name_Url_Descriptor) {
+            Name_Url_selected = true;
+        } else
+        {}
+    }
+    Links_selected = Links_Backward_selected || Links_Forward_selected;
+    Name_selected = Name_Language_Code_selected || Name_Language_Country_selected || Name_Url_selected;
+    Name_Language_selected = Name_Language_Code_selected || Name_Language_Country_selected;
+    Position(tid);
+}
+
+void DocumentTable::Cursor::Position(uint64_t tid) {
+    assert(tid <= _table.size());
+    if (DocId_selected) DocId_Reader.Seek(_table.DocId_Column.record_start(tid));
+    if (Links_Backward_selected) Links_Backward_Reader.Seek(_table.Links_Backward_Column.record_start(tid));
+    if (Links_Forward_selected) Links_Forward_Reader.Seek(_table.Links_Forward_Column.record_start(tid));
+    if (Name_Language_Code_selected) Name_Language_Code_Reader.Seek(_table.Name_Language_Code_Column.record_start(tid));
+    if (Name_Language_Country_selected) Name_Language_Country_Reader.Seek(_table.Name_Language_Country_Column.record_start(tid));
+    if (Name_Url_selected) Name_Url_Reader.Seek(_table.Name_Url_Column.record_start(tid));
+    _tid = tid;
+}
+
+FieldValue DocumentTable::Cursor::Links_Peek() {
+    return Links_Backward_selected ? Links_Backward_Reader.Peek() : Links_Forward_Reader.Peek();
+}
+
+FieldValue DocumentTable::Cursor::Name_Peek() {
+    return Name_Language_Code_selected ? Name_Language_Code_Reader.Peek() : Name_Language_Country_selected ? Name_Language_Country_Reader.Peek() : Name_Url_Reader.Peek();
+}
+
+FieldValue DocumentTable::Cursor::Name_Language_Peek() {
+    return Name_Language_Code_selected ? Name_Language_Code_Reader.Peek() : Name_Language_Country_Reader.Peek();
+}
+
+void DocumentTable::Cursor::AssembleNext(Document* record) {
+    assert(_tid < _table.size());
+    if (DocId_selected) {
+        if (!DocId_Reader.Peek().is_null()) record->set_docid(DocId_Reader.PeekValue());
+        DocId_Reader.ReadNext();
+    }
+    if (Links_selected) {
+        if (Links_Peek().definition_level() >= 1) {
+            auto* links = record->mutable_links();
+            if (Links_Backward_selected) {
+                do {
+                    if (!Links_Backward_Reader.Peek().is_null()) links->add_backward(Links_Backward_Reader.PeekValue());
+                    Links_Backward_Reader.ReadNext();
+                } while (Links_Backward_Reader.Peek().repetition_level() == 1);
+            }
+            if (Links_Forward_selected) {
+                do {
+                    if (!Links_Forward_Reader.Peek().is_null()) links->add_forward(Links_Forward_Reader.PeekValue());
+                    Links_Forward_Reader.ReadNext();
+                } while (Links_Forward_Reader.Peek().repetition_level() == 1);
+            }
+        } else {
+            // The field is missing, so every column below it has a single NULL.
+            if (Links_Backward_selected) Links_Backward_Reader.ReadNext();
+            if (Links_Forward_selected) Links_Forward_Reader.ReadNext();
+        }
+    }
+    if (Name_selected) {
+        if (Name_Peek().definition_level() >= 1) {
+            do {
+                auto* name = record->add_name();
+                if (Name_Language_selected) {
+                    if (Name_Language_Peek().definition_level() >= 2) {
+                        do {
+                            auto* name_language = name->add_language();
+                            if (Name_Language_Code_selected) {
+                                if (!Name_Language_Code_Reader.Peek().is_null()) name_language->set_code(std::string(Name_Language_Code_Reader.PeekValue()));
+                                Name_Language_Code_Reader.ReadNext();
+                            }
+                            if (Name_Language_Country_selected) {
+                                if (!Name_Language_Country_Reader.Peek().is_null()) name_language->set_country(std::string(Name_Language_Country_Reader.PeekValue()));
+                                Name_Language_Country_Reader.ReadNext();
+                            }
+                        } while (Name_Language_Peek().repetition_level() == 2);
+                    } else {
+                        // The field is missing, so every column below it has a single NULL.
+                        if (Name_Language_Code_selected) Name_Language_Code_Reader.ReadNext();
+                        if (Name_Language_Country_selected) Name_Language_Country_Reader.ReadNext();
+                    }
+                }
+                if (Name_Url_selected) {
+                    if (!Name_Url_Reader.Peek().is_null()) name->set_url(std::string(Name_Url_Reader.PeekValue()));
+                    Name_Url_Reader.ReadNext();
+                }
+            } while (Name_Peek().repetition_level() == 1);
+        } else {
+            // The field is missing, so every column below it has a single NULL.
+            if (Name_Language_Code_selected) Name_Language_Code_Reader.ReadNext();
+            if (Name_Language_Country_selected) Name_Language_Country_Reader.ReadNext();
+            if (Name_Url_selected) Name_Url_Reader.ReadNext();
+        }
+    }
+    _tid++;
+}
+
 std::vector<Document> DocumentTable::get_range(uint64_t from_tid, uint64_t to_tid, const std::vector<const FieldDescriptor*>& fields) {
+    std::vector<Document> records(to_tid - from_tid);
+    std::vector<Document*> targets(records.size());
+    for (size_t i = 0; i < records.size(); i++) {
+        targets[i] = &records[i];
+    }
+    AssembleRange(from_tid, to_tid, fields, targets.data());
+    return records;
+}
+
+RecordBatch<Document> DocumentTable::get_batch(uint64_t from_tid, uint64_t to_tid, const std::vector<const FieldDescriptor*>& fields) {
+    RecordBatch<Document> batch(to_tid - from_tid);
+    AssembleRange(from_tid, to_tid, fields, batch.data());
+    return batch;
+}
+
+std::vector<Document> DocumentTable::get_range_reflection(uint64_t from_tid, uint64_t to_tid, const std::vector<const FieldDescriptor*>& fields) {
     assert(from_tid >= 0 && from_tid <= to_tid && to_tid <= size());
     RecordFSM fsm {fields};
 
     std::vector<IFieldReader*> readers {};
 
-    uint64_t DocId_index = DocId_Record_TIDs[from_tid];
+    uint64_t DocId_index = DocId_Column.record_start(from_tid);
     FieldReader DocId_Reader { &DocId_Column, DocId_index };
-    uint64_t Links_Backward_index = Links_Backward_Record_TIDs[from_tid];
+    uint64_t Links_Backward_index = Links_Backward_Column.record_start(from_tid);
     FieldReader Links_Backward_Reader { &Links_Backward_Column, Links_Backward_index };
-    uint64_t Links_Forward_index = Links_Forward_Record_TIDs[from_tid];
+    uint64_t Links_Forward_index = Links_Forward_Column.record_start(from_tid);
     FieldReader Links_Forward_Reader { &Links_Forward_Column, Links_Forward_index };
-    uint64_t Name_Language_Code_index = Name_Language_Code_Record_TIDs[from_tid];
+    uint64_t Name_Language_Code_index = Name_Language_Code_Column.record_start(from_tid);
     FieldReader Name_Language_Code_Reader { &Name_Language_Code_Column, Name_Language_Code_index };
-    uint64_t Name_Language_Country_index = Name_Language_Country_Record_TIDs[from_tid];
+    uint64_t Name_Language_Country_index = Name_Language_Country_Column.record_start(from_tid);
     FieldReader Name_Language_Country_Reader { &Name_Language_Country_Column, Name_Language_Country_index };
-    uint64_t Name_Url_index = Name_Url_Record_TIDs[from_tid];
+    uint64_t Name_Url_index = Name_Url_Column.record_start(from_tid);
     FieldReader Name_Url_Reader { &Name_Url_Column, Name_Url_index };
 
     for (auto& field : fields) {
@@ -73,9 +652,9 @@ std::vector<Document> DocumentTable::get_range(uint64_t from_tid, uint64_t to_ti
     }
 
     RecordAssembler<Document> assembler { fsm, readers };
-    std::vector<Document> records {};
-    for (unsigned i = from_tid; i < to_tid; i++) {
-        records.push_back(assembler.AssembleNextRecord());
+    std::vector<Document> records(to_tid - from_tid);
+    for (auto& record : records) {
+        assembler.AssembleNextRecord(&record);
     }
     return records;
 }
@@ -5,13 +5,23 @@
 #ifndef INCLUDE_IMLAB_SCHEMA_H_
 #define INCLUDE_IMLAB_SCHEMA_H_
 // ---------------------------------------------------------------------------
+#include <istream>
 #include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
 #include <vector>
 #include "./schema.pb.h"
+#include "../../../include/imlab/dremel/bulk_loading.h"
 #include "../../../include/imlab/dremel/storage.h"
+#include "../../../include/imlab/dremel/field_reader.h"
 #include "../../../include/imlab/dremel/field_writer.h"
+#include "../../../include/imlab/dremel/record_batch.h"
 #include "../../../include/imlab/infra/types.h"
 #include <google/protobuf/descriptor.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
 // ---------------------------------------------------------------------------
 namespace imlab {
 namespace schema {
@@ -22,39 +32,170 @@ class DocumentTable : public TableBase {
  public:
     /// Insert a new record into the table.
     uint64_t insert(Document& record);
+    /// Insert a new record into the table with the generic shredder that walks the record via reflection.
+    uint64_t insert_reflection(Document& record);
+    /// Insert a serialized record into the table; it is shredded straight from the Protobuf wire format.
+    uint64_t insert_serialized(std::string_view bytes);
     /// Gets one record from the table.
     Document get(uint64_t tid, const std::vector<const FieldDescriptor*>& fields) { return get_range(tid, tid + 1, fields)[0]; }
+    /// Gets one record from the table into an existing message, which is cleared first.
+    /// The nested messages that the message has allocated already are reused.
+    void get(uint64_t tid, const std::vector<const FieldDescriptor*>& fields, Document* record) { record->Clear(); AssembleRange(tid, tid + 1, fields, &record); }
     /// Gets a range of record from the table. `to_tid` is exclusive.
+    /// The records are assembled by code that is generated for this schema, without a RecordFSM or reflection.
     std::vector<Document> get_range(uint64_t from_tid, uint64_t to_tid, const std::vector<const FieldDescriptor*>& fields);
+    /// Gets a range of records that are allocated on an arena, which is freed together with the batch.
+    RecordBatch<Document> get_batch(uint64_t from_tid, uint64_t to_tid, const std::vector<const FieldDescriptor*>& fields);
+    /// Gets a range of records with the generic assembler that is driven by a RecordFSM and builds the records via reflection.
+    std::vector<Document> get_range_reflection(uint64_t from_tid, uint64_t to_tid, const std::vector<const FieldDescriptor*>& fields);
     /// Get the corresponding FieldWriter-tree for this table.
     FieldWriter* record_writer() override { return &Root_Writer; }
     /// Get a reference to the fields in this table.
     static std::vector<const FieldDescriptor*> fields();
+    /// Split the records into morsels that are aligned to segments.
+    std::vector<RecordRange> morsels() override;
+    /// Get the records that might satisfy a predicate according to the zone maps.
+    std::vector<RecordRange> candidate_records(const RangePredicate& predicate) override;
+    using TableBase::morsels;
+    /// Write all records to a file.
+    void save(const std::string& path, const std::string& source = "") override;
+    /// Replace all records with those in a file written by save(); the table is left empty if that fails.
+    void open(const std::string& path, const std::string& source = "") override;
+    /// Remove all records.
+    void clear();
+    /// Write all records to a Parquet file.
+    void export_parquet(const std::string& path);
+    /// Append the records of a Parquet file.
+    void import_parquet(const std::string& path);
+    /// Append the records of a JSON array; they are shredded while the JSON is parsed.
+    void load_json(std::istream& in);
+    /// Append the records of newline-delimited JSON; chunks of the input are shredded in parallel.
+    void load_json_lines(std::istream& in, size_t chunk_size = kDefaultBulkLoadChunkSize);
+    /// Append the records of a stream of length-delimited serialized records; chunks of it are shredded in parallel.
+    void load_protobuf(std::string_view stream, size_t chunk_size = kDefaultBulkLoadChunkSize);
+    /// Append the records of a file of length-delimited serialized records; the file is memory-mapped.
+    void load_protobuf_file(const std::string& path, size_t chunk_size = kDefaultBulkLoadChunkSize);
+    /// Append all records of another table, which is left empty; its segments are moved column by column in parallel.
+    void append(DocumentTable& other);
+    /// Call a function with every column of the table, in the order of fields().
+    template<typename Function>
+    void for_each_column(Function&& function) {
+        function(DocId_Column);
+        function(Links_Backward_Column);
+        function(Links_Forward_Column);
+        function(Name_Language_Code_Column);
+        function(Name_Language_Country_Column);
+        function(Name_Url_Column);
+    }
+    /// Get the column of a field, e.g. to scan it directly. T has to be the type of its values.
+    template<typename T>
+    DremelColumn<T>& column(const FieldDescriptor* field) {
+        DremelColumn<T>* result = nullptr;
+        for_each_column([&](auto& column) {
+            if constexpr (std::is_same_v<std::decay_t<decltype(column)>, DremelColumn<T>>) {
+                if (column.field() == field) result = &column;
+            }
+        });
+        if (result == nullptr) {
+            throw std::invalid_argument("no column of this type for the field " + field->full_name());
+        }
+        return *result;
+    }
+
+    /// Assembles records from the selected columns one after the other, with code that is generated for this schema.
+    /// A cursor keeps a positioned reader for every selected column, so it can move on to the next range of records
+    /// without setting up its readers again. A cursor is not thread-safe.
+    class Cursor {
+     public:
+        /// Creates a cursor for the selected fields that points to a record.
+        Cursor(DocumentTable& table, const std::vector<const FieldDescriptor*>& fields, uint64_t tid = 0);
+        /// Moves the cursor to a record; moving to the record under the cursor costs nothing.
+        void Seek(uint64_t tid) { if (tid != _tid) Position(tid); }
+        /// Assembles the record under the cursor into a message, which has to be empty, and moves to the next record.
+        void AssembleNext(Document* record);
+        /// The record under the cursor.
+        uint64_t tid() const { return _tid; }
+
+     protected:
+        /// Positions the readers of the selected columns at the first row of a record.
+        void Position(uint64_t tid);
+        // The levels of a nested field are those of the first selected column below it.
+        FieldValue Links_Peek();
+        FieldValue Name_Peek();
+        FieldValue Name_Language_Peek();
+
+        DocumentTable& _table;
+        uint64_t _tid;
+        bool DocId_selected = false;
+        bool Links_Backward_selected = false;
+        bool Links_Forward_selected = false;
+        bool Name_Language_Code_selected = false;
+        bool Name_Language_Country_selected = false;
+        bool Name_Url_selected = false;
+        bool Links_selected = false;
+        bool Name_selected = false;
+        bool Name_Language_selected = false;
+        FieldReader<int64_t> DocId_Reader;
+        FieldReader<int64_t> Links_Backward_Reader;
+        FieldReader<int64_t> Links_Forward_Reader;
+        FieldReader<std::string> Name_Language_Code_Reader;
+        FieldReader<std::string> Name_Language_Country_Reader;
+        FieldReader<std::string> Name_Url_Reader;
+    };
+
+    /// Assembles all records with the selected fields and calls callback(uint64_t tid, const Document& record)
+    /// for every one of them. The morsels (see morsels()) are scanned in parallel: Every worker keeps one Cursor
+    /// and one message for the whole scan and assembles the records of a morsel sequentially into the message.
+    /// The callback is called concurrently; the record is only valid until it returns.
+    template<typename Callback>
+    void scan_morsels(const std::vector<const FieldDescriptor*>& fields, Callback&& callback) {
+        struct Worker {
+            Cursor cursor;
+            Document record;
+        };
+        tbb::enumerable_thread_specific<Worker> workers([&] { return Worker { Cursor(*this, fields), {} }; });
+        const auto ranges = morsels();
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, ranges.size(), 1), [&](const tbb::blocked_range<size_t>& morsel_range) {
+            auto& worker = workers.local();
+            for (size_t m = morsel_range.begin(); m != morsel_range.end(); ++m) {
+                worker.cursor.Seek(ranges[m].begin);
+                for (uint64_t tid = ranges[m].begin; tid != ranges[m].end; ++tid) {
+                    worker.record.Clear();
+                    worker.cursor.AssembleNext(&worker.record);
+                    callback(tid, static_cast<const Document&>(worker.record));
+                }
+            }
+        });
+    }
 
  protected:
+    /// Shred a record into the columns; generated for this schema, so it needs no reflection.
+    void Shred(const Document& record);
+    /// Shred a serialized record into the columns without parsing it into a message.
+    /// Records are checked first, so a malformed record leaves all columns as they were.
+    void ShredSerialized(std::string_view bytes);
+    /// Check a serialized record; returns false if a field that is not repeated occurs more than once.
+    bool CheckSerialized(std::string_view bytes);
+    /// Assemble the records of a range into the given messages, which have to be empty.
+    void AssembleRange(uint64_t from_tid, uint64_t to_tid, const std::vector<const FieldDescriptor*>& fields, Document* const* records);
+
     static inline const FieldDescriptor* DocId_Descriptor = Document::descriptor()->FindFieldByName("DocId");
     DremelColumn<int64_t> DocId_Column { DocId_Descriptor };
-    std::vector<uint64_t> DocId_Record_TIDs;  // Maps the beginning of a record to a TID in the column.
 
     static inline const FieldDescriptor* Links_Backward_Descriptor = Document_Links::descriptor()->FindFieldByName("Backward");
     DremelColumn<int64_t> Links_Backward_Column { Links_Backward_Descriptor };
-    std::vector<uint64_t> Links_Backward_Record_TIDs;  // Maps the beginning of a record to a TID in the column.
 
     static inline const FieldDescriptor* Links_Forward_Descriptor = Document_Links::descriptor()->FindFieldByName("Forward");
     DremelColumn<int64_t> Links_Forward_Column { Links_Forward_Descriptor };
-    std::vector<uint64_t> Links_Forward_Record_TIDs;  // Maps the beginning of a record to a TID in the column.
 
     static inline const FieldDescriptor* Name_Language_Code_Descriptor = Document_Name_Language::descriptor()->FindFieldByName("Code");
     DremelColumn<std::string> Name_Language_Code_Column { Name_Language_Code_Descriptor };
-    std::vector<uint64_t> Name_Language_Code_Record_TIDs;  // Maps the beginning of a record to a TID in the column.
 
     static inline const FieldDescriptor* Name_Language_Country_Descriptor = Document_Name_Language::descriptor()->FindFieldByName("Country");
     DremelColumn<std::string> Name_Language_Country_Column { Name_Language_Country_Descriptor };
-    std::vector<uint64_t> Name_Language_Country_Record_TIDs;  // Maps the beginning of a record to a TID in the column.
 
     static inline const FieldDescriptor* Name_Url_Descriptor = Document_Name::descriptor()->FindFieldByName("Url");
     DremelColumn<std::string> Name_Url_Column { Name_Url_Descriptor };
-    std::vector<uint64_t> Name_Url_Record_TIDs;  // Maps the beginning of a record to a TID in the column.
 
     // A tree-like structure of FieldWriters
     AtomicFieldWriter<int64_t> DocId_Writer { &DocId_Column };
@@ -5,392 +5,313 @@
 
 #include <algorithm>
 
-#include <google/protobuf/stubs/common.h>
-#include <google/protobuf/stubs/port.h>
 #include <google/protobuf/io/coded_stream.h>
-#include <google/protobuf/wire_format_lite_inl.h>
+#include <google/protobuf/extension_set.h>
+#include <google/protobuf/wire_format_lite.h>
 #include <google/protobuf/descriptor.h>
 #include <google/protobuf/generated_message_reflection.h>
 #include <google/protobuf/reflection_ops.h>
 #include <google/protobuf/wire_format.h>
-// This is a temporary google only hack
-#ifdef GOOGLE_PROTOBUF_ENFORCE_UNIQUENESS
-#include "third_party/protobuf/version.h"
-#endif
 // @@protoc_insertion_point(includes)
-
-namespace protobuf_schema_2eproto {
-extern PROTOBUF_INTERNAL_EXPORT_protobuf_schema_2eproto ::google::protobuf::internal::SCCInfo<0> scc_info_Document_Links;
-extern PROTOBUF_INTERNAL_EXPORT_protobuf_schema_2eproto ::google::protobuf::internal::SCCInfo<0> scc_info_Document_Name_Language;
-extern PROTOBUF_INTERNAL_EXPORT_protobuf_schema_2eproto ::google::protobuf::internal::SCCInfo<1> scc_info_Document_Name;
-}  // namespace protobuf_schema_2eproto
-class Document_LinksDefaultTypeInternal {
- public:
-  ::google::protobuf::internal::ExplicitlyConstructed<Document_Links>
-      _instance;
-} _Document_Links_default_instance_;
-class Document_Name_LanguageDefaultTypeInternal {
- public:
-  ::google::protobuf::internal::ExplicitlyConstructed<Document_Name_Language>
-      _instance;
-} _Document_Name_Language_default_instance_;
-class Document_NameDefaultTypeInternal {
- public:
-  ::google::protobuf::internal::ExplicitlyConstructed<Document_Name>
-      _instance;
-} _Document_Name_default_instance_;
-class DocumentDefaultTypeInternal {
- public:
-  ::google::protobuf::internal::ExplicitlyConstructed<Document>
-      _instance;
-} _Document_default_instance_;
-namespace protobuf_schema_2eproto {
-static void InitDefaultsDocument_Links() {
-  GOOGLE_PROTOBUF_VERIFY_VERSION;
-
-  {
-    void* ptr = &::_Document_Links_default_instance_;
-    new (ptr) ::Document_Links();
-    ::google::protobuf::internal::OnShutdownDestroyMessage(ptr);
-  }
-  ::Document_Links::InitAsDefaultInstance();
-}
-
-::google::protobuf::internal::SCCInfo<0> scc_info_Document_Links =
-    {{ATOMIC_VAR_INIT(::google::protobuf::internal::SCCInfoBase::kUninitialized), 0, InitDefaultsDocument_Links}, {}};
-
-static void InitDefaultsDocument_Name_Language() {
-  GOOGLE_PROTOBUF_VERIFY_VERSION;
-
-  {
-    void* ptr = &::_Document_Name_Language_default_instance_;
-    new (ptr) ::Document_Name_Language();
-    ::google::protobuf::internal::OnShutdownDestroyMessage(ptr);
-  }
-  ::Document_Name_Language::InitAsDefaultInstance();
-}
-
-::google::protobuf::internal::SCCInfo<0> scc_info_Document_Name_Language =
-    {{ATOMIC_VAR_INIT(::google::protobuf::internal::SCCInfoBase::kUninitialized), 0, InitDefaultsDocument_Name_Language}, {}};
-
-static void InitDefaultsDocument_Name() {
-  GOOGLE_PROTOBUF_VERIFY_VERSION;
-
-  {
-    void* ptr = &::_Document_Name_default_instance_;
-    new (ptr) ::Document_Name();
-    ::google::protobuf::internal::OnShutdownDestroyMessage(ptr);
-  }
-  ::Document_Name::InitAsDefaultInstance();
-}
-
-::google::protobuf::internal::SCCInfo<1> scc_info_Document_Name =
-    {{ATOMIC_VAR_INIT(::google::protobuf::internal::SCCInfoBase::kUninitialized), 1, InitDefaultsDocument_Name}, {
-      &protobuf_schema_2eproto::scc_info_Document_Name_Language.base,}};
-
-static void InitDefaultsDocument() {
-  GOOGLE_PROTOBUF_VERIFY_VERSION;
-
-  {
-    void* ptr = &::_Document_default_instance_;
-    new (ptr) ::Document();
-    ::google::protobuf::internal::OnShutdownDestroyMessage(ptr);
-  }
-  ::Document::InitAsDefaultInstance();
-}
-
-::google::protobuf::internal::SCCInfo<2> scc_info_Document =
-    {{ATOMIC_VAR_INIT(::google::protobuf::internal::SCCInfoBase::kUninitialized), 2, InitDefaultsDocument}, {
-      &protobuf_schema_2eproto::scc_info_Document_Links.base,
-      &protobuf_schema_2eproto::scc_info_Document_Name.base,}};
-
-void InitDefaults() {
-  ::google::protobuf::internal::InitSCC(&scc_info_Document_Links.base);
-  ::google::protobuf::internal::InitSCC(&scc_info_Document_Name_Language.base);
-  ::google::protobuf::internal::InitSCC(&scc_info_Document_Name.base);
-  ::google::protobuf::internal::InitSCC(&scc_info_Document.base);
-}
-
-::google::protobuf::Metadata file_level_metadata[4];
-
-const ::google::protobuf::uint32 TableStruct::offsets[] GOOGLE_PROTOBUF_ATTRIBUTE_SECTION_VARIABLE(protodesc_cold) = {
-  GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(::Document_Links, _has_bits_),
-  GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(::Document_Links, _internal_metadata_),
+#include <google/protobuf/port_def.inc>
+
+PROTOBUF_PRAGMA_INIT_SEG
+
+namespace _pb = ::PROTOBUF_NAMESPACE_ID;
+namespace _pbi = _pb::internal;
+
+PROTOBUF_CONSTEXPR Document_Links::Document_Links(
+    ::_pbi::ConstantInitialized): _impl_{
+    /*decltype(_impl_.backward_)*/{}
+  , /*decltype(_impl_.forward_)*/{}
+  , /*decltype(_impl_._cached_size_)*/{}} {}
+struct Document_LinksDefaultTypeInternal {
+  PROTOBUF_CONSTEXPR Document_LinksDefaultTypeInternal()
+      : _instance(::_pbi::ConstantInitialized{}) {}
+  ~Document_LinksDefaultTypeInternal() {}
+  union {
+    Document_Links _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 Document_LinksDefaultTypeInternal _Document_Links_default_instance_;
+PROTOBUF_CONSTEXPR Document_Name_Language::Document_Name_Language(
+    ::_pbi::ConstantInitialized): _impl_{
+    /*decltype(_impl_._has_bits_)*/{}
+  , /*decltype(_impl_._cached_size_)*/{}
+  , /*decltype(_impl_.code_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
+  , /*decltype(_impl_.country_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}} {}
+struct Document_Name_LanguageDefaultTypeInternal {
+  PROTOBUF_CONSTEXPR Document_Name_LanguageDefaultTypeInternal()
+      : _instance(::_pbi::ConstantInitialized{}) {}
+  ~Document_Name_LanguageDefaultTypeInternal() {}
+  union {
+    Document_Name_Language _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 Document_Name_LanguageDefaultTypeInternal _Document_Name_Language_default_instance_;
+PROTOBUF_CONSTEXPR Document_Name::Document_Name(
+    ::_pbi::ConstantInitialized): _impl_{
+    /*decltype(_impl_._has_bits_)*/{}
+  , /*decltype(_impl_._cached_size_)*/{}
+  , /*decltype(_impl_.language_)*/{}
+  , /*decltype(_impl_.url_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}} {}
+struct Document_NameDefaultTypeInternal {
+  PROTOBUF_CONSTEXPR Document_NameDefaultTypeInternal()
+      : _instance(::_pbi::ConstantInitialized{}) {}
+  ~Document_NameDefaultTypeInternal() {}
+  union {
+    Document_Name _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 Document_NameDefaultTypeInternal _Document_Name_default_instance_;
+PROTOBUF_CONSTEXPR Document::Document(
+    ::_pbi::ConstantInitialized): _impl_{
+    /*decltype(_impl_._has_bits_)*/{}
+  , /*decltype(_impl_._cached_size_)*/{}
+  , /*decltype(_impl_.name_)*/{}
+  , /*decltype(_impl_.links_)*/nullptr
+  , /*decltype(_impl_.docid_)*/int64_t{0}} {}
+struct DocumentDefaultTypeInternal {
+  PROTOBUF_CONSTEXPR DocumentDefaultTypeInternal()
+      : _instance(::_pbi::ConstantInitialized{}) {}
+  ~DocumentDefaultTypeInternal() {}
+  union {
+    Document _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 DocumentDefaultTypeInternal _Document_default_instance_;
+static ::_pb::Metadata file_level_metadata_schema_2eproto[4];
+static constexpr ::_pb::EnumDescriptor const** file_level_enum_descriptors_schema_2eproto = nullptr;
+static constexpr ::_pb::ServiceDescriptor const** file_level_service_descriptors_schema_2eproto = nullptr;
+
+const uint32_t TableStruct_schema_2eproto::offsets[] PROTOBUF_SECTION_VARIABLE(protodesc_cold) = {
+  ~0u,  // no _has_bits_
+  PROTOBUF_FIELD_OFFSET(::Document_Links, _internal_metadata_),
   ~0u,  // no _extensions_
   ~0u,  // no _oneof_case_
   ~0u,  // no _weak_field_map_
-  GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(::Document_Links, backward_),
-  GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(::Document_Links, forward_),
-  ~0u,
-  ~0u,
-  GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(::Document_Name_Language, _has_bits_),
-  GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(::Document_Name_Language, _internal_metadata_),
+  ~0u,  // no _inlined_string_donated_
+  PROTOBUF_FIELD_OFFSET(::Document_Links, _impl_.backward_),
+  PROTOBUF_FIELD_OFFSET(::Document_Links, _impl_.forward_),
+  PROTOBUF_FIELD_OFFSET(::Document_Name_Language, _impl_._has_bits_),
+  PROTOBUF_FIELD_OFFSET(::Document_Name_Language, _internal_metadata_),
   ~0u,  // no _extensions_
   ~0u,  // no _oneof_case_
   ~0u,  // no _weak_field_map_
-  GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(::Document_Name_Language, code_),
-  GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(::Document_Name_Language, country_),
+  ~0u,  // no _inlined_string_donated_
+  PROTOBUF_FIELD_OFFSET(::Document_Name_Language, _impl_.code_),
+  PROTOBUF_FIELD_OFFSET(::Document_Name_Language, _impl_.country_),
   0,
   1,
-  GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(::Document_Name, _has_bits_),
-  GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(::Document_Name, _internal_metadata_),
+  PROTOBUF_FIELD_OFFSET(::Document_Name, _impl_._has_bits_),
+  PROTOBUF_FIELD_OFFSET(::Document_Name, _internal_metadata_),
   ~0u,  // no _extensions_
   ~0u,  // no _oneof_case_
   ~0u,  // no _weak_field_map_
-  GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(::Document_Name, language_),
-  GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(::Document_Name, url_),
+  ~0u,  // no _inlined_string_donated_
+  PROTOBUF_FIELD_OFFSET(::Document_Name, _impl_.language_),
+  PROTOBUF_FIELD_OFFSET(::Document_Name, _impl_.url_),
   ~0u,
   0,
-  GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(::Document, _has_bits_),
-  GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(::Document, _internal_metadata_),
+  PROTOBUF_FIELD_OFFSET(::Document, _impl_._has_bits_),
+  PROTOBUF_FIELD_OFFSET(::Document, _internal_metadata_),
   ~0u,  // no _extensions_
   ~0u,  // no _oneof_case_
   ~0u,  // no _weak_field_map_
-  GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(::Document, docid_),
-  GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(::Document, links_),
-  GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(::Document, name_),
+  ~0u,  // no _inlined_string_donated_
+  PROTOBUF_FIELD_OFFSET(::Document, _impl_.docid_),
+  PROTOBUF_FIELD_OFFSET(::Document, _impl_.links_),
+  PROTOBUF_FIELD_OFFSET(::Document, _impl_.name_),
   1,
   0,
   ~0u,
 };
-static const ::google::protobuf::internal::MigrationSchema schemas[] GOOGLE_PROTOBUF_ATTRIBUTE_SECTION_VARIABLE(protodesc_cold) = {
-  { 0, 7, sizeof(::Document_Links)},
-  { 9, 16, sizeof(::Document_Name_Language)},
-  { 18, 25, sizeof(::Document_Name)},
-  { 27, 35, sizeof(::Document)},
+static const ::_pbi::MigrationSchema schemas[] PROTOBUF_SECTION_VARIABLE(protodesc_cold) = {
+  { 0, -1, -1, sizeof(::Document_Links)},
+  { 8, 16, -1, sizeof(::Document_Name_Language)},
+  { 18, 26, -1, sizeof(::Document_Name)},
+  { 28, 37, -1, sizeof(::Document)},
 };
 
-static ::google::protobuf::Message const * const file_default_instances[] = {
-  reinterpret_cast<const ::google::protobuf::Message*>(&::_Document_Links_default_instance_),
-  reinterpret_cast<const ::google::protobuf::Message*>(&::_Document_Name_Language_default_instance_),
-  reinterpret_cast<const ::google::protobuf::Message*>(&::_Document_Name_default_instance_),
-  reinterpret_cast<const ::google::protobuf::Message*>(&::_Document_default_instance_),
+static const ::_pb::Message* const file_default_instances[] = {
+  &::_Document_Links_default_instance_._instance,
+  &::_Document_Name_Language_default_instance_._instance,
+  &::_Document_Name_default_instance_._instance,
+  &::_Document_default_instance_._instance,
 };
 
-void protobuf_AssignDescriptors() {
-  AddDescriptors();
-  AssignDescriptors(
-      "schema.proto", schemas, file_default_instances, TableStruct::offsets,
-      file_level_metadata, NULL, NULL);
-}
-
-void protobuf_AssignDescriptorsOnce() {
-  static ::google::protobuf::internal::once_flag once;
-  ::google::protobuf::internal::call_once(once, protobuf_AssignDescriptors);
-}
-
-void protobuf_RegisterTypes(const ::std::string&) GOOGLE_PROTOBUF_ATTRIBUTE_COLD;
-void protobuf_RegisterTypes(const ::std::string&) {
-  protobuf_AssignDescriptorsOnce();
-  ::google::protobuf::internal::RegisterAllTypes(file_level_metadata, 4);
-}
-
-void AddDescriptorsImpl() {
-  InitDefaults();
-  static const char descriptor[] GOOGLE_PROTOBUF_ATTRIBUTE_SECTION_VARIABLE(protodesc_cold) = {
-      "\n\014schema.proto\"\356\001\n\010Document\022\r\n\005DocId\030\001 \002"
-      "(\003\022\036\n\005links\030\002 \001(\n2\017.Document.Links\022\034\n\004na"
-      "me\030\005 \003(\n2\016.Document.Name\032*\n\005Links\022\020\n\010Bac"
-      "kward\030\003 \003(\003\022\017\n\007Forward\030\004 \003(\003\032i\n\004Name\022)\n\010"
-      "language\030\006 \003(\n2\027.Document.Name.Language\022"
-      "\013\n\003Url\030\t \001(\t\032)\n\010Language\022\014\n\004Code\030\007 \002(\t\022\017"
-      "\n\007Country\030\010 \001(\t"
-  };
-  ::google::protobuf::DescriptorPool::InternalAddGeneratedFile(
-      descriptor, 255);
-  ::google::protobuf::MessageFactory::InternalRegisterGeneratedFile(
-    "schema.proto", &protobuf_RegisterTypes);
+const char descriptor_table_protodef_schema_2eproto[] PROTOBUF_SECTION_VARIABLE(protodesc_cold) =
+  "\n\014schema.proto\"\356\001\n\010Document\022\r\n\005DocId\030\001 \002"
+  "(\003\022\036\n\005links\030\002 \001(\n2\017.Document.Links\022\034\n\004na"
+  "me\030\005 \003(\n2\016.Document.Name\032*\n\005Links\022\020\n\010Bac"
+  "kward\030\003 \003(\003\022\017\n\007Forward\030\004 \003(\003\032i\n\004Name\022)\n\010"
+  "language\030\006 \003(\n2\027.Document.Name.Language\022"
+  "\013\n\003Url\030\t \001(\t\032)\n\010Language\022\014\n\004Code\030\007 \002(\t\022\017"
+  "\n\007Country\030\010 \001(\tB\003\370\001\001"
+  ;
+static ::_pbi::once_flag descriptor_table_schema_2eproto_once;
+const ::_pbi::DescriptorTable descriptor_table_schema_2eproto = {
+    false, false, 260, descriptor_table_protodef_schema_2eproto,
+    "schema.proto",
+    &descriptor_table_schema_2eproto_once, nullptr, 0, 4,
+    schemas, file_default_instances, TableStruct_schema_2eproto::offsets,
+    file_level_metadata_schema_2eproto, file_level_enum_descriptors_schema_2eproto,
+    file_level_service_descriptors_schema_2eproto,
+};
+PROTOBUF_ATTRIBUTE_WEAK const ::_pbi::DescriptorTable* descriptor_table_schema_2eproto_getter() {
+  return &descriptor_table_schema_2eproto;
 }
 
-void AddDescriptors() {
-  static ::google::protobuf::internal::once_flag once;
-  ::google::protobuf::internal::call_once(once, AddDescriptorsImpl);
-}
-// Force AddDescriptors() to be called at dynamic initialization time.
-struct StaticDescriptorInitializer {
-  StaticDescriptorInitializer() {
-    AddDescriptors();
-  }
-} static_descriptor_initializer;
-}  // namespace protobuf_schema_2eproto
+// Force running AddDescriptors() at dynamic initialization time.
+PROTOBUF_ATTRIBUTE_INIT_PRIORITY2 static ::_pbi::AddDescriptorsRunner dynamic_init_dummy_schema_2eproto(&descriptor_table_schema_2eproto);
 
 // ===================================================================
 
-void Document_Links::InitAsDefaultInstance() {
-}
-#if !defined(_MSC_VER) || _MSC_VER >= 1900
-const int Document_Links::kBackwardFieldNumber;
-const int Document_Links::kForwardFieldNumber;
-#endif  // !defined(_MSC_VER) || _MSC_VER >= 1900
+class Document_Links::_Internal {
+ public:
+};
 
-Document_Links::Document_Links()
-  : ::google::protobuf::Message(), _internal_metadata_(NULL) {
-  ::google::protobuf::internal::InitSCC(
-      &protobuf_schema_2eproto::scc_info_Document_Links.base);
-  SharedCtor();
-  // @@protoc_insertion_point(constructor:Document.Links)
+Document_Links::Document_Links(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                         bool is_message_owned)
+  : ::PROTOBUF_NAMESPACE_ID::Message(arena, is_message_owned) {
+  SharedCtor(arena, is_message_owned);
+  // @@protoc_insertion_point(arena_constructor:Document.Links)
 }
 Document_Links::Document_Links(const Document_Links& from)
-  : ::google::protobuf::Message(),
-      _internal_metadata_(NULL),
-      _has_bits_(from._has_bits_),
-      backward_(from.backward_),
-      forward_(from.forward_) {
-  _internal_metadata_.MergeFrom(from._internal_metadata_);
+  : ::PROTOBUF_NAMESPACE_ID::Message() {
+  Document_Links* const _this = this; (void)_this;
+  new (&_impl_) Impl_{
+      decltype(_impl_.backward_){from._impl_.backward_}
+    , decltype(_impl_.forward_){from._impl_.forward_}
+    , /*decltype(_impl_._cached_size_)*/{}};
+
+  _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
   // @@protoc_insertion_point(copy_constructor:Document.Links)
 }
 
-void Document_Links::SharedCtor() {
+inline void Document_Links::SharedCtor(
+    ::_pb::Arena* arena, bool is_message_owned) {
+  (void)arena;
+  (void)is_message_owned;
+  new (&_impl_) Impl_{
+      decltype(_impl_.backward_){arena}
+    , decltype(_impl_.forward_){arena}
+    , /*decltype(_impl_._cached_size_)*/{}
+  };
 }
 
 Document_Links::~Document_Links() {
   // @@protoc_insertion_point(destructor:Document.Links)
+  if (auto *arena = _internal_metadata_.DeleteReturnArena<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>()) {
+  (void)arena;
+    return;
+  }
   SharedDtor();
 }
 
-void Document_Links::SharedDtor() {
+inline void Document_Links::SharedDtor() {
+  GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+  _impl_.backward_.~RepeatedField();
+  _impl_.forward_.~RepeatedField();
 }
 
 void Document_Links::SetCachedSize(int size) const {
-  _cached_size_.Set(size);
-}
-const ::google::protobuf::Descriptor* Document_Links::descriptor() {
-  ::protobuf_schema_2eproto::protobuf_AssignDescriptorsOnce();
-  return ::protobuf_schema_2eproto::file_level_metadata[kIndexInFileMessages].descriptor;
+  _impl_._cached_size_.Set(size);
 }
 
-const Document_Links& Document_Links::default_instance() {
-  ::google::protobuf::internal::InitSCC(&protobuf_schema_2eproto::scc_info_Document_Links.base);
-  return *internal_default_instance();
-}
-
-
 void Document_Links::Clear() {
 // @@protoc_insertion_point(message_clear_start:Document.Links)
-  ::google::protobuf::uint32 cached_has_bits = 0;
+  uint32_t cached_has_bits = 0;
   // Prevent compiler warnings about cached_has_bits being unused
   (void) cached_has_bits;
 
-  backward_.Clear();
-  forward_.Clear();
-  _has_bits_.Clear();
-  _internal_metadata_.Clear();
-}
-
-bool Document_Links::MergePartialFromCodedStream(
-    ::google::protobuf::io::CodedInputStream* input) {
-#define DO_(EXPRESSION) if (!GOOGLE_PREDICT_TRUE(EXPRESSION)) goto failure
-  ::google::protobuf::uint32 tag;
-  // @@protoc_insertion_point(parse_start:Document.Links)
-  for (;;) {
-    ::std::pair<::google::protobuf::uint32, bool> p = input->ReadTagWithCutoffNoLastTag(127u);
-    tag = p.first;
-    if (!p.second) goto handle_unusual;
-    switch (::google::protobuf::internal::WireFormatLite::GetTagFieldNumber(tag)) {
+  _impl_.backward_.Clear();
+  _impl_.forward_.Clear();
+  _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
+}
+
+const char* Document_Links::_InternalParse(const char* ptr, ::_pbi::ParseContext* ctx) {
+#define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  while (!ctx->Done(&ptr)) {
+    uint32_t tag;
+    ptr = ::_pbi::ReadTag(ptr, &tag);
+    switch (tag >> 3) {
       // repeated int64 Backward = 3;
-      case 3: {
-        if (static_cast< ::google::protobuf::uint8>(tag) ==
-            static_cast< ::google::protobuf::uint8>(24u /* 24 & 0xFF */)) {
-          DO_((::google::protobuf::internal::WireFormatLite::ReadRepeatedPrimitive<
-                   ::google::protobuf::int64, ::google::protobuf::internal::WireFormatLite::TYPE_INT64>(
-                 1, 24u, input, this->mutable_backward())));
-        } else if (
-            static_cast< ::google::protobuf::uint8>(tag) ==
-            static_cast< ::google::protobuf::uint8>(26u /* 26 & 0xFF */)) {
-          DO_((::google::protobuf::internal::WireFormatLite::ReadPackedPrimitiveNoInline<
-                   ::google::protobuf::int64, ::google::protobuf::internal::WireFormatLite::TYPE_INT64>(
-                 input, this->mutable_backward())));
-        } else {
+      case 3:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 24)) {
+          ptr -= 1;
+          do {
+            ptr += 1;
+            _internal_add_backward(::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr));
+            CHK_(ptr);
+            if (!ctx->DataAvailable(ptr)) break;
+          } while (::PROTOBUF_NAMESPACE_ID::internal::ExpectTag<24>(ptr));
+        } else if (static_cast<uint8_t>(tag) == 26) {
+          ptr = ::PROTOBUF_NAMESPACE_ID::internal::PackedInt64Parser(_internal_mutable_backward(), ptr, ctx);
+          CHK_(ptr);
+        } else
           goto handle_unusual;
-        }
-        break;
-      }
-
+        continue;
       // repeated int64 Forward = 4;
-      case 4: {
-        if (static_cast< ::google::protobuf::uint8>(tag) ==
-            static_cast< ::google::protobuf::uint8>(32u /* 32 & 0xFF */)) {
-          DO_((::google::protobuf::internal::WireFormatLite::ReadRepeatedPrimitive<
-                   ::google::protobuf::int64, ::google::protobuf::internal::WireFormatLite::TYPE_INT64>(
-                 1, 32u, input, this->mutable_forward())));
-        } else if (
-            static_cast< ::google::protobuf::uint8>(tag) ==
-            static_cast< ::google::protobuf::uint8>(34u /* 34 & 0xFF */)) {
-          DO_((::google::protobuf::internal::WireFormatLite::ReadPackedPrimitiveNoInline<
-                   ::google::protobuf::int64, ::google::protobuf::internal::WireFormatLite::TYPE_INT64>(
-                 input, this->mutable_forward())));
-        } else {
+      case 4:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 32)) {
+          ptr -= 1;
+          do {
+            ptr += 1;
+            _internal_add_forward(::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr));
+            CHK_(ptr);
+            if (!ctx->DataAvailable(ptr)) break;
+          } while (::PROTOBUF_NAMESPACE_ID::internal::ExpectTag<32>(ptr));
+        } else if (static_cast<uint8_t>(tag) == 34) {
+          ptr = ::PROTOBUF_NAMESPACE_ID::internal::PackedInt64Parser(_internal_mutable_forward(), ptr, ctx);
+          CHK_(ptr);
+        } else
           goto handle_unusual;
-        }
-        break;
-      }
-
-      default: {
-      handle_unusual:
-        if (tag == 0 ||
-            ::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
-            ::google::protobuf::internal::WireFormatLite::WIRETYPE_END_GROUP) {
-          input->SetLastTag(tag);
-          goto success;
-        }
-        DO_(::google::protobuf::internal::WireFormat::SkipField(
-              input, tag, _internal_metadata_.mutable_unknown_fields()));
-        break;
-      }
+        continue;
+      default:
+        goto handle_unusual;
+    }  // switch
+  handle_unusual:
+    if ((tag == 0) || ((tag & 7) == 4)) {
+      CHK_(ptr);
+      ctx->SetLastTag(tag);
+      goto message_done;
     }
-  }
-success:
-  // @@protoc_insertion_point(parse_success:Document.Links)
-  return true;
+    ptr = UnknownFieldParse(
+        tag,
+        _internal_metadata_.mutable_unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(),
+        ptr, ctx);
+    CHK_(ptr != nullptr);
+  }  // while
+message_done:
+  return ptr;
 failure:
-  // @@protoc_insertion_point(parse_failure:Document.Links)
-  return false;
-#undef DO_
+  ptr = nullptr;
+  goto message_done;
+#undef CHK_
 }
 
-void Document_Links::SerializeWithCachedSizes(
-    ::google::protobuf::io::CodedOutputStream* output) const {
-  // @@protoc_insertion_point(serialize_start:Document.Links)
-  ::google::protobuf::uint32 cached_has_bits = 0;
+uint8_t* Document_Links::_InternalSerialize(
+    uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
+  // @@protoc_insertion_point(serialize_to_array_start:Document.Links)
+  uint32_t cached_has_bits = 0;
   (void) cached_has_bits;
 
   // repeated int64 Backward = 3;
-  for (int i = 0, n = this->backward_size(); i < n; i++) {
-    ::google::protobuf::internal::WireFormatLite::WriteInt64(
-      3, this->backward(i), output);
+  for (int i = 0, n = this->_internal_backward_size(); i < n; i++) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteInt64ToArray(3, this->_internal_backward(i), target);
   }
 
   // repeated int64 Forward = 4;
-  for (int i = 0, n = this->forward_size(); i < n; i++) {
-    ::google::protobuf::internal::WireFormatLite::WriteInt64(
-      4, this->forward(i), output);
-  }
-
-  if (_internal_metadata_.have_unknown_fields()) {
-    ::google::protobuf::internal::WireFormat::SerializeUnknownFields(
-        _internal_metadata_.unknown_fields(), output);
+  for (int i = 0, n = this->_internal_forward_size(); i < n; i++) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteInt64ToArray(4, this->_internal_forward(i), target);
   }
-  // @@protoc_insertion_point(serialize_end:Document.Links)
-}
 
-::google::protobuf::uint8* Document_Links::InternalSerializeWithCachedSizesToArray(
-    bool deterministic, ::google::protobuf::uint8* target) const {
-  (void)deterministic; // Unused
-  // @@protoc_insertion_point(serialize_to_array_start:Document.Links)
-  ::google::protobuf::uint32 cached_has_bits = 0;
-  (void) cached_has_bits;
-
-  // repeated int64 Backward = 3;
-  target = ::google::protobuf::internal::WireFormatLite::
-    WriteInt64ToArray(3, this->backward_, target);
-
-  // repeated int64 Forward = 4;
-  target = ::google::protobuf::internal::WireFormatLite::
-    WriteInt64ToArray(4, this->forward_, target);
-
-  if (_internal_metadata_.have_unknown_fields()) {
-    target = ::google::protobuf::internal::WireFormat::SerializeUnknownFieldsToArray(
-        _internal_metadata_.unknown_fields(), target);
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
+        _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
   }
   // @@protoc_insertion_point(serialize_to_array_end:Document.Links)
   return target;
@@ -400,65 +321,49 @@ size_t Document_Links::ByteSizeLong() const {
 // @@protoc_insertion_point(message_byte_size_start:Document.Links)
   size_t total_size = 0;
 
-  if (_internal_metadata_.have_unknown_fields()) {
-    total_size +=
-      ::google::protobuf::internal::WireFormat::ComputeUnknownFieldsSize(
-        _internal_metadata_.unknown_fields());
-  }
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
   // repeated int64 Backward = 3;
   {
-    size_t data_size = ::google::protobuf::internal::WireFormatLite::
-      Int64Size(this->backward_);
+    size_t data_size = ::_pbi::WireFormatLite::
+      Int64Size(this->_impl_.backward_);
     total_size += 1 *
-                  ::google::protobuf::internal::FromIntSize(this->backward_size());
+                  ::_pbi::FromIntSize(this->_internal_backward_size());
     total_size += data_size;
   }
 
   // repeated int64 Forward = 4;
   {
-    size_t data_size = ::google::protobuf::internal::WireFormatLite::
-      Int64Size(this->forward_);
+    size_t data_size = ::_pbi::WireFormatLite::
+      Int64Size(this->_impl_.forward_);
     total_size += 1 *
-                  ::google::protobuf::internal::FromIntSize(this->forward_size());
+                  ::_pbi::FromIntSize(this->_internal_forward_size());
     total_size += data_size;
   }
 
-  int cached_size = ::google::protobuf::internal::ToCachedSize(total_size);
-  SetCachedSize(cached_size);
-  return total_size;
-}
-
-void Document_Links::MergeFrom(const ::google::protobuf::Message& from) {
-// @@protoc_insertion_point(generalized_merge_from_start:Document.Links)
-  GOOGLE_DCHECK_NE(&from, this);
-  const Document_Links* source =
-      ::google::protobuf::internal::DynamicCastToGenerated<const Document_Links>(
-          &from);
-  if (source == NULL) {
-  // @@protoc_insertion_point(generalized_merge_from_cast_fail:Document.Links)
-    ::google::protobuf::internal::ReflectionOps::Merge(from, this);
-  } else {
-  // @@protoc_insertion_point(generalized_merge_from_cast_success:Document.Links)
-    MergeFrom(*source);
-  }
+  return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
 }
 
-void Document_Links::MergeFrom(const Document_Links& from) {
-// @@protoc_insertion_point(class_specific_merge_from_start:Document.Links)
-  GOOGLE_DCHECK_NE(&from, this);
-  _internal_metadata_.MergeFrom(from._internal_metadata_);
-  ::google::protobuf::uint32 cached_has_bits = 0;
-  (void) cached_has_bits;
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData Document_Links::_class_data_ = {
+    ::PROTOBUF_NAMESPACE_ID::Message::CopyWithSourceCheck,
+    Document_Links::MergeImpl
+};
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*Document_Links::GetClassData() const { return &_class_data_; }
 
-  backward_.MergeFrom(from.backward_);
-  forward_.MergeFrom(from.forward_);
-}
 
-void Document_Links::CopyFrom(const ::google::protobuf::Message& from) {
-// @@protoc_insertion_point(generalized_copy_from_start:Document.Links)
-  if (&from == this) return;
-  Clear();
-  MergeFrom(from);
+void Document_Links::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg) {
+  auto* const _this = static_cast<Document_Links*>(&to_msg);
+  auto& from = static_cast<const Document_Links&>(from_msg);
+  // @@protoc_insertion_point(class_specific_merge_from_start:Document.Links)
+  GOOGLE_DCHECK_NE(&from, _this);
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  _this->_impl_.backward_.MergeFrom(from._impl_.backward_);
+  _this->_impl_.forward_.MergeFrom(from._impl_.forward_);
+  _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
 }
 
 void Document_Links::CopyFrom(const Document_Links& from) {
@@ -472,236 +377,213 @@ bool Document_Links::IsInitialized() const {
   return true;
 }
 
-void Document_Links::Swap(Document_Links* other) {
-  if (other == this) return;
-  InternalSwap(other);
-}
 void Document_Links::InternalSwap(Document_Links* other) {
   using std::swap;
-  backward_.InternalSwap(&other->backward_);
-  forward_.InternalSwap(&other->forward_);
-  swap(_has_bits_[0], other->_has_bits_[0]);
-  _internal_metadata_.Swap(&other->_internal_metadata_);
+  _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  _impl_.backward_.InternalSwap(&other->_impl_.backward_);
+  _impl_.forward_.InternalSwap(&other->_impl_.forward_);
 }
 
-::google::protobuf::Metadata Document_Links::GetMetadata() const {
-  protobuf_schema_2eproto::protobuf_AssignDescriptorsOnce();
-  return ::protobuf_schema_2eproto::file_level_metadata[kIndexInFileMessages];
+::PROTOBUF_NAMESPACE_ID::Metadata Document_Links::GetMetadata() const {
+  return ::_pbi::AssignDescriptors(
+      &descriptor_table_schema_2eproto_getter, &descriptor_table_schema_2eproto_once,
+      file_level_metadata_schema_2eproto[0]);
 }
 
-
 // ===================================================================
 
-void Document_Name_Language::InitAsDefaultInstance() {
-}
-#if !defined(_MSC_VER) || _MSC_VER >= 1900
-const int Document_Name_Language::kCodeFieldNumber;
-const int Document_Name_Language::kCountryFieldNumber;
-#endif  // !defined(_MSC_VER) || _MSC_VER >= 1900
+class Document_Name_Language::_Internal {
+ public:
+  using HasBits = decltype(std::declval<Document_Name_Language>()._impl_._has_bits_);
+  static void set_has_code(HasBits* has_bits) {
+    (*has_bits)[0] |= 1u;
+  }
+  static void set_has_country(HasBits* has_bits) {
+    (*has_bits)[0] |= 2u;
+  }
+  static bool MissingRequiredFields(const HasBits& has_bits) {
+    return ((has_bits[0] & 0x00000001) ^ 0x00000001) != 0;
+  }
+};
 
-Document_Name_Language::Document_Name_Language()
-  : ::google::protobuf::Message(), _internal_metadata_(NULL) {
-  ::google::protobuf::internal::InitSCC(
-      &protobuf_schema_2eproto::scc_info_Document_Name_Language.base);
-  SharedCtor();
-  // @@protoc_insertion_point(constructor:Document.Name.Language)
+Document_Name_Language::Document_Name_Language(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                         bool is_message_owned)
+  : ::PROTOBUF_NAMESPACE_ID::Message(arena, is_message_owned) {
+  SharedCtor(arena, is_message_owned);
+  // @@protoc_insertion_point(arena_constructor:Document.Name.Language)
 }
 Document_Name_Language::Document_Name_Language(const Document_Name_Language& from)
-  : ::google::protobuf::Message(),
-      _internal_metadata_(NULL),
-      _has_bits_(from._has_bits_) {
-  _internal_metadata_.MergeFrom(from._internal_metadata_);
-  code_.UnsafeSetDefault(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
-  if (from.has_code()) {
-    code_.AssignWithDefault(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), from.code_);
+  : ::PROTOBUF_NAMESPACE_ID::Message() {
+  Document_Name_Language* const _this = this; (void)_this;
+  new (&_impl_) Impl_{
+      decltype(_impl_._has_bits_){from._impl_._has_bits_}
+    , /*decltype(_impl_._cached_size_)*/{}
+    , decltype(_impl_.code_){}
+    , decltype(_impl_.country_){}};
+
+  _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+  _impl_.code_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.code_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (from._internal_has_code()) {
+    _this->_impl_.code_.Set(from._internal_code(), 
+      _this->GetArenaForAllocation());
   }
-  country_.UnsafeSetDefault(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
-  if (from.has_country()) {
-    country_.AssignWithDefault(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), from.country_);
+  _impl_.country_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.country_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (from._internal_has_country()) {
+    _this->_impl_.country_.Set(from._internal_country(), 
+      _this->GetArenaForAllocation());
   }
   // @@protoc_insertion_point(copy_constructor:Document.Name.Language)
 }
 
-void Document_Name_Language::SharedCtor() {
-  code_.UnsafeSetDefault(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
-  country_.UnsafeSetDefault(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
+inline void Document_Name_Language::SharedCtor(
+    ::_pb::Arena* arena, bool is_message_owned) {
+  (void)arena;
+  (void)is_message_owned;
+  new (&_impl_) Impl_{
+      decltype(_impl_._has_bits_){}
+    , /*decltype(_impl_._cached_size_)*/{}
+    , decltype(_impl_.code_){}
+    , decltype(_impl_.country_){}
+  };
+  _impl_.code_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.code_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  _impl_.country_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.country_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
 }
 
 Document_Name_Language::~Document_Name_Language() {
   // @@protoc_insertion_point(destructor:Document.Name.Language)
+  if (auto *arena = _internal_metadata_.DeleteReturnArena<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>()) {
+  (void)arena;
+    return;
+  }
   SharedDtor();
 }
 
-void Document_Name_Language::SharedDtor() {
-  code_.DestroyNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
-  country_.DestroyNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
+inline void Document_Name_Language::SharedDtor() {
+  GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+  _impl_.code_.Destroy();
+  _impl_.country_.Destroy();
 }
 
 void Document_Name_Language::SetCachedSize(int size) const {
-  _cached_size_.Set(size);
+  _impl_._cached_size_.Set(size);
 }
-const ::google::protobuf::Descriptor* Document_Name_Language::descriptor() {
-  ::protobuf_schema_2eproto::protobuf_AssignDescriptorsOnce();
-  return ::protobuf_schema_2eproto::file_level_metadata[kIndexInFileMessages].descriptor;
-}
-
-const Document_Name_Language& Document_Name_Language::default_instance() {
-  ::google::protobuf::internal::InitSCC(&protobuf_schema_2eproto::scc_info_Document_Name_Language.base);
-  return *internal_default_instance();
-}
-
 
 void Document_Name_Language::Clear() {
 // @@protoc_insertion_point(message_clear_start:Document.Name.Language)
-  ::google::protobuf::uint32 cached_has_bits = 0;
+  uint32_t cached_has_bits = 0;
   // Prevent compiler warnings about cached_has_bits being unused
   (void) cached_has_bits;
 
-  cached_has_bits = _has_bits_[0];
-  if (cached_has_bits & 3u) {
+  cached_has_bits = _impl_._has_bits_[0];
+  if (cached_has_bits & 0x00000003u) {
     if (cached_has_bits & 0x00000001u) {
-      code_.ClearNonDefaultToEmptyNoArena();
+      _impl_.code_.ClearNonDefaultToEmpty();
     }
     if (cached_has_bits & 0x00000002u) {
-      country_.ClearNonDefaultToEmptyNoArena();
+      _impl_.country_.ClearNonDefaultToEmpty();
     }
   }
-  _has_bits_.Clear();
-  _internal_metadata_.Clear();
-}
-
-bool Document_Name_Language::MergePartialFromCodedStream(
-    ::google::protobuf::io::CodedInputStream* input) {
-#define DO_(EXPRESSION) if (!GOOGLE_PREDICT_TRUE(EXPRESSION)) goto failure
-  ::google::protobuf::uint32 tag;
-  // @@protoc_insertion_point(parse_start:Document.Name.Language)
-  for (;;) {
-    ::std::pair<::google::protobuf::uint32, bool> p = input->ReadTagWithCutoffNoLastTag(127u);
-    tag = p.first;
-    if (!p.second) goto handle_unusual;
-    switch (::google::protobuf::internal::WireFormatLite::GetTagFieldNumber(tag)) {
+  _impl_._has_bits_.Clear();
+  _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
+}
+
+const char* Document_Name_Language::_InternalParse(const char* ptr, ::_pbi::ParseContext* ctx) {
+#define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  _Internal::HasBits has_bits{};
+  while (!ctx->Done(&ptr)) {
+    uint32_t tag;
+    ptr = ::_pbi::ReadTag(ptr, &tag);
+    switch (tag >> 3) {
       // required string Code = 7;
-      case 7: {
-        if (static_cast< ::google::protobuf::uint8>(tag) ==
-            static_cast< ::google::protobuf::uint8>(58u /* 58 & 0xFF */)) {
-          DO_(::google::protobuf::internal::WireFormatLite::ReadString(
-                input, this->mutable_code()));
-          ::google::protobuf::internal::WireFormat::VerifyUTF8StringNamedField(
-            this->code().data(), static_cast<int>(this->code().length()),
-            ::google::protobuf::internal::WireFormat::PARSE,
-            "Document.Name.Language.Code");
-        } else {
+      case 7:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 58)) {
+          auto str = _internal_mutable_code();
+          ptr = ::_pbi::InlineGreedyStringParser(str, ptr, ctx);
+          CHK_(ptr);
+          #ifndef NDEBUG
+          ::_pbi::VerifyUTF8(str, "Document.Name.Language.Code");
+          #endif  // !NDEBUG
+        } else
           goto handle_unusual;
-        }
-        break;
-      }
-
+        continue;
       // optional string Country = 8;
-      case 8: {
-        if (static_cast< ::google::protobuf::uint8>(tag) ==
-            static_cast< ::google::protobuf::uint8>(66u /* 66 & 0xFF */)) {
-          DO_(::google::protobuf::internal::WireFormatLite::ReadString(
-                input, this->mutable_country()));
-          ::google::protobuf::internal::WireFormat::VerifyUTF8StringNamedField(
-            this->country().data(), static_cast<int>(this->country().length()),
-            ::google::protobuf::internal::WireFormat::PARSE,
-            "Document.Name.Language.Country");
-        } else {
+      case 8:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 66)) {
+          auto str = _internal_mutable_country();
+          ptr = ::_pbi::InlineGreedyStringParser(str, ptr, ctx);
+          CHK_(ptr);
+          #ifndef NDEBUG
+          ::_pbi::VerifyUTF8(str, "Document.Name.Language.Country");
+          #endif  // !NDEBUG
+        } else
           goto handle_unusual;
-        }
-        break;
-      }
-
-      default: {
-      handle_unusual:
-        if (tag == 0 ||
-            ::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
-            ::google::protobuf::internal::WireFormatLite::WIRETYPE_END_GROUP) {
-          input->SetLastTag(tag);
-          goto success;
-        }
-        DO_(::google::protobuf::internal::WireFormat::SkipField(
-              input, tag, _internal_metadata_.mutable_unknown_fields()));
-        break;
-      }
+        continue;
+      default:
+        goto handle_unusual;
+    }  // switch
+  handle_unusual:
+    if ((tag == 0) || ((tag & 7) == 4)) {
+      CHK_(ptr);
+      ctx->SetLastTag(tag);
+      goto message_done;
     }
-  }
-success:
-  // @@protoc_insertion_point(parse_success:Document.Name.Language)
-  return true;
+    ptr = UnknownFieldParse(
+        tag,
+        _internal_metadata_.mutable_unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(),
+        ptr, ctx);
+    CHK_(ptr != nullptr);
+  }  // while
+message_done:
+  _impl_._has_bits_.Or(has_bits);
+  return ptr;
 failure:
-  // @@protoc_insertion_point(parse_failure:Document.Name.Language)
-  return false;
-#undef DO_
-}
-
-void Document_Name_Language::SerializeWithCachedSizes(
-    ::google::protobuf::io::CodedOutputStream* output) const {
-  // @@protoc_insertion_point(serialize_start:Document.Name.Language)
-  ::google::protobuf::uint32 cached_has_bits = 0;
-  (void) cached_has_bits;
-
-  cached_has_bits = _has_bits_[0];
-  // required string Code = 7;
-  if (cached_has_bits & 0x00000001u) {
-    ::google::protobuf::internal::WireFormat::VerifyUTF8StringNamedField(
-      this->code().data(), static_cast<int>(this->code().length()),
-      ::google::protobuf::internal::WireFormat::SERIALIZE,
-      "Document.Name.Language.Code");
-    ::google::protobuf::internal::WireFormatLite::WriteStringMaybeAliased(
-      7, this->code(), output);
-  }
-
-  // optional string Country = 8;
-  if (cached_has_bits & 0x00000002u) {
-    ::google::protobuf::internal::WireFormat::VerifyUTF8StringNamedField(
-      this->country().data(), static_cast<int>(this->country().length()),
-      ::google::protobuf::internal::WireFormat::SERIALIZE,
-      "Document.Name.Language.Country");
-    ::google::protobuf::internal::WireFormatLite::WriteStringMaybeAliased(
-      8, this->country(), output);
-  }
-
-  if (_internal_metadata_.have_unknown_fields()) {
-    ::google::protobuf::internal::WireFormat::SerializeUnknownFields(
-        _internal_metadata_.unknown_fields(), output);
-  }
-  // @@protoc_insertion_point(serialize_end:Document.Name.Language)
+  ptr = nullptr;
+  goto message_done;
+#undef CHK_
 }
 
-::google::protobuf::uint8* Document_Name_Language::InternalSerializeWithCachedSizesToArray(
-    bool deterministic, ::google::protobuf::uint8* target) const {
-  (void)deterministic; // Unused
+uint8_t* Document_Name_Language::_InternalSerialize(
+    uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
   // @@protoc_insertion_point(serialize_to_array_start:Document.Name.Language)
-  ::google::protobuf::uint32 cached_has_bits = 0;
+  uint32_t cached_has_bits = 0;
   (void) cached_has_bits;
 
-  cached_has_bits = _has_bits_[0];
+  cached_has_bits = _impl_._has_bits_[0];
   // required string Code = 7;
   if (cached_has_bits & 0x00000001u) {
-    ::google::protobuf::internal::WireFormat::VerifyUTF8StringNamedField(
-      this->code().data(), static_cast<int>(this->code().length()),
-      ::google::protobuf::internal::WireFormat::SERIALIZE,
+    ::PROTOBUF_NAMESPACE_ID::internal::WireFormat::VerifyUTF8StringNamedField(
+      this->_internal_code().data(), static_cast<int>(this->_internal_code().length()),
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormat::SERIALIZE,
       "Document.Name.Language.Code");
-    target =
-      ::google::protobuf::internal::WireFormatLite::WriteStringToArray(
-        7, this->code(), target);
+    target = stream->WriteStringMaybeAliased(
+        7, this->_internal_code(), target);
   }
 
   // optional string Country = 8;
   if (cached_has_bits & 0x00000002u) {
-    ::google::protobuf::internal::WireFormat::VerifyUTF8StringNamedField(
-      this->country().data(), static_cast<int>(this->country().length()),
-      ::google::protobuf::internal::WireFormat::SERIALIZE,
+    ::PROTOBUF_NAMESPACE_ID::internal::WireFormat::VerifyUTF8StringNamedField(
+      this->_internal_country().data(), static_cast<int>(this->_internal_country().length()),
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormat::SERIALIZE,
       "Document.Name.Language.Country");
-    target =
-      ::google::protobuf::internal::WireFormatLite::WriteStringToArray(
-        8, this->country(), target);
+    target = stream->WriteStringMaybeAliased(
+        8, this->_internal_country(), target);
   }
 
-  if (_internal_metadata_.have_unknown_fields()) {
-    target = ::google::protobuf::internal::WireFormat::SerializeUnknownFieldsToArray(
-        _internal_metadata_.unknown_fields(), target);
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
+        _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
   }
   // @@protoc_insertion_point(serialize_to_array_end:Document.Name.Language)
   return target;
@@ -711,69 +593,52 @@ size_t Document_Name_Language::ByteSizeLong() const {
 // @@protoc_insertion_point(message_byte_size_start:Document.Name.Language)
   size_t total_size = 0;
 
-  if (_internal_metadata_.have_unknown_fields()) {
-    total_size +=
-      ::google::protobuf::internal::WireFormat::ComputeUnknownFieldsSize(
-        _internal_metadata_.unknown_fields());
-  }
   // required string Code = 7;
-  if (has_code()) {
+  if (_internal_has_code()) {
     total_size += 1 +
-      ::google::protobuf::internal::WireFormatLite::StringSize(
-        this->code());
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::StringSize(
+        this->_internal_code());
   }
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
   // optional string Country = 8;
-  if (has_country()) {
+  cached_has_bits = _impl_._has_bits_[0];
+  if (cached_has_bits & 0x00000002u) {
     total_size += 1 +
-      ::google::protobuf::internal::WireFormatLite::StringSize(
-        this->country());
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::StringSize(
+        this->_internal_country());
   }
 
-  int cached_size = ::google::protobuf::internal::ToCachedSize(total_size);
-  SetCachedSize(cached_size);
-  return total_size;
-}
-
-void Document_Name_Language::MergeFrom(const ::google::protobuf::Message& from) {
-// @@protoc_insertion_point(generalized_merge_from_start:Document.Name.Language)
-  GOOGLE_DCHECK_NE(&from, this);
-  const Document_Name_Language* source =
-      ::google::protobuf::internal::DynamicCastToGenerated<const Document_Name_Language>(
-          &from);
-  if (source == NULL) {
-  // @@protoc_insertion_point(generalized_merge_from_cast_fail:Document.Name.Language)
-    ::google::protobuf::internal::ReflectionOps::Merge(from, this);
-  } else {
-  // @@protoc_insertion_point(generalized_merge_from_cast_success:Document.Name.Language)
-    MergeFrom(*source);
-  }
+  return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
 }
 
-void Document_Name_Language::MergeFrom(const Document_Name_Language& from) {
-// @@protoc_insertion_point(class_specific_merge_from_start:Document.Name.Language)
-  GOOGLE_DCHECK_NE(&from, this);
-  _internal_metadata_.MergeFrom(from._internal_metadata_);
-  ::google::protobuf::uint32 cached_has_bits = 0;
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData Document_Name_Language::_class_data_ = {
+    ::PROTOBUF_NAMESPACE_ID::Message::CopyWithSourceCheck,
+    Document_Name_Language::MergeImpl
+};
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*Document_Name_Language::GetClassData() const { return &_class_data_; }
+
+
+void Document_Name_Language::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg) {
+  auto* const _this = static_cast<Document_Name_Language*>(&to_msg);
+  auto& from = static_cast<const Document_Name_Language&>(from_msg);
+  // @@protoc_insertion_point(class_specific_merge_from_start:Document.Name.Language)
+  GOOGLE_DCHECK_NE(&from, _this);
+  uint32_t cached_has_bits = 0;
   (void) cached_has_bits;
 
-  cached_has_bits = from._has_bits_[0];
-  if (cached_has_bits & 3u) {
+  cached_has_bits = from._impl_._has_bits_[0];
+  if (cached_has_bits & 0x00000003u) {
     if (cached_has_bits & 0x00000001u) {
-      set_has_code();
-      code_.AssignWithDefault(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), from.code_);
+      _this->_internal_set_code(from._internal_code());
     }
     if (cached_has_bits & 0x00000002u) {
-      set_has_country();
-      country_.AssignWithDefault(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), from.country_);
+      _this->_internal_set_country(from._internal_country());
     }
   }
-}
-
-void Document_Name_Language::CopyFrom(const ::google::protobuf::Message& from) {
-// @@protoc_insertion_point(generalized_copy_from_start:Document.Name.Language)
-  if (&from == this) return;
-  Clear();
-  MergeFrom(from);
+  _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
 }
 
 void Document_Name_Language::CopyFrom(const Document_Name_Language& from) {
@@ -784,224 +649,203 @@ void Document_Name_Language::CopyFrom(const Document_Name_Language& from) {
 }
 
 bool Document_Name_Language::IsInitialized() const {
-  if ((_has_bits_[0] & 0x00000001) != 0x00000001) return false;
+  if (_Internal::MissingRequiredFields(_impl_._has_bits_)) return false;
   return true;
 }
 
-void Document_Name_Language::Swap(Document_Name_Language* other) {
-  if (other == this) return;
-  InternalSwap(other);
-}
 void Document_Name_Language::InternalSwap(Document_Name_Language* other) {
   using std::swap;
-  code_.Swap(&other->code_, &::google::protobuf::internal::GetEmptyStringAlreadyInited(),
-    GetArenaNoVirtual());
-  country_.Swap(&other->country_, &::google::protobuf::internal::GetEmptyStringAlreadyInited(),
-    GetArenaNoVirtual());
-  swap(_has_bits_[0], other->_has_bits_[0]);
-  _internal_metadata_.Swap(&other->_internal_metadata_);
-}
-
-::google::protobuf::Metadata Document_Name_Language::GetMetadata() const {
-  protobuf_schema_2eproto::protobuf_AssignDescriptorsOnce();
-  return ::protobuf_schema_2eproto::file_level_metadata[kIndexInFileMessages];
+  auto* lhs_arena = GetArenaForAllocation();
+  auto* rhs_arena = other->GetArenaForAllocation();
+  _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  swap(_impl_._has_bits_[0], other->_impl_._has_bits_[0]);
+  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::InternalSwap(
+      &_impl_.code_, lhs_arena,
+      &other->_impl_.code_, rhs_arena
+  );
+  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::InternalSwap(
+      &_impl_.country_, lhs_arena,
+      &other->_impl_.country_, rhs_arena
+  );
+}
+
+::PROTOBUF_NAMESPACE_ID::Metadata Document_Name_Language::GetMetadata() const {
+  return ::_pbi::AssignDescriptors(
+      &descriptor_table_schema_2eproto_getter, &descriptor_table_schema_2eproto_once,
+      file_level_metadata_schema_2eproto[1]);
 }
 
-
 // ===================================================================
 
-void Document_Name::InitAsDefaultInstance() {
-}
-#if !defined(_MSC_VER) || _MSC_VER >= 1900
-const int Document_Name::kLanguageFieldNumber;
-const int Document_Name::kUrlFieldNumber;
-#endif  // !defined(_MSC_VER) || _MSC_VER >= 1900
+class Document_Name::_Internal {
+ public:
+  using HasBits = decltype(std::declval<Document_Name>()._impl_._has_bits_);
+  static void set_has_url(HasBits* has_bits) {
+    (*has_bits)[0] |= 1u;
+  }
+};
 
-Document_Name::Document_Name()
-  : ::google::protobuf::Message(), _internal_metadata_(NULL) {
-  ::google::protobuf::internal::InitSCC(
-      &protobuf_schema_2eproto::scc_info_Document_Name.base);
-  SharedCtor();
-  // @@protoc_insertion_point(constructor:Document.Name)
+Document_Name::Document_Name(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                         bool is_message_owned)
+  : ::PROTOBUF_NAMESPACE_ID::Message(arena, is_message_owned) {
+  SharedCtor(arena, is_message_owned);
+  // @@protoc_insertion_point(arena_constructor:Document.Name)
 }
 Document_Name::Document_Name(const Document_Name& from)
-  : ::google::protobuf::Message(),
-      _internal_metadata_(NULL),
-      _has_bits_(from._has_bits_),
-      language_(from.language_) {
-  _internal_metadata_.MergeFrom(from._internal_metadata_);
-  url_.UnsafeSetDefault(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
-  if (from.has_url()) {
-    url_.AssignWithDefault(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), from.url_);
+  : ::PROTOBUF_NAMESPACE_ID::Message() {
+  Document_Name* const _this = this; (void)_this;
+  new (&_impl_) Impl_{
+      decltype(_impl_._has_bits_){from._impl_._has_bits_}
+    , /*decltype(_impl_._cached_size_)*/{}
+    , decltype(_impl_.language_){from._impl_.language_}
+    , decltype(_impl_.url_){}};
+
+  _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+  _impl_.url_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.url_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (from._internal_has_url()) {
+    _this->_impl_.url_.Set(from._internal_url(), 
+      _this->GetArenaForAllocation());
   }
   // @@protoc_insertion_point(copy_constructor:Document.Name)
 }
 
-void Document_Name::SharedCtor() {
-  url_.UnsafeSetDefault(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
+inline void Document_Name::SharedCtor(
+    ::_pb::Arena* arena, bool is_message_owned) {
+  (void)arena;
+  (void)is_message_owned;
+  new (&_impl_) Impl_{
+      decltype(_impl_._has_bits_){}
+    , /*decltype(_impl_._cached_size_)*/{}
+    , decltype(_impl_.language_){arena}
+    , decltype(_impl_.url_){}
+  };
+  _impl_.url_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.url_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
 }
 
 Document_Name::~Document_Name() {
   // @@protoc_insertion_point(destructor:Document.Name)
+  if (auto *arena = _internal_metadata_.DeleteReturnArena<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>()) {
+  (void)arena;
+    return;
+  }
   SharedDtor();
 }
 
-void Document_Name::SharedDtor() {
-  url_.DestroyNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
+inline void Document_Name::SharedDtor() {
+  GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+  _impl_.language_.~RepeatedPtrField();
+  _impl_.url_.Destroy();
 }
 
 void Document_Name::SetCachedSize(int size) const {
-  _cached_size_.Set(size);
-}
-const ::google::protobuf::Descriptor* Document_Name::descriptor() {
-  ::protobuf_schema_2eproto::protobuf_AssignDescriptorsOnce();
-  return ::protobuf_schema_2eproto::file_level_metadata[kIndexInFileMessages].descriptor;
+  _impl_._cached_size_.Set(size);
 }
 
-const Document_Name& Document_Name::default_instance() {
-  ::google::protobuf::internal::InitSCC(&protobuf_schema_2eproto::scc_info_Document_Name.base);
-  return *internal_default_instance();
-}
-
-
 void Document_Name::Clear() {
 // @@protoc_insertion_point(message_clear_start:Document.Name)
-  ::google::protobuf::uint32 cached_has_bits = 0;
+  uint32_t cached_has_bits = 0;
   // Prevent compiler warnings about cached_has_bits being unused
   (void) cached_has_bits;
 
-  language_.Clear();
-  cached_has_bits = _has_bits_[0];
+  _impl_.language_.Clear();
+  cached_has_bits = _impl_._has_bits_[0];
   if (cached_has_bits & 0x00000001u) {
-    url_.ClearNonDefaultToEmptyNoArena();
+    _impl_.url_.ClearNonDefaultToEmpty();
   }
-  _has_bits_.Clear();
-  _internal_metadata_.Clear();
-}
-
-bool Document_Name::MergePartialFromCodedStream(
-    ::google::protobuf::io::CodedInputStream* input) {
-#define DO_(EXPRESSION) if (!GOOGLE_PREDICT_TRUE(EXPRESSION)) goto failure
-  ::google::protobuf::uint32 tag;
-  // @@protoc_insertion_point(parse_start:Document.Name)
-  for (;;) {
-    ::std::pair<::google::protobuf::uint32, bool> p = input->ReadTagWithCutoffNoLastTag(127u);
-    tag = p.first;
-    if (!p.second) goto handle_unusual;
-    switch (::google::protobuf::internal::WireFormatLite::GetTagFieldNumber(tag)) {
+  _impl_._has_bits_.Clear();
+  _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
+}
+
+const char* Document_Name::_InternalParse(const char* ptr, ::_pbi::ParseContext* ctx) {
+#define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  _Internal::HasBits has_bits{};
+  while (!ctx->Done(&ptr)) {
+    uint32_t tag;
+    ptr = ::_pbi::ReadTag(ptr, &tag);
+    switch (tag >> 3) {
       // repeated group Language = 6 { ... };
-      case 6: {
-        if (static_cast< ::google::protobuf::uint8>(tag) ==
-            static_cast< ::google::protobuf::uint8>(51u /* 51 & 0xFF */)) {
-          DO_(::google::protobuf::internal::WireFormatLite::ReadGroup(6, input, add_language()));
-        } else {
+      case 6:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 51)) {
+          ptr -= 1;
+          do {
+            ptr += 1;
+            ptr = ctx->ParseGroup(_internal_add_language(), ptr, 51);
+            CHK_(ptr);
+            if (!ctx->DataAvailable(ptr)) break;
+          } while (::PROTOBUF_NAMESPACE_ID::internal::ExpectTag<51>(ptr));
+        } else
           goto handle_unusual;
-        }
-        break;
-      }
-
+        continue;
       // optional string Url = 9;
-      case 9: {
-        if (static_cast< ::google::protobuf::uint8>(tag) ==
-            static_cast< ::google::protobuf::uint8>(74u /* 74 & 0xFF */)) {
-          DO_(::google::protobuf::internal::WireFormatLite::ReadString(
-                input, this->mutable_url()));
-          ::google::protobuf::internal::WireFormat::VerifyUTF8StringNamedField(
-            this->url().data(), static_cast<int>(this->url().length()),
-            ::google::protobuf::internal::WireFormat::PARSE,
-            "Document.Name.Url");
-        } else {
+      case 9:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 74)) {
+          auto str = _internal_mutable_url();
+          ptr = ::_pbi::InlineGreedyStringParser(str, ptr, ctx);
+          CHK_(ptr);
+          #ifndef NDEBUG
+          ::_pbi::VerifyUTF8(str, "Document.Name.Url");
+          #endif  // !NDEBUG
+        } else
           goto handle_unusual;
-        }
-        break;
-      }
-
-      default: {
-      handle_unusual:
-        if (tag == 0 ||
-            ::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
-            ::google::protobuf::internal::WireFormatLite::WIRETYPE_END_GROUP) {
-          input->SetLastTag(tag);
-          goto success;
-        }
-        DO_(::google::protobuf::internal::WireFormat::SkipField(
-              input, tag, _internal_metadata_.mutable_unknown_fields()));
-        break;
-      }
+        continue;
+      default:
+        goto handle_unusual;
+    }  // switch
+  handle_unusual:
+    if ((tag == 0) || ((tag & 7) == 4)) {
+      CHK_(ptr);
+      ctx->SetLastTag(tag);
+      goto message_done;
     }
-  }
-success:
-  // @@protoc_insertion_point(parse_success:Document.Name)
-  return true;
+    ptr = UnknownFieldParse(
+        tag,
+        _internal_metadata_.mutable_unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(),
+        ptr, ctx);
+    CHK_(ptr != nullptr);
+  }  // while
+message_done:
+  _impl_._has_bits_.Or(has_bits);
+  return ptr;
 failure:
-  // @@protoc_insertion_point(parse_failure:Document.Name)
-  return false;
-#undef DO_
+  ptr = nullptr;
+  goto message_done;
+#undef CHK_
 }
 
-void Document_Name::SerializeWithCachedSizes(
-    ::google::protobuf::io::CodedOutputStream* output) const {
-  // @@protoc_insertion_point(serialize_start:Document.Name)
-  ::google::protobuf::uint32 cached_has_bits = 0;
-  (void) cached_has_bits;
-
-  // repeated group Language = 6 { ... };
-  for (unsigned int i = 0,
-      n = static_cast<unsigned int>(this->language_size()); i < n; i++) {
-    ::google::protobuf::internal::WireFormatLite::WriteGroupMaybeToArray(
-      6,
-      this->language(static_cast<int>(i)),
-      output);
-  }
-
-  cached_has_bits = _has_bits_[0];
-  // optional string Url = 9;
-  if (cached_has_bits & 0x00000001u) {
-    ::google::protobuf::internal::WireFormat::VerifyUTF8StringNamedField(
-      this->url().data(), static_cast<int>(this->url().length()),
-      ::google::protobuf::internal::WireFormat::SERIALIZE,
-      "Document.Name.Url");
-    ::google::protobuf::internal::WireFormatLite::WriteStringMaybeAliased(
-      9, this->url(), output);
-  }
-
-  if (_internal_metadata_.have_unknown_fields()) {
-    ::google::protobuf::internal::WireFormat::SerializeUnknownFields(
-        _internal_metadata_.unknown_fields(), output);
-  }
-  // @@protoc_insertion_point(serialize_end:Document.Name)
-}
-
-::google::protobuf::uint8* Document_Name::InternalSerializeWithCachedSizesToArray(
-    bool deterministic, ::google::protobuf::uint8* target) const {
-  (void)deterministic; // Unused
+uint8_t* Document_Name::_InternalSerialize(
+    uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
   // @@protoc_insertion_point(serialize_to_array_start:Document.Name)
-  ::google::protobuf::uint32 cached_has_bits = 0;
+  uint32_t cached_has_bits = 0;
   (void) cached_has_bits;
 
   // repeated group Language = 6 { ... };
-  for (unsigned int i = 0,
-      n = static_cast<unsigned int>(this->language_size()); i < n; i++) {
-    target = ::google::protobuf::internal::WireFormatLite::
-      InternalWriteGroupToArray(
-        6, this->language(static_cast<int>(i)), deterministic, target);
+  for (unsigned i = 0,
+      n = static_cast<unsigned>(this->_internal_language_size()); i < n; i++) {
+    target = stream->EnsureSpace(target);
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::
+      InternalWriteGroup(6, this->_internal_language(i), target, stream);
   }
 
-  cached_has_bits = _has_bits_[0];
+  cached_has_bits = _impl_._has_bits_[0];
   // optional string Url = 9;
   if (cached_has_bits & 0x00000001u) {
-    ::google::protobuf::internal::WireFormat::VerifyUTF8StringNamedField(
-      this->url().data(), static_cast<int>(this->url().length()),
-      ::google::protobuf::internal::WireFormat::SERIALIZE,
+    ::PROTOBUF_NAMESPACE_ID::internal::WireFormat::VerifyUTF8StringNamedField(
+      this->_internal_url().data(), static_cast<int>(this->_internal_url().length()),
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormat::SERIALIZE,
       "Document.Name.Url");
-    target =
-      ::google::protobuf::internal::WireFormatLite::WriteStringToArray(
-        9, this->url(), target);
+    target = stream->WriteStringMaybeAliased(
+        9, this->_internal_url(), target);
   }
 
-  if (_internal_metadata_.have_unknown_fields()) {
-    target = ::google::protobuf::internal::WireFormat::SerializeUnknownFieldsToArray(
-        _internal_metadata_.unknown_fields(), target);
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
+        _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
   }
   // @@protoc_insertion_point(serialize_to_array_end:Document.Name)
   return target;
@@ -1011,68 +855,48 @@ size_t Document_Name::ByteSizeLong() const {
 // @@protoc_insertion_point(message_byte_size_start:Document.Name)
   size_t total_size = 0;
 
-  if (_internal_metadata_.have_unknown_fields()) {
-    total_size +=
-      ::google::protobuf::internal::WireFormat::ComputeUnknownFieldsSize(
-        _internal_metadata_.unknown_fields());
-  }
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
   // repeated group Language = 6 { ... };
-  {
-    unsigned int count = static_cast<unsigned int>(this->language_size());
-    total_size += 2UL * count;
-    for (unsigned int i = 0; i < count; i++) {
-      total_size +=
-        ::google::protobuf::internal::WireFormatLite::GroupSize(
-          this->language(static_cast<int>(i)));
-    }
+  total_size += 2UL * this->_internal_language_size();
+  for (const auto& msg : this->_impl_.language_) {
+    total_size +=
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::GroupSize(msg);
   }
 
   // optional string Url = 9;
-  if (has_url()) {
+  cached_has_bits = _impl_._has_bits_[0];
+  if (cached_has_bits & 0x00000001u) {
     total_size += 1 +
-      ::google::protobuf::internal::WireFormatLite::StringSize(
-        this->url());
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::StringSize(
+        this->_internal_url());
   }
 
-  int cached_size = ::google::protobuf::internal::ToCachedSize(total_size);
-  SetCachedSize(cached_size);
-  return total_size;
-}
-
-void Document_Name::MergeFrom(const ::google::protobuf::Message& from) {
-// @@protoc_insertion_point(generalized_merge_from_start:Document.Name)
-  GOOGLE_DCHECK_NE(&from, this);
-  const Document_Name* source =
-      ::google::protobuf::internal::DynamicCastToGenerated<const Document_Name>(
-          &from);
-  if (source == NULL) {
-  // @@protoc_insertion_point(generalized_merge_from_cast_fail:Document.Name)
-    ::google::protobuf::internal::ReflectionOps::Merge(from, this);
-  } else {
-  // @@protoc_insertion_point(generalized_merge_from_cast_success:Document.Name)
-    MergeFrom(*source);
-  }
+  return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
 }
 
-void Document_Name::MergeFrom(const Document_Name& from) {
-// @@protoc_insertion_point(class_specific_merge_from_start:Document.Name)
-  GOOGLE_DCHECK_NE(&from, this);
-  _internal_metadata_.MergeFrom(from._internal_metadata_);
-  ::google::protobuf::uint32 cached_has_bits = 0;
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData Document_Name::_class_data_ = {
+    ::PROTOBUF_NAMESPACE_ID::Message::CopyWithSourceCheck,
+    Document_Name::MergeImpl
+};
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*Document_Name::GetClassData() const { return &_class_data_; }
+
+
+void Document_Name::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg) {
+  auto* const _this = static_cast<Document_Name*>(&to_msg);
+  auto& from = static_cast<const Document_Name&>(from_msg);
+  // @@protoc_insertion_point(class_specific_merge_from_start:Document.Name)
+  GOOGLE_DCHECK_NE(&from, _this);
+  uint32_t cached_has_bits = 0;
   (void) cached_has_bits;
 
-  language_.MergeFrom(from.language_);
-  if (from.has_url()) {
-    set_has_url();
-    url_.AssignWithDefault(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), from.url_);
+  _this->_impl_.language_.MergeFrom(from._impl_.language_);
+  if (from._internal_has_url()) {
+    _this->_internal_set_url(from._internal_url());
   }
-}
-
-void Document_Name::CopyFrom(const ::google::protobuf::Message& from) {
-// @@protoc_insertion_point(generalized_copy_from_start:Document.Name)
-  if (&from == this) return;
-  Clear();
-  MergeFrom(from);
+  _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
 }
 
 void Document_Name::CopyFrom(const Document_Name& from) {
@@ -1083,241 +907,217 @@ void Document_Name::CopyFrom(const Document_Name& from) {
 }
 
 bool Document_Name::IsInitialized() const {
-  if (!::google::protobuf::internal::AllAreInitialized(this->language())) return false;
+  if (!::PROTOBUF_NAMESPACE_ID::internal::AllAreInitialized(_impl_.language_))
+    return false;
   return true;
 }
 
-void Document_Name::Swap(Document_Name* other) {
-  if (other == this) return;
-  InternalSwap(other);
-}
 void Document_Name::InternalSwap(Document_Name* other) {
   using std::swap;
-  CastToBase(&language_)->InternalSwap(CastToBase(&other->language_));
-  url_.Swap(&other->url_, &::google::protobuf::internal::GetEmptyStringAlreadyInited(),
-    GetArenaNoVirtual());
-  swap(_has_bits_[0], other->_has_bits_[0]);
-  _internal_metadata_.Swap(&other->_internal_metadata_);
+  auto* lhs_arena = GetArenaForAllocation();
+  auto* rhs_arena = other->GetArenaForAllocation();
+  _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  swap(_impl_._has_bits_[0], other->_impl_._has_bits_[0]);
+  _impl_.language_.InternalSwap(&other->_impl_.language_);
+  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::InternalSwap(
+      &_impl_.url_, lhs_arena,
+      &other->_impl_.url_, rhs_arena
+  );
 }
 
-::google::protobuf::Metadata Document_Name::GetMetadata() const {
-  protobuf_schema_2eproto::protobuf_AssignDescriptorsOnce();
-  return ::protobuf_schema_2eproto::file_level_metadata[kIndexInFileMessages];
+::PROTOBUF_NAMESPACE_ID::Metadata Document_Name::GetMetadata() const {
+  return ::_pbi::AssignDescriptors(
+      &descriptor_table_schema_2eproto_getter, &descriptor_table_schema_2eproto_once,
+      file_level_metadata_schema_2eproto[2]);
 }
 
-
 // ===================================================================
 
-void Document::InitAsDefaultInstance() {
-  ::_Document_default_instance_._instance.get_mutable()->links_ = const_cast< ::Document_Links*>(
-      ::Document_Links::internal_default_instance());
-}
-#if !defined(_MSC_VER) || _MSC_VER >= 1900
-const int Document::kDocIdFieldNumber;
-const int Document::kLinksFieldNumber;
-const int Document::kNameFieldNumber;
-#endif  // !defined(_MSC_VER) || _MSC_VER >= 1900
+class Document::_Internal {
+ public:
+  using HasBits = decltype(std::declval<Document>()._impl_._has_bits_);
+  static void set_has_docid(HasBits* has_bits) {
+    (*has_bits)[0] |= 2u;
+  }
+  static const ::Document_Links& links(const Document* msg);
+  static void set_has_links(HasBits* has_bits) {
+    (*has_bits)[0] |= 1u;
+  }
+  static bool MissingRequiredFields(const HasBits& has_bits) {
+    return ((has_bits[0] & 0x00000002) ^ 0x00000002) != 0;
+  }
+};
 
-Document::Document()
-  : ::google::protobuf::Message(), _internal_metadata_(NULL) {
-  ::google::protobuf::internal::InitSCC(
-      &protobuf_schema_2eproto::scc_info_Document.base);
-  SharedCtor();
-  // @@protoc_insertion_point(constructor:Document)
+const ::Document_Links&
+Document::_Internal::links(const Document* msg) {
+  return *msg->_impl_.links_;
+}
+Document::Document(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                         bool is_message_owned)
+  : ::PROTOBUF_NAMESPACE_ID::Message(arena, is_message_owned) {
+  SharedCtor(arena, is_message_owned);
+  // @@protoc_insertion_point(arena_constructor:Document)
 }
 Document::Document(const Document& from)
-  : ::google::protobuf::Message(),
-      _internal_metadata_(NULL),
-      _has_bits_(from._has_bits_),
-      name_(from.name_) {
-  _internal_metadata_.MergeFrom(from._internal_metadata_);
-  if (from.has_links()) {
-    links_ = new ::Document_Links(*from.links_);
-  } else {
-    links_ = NULL;
+  : ::PROTOBUF_NAMESPACE_ID::Message() {
+  Document* const _this = this; (void)_this;
+  new (&_impl_) Impl_{
+      decltype(_impl_._has_bits_){from._impl_._has_bits_}
+    , /*decltype(_impl_._cached_size_)*/{}
+    , decltype(_impl_.name_){from._impl_.name_}
+    , decltype(_impl_.links_){nullptr}
+    , decltype(_impl_.docid_){}};
+
+  _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+  if (from._internal_has_links()) {
+    _this->_impl_.links_ = new ::Document_Links(*from._impl_.links_);
   }
-  docid_ = from.docid_;
+  _this->_impl_.docid_ = from._impl_.docid_;
   // @@protoc_insertion_point(copy_constructor:Document)
 }
 
-void Document::SharedCtor() {
-  ::memset(&links_, 0, static_cast<size_t>(
-      reinterpret_cast<char*>(&docid_) -
-      reinterpret_cast<char*>(&links_)) + sizeof(docid_));
+inline void Document::SharedCtor(
+    ::_pb::Arena* arena, bool is_message_owned) {
+  (void)arena;
+  (void)is_message_owned;
+  new (&_impl_) Impl_{
+      decltype(_impl_._has_bits_){}
+    , /*decltype(_impl_._cached_size_)*/{}
+    , decltype(_impl_.name_){arena}
+    , decltype(_impl_.links_){nullptr}
+    , decltype(_impl_.docid_){int64_t{0}}
+  };
 }
 
 Document::~Document() {
   // @@protoc_insertion_point(destructor:Document)
+  if (auto *arena = _internal_metadata_.DeleteReturnArena<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>()) {
+  (void)arena;
+    return;
+  }
   SharedDtor();
 }
 
-void Document::SharedDtor() {
-  if (this != internal_default_instance()) delete links_;
+inline void Document::SharedDtor() {
+  GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+  _impl_.name_.~RepeatedPtrField();
+  if (this != internal_default_instance()) delete _impl_.links_;
 }
 
 void Document::SetCachedSize(int size) const {
-  _cached_size_.Set(size);
+  _impl_._cached_size_.Set(size);
 }
-const ::google::protobuf::Descriptor* Document::descriptor() {
-  ::protobuf_schema_2eproto::protobuf_AssignDescriptorsOnce();
-  return ::protobuf_schema_2eproto::file_level_metadata[kIndexInFileMessages].descriptor;
-}
-
-const Document& Document::default_instance() {
-  ::google::protobuf::internal::InitSCC(&protobuf_schema_2eproto::scc_info_Document.base);
-  return *internal_default_instance();
-}
-
 
 void Document::Clear() {
 // @@protoc_insertion_point(message_clear_start:Document)
-  ::google::protobuf::uint32 cached_has_bits = 0;
+  uint32_t cached_has_bits = 0;
   // Prevent compiler warnings about cached_has_bits being unused
   (void) cached_has_bits;
 
-  name_.Clear();
-  cached_has_bits = _has_bits_[0];
+  _impl_.name_.Clear();
+  cached_has_bits = _impl_._has_bits_[0];
   if (cached_has_bits & 0x00000001u) {
-    GOOGLE_DCHECK(links_ != NULL);
-    links_->Clear();
+    GOOGLE_DCHECK(_impl_.links_ != nullptr);
+    _impl_.links_->Clear();
   }
-  docid_ = GOOGLE_LONGLONG(0);
-  _has_bits_.Clear();
-  _internal_metadata_.Clear();
-}
-
-bool Document::MergePartialFromCodedStream(
-    ::google::protobuf::io::CodedInputStream* input) {
-#define DO_(EXPRESSION) if (!GOOGLE_PREDICT_TRUE(EXPRESSION)) goto failure
-  ::google::protobuf::uint32 tag;
-  // @@protoc_insertion_point(parse_start:Document)
-  for (;;) {
-    ::std::pair<::google::protobuf::uint32, bool> p = input->ReadTagWithCutoffNoLastTag(127u);
-    tag = p.first;
-    if (!p.second) goto handle_unusual;
-    switch (::google::protobuf::internal::WireFormatLite::GetTagFieldNumber(tag)) {
+  _impl_.docid_ = int64_t{0};
+  _impl_._has_bits_.Clear();
+  _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
+}
+
+const char* Document::_InternalParse(const char* ptr, ::_pbi::ParseContext* ctx) {
+#define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  _Internal::HasBits has_bits{};
+  while (!ctx->Done(&ptr)) {
+    uint32_t tag;
+    ptr = ::_pbi::ReadTag(ptr, &tag);
+    switch (tag >> 3) {
       // required int64 DocId = 1;
-      case 1: {
-        if (static_cast< ::google::protobuf::uint8>(tag) ==
-            static_cast< ::google::protobuf::uint8>(8u /* 8 & 0xFF */)) {
-          set_has_docid();
-          DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
-                   ::google::protobuf::int64, ::google::protobuf::internal::WireFormatLite::TYPE_INT64>(
-                 input, &docid_)));
-        } else {
+      case 1:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 8)) {
+          _Internal::set_has_docid(&has_bits);
+          _impl_.docid_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
           goto handle_unusual;
-        }
-        break;
-      }
-
+        continue;
       // optional group Links = 2 { ... };
-      case 2: {
-        if (static_cast< ::google::protobuf::uint8>(tag) ==
-            static_cast< ::google::protobuf::uint8>(19u /* 19 & 0xFF */)) {
-          DO_(::google::protobuf::internal::WireFormatLite::ReadGroup(
-                2, input, mutable_links()));
-        } else {
+      case 2:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 19)) {
+          ptr = ctx->ParseGroup(_internal_mutable_links(), ptr, 19);
+          CHK_(ptr);
+        } else
           goto handle_unusual;
-        }
-        break;
-      }
-
+        continue;
       // repeated group Name = 5 { ... };
-      case 5: {
-        if (static_cast< ::google::protobuf::uint8>(tag) ==
-            static_cast< ::google::protobuf::uint8>(43u /* 43 & 0xFF */)) {
-          DO_(::google::protobuf::internal::WireFormatLite::ReadGroup(5, input, add_name()));
-        } else {
+      case 5:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 43)) {
+          ptr -= 1;
+          do {
+            ptr += 1;
+            ptr = ctx->ParseGroup(_internal_add_name(), ptr, 43);
+            CHK_(ptr);
+            if (!ctx->DataAvailable(ptr)) break;
+          } while (::PROTOBUF_NAMESPACE_ID::internal::ExpectTag<43>(ptr));
+        } else
           goto handle_unusual;
-        }
-        break;
-      }
-
-      default: {
-      handle_unusual:
-        if (tag == 0) {
-          goto success;
-        }
-        DO_(::google::protobuf::internal::WireFormat::SkipField(
-              input, tag, _internal_metadata_.mutable_unknown_fields()));
-        break;
-      }
+        continue;
+      default:
+        goto handle_unusual;
+    }  // switch
+  handle_unusual:
+    if ((tag == 0) || ((tag & 7) == 4)) {
+      CHK_(ptr);
+      ctx->SetLastTag(tag);
+      goto message_done;
     }
-  }
-success:
-  // @@protoc_insertion_point(parse_success:Document)
-  return true;
+    ptr = UnknownFieldParse(
+        tag,
+        _internal_metadata_.mutable_unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(),
+        ptr, ctx);
+    CHK_(ptr != nullptr);
+  }  // while
+message_done:
+  _impl_._has_bits_.Or(has_bits);
+  return ptr;
 failure:
-  // @@protoc_insertion_point(parse_failure:Document)
-  return false;
-#undef DO_
+  ptr = nullptr;
+  goto message_done;
+#undef CHK_
 }
 
-void Document::SerializeWithCachedSizes(
-    ::google::protobuf::io::CodedOutputStream* output) const {
-  // @@protoc_insertion_point(serialize_start:Document)
-  ::google::protobuf::uint32 cached_has_bits = 0;
-  (void) cached_has_bits;
-
-  cached_has_bits = _has_bits_[0];
-  // required int64 DocId = 1;
-  if (cached_has_bits & 0x00000002u) {
-    ::google::protobuf::internal::WireFormatLite::WriteInt64(1, this->docid(), output);
-  }
-
-  // optional group Links = 2 { ... };
-  if (cached_has_bits & 0x00000001u) {
-    ::google::protobuf::internal::WireFormatLite::WriteGroupMaybeToArray(
-      2, this->_internal_links(), output);
-  }
-
-  // repeated group Name = 5 { ... };
-  for (unsigned int i = 0,
-      n = static_cast<unsigned int>(this->name_size()); i < n; i++) {
-    ::google::protobuf::internal::WireFormatLite::WriteGroupMaybeToArray(
-      5,
-      this->name(static_cast<int>(i)),
-      output);
-  }
-
-  if (_internal_metadata_.have_unknown_fields()) {
-    ::google::protobuf::internal::WireFormat::SerializeUnknownFields(
-        _internal_metadata_.unknown_fields(), output);
-  }
-  // @@protoc_insertion_point(serialize_end:Document)
-}
-
-::google::protobuf::uint8* Document::InternalSerializeWithCachedSizesToArray(
-    bool deterministic, ::google::protobuf::uint8* target) const {
-  (void)deterministic; // Unused
+uint8_t* Document::_InternalSerialize(
+    uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
   // @@protoc_insertion_point(serialize_to_array_start:Document)
-  ::google::protobuf::uint32 cached_has_bits = 0;
+  uint32_t cached_has_bits = 0;
   (void) cached_has_bits;
 
-  cached_has_bits = _has_bits_[0];
+  cached_has_bits = _impl_._has_bits_[0];
   // required int64 DocId = 1;
   if (cached_has_bits & 0x00000002u) {
-    target = ::google::protobuf::internal::WireFormatLite::WriteInt64ToArray(1, this->docid(), target);
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteInt64ToArray(1, this->_internal_docid(), target);
   }
 
   // optional group Links = 2 { ... };
   if (cached_has_bits & 0x00000001u) {
-    target = ::google::protobuf::internal::WireFormatLite::
-      InternalWriteGroupToArray(
-        2, this->_internal_links(), deterministic, target);
+    target = stream->EnsureSpace(target);
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::
+      InternalWriteGroup(
+        2, _Internal::links(this), target, stream);
   }
 
   // repeated group Name = 5 { ... };
-  for (unsigned int i = 0,
-      n = static_cast<unsigned int>(this->name_size()); i < n; i++) {
-    target = ::google::protobuf::internal::WireFormatLite::
-      InternalWriteGroupToArray(
-        5, this->name(static_cast<int>(i)), deterministic, target);
+  for (unsigned i = 0,
+      n = static_cast<unsigned>(this->_internal_name_size()); i < n; i++) {
+    target = stream->EnsureSpace(target);
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::
+      InternalWriteGroup(5, this->_internal_name(i), target, stream);
   }
 
-  if (_internal_metadata_.have_unknown_fields()) {
-    target = ::google::protobuf::internal::WireFormat::SerializeUnknownFieldsToArray(
-        _internal_metadata_.unknown_fields(), target);
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
+        _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
   }
   // @@protoc_insertion_point(serialize_to_array_end:Document)
   return target;
@@ -1327,80 +1127,60 @@ size_t Document::ByteSizeLong() const {
 // @@protoc_insertion_point(message_byte_size_start:Document)
   size_t total_size = 0;
 
-  if (_internal_metadata_.have_unknown_fields()) {
-    total_size +=
-      ::google::protobuf::internal::WireFormat::ComputeUnknownFieldsSize(
-        _internal_metadata_.unknown_fields());
-  }
   // required int64 DocId = 1;
-  if (has_docid()) {
-    total_size += 1 +
-      ::google::protobuf::internal::WireFormatLite::Int64Size(
-        this->docid());
+  if (_internal_has_docid()) {
+    total_size += ::_pbi::WireFormatLite::Int64SizePlusOne(this->_internal_docid());
   }
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
   // repeated group Name = 5 { ... };
-  {
-    unsigned int count = static_cast<unsigned int>(this->name_size());
-    total_size += 2UL * count;
-    for (unsigned int i = 0; i < count; i++) {
-      total_size +=
-        ::google::protobuf::internal::WireFormatLite::GroupSize(
-          this->name(static_cast<int>(i)));
-    }
+  total_size += 2UL * this->_internal_name_size();
+  for (const auto& msg : this->_impl_.name_) {
+    total_size +=
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::GroupSize(msg);
   }
 
   // optional group Links = 2 { ... };
-  if (has_links()) {
+  cached_has_bits = _impl_._has_bits_[0];
+  if (cached_has_bits & 0x00000001u) {
     total_size += 2 +
-      ::google::protobuf::internal::WireFormatLite::GroupSize(
-        *links_);
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::GroupSize(
+        *_impl_.links_);
   }
 
-  int cached_size = ::google::protobuf::internal::ToCachedSize(total_size);
-  SetCachedSize(cached_size);
-  return total_size;
-}
-
-void Document::MergeFrom(const ::google::protobuf::Message& from) {
-// @@protoc_insertion_point(generalized_merge_from_start:Document)
-  GOOGLE_DCHECK_NE(&from, this);
-  const Document* source =
-      ::google::protobuf::internal::DynamicCastToGenerated<const Document>(
-          &from);
-  if (source == NULL) {
-  // @@protoc_insertion_point(generalized_merge_from_cast_fail:Document)
-    ::google::protobuf::internal::ReflectionOps::Merge(from, this);
-  } else {
-  // @@protoc_insertion_point(generalized_merge_from_cast_success:Document)
-    MergeFrom(*source);
-  }
+  return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
 }
 
-void Document::MergeFrom(const Document& from) {
-// @@protoc_insertion_point(class_specific_merge_from_start:Document)
-  GOOGLE_DCHECK_NE(&from, this);
-  _internal_metadata_.MergeFrom(from._internal_metadata_);
-  ::google::protobuf::uint32 cached_has_bits = 0;
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData Document::_class_data_ = {
+    ::PROTOBUF_NAMESPACE_ID::Message::CopyWithSourceCheck,
+    Document::MergeImpl
+};
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*Document::GetClassData() const { return &_class_data_; }
+
+
+void Document::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg) {
+  auto* const _this = static_cast<Document*>(&to_msg);
+  auto& from = static_cast<const Document&>(from_msg);
+  // @@protoc_insertion_point(class_specific_merge_from_start:Document)
+  GOOGLE_DCHECK_NE(&from, _this);
+  uint32_t cached_has_bits = 0;
   (void) cached_has_bits;
 
-  name_.MergeFrom(from.name_);
-  cached_has_bits = from._has_bits_[0];
-  if (cached_has_bits & 3u) {
+  _this->_impl_.name_.MergeFrom(from._impl_.name_);
+  cached_has_bits = from._impl_._has_bits_[0];
+  if (cached_has_bits & 0x00000003u) {
     if (cached_has_bits & 0x00000001u) {
-      mutable_links()->::Document_Links::MergeFrom(from.links());
+      _this->_internal_mutable_links()->::Document_Links::MergeFrom(
+          from._internal_links());
     }
     if (cached_has_bits & 0x00000002u) {
-      docid_ = from.docid_;
+      _this->_impl_.docid_ = from._impl_.docid_;
     }
-    _has_bits_[0] |= cached_has_bits;
+    _this->_impl_._has_bits_[0] |= cached_has_bits;
   }
-}
-
-void Document::CopyFrom(const ::google::protobuf::Message& from) {
-// @@protoc_insertion_point(generalized_copy_from_start:Document)
-  if (&from == this) return;
-  Clear();
-  MergeFrom(from);
+  _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
 }
 
 void Document::CopyFrom(const Document& from) {
@@ -1411,46 +1191,50 @@ void Document::CopyFrom(const Document& from) {
 }
 
 bool Document::IsInitialized() const {
-  if ((_has_bits_[0] & 0x00000002) != 0x00000002) return false;
-  if (!::google::protobuf::internal::AllAreInitialized(this->name())) return false;
+  if (_Internal::MissingRequiredFields(_impl_._has_bits_)) return false;
+  if (!::PROTOBUF_NAMESPACE_ID::internal::AllAreInitialized(_impl_.name_))
+    return false;
   return true;
 }
 
-void Document::Swap(Document* other) {
-  if (other == this) return;
-  InternalSwap(other);
-}
 void Document::InternalSwap(Document* other) {
   using std::swap;
-  CastToBase(&name_)->InternalSwap(CastToBase(&other->name_));
-  swap(links_, other->links_);
-  swap(docid_, other->docid_);
-  swap(_has_bits_[0], other->_has_bits_[0]);
-  _internal_metadata_.Swap(&other->_internal_metadata_);
+  _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  swap(_impl_._has_bits_[0], other->_impl_._has_bits_[0]);
+  _impl_.name_.InternalSwap(&other->_impl_.name_);
+  ::PROTOBUF_NAMESPACE_ID::internal::memswap<
+      PROTOBUF_FIELD_OFFSET(Document, _impl_.docid_)
+      + sizeof(Document::_impl_.docid_)
+      - PROTOBUF_FIELD_OFFSET(Document, _impl_.links_)>(
+          reinterpret_cast<char*>(&_impl_.links_),
+          reinterpret_cast<char*>(&other->_impl_.links_));
 }
 
-::google::protobuf::Metadata Document::GetMetadata() const {
-  protobuf_schema_2eproto::protobuf_AssignDescriptorsOnce();
-  return ::protobuf_schema_2eproto::file_level_metadata[kIndexInFileMessages];
+::PROTOBUF_NAMESPACE_ID::Metadata Document::GetMetadata() const {
+  return ::_pbi::AssignDescriptors(
+      &descriptor_table_schema_2eproto_getter, &descriptor_table_schema_2eproto_once,
+      file_level_metadata_schema_2eproto[3]);
 }
 
-
 // @@protoc_insertion_point(namespace_scope)
-namespace google {
-namespace protobuf {
-template<> GOOGLE_PROTOBUF_ATTRIBUTE_NOINLINE ::Document_Links* Arena::CreateMaybeMessage< ::Document_Links >(Arena* arena) {
-  return Arena::CreateInternal< ::Document_Links >(arena);
+PROTOBUF_NAMESPACE_OPEN
+template<> PROTOBUF_NOINLINE ::Document_Links*
+Arena::CreateMaybeMessage< ::Document_Links >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::Document_Links >(arena);
 }
-template<> GOOGLE_PROTOBUF_ATTRIBUTE_NOINLINE ::Document_Name_Language* Arena::CreateMaybeMessage< ::Document_Name_Language >(Arena* arena) {
-  return Arena::CreateInternal< ::Document_Name_Language >(arena);
+template<> PROTOBUF_NOINLINE ::Document_Name_Language*
+Arena::CreateMaybeMessage< ::Document_Name_Language >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::Document_Name_Language >(arena);
 }
-template<> GOOGLE_PROTOBUF_ATTRIBUTE_NOINLINE ::Document_Name* Arena::CreateMaybeMessage< ::Document_Name >(Arena* arena) {
-  return Arena::CreateInternal< ::Document_Name >(arena);
+template<> PROTOBUF_NOINLINE ::Document_Name*
+Arena::CreateMaybeMessage< ::Document_Name >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::Document_Name >(arena);
 }
-template<> GOOGLE_PROTOBUF_ATTRIBUTE_NOINLINE ::Document* Arena::CreateMaybeMessage< ::Document >(Arena* arena) {
-  return Arena::CreateInternal< ::Document >(arena);
+template<> PROTOBUF_NOINLINE ::Document*
+Arena::CreateMaybeMessage< ::Document >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::Document >(arena);
 }
-}  // namespace protobuf
-}  // namespace google
+PROTOBUF_NAMESPACE_CLOSE
 
 // @@protoc_insertion_point(global_scope)
+#include <google/protobuf/port_undef.inc>
@@ -1,110 +1,120 @@
 // Generated by the protocol buffer compiler.  DO NOT EDIT!
 // source: schema.proto
 
-#ifndef PROTOBUF_INCLUDED_schema_2eproto
-#define PROTOBUF_INCLUDED_schema_2eproto
+#ifndef GOOGLE_PROTOBUF_INCLUDED_schema_2eproto
+#define GOOGLE_PROTOBUF_INCLUDED_schema_2eproto
 
+#include <limits>
 #include <string>
 
-#include <google/protobuf/stubs/common.h>
-
-#if GOOGLE_PROTOBUF_VERSION < 3006001
+#include <google/protobuf/port_def.inc>
+#if PROTOBUF_VERSION < 3021000
 #error This file was generated by a newer version of protoc which is
-#error incompatible with your Protocol Buffer headers.  Please update
+#error incompatible with your Protocol Buffer headers. Please update
 #error your headers.
 #endif
-#if 3006001 < GOOGLE_PROTOBUF_MIN_PROTOC_VERSION
+#if 3021012 < PROTOBUF_MIN_PROTOC_VERSION
 #error This file was generated by an older version of protoc which is
-#error incompatible with your Protocol Buffer headers.  Please
+#error incompatible with your Protocol Buffer headers. Please
 #error regenerate this file with a newer version of protoc.
 #endif
 
+#include <google/protobuf/port_undef.inc>
 #include <google/protobuf/io/coded_stream.h>
 #include <google/protobuf/arena.h>
 #include <google/protobuf/arenastring.h>
-#include <google/protobuf/generated_message_table_driven.h>
 #include <google/protobuf/generated_message_util.h>
-#include <google/protobuf/inlined_string_field.h>
-#include <google/protobuf/metadata.h>
+#include <google/protobuf/metadata_lite.h>
+#include <google/protobuf/generated_message_reflection.h>
 #include <google/protobuf/message.h>
 #include <google/protobuf/repeated_field.h>  // IWYU pragma: export
 #include <google/protobuf/extension_set.h>  // IWYU pragma: export
 #include <google/protobuf/unknown_field_set.h>
 // @@protoc_insertion_point(includes)
-#define PROTOBUF_INTERNAL_EXPORT_protobuf_schema_2eproto 
+#include <google/protobuf/port_def.inc>
+#define PROTOBUF_INTERNAL_EXPORT_schema_2eproto
+PROTOBUF_NAMESPACE_OPEN
+namespace internal {
+class AnyMetadata;
+}  // namespace internal
+PROTOBUF_NAMESPACE_CLOSE
 
-namespace protobuf_schema_2eproto {
 // Internal implementation detail -- do not use these members.
-struct TableStruct {
-  static const ::google::protobuf::internal::ParseTableField entries[];
-  static const ::google::protobuf::internal::AuxillaryParseTableField aux[];
-  static const ::google::protobuf::internal::ParseTable schema[4];
-  static const ::google::protobuf::internal::FieldMetadata field_metadata[];
-  static const ::google::protobuf::internal::SerializationTable serialization_table[];
-  static const ::google::protobuf::uint32 offsets[];
+struct TableStruct_schema_2eproto {
+  static const uint32_t offsets[];
 };
-void AddDescriptors();
-}  // namespace protobuf_schema_2eproto
+extern const ::PROTOBUF_NAMESPACE_ID::internal::DescriptorTable descriptor_table_schema_2eproto;
 class Document;
-class DocumentDefaultTypeInternal;
+struct DocumentDefaultTypeInternal;
 extern DocumentDefaultTypeInternal _Document_default_instance_;
 class Document_Links;
-class Document_LinksDefaultTypeInternal;
+struct Document_LinksDefaultTypeInternal;
 extern Document_LinksDefaultTypeInternal _Document_Links_default_instance_;
 class Document_Name;
-class Document_NameDefaultTypeInternal;
+struct Document_NameDefaultTypeInternal;
 extern Document_NameDefaultTypeInternal _Document_Name_default_instance_;
 class Document_Name_Language;
-class Document_Name_LanguageDefaultTypeInternal;
+struct Document_Name_LanguageDefaultTypeInternal;
 extern Document_Name_LanguageDefaultTypeInternal _Document_Name_Language_default_instance_;
-namespace google {
-namespace protobuf {
+PROTOBUF_NAMESPACE_OPEN
 template<> ::Document* Arena::CreateMaybeMessage<::Document>(Arena*);
 template<> ::Document_Links* Arena::CreateMaybeMessage<::Document_Links>(Arena*);
 template<> ::Document_Name* Arena::CreateMaybeMessage<::Document_Name>(Arena*);
 template<> ::Document_Name_Language* Arena::CreateMaybeMessage<::Document_Name_Language>(Arena*);
-}  // namespace protobuf
-}  // namespace google
+PROTOBUF_NAMESPACE_CLOSE
 
 // ===================================================================
 
-class Document_Links : public ::google::protobuf::Message /* @@protoc_insertion_point(class_definition:Document.Links) */ {
+class Document_Links final :
+    public ::PROTOBUF_NAMESPACE_ID::Message /* @@protoc_insertion_point(class_definition:Document.Links) */ {
  public:
-  Document_Links();
-  virtual ~Document_Links();
+  inline Document_Links() : Document_Links(nullptr) {}
+  ~Document_Links() override;
+  explicit PROTOBUF_CONSTEXPR Document_Links(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
 
   Document_Links(const Document_Links& from);
-
-  inline Document_Links& operator=(const Document_Links& from) {
-    CopyFrom(from);
-    return *this;
-  }
-  #if LANG_CXX11
   Document_Links(Document_Links&& from) noexcept
     : Document_Links() {
     *this = ::std::move(from);
   }
 
+  inline Document_Links& operator=(const Document_Links& from) {
+    CopyFrom(from);
+    return *this;
+  }
   inline Document_Links& operator=(Document_Links&& from) noexcept {
-    if (GetArenaNoVirtual() == from.GetArenaNoVirtual()) {
-      if (this != &from) InternalSwap(&from);
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
     } else {
       CopyFrom(from);
     }
     return *this;
   }
-  #endif
-  inline const ::google::protobuf::UnknownFieldSet& unknown_fields() const {
-    return _internal_metadata_.unknown_fields();
+
+  inline const ::PROTOBUF_NAMESPACE_ID::UnknownFieldSet& unknown_fields() const {
+    return _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance);
   }
-  inline ::google::protobuf::UnknownFieldSet* mutable_unknown_fields() {
-    return _internal_metadata_.mutable_unknown_fields();
+  inline ::PROTOBUF_NAMESPACE_ID::UnknownFieldSet* mutable_unknown_fields() {
+    return _internal_metadata_.mutable_unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
   }
 
-  static const ::google::protobuf::Descriptor* descriptor();
-  static const Document_Links& default_instance();
-
-  static void InitAsDefaultInstance();  // FOR INTERNAL USE ONLY
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* descriptor() {
+    return GetDescriptor();
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* GetDescriptor() {
+    return default_instance().GetMetadata().descriptor;
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Reflection* GetReflection() {
+    return default_instance().GetMetadata().reflection;
+  }
+  static const Document_Links& default_instance() {
+    return *internal_default_instance();
+  }
   static inline const Document_Links* internal_default_instance() {
     return reinterpret_cast<const Document_Links*>(
                &_Document_Links_default_instance_);
@@ -112,129 +122,191 @@ class Document_Links : public ::google::protobuf::Message /* @@protoc_insertion_
   static constexpr int kIndexInFileMessages =
     0;
 
-  void Swap(Document_Links* other);
   friend void swap(Document_Links& a, Document_Links& b) {
     a.Swap(&b);
   }
+  inline void Swap(Document_Links* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(Document_Links* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
 
   // implements Message ----------------------------------------------
 
-  inline Document_Links* New() const final {
-    return CreateMaybeMessage<Document_Links>(NULL);
-  }
-
-  Document_Links* New(::google::protobuf::Arena* arena) const final {
+  Document_Links* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
     return CreateMaybeMessage<Document_Links>(arena);
   }
-  void CopyFrom(const ::google::protobuf::Message& from) final;
-  void MergeFrom(const ::google::protobuf::Message& from) final;
+  using ::PROTOBUF_NAMESPACE_ID::Message::CopyFrom;
   void CopyFrom(const Document_Links& from);
-  void MergeFrom(const Document_Links& from);
-  void Clear() final;
+  using ::PROTOBUF_NAMESPACE_ID::Message::MergeFrom;
+  void MergeFrom( const Document_Links& from) {
+    Document_Links::MergeImpl(*this, from);
+  }
+  private:
+  static void MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg);
+  public:
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
   bool IsInitialized() const final;
 
   size_t ByteSizeLong() const final;
-  bool MergePartialFromCodedStream(
-      ::google::protobuf::io::CodedInputStream* input) final;
-  void SerializeWithCachedSizes(
-      ::google::protobuf::io::CodedOutputStream* output) const final;
-  ::google::protobuf::uint8* InternalSerializeWithCachedSizesToArray(
-      bool deterministic, ::google::protobuf::uint8* target) const final;
-  int GetCachedSize() const final { return _cached_size_.Get(); }
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _impl_._cached_size_.Get(); }
 
   private:
-  void SharedCtor();
+  void SharedCtor(::PROTOBUF_NAMESPACE_ID::Arena* arena, bool is_message_owned);
   void SharedDtor();
   void SetCachedSize(int size) const final;
   void InternalSwap(Document_Links* other);
+
   private:
-  inline ::google::protobuf::Arena* GetArenaNoVirtual() const {
-    return NULL;
-  }
-  inline void* MaybeArenaPtr() const {
-    return NULL;
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "Document.Links";
   }
+  protected:
+  explicit Document_Links(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
   public:
 
-  ::google::protobuf::Metadata GetMetadata() const final;
+  static const ClassData _class_data_;
+  const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*GetClassData() const final;
+
+  ::PROTOBUF_NAMESPACE_ID::Metadata GetMetadata() const final;
 
   // nested types ----------------------------------------------------
 
   // accessors -------------------------------------------------------
 
+  enum : int {
+    kBackwardFieldNumber = 3,
+    kForwardFieldNumber = 4,
+  };
   // repeated int64 Backward = 3;
   int backward_size() const;
+  private:
+  int _internal_backward_size() const;
+  public:
   void clear_backward();
-  static const int kBackwardFieldNumber = 3;
-  ::google::protobuf::int64 backward(int index) const;
-  void set_backward(int index, ::google::protobuf::int64 value);
-  void add_backward(::google::protobuf::int64 value);
-  const ::google::protobuf::RepeatedField< ::google::protobuf::int64 >&
+  private:
+  int64_t _internal_backward(int index) const;
+  const ::PROTOBUF_NAMESPACE_ID::RepeatedField< int64_t >&
+      _internal_backward() const;
+  void _internal_add_backward(int64_t value);
+  ::PROTOBUF_NAMESPACE_ID::RepeatedField< int64_t >*
+      _internal_mutable_backward();
+  public:
+  int64_t backward(int index) const;
+  void set_backward(int index, int64_t value);
+  void add_backward(int64_t value);
+  const ::PROTOBUF_NAMESPACE_ID::RepeatedField< int64_t >&
       backward() const;
-  ::google::protobuf::RepeatedField< ::google::protobuf::int64 >*
+  ::PROTOBUF_NAMESPACE_ID::RepeatedField< int64_t >*
       mutable_backward();
 
   // repeated int64 Forward = 4;
   int forward_size() const;
+  private:
+  int _internal_forward_size() const;
+  public:
   void clear_forward();
-  static const int kForwardFieldNumber = 4;
-  ::google::protobuf::int64 forward(int index) const;
-  void set_forward(int index, ::google::protobuf::int64 value);
-  void add_forward(::google::protobuf::int64 value);
-  const ::google::protobuf::RepeatedField< ::google::protobuf::int64 >&
+  private:
+  int64_t _internal_forward(int index) const;
+  const ::PROTOBUF_NAMESPACE_ID::RepeatedField< int64_t >&
+      _internal_forward() const;
+  void _internal_add_forward(int64_t value);
+  ::PROTOBUF_NAMESPACE_ID::RepeatedField< int64_t >*
+      _internal_mutable_forward();
+  public:
+  int64_t forward(int index) const;
+  void set_forward(int index, int64_t value);
+  void add_forward(int64_t value);
+  const ::PROTOBUF_NAMESPACE_ID::RepeatedField< int64_t >&
       forward() const;
-  ::google::protobuf::RepeatedField< ::google::protobuf::int64 >*
+  ::PROTOBUF_NAMESPACE_ID::RepeatedField< int64_t >*
       mutable_forward();
 
   // @@protoc_insertion_point(class_scope:Document.Links)
  private:
-
-  ::google::protobuf::internal::InternalMetadataWithArena _internal_metadata_;
-  ::google::protobuf::internal::HasBits<1> _has_bits_;
-  mutable ::google::protobuf::internal::CachedSize _cached_size_;
-  ::google::protobuf::RepeatedField< ::google::protobuf::int64 > backward_;
-  ::google::protobuf::RepeatedField< ::google::protobuf::int64 > forward_;
-  friend struct ::protobuf_schema_2eproto::TableStruct;
+  class _Internal;
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  struct Impl_ {
+    ::PROTOBUF_NAMESPACE_ID::RepeatedField< int64_t > backward_;
+    ::PROTOBUF_NAMESPACE_ID::RepeatedField< int64_t > forward_;
+    mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  };
+  union { Impl_ _impl_; };
+  friend struct ::TableStruct_schema_2eproto;
 };
 // -------------------------------------------------------------------
 
-class Document_Name_Language : public ::google::protobuf::Message /* @@protoc_insertion_point(class_definition:Document.Name.Language) */ {
+class Document_Name_Language final :
+    public ::PROTOBUF_NAMESPACE_ID::Message /* @@protoc_insertion_point(class_definition:Document.Name.Language) */ {
  public:
-  Document_Name_Language();
-  virtual ~Document_Name_Language();
+  inline Document_Name_Language() : Document_Name_Language(nullptr) {}
+  ~Document_Name_Language() override;
+  explicit PROTOBUF_CONSTEXPR Document_Name_Language(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
 
   Document_Name_Language(const Document_Name_Language& from);
-
-  inline Document_Name_Language& operator=(const Document_Name_Language& from) {
-    CopyFrom(from);
-    return *this;
-  }
-  #if LANG_CXX11
   Document_Name_Language(Document_Name_Language&& from) noexcept
     : Document_Name_Language() {
     *this = ::std::move(from);
   }
 
+  inline Document_Name_Language& operator=(const Document_Name_Language& from) {
+    CopyFrom(from);
+    return *this;
+  }
   inline Document_Name_Language& operator=(Document_Name_Language&& from) noexcept {
-    if (GetArenaNoVirtual() == from.GetArenaNoVirtual()) {
-      if (this != &from) InternalSwap(&from);
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
     } else {
       CopyFrom(from);
     }
     return *this;
   }
-  #endif
-  inline const ::google::protobuf::UnknownFieldSet& unknown_fields() const {
-    return _internal_metadata_.unknown_fields();
+
+  inline const ::PROTOBUF_NAMESPACE_ID::UnknownFieldSet& unknown_fields() const {
+    return _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance);
   }
-  inline ::google::protobuf::UnknownFieldSet* mutable_unknown_fields() {
-    return _internal_metadata_.mutable_unknown_fields();
+  inline ::PROTOBUF_NAMESPACE_ID::UnknownFieldSet* mutable_unknown_fields() {
+    return _internal_metadata_.mutable_unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
   }
 
-  static const ::google::protobuf::Descriptor* descriptor();
-  static const Document_Name_Language& default_instance();
-
-  static void InitAsDefaultInstance();  // FOR INTERNAL USE ONLY
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* descriptor() {
+    return GetDescriptor();
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* GetDescriptor() {
+    return default_instance().GetMetadata().descriptor;
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Reflection* GetReflection() {
+    return default_instance().GetMetadata().reflection;
+  }
+  static const Document_Name_Language& default_instance() {
+    return *internal_default_instance();
+  }
   static inline const Document_Name_Language* internal_default_instance() {
     return reinterpret_cast<const Document_Name_Language*>(
                &_Document_Name_Language_default_instance_);
@@ -242,139 +314,184 @@ class Document_Name_Language : public ::google::protobuf::Message /* @@protoc_in
   static constexpr int kIndexInFileMessages =
     1;
 
-  void Swap(Document_Name_Language* other);
   friend void swap(Document_Name_Language& a, Document_Name_Language& b) {
     a.Swap(&b);
   }
+  inline void Swap(Document_Name_Language* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(Document_Name_Language* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
 
   // implements Message ----------------------------------------------
 
-  inline Document_Name_Language* New() const final {
-    return CreateMaybeMessage<Document_Name_Language>(NULL);
-  }
-
-  Document_Name_Language* New(::google::protobuf::Arena* arena) const final {
+  Document_Name_Language* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
     return CreateMaybeMessage<Document_Name_Language>(arena);
   }
-  void CopyFrom(const ::google::protobuf::Message& from) final;
-  void MergeFrom(const ::google::protobuf::Message& from) final;
+  using ::PROTOBUF_NAMESPACE_ID::Message::CopyFrom;
   void CopyFrom(const Document_Name_Language& from);
-  void MergeFrom(const Document_Name_Language& from);
-  void Clear() final;
+  using ::PROTOBUF_NAMESPACE_ID::Message::MergeFrom;
+  void MergeFrom( const Document_Name_Language& from) {
+    Document_Name_Language::MergeImpl(*this, from);
+  }
+  private:
+  static void MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg);
+  public:
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
   bool IsInitialized() const final;
 
   size_t ByteSizeLong() const final;
-  bool MergePartialFromCodedStream(
-      ::google::protobuf::io::CodedInputStream* input) final;
-  void SerializeWithCachedSizes(
-      ::google::protobuf::io::CodedOutputStream* output) const final;
-  ::google::protobuf::uint8* InternalSerializeWithCachedSizesToArray(
-      bool deterministic, ::google::protobuf::uint8* target) const final;
-  int GetCachedSize() const final { return _cached_size_.Get(); }
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _impl_._cached_size_.Get(); }
 
   private:
-  void SharedCtor();
+  void SharedCtor(::PROTOBUF_NAMESPACE_ID::Arena* arena, bool is_message_owned);
   void SharedDtor();
   void SetCachedSize(int size) const final;
   void InternalSwap(Document_Name_Language* other);
+
   private:
-  inline ::google::protobuf::Arena* GetArenaNoVirtual() const {
-    return NULL;
-  }
-  inline void* MaybeArenaPtr() const {
-    return NULL;
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "Document.Name.Language";
   }
+  protected:
+  explicit Document_Name_Language(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
   public:
 
-  ::google::protobuf::Metadata GetMetadata() const final;
+  static const ClassData _class_data_;
+  const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*GetClassData() const final;
+
+  ::PROTOBUF_NAMESPACE_ID::Metadata GetMetadata() const final;
 
   // nested types ----------------------------------------------------
 
   // accessors -------------------------------------------------------
 
+  enum : int {
+    kCodeFieldNumber = 7,
+    kCountryFieldNumber = 8,
+  };
   // required string Code = 7;
   bool has_code() const;
+  private:
+  bool _internal_has_code() const;
+  public:
   void clear_code();
-  static const int kCodeFieldNumber = 7;
-  const ::std::string& code() const;
-  void set_code(const ::std::string& value);
-  #if LANG_CXX11
-  void set_code(::std::string&& value);
-  #endif
-  void set_code(const char* value);
-  void set_code(const char* value, size_t size);
-  ::std::string* mutable_code();
-  ::std::string* release_code();
-  void set_allocated_code(::std::string* code);
+  const std::string& code() const;
+  template <typename ArgT0 = const std::string&, typename... ArgT>
+  void set_code(ArgT0&& arg0, ArgT... args);
+  std::string* mutable_code();
+  PROTOBUF_NODISCARD std::string* release_code();
+  void set_allocated_code(std::string* code);
+  private:
+  const std::string& _internal_code() const;
+  inline PROTOBUF_ALWAYS_INLINE void _internal_set_code(const std::string& value);
+  std::string* _internal_mutable_code();
+  public:
 
   // optional string Country = 8;
   bool has_country() const;
+  private:
+  bool _internal_has_country() const;
+  public:
   void clear_country();
-  static const int kCountryFieldNumber = 8;
-  const ::std::string& country() const;
-  void set_country(const ::std::string& value);
-  #if LANG_CXX11
-  void set_country(::std::string&& value);
-  #endif
-  void set_country(const char* value);
-  void set_country(const char* value, size_t size);
-  ::std::string* mutable_country();
-  ::std::string* release_country();
-  void set_allocated_country(::std::string* country);
+  const std::string& country() const;
+  template <typename ArgT0 = const std::string&, typename... ArgT>
+  void set_country(ArgT0&& arg0, ArgT... args);
+  std::string* mutable_country();
+  PROTOBUF_NODISCARD std::string* release_country();
+  void set_allocated_country(std::string* country);
+  private:
+  const std::string& _internal_country() const;
+  inline PROTOBUF_ALWAYS_INLINE void _internal_set_country(const std::string& value);
+  std::string* _internal_mutable_country();
+  public:
 
   // @@protoc_insertion_point(class_scope:Document.Name.Language)
  private:
-  void set_has_code();
-  void clear_has_code();
-  void set_has_country();
-  void clear_has_country();
-
-  ::google::protobuf::internal::InternalMetadataWithArena _internal_metadata_;
-  ::google::protobuf::internal::HasBits<1> _has_bits_;
-  mutable ::google::protobuf::internal::CachedSize _cached_size_;
-  ::google::protobuf::internal::ArenaStringPtr code_;
-  ::google::protobuf::internal::ArenaStringPtr country_;
-  friend struct ::protobuf_schema_2eproto::TableStruct;
+  class _Internal;
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  struct Impl_ {
+    ::PROTOBUF_NAMESPACE_ID::internal::HasBits<1> _has_bits_;
+    mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+    ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr code_;
+    ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr country_;
+  };
+  union { Impl_ _impl_; };
+  friend struct ::TableStruct_schema_2eproto;
 };
 // -------------------------------------------------------------------
 
-class Document_Name : public ::google::protobuf::Message /* @@protoc_insertion_point(class_definition:Document.Name) */ {
+class Document_Name final :
+    public ::PROTOBUF_NAMESPACE_ID::Message /* @@protoc_insertion_point(class_definition:Document.Name) */ {
  public:
-  Document_Name();
-  virtual ~Document_Name();
+  inline Document_Name() : Document_Name(nullptr) {}
+  ~Document_Name() override;
+  explicit PROTOBUF_CONSTEXPR Document_Name(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
 
   Document_Name(const Document_Name& from);
-
-  inline Document_Name& operator=(const Document_Name& from) {
-    CopyFrom(from);
-    return *this;
-  }
-  #if LANG_CXX11
   Document_Name(Document_Name&& from) noexcept
     : Document_Name() {
     *this = ::std::move(from);
   }
 
+  inline Document_Name& operator=(const Document_Name& from) {
+    CopyFrom(from);
+    return *this;
+  }
   inline Document_Name& operator=(Document_Name&& from) noexcept {
-    if (GetArenaNoVirtual() == from.GetArenaNoVirtual()) {
-      if (this != &from) InternalSwap(&from);
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
     } else {
       CopyFrom(from);
     }
     return *this;
   }
-  #endif
-  inline const ::google::protobuf::UnknownFieldSet& unknown_fields() const {
-    return _internal_metadata_.unknown_fields();
+
+  inline const ::PROTOBUF_NAMESPACE_ID::UnknownFieldSet& unknown_fields() const {
+    return _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance);
   }
-  inline ::google::protobuf::UnknownFieldSet* mutable_unknown_fields() {
-    return _internal_metadata_.mutable_unknown_fields();
+  inline ::PROTOBUF_NAMESPACE_ID::UnknownFieldSet* mutable_unknown_fields() {
+    return _internal_metadata_.mutable_unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
   }
 
-  static const ::google::protobuf::Descriptor* descriptor();
-  static const Document_Name& default_instance();
-
-  static void InitAsDefaultInstance();  // FOR INTERNAL USE ONLY
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* descriptor() {
+    return GetDescriptor();
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* GetDescriptor() {
+    return default_instance().GetMetadata().descriptor;
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Reflection* GetReflection() {
+    return default_instance().GetMetadata().reflection;
+  }
+  static const Document_Name& default_instance() {
+    return *internal_default_instance();
+  }
   static inline const Document_Name* internal_default_instance() {
     return reinterpret_cast<const Document_Name*>(
                &_Document_Name_default_instance_);
@@ -382,51 +499,71 @@ class Document_Name : public ::google::protobuf::Message /* @@protoc_insertion_p
   static constexpr int kIndexInFileMessages =
     2;
 
-  void Swap(Document_Name* other);
   friend void swap(Document_Name& a, Document_Name& b) {
     a.Swap(&b);
   }
+  inline void Swap(Document_Name* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(Document_Name* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
 
   // implements Message ----------------------------------------------
 
-  inline Document_Name* New() const final {
-    return CreateMaybeMessage<Document_Name>(NULL);
-  }
-
-  Document_Name* New(::google::protobuf::Arena* arena) const final {
+  Document_Name* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
     return CreateMaybeMessage<Document_Name>(arena);
   }
-  void CopyFrom(const ::google::protobuf::Message& from) final;
-  void MergeFrom(const ::google::protobuf::Message& from) final;
+  using ::PROTOBUF_NAMESPACE_ID::Message::CopyFrom;
   void CopyFrom(const Document_Name& from);
-  void MergeFrom(const Document_Name& from);
-  void Clear() final;
+  using ::PROTOBUF_NAMESPACE_ID::Message::MergeFrom;
+  void MergeFrom( const Document_Name& from) {
+    Document_Name::MergeImpl(*this, from);
+  }
+  private:
+  static void MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg);
+  public:
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
   bool IsInitialized() const final;
 
   size_t ByteSizeLong() const final;
-  bool MergePartialFromCodedStream(
-      ::google::protobuf::io::CodedInputStream* input) final;
-  void SerializeWithCachedSizes(
-      ::google::protobuf::io::CodedOutputStream* output) const final;
-  ::google::protobuf::uint8* InternalSerializeWithCachedSizesToArray(
-      bool deterministic, ::google::protobuf::uint8* target) const final;
-  int GetCachedSize() const final { return _cached_size_.Get(); }
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _impl_._cached_size_.Get(); }
 
   private:
-  void SharedCtor();
+  void SharedCtor(::PROTOBUF_NAMESPACE_ID::Arena* arena, bool is_message_owned);
   void SharedDtor();
   void SetCachedSize(int size) const final;
   void InternalSwap(Document_Name* other);
+
   private:
-  inline ::google::protobuf::Arena* GetArenaNoVirtual() const {
-    return NULL;
-  }
-  inline void* MaybeArenaPtr() const {
-    return NULL;
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "Document.Name";
   }
+  protected:
+  explicit Document_Name(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
   public:
 
-  ::google::protobuf::Metadata GetMetadata() const final;
+  static const ClassData _class_data_;
+  const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*GetClassData() const final;
+
+  ::PROTOBUF_NAMESPACE_ID::Metadata GetMetadata() const final;
 
   // nested types ----------------------------------------------------
 
@@ -434,84 +571,114 @@ class Document_Name : public ::google::protobuf::Message /* @@protoc_insertion_p
 
   // accessors -------------------------------------------------------
 
+  enum : int {
+    kLanguageFieldNumber = 6,
+    kUrlFieldNumber = 9,
+  };
   // repeated group Language = 6 { ... };
   int language_size() const;
+  private:
+  int _internal_language_size() const;
+  public:
   void clear_language();
-  static const int kLanguageFieldNumber = 6;
   ::Document_Name_Language* mutable_language(int index);
-  ::google::protobuf::RepeatedPtrField< ::Document_Name_Language >*
+  ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::Document_Name_Language >*
       mutable_language();
+  private:
+  const ::Document_Name_Language& _internal_language(int index) const;
+  ::Document_Name_Language* _internal_add_language();
+  public:
   const ::Document_Name_Language& language(int index) const;
   ::Document_Name_Language* add_language();
-  const ::google::protobuf::RepeatedPtrField< ::Document_Name_Language >&
+  const ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::Document_Name_Language >&
       language() const;
 
   // optional string Url = 9;
   bool has_url() const;
+  private:
+  bool _internal_has_url() const;
+  public:
   void clear_url();
-  static const int kUrlFieldNumber = 9;
-  const ::std::string& url() const;
-  void set_url(const ::std::string& value);
-  #if LANG_CXX11
-  void set_url(::std::string&& value);
-  #endif
-  void set_url(const char* value);
-  void set_url(const char* value, size_t size);
-  ::std::string* mutable_url();
-  ::std::string* release_url();
-  void set_allocated_url(::std::string* url);
+  const std::string& url() const;
+  template <typename ArgT0 = const std::string&, typename... ArgT>
+  void set_url(ArgT0&& arg0, ArgT... args);
+  std::string* mutable_url();
+  PROTOBUF_NODISCARD std::string* release_url();
+  void set_allocated_url(std::string* url);
+  private:
+  const std::string& _internal_url() const;
+  inline PROTOBUF_ALWAYS_INLINE void _internal_set_url(const std::string& value);
+  std::string* _internal_mutable_url();
+  public:
 
   // @@protoc_insertion_point(class_scope:Document.Name)
  private:
-  void set_has_url();
-  void clear_has_url();
-
-  ::google::protobuf::internal::InternalMetadataWithArena _internal_metadata_;
-  ::google::protobuf::internal::HasBits<1> _has_bits_;
-  mutable ::google::protobuf::internal::CachedSize _cached_size_;
-  ::google::protobuf::RepeatedPtrField< ::Document_Name_Language > language_;
-  ::google::protobuf::internal::ArenaStringPtr url_;
-  friend struct ::protobuf_schema_2eproto::TableStruct;
+  class _Internal;
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  struct Impl_ {
+    ::PROTOBUF_NAMESPACE_ID::internal::HasBits<1> _has_bits_;
+    mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+    ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::Document_Name_Language > language_;
+    ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr url_;
+  };
+  union { Impl_ _impl_; };
+  friend struct ::TableStruct_schema_2eproto;
 };
 // -------------------------------------------------------------------
 
-class Document : public ::google::protobuf::Message /* @@protoc_insertion_point(class_definition:Document) */ {
+class Document final :
+    public ::PROTOBUF_NAMESPACE_ID::Message /* @@protoc_insertion_point(class_definition:Document) */ {
  public:
-  Document();
-  virtual ~Document();
+  inline Document() : Document(nullptr) {}
+  ~Document() override;
+  explicit PROTOBUF_CONSTEXPR Document(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
 
   Document(const Document& from);
-
-  inline Document& operator=(const Document& from) {
-    CopyFrom(from);
-    return *this;
-  }
-  #if LANG_CXX11
   Document(Document&& from) noexcept
     : Document() {
     *this = ::std::move(from);
   }
 
+  inline Document& operator=(const Document& from) {
+    CopyFrom(from);
+    return *this;
+  }
   inline Document& operator=(Document&& from) noexcept {
-    if (GetArenaNoVirtual() == from.GetArenaNoVirtual()) {
-      if (this != &from) InternalSwap(&from);
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
     } else {
       CopyFrom(from);
     }
     return *this;
   }
-  #endif
-  inline const ::google::protobuf::UnknownFieldSet& unknown_fields() const {
-    return _internal_metadata_.unknown_fields();
+
+  inline const ::PROTOBUF_NAMESPACE_ID::UnknownFieldSet& unknown_fields() const {
+    return _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance);
   }
-  inline ::google::protobuf::UnknownFieldSet* mutable_unknown_fields() {
-    return _internal_metadata_.mutable_unknown_fields();
+  inline ::PROTOBUF_NAMESPACE_ID::UnknownFieldSet* mutable_unknown_fields() {
+    return _internal_metadata_.mutable_unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
   }
 
-  static const ::google::protobuf::Descriptor* descriptor();
-  static const Document& default_instance();
-
-  static void InitAsDefaultInstance();  // FOR INTERNAL USE ONLY
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* descriptor() {
+    return GetDescriptor();
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* GetDescriptor() {
+    return default_instance().GetMetadata().descriptor;
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Reflection* GetReflection() {
+    return default_instance().GetMetadata().reflection;
+  }
+  static const Document& default_instance() {
+    return *internal_default_instance();
+  }
   static inline const Document* internal_default_instance() {
     return reinterpret_cast<const Document*>(
                &_Document_default_instance_);
@@ -519,51 +686,71 @@ class Document : public ::google::protobuf::Message /* @@protoc_insertion_point(
   static constexpr int kIndexInFileMessages =
     3;
 
-  void Swap(Document* other);
   friend void swap(Document& a, Document& b) {
     a.Swap(&b);
   }
+  inline void Swap(Document* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(Document* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
 
   // implements Message ----------------------------------------------
 
-  inline Document* New() const final {
-    return CreateMaybeMessage<Document>(NULL);
-  }
-
-  Document* New(::google::protobuf::Arena* arena) const final {
+  Document* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
     return CreateMaybeMessage<Document>(arena);
   }
-  void CopyFrom(const ::google::protobuf::Message& from) final;
-  void MergeFrom(const ::google::protobuf::Message& from) final;
+  using ::PROTOBUF_NAMESPACE_ID::Message::CopyFrom;
   void CopyFrom(const Document& from);
-  void MergeFrom(const Document& from);
-  void Clear() final;
+  using ::PROTOBUF_NAMESPACE_ID::Message::MergeFrom;
+  void MergeFrom( const Document& from) {
+    Document::MergeImpl(*this, from);
+  }
+  private:
+  static void MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg);
+  public:
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
   bool IsInitialized() const final;
 
   size_t ByteSizeLong() const final;
-  bool MergePartialFromCodedStream(
-      ::google::protobuf::io::CodedInputStream* input) final;
-  void SerializeWithCachedSizes(
-      ::google::protobuf::io::CodedOutputStream* output) const final;
-  ::google::protobuf::uint8* InternalSerializeWithCachedSizesToArray(
-      bool deterministic, ::google::protobuf::uint8* target) const final;
-  int GetCachedSize() const final { return _cached_size_.Get(); }
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _impl_._cached_size_.Get(); }
 
   private:
-  void SharedCtor();
+  void SharedCtor(::PROTOBUF_NAMESPACE_ID::Arena* arena, bool is_message_owned);
   void SharedDtor();
   void SetCachedSize(int size) const final;
   void InternalSwap(Document* other);
+
   private:
-  inline ::google::protobuf::Arena* GetArenaNoVirtual() const {
-    return NULL;
-  }
-  inline void* MaybeArenaPtr() const {
-    return NULL;
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "Document";
   }
+  protected:
+  explicit Document(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
   public:
 
-  ::google::protobuf::Metadata GetMetadata() const final;
+  static const ClassData _class_data_;
+  const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*GetClassData() const final;
+
+  ::PROTOBUF_NAMESPACE_ID::Metadata GetMetadata() const final;
 
   // nested types ----------------------------------------------------
 
@@ -572,51 +759,76 @@ class Document : public ::google::protobuf::Message /* @@protoc_insertion_point(
 
   // accessors -------------------------------------------------------
 
+  enum : int {
+    kNameFieldNumber = 5,
+    kLinksFieldNumber = 2,
+    kDocIdFieldNumber = 1,
+  };
   // repeated group Name = 5 { ... };
   int name_size() const;
+  private:
+  int _internal_name_size() const;
+  public:
   void clear_name();
-  static const int kNameFieldNumber = 5;
   ::Document_Name* mutable_name(int index);
-  ::google::protobuf::RepeatedPtrField< ::Document_Name >*
+  ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::Document_Name >*
       mutable_name();
+  private:
+  const ::Document_Name& _internal_name(int index) const;
+  ::Document_Name* _internal_add_name();
+  public:
   const ::Document_Name& name(int index) const;
   ::Document_Name* add_name();
-  const ::google::protobuf::RepeatedPtrField< ::Document_Name >&
+  const ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::Document_Name >&
       name() const;
 
   // optional group Links = 2 { ... };
   bool has_links() const;
-  void clear_links();
-  static const int kLinksFieldNumber = 2;
   private:
-  const ::Document_Links& _internal_links() const;
+  bool _internal_has_links() const;
   public:
+  void clear_links();
   const ::Document_Links& links() const;
-  ::Document_Links* release_links();
+  PROTOBUF_NODISCARD ::Document_Links* release_links();
   ::Document_Links* mutable_links();
   void set_allocated_links(::Document_Links* links);
+  private:
+  const ::Document_Links& _internal_links() const;
+  ::Document_Links* _internal_mutable_links();
+  public:
+  void unsafe_arena_set_allocated_links(
+      ::Document_Links* links);
+  ::Document_Links* unsafe_arena_release_links();
 
   // required int64 DocId = 1;
   bool has_docid() const;
+  private:
+  bool _internal_has_docid() const;
+  public:
   void clear_docid();
-  static const int kDocIdFieldNumber = 1;
-  ::google::protobuf::int64 docid() const;
-  void set_docid(::google::protobuf::int64 value);
+  int64_t docid() const;
+  void set_docid(int64_t value);
+  private:
+  int64_t _internal_docid() const;
+  void _internal_set_docid(int64_t value);
+  public:
 
   // @@protoc_insertion_point(class_scope:Document)
  private:
-  void set_has_docid();
-  void clear_has_docid();
-  void set_has_links();
-  void clear_has_links();
-
-  ::google::protobuf::internal::InternalMetadataWithArena _internal_metadata_;
-  ::google::protobuf::internal::HasBits<1> _has_bits_;
-  mutable ::google::protobuf::internal::CachedSize _cached_size_;
-  ::google::protobuf::RepeatedPtrField< ::Document_Name > name_;
-  ::Document_Links* links_;
-  ::google::protobuf::int64 docid_;
-  friend struct ::protobuf_schema_2eproto::TableStruct;
+  class _Internal;
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  struct Impl_ {
+    ::PROTOBUF_NAMESPACE_ID::internal::HasBits<1> _has_bits_;
+    mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+    ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::Document_Name > name_;
+    ::Document_Links* links_;
+    int64_t docid_;
+  };
+  union { Impl_ _impl_; };
+  friend struct ::TableStruct_schema_2eproto;
 };
 // ===================================================================
 
@@ -630,63 +842,97 @@ class Document : public ::google::protobuf::Message /* @@protoc_insertion_point(
 // Document_Links
 
 // repeated int64 Backward = 3;
+inline int Document_Links::_internal_backward_size() const {
+  return _impl_.backward_.size();
+}
 inline int Document_Links::backward_size() const {
-  return backward_.size();
+  return _internal_backward_size();
 }
 inline void Document_Links::clear_backward() {
-  backward_.Clear();
+  _impl_.backward_.Clear();
 }
-inline ::google::protobuf::int64 Document_Links::backward(int index) const {
+inline int64_t Document_Links::_internal_backward(int index) const {
+  return _impl_.backward_.Get(index);
+}
+inline int64_t Document_Links::backward(int index) const {
   // @@protoc_insertion_point(field_get:Document.Links.Backward)
-  return backward_.Get(index);
+  return _internal_backward(index);
 }
-inline void Document_Links::set_backward(int index, ::google::protobuf::int64 value) {
-  backward_.Set(index, value);
+inline void Document_Links::set_backward(int index, int64_t value) {
+  _impl_.backward_.Set(index, value);
   // @@protoc_insertion_point(field_set:Document.Links.Backward)
 }
-inline void Document_Links::add_backward(::google::protobuf::int64 value) {
-  backward_.Add(value);
+inline void Document_Links::_internal_add_backward(int64_t value) {
+  _impl_.backward_.Add(value);
+}
+inline void Document_Links::add_backward(int64_t value) {
+  _internal_add_backward(value);
   // @@protoc_insertion_point(field_add:Document.Links.Backward)
 }
-inline const ::google::protobuf::RepeatedField< ::google::protobuf::int64 >&
+inline const ::PROTOBUF_NAMESPACE_ID::RepeatedField< int64_t >&
+Document_Links::_internal_backward() const {
+  return _impl_.backward_;
+}
+inline const ::PROTOBUF_NAMESPACE_ID::RepeatedField< int64_t >&
 Document_Links::backward() const {
   // @@protoc_insertion_point(field_list:Document.Links.Backward)
-  return backward_;
+  return _internal_backward();
+}
+inline ::PROTOBUF_NAMESPACE_ID::RepeatedField< int64_t >*
+Document_Links::_internal_mutable_backward() {
+  return &_impl_.backward_;
 }
-inline ::google::protobuf::RepeatedField< ::google::protobuf::int64 >*
+inline ::PROTOBUF_NAMESPACE_ID::RepeatedField< int64_t >*
 Document_Links::mutable_backward() {
   // @@protoc_insertion_point(field_mutable_list:Document.Links.Backward)
-  return &backward_;
+  return _internal_mutable_backward();
 }
 
 // repeated int64 Forward = 4;
+inline int Document_Links::_internal_forward_size() const {
+  return _impl_.forward_.size();
+}
 inline int Document_Links::forward_size() const {
-  return forward_.size();
+  return _internal_forward_size();
 }
 inline void Document_Links::clear_forward() {
-  forward_.Clear();
+  _impl_.forward_.Clear();
 }
-inline ::google::protobuf::int64 Document_Links::forward(int index) const {
+inline int64_t Document_Links::_internal_forward(int index) const {
+  return _impl_.forward_.Get(index);
+}
+inline int64_t Document_Links::forward(int index) const {
   // @@protoc_insertion_point(field_get:Document.Links.Forward)
-  return forward_.Get(index);
+  return _internal_forward(index);
 }
-inline void Document_Links::set_forward(int index, ::google::protobuf::int64 value) {
-  forward_.Set(index, value);
+inline void Document_Links::set_forward(int index, int64_t value) {
+  _impl_.forward_.Set(index, value);
   // @@protoc_insertion_point(field_set:Document.Links.Forward)
 }
-inline void Document_Links::add_forward(::google::protobuf::int64 value) {
-  forward_.Add(value);
+inline void Document_Links::_internal_add_forward(int64_t value) {
+  _impl_.forward_.Add(value);
+}
+inline void Document_Links::add_forward(int64_t value) {
+  _internal_add_forward(value);
   // @@protoc_insertion_point(field_add:Document.Links.Forward)
 }
-inline const ::google::protobuf::RepeatedField< ::google::protobuf::int64 >&
+inline const ::PROTOBUF_NAMESPACE_ID::RepeatedField< int64_t >&
+Document_Links::_internal_forward() const {
+  return _impl_.forward_;
+}
+inline const ::PROTOBUF_NAMESPACE_ID::RepeatedField< int64_t >&
 Document_Links::forward() const {
   // @@protoc_insertion_point(field_list:Document.Links.Forward)
-  return forward_;
+  return _internal_forward();
 }
-inline ::google::protobuf::RepeatedField< ::google::protobuf::int64 >*
+inline ::PROTOBUF_NAMESPACE_ID::RepeatedField< int64_t >*
+Document_Links::_internal_mutable_forward() {
+  return &_impl_.forward_;
+}
+inline ::PROTOBUF_NAMESPACE_ID::RepeatedField< int64_t >*
 Document_Links::mutable_forward() {
   // @@protoc_insertion_point(field_mutable_list:Document.Links.Forward)
-  return &forward_;
+  return _internal_mutable_forward();
 }
 
 // -------------------------------------------------------------------
@@ -694,134 +940,138 @@ Document_Links::mutable_forward() {
 // Document_Name_Language
 
 // required string Code = 7;
-inline bool Document_Name_Language::has_code() const {
-  return (_has_bits_[0] & 0x00000001u) != 0;
-}
-inline void Document_Name_Language::set_has_code() {
-  _has_bits_[0] |= 0x00000001u;
+inline bool Document_Name_Language::_internal_has_code() const {
+  bool value = (_impl_._has_bits_[0] & 0x00000001u) != 0;
+  return value;
 }
-inline void Document_Name_Language::clear_has_code() {
-  _has_bits_[0] &= ~0x00000001u;
+inline bool Document_Name_Language::has_code() const {
+  return _internal_has_code();
 }
 inline void Document_Name_Language::clear_code() {
-  code_.ClearToEmptyNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
-  clear_has_code();
+  _impl_.code_.ClearToEmpty();
+  _impl_._has_bits_[0] &= ~0x00000001u;
 }
-inline const ::std::string& Document_Name_Language::code() const {
+inline const std::string& Document_Name_Language::code() const {
   // @@protoc_insertion_point(field_get:Document.Name.Language.Code)
-  return code_.GetNoArena();
+  return _internal_code();
 }
-inline void Document_Name_Language::set_code(const ::std::string& value) {
-  set_has_code();
-  code_.SetNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), value);
+template <typename ArgT0, typename... ArgT>
+inline PROTOBUF_ALWAYS_INLINE
+void Document_Name_Language::set_code(ArgT0&& arg0, ArgT... args) {
+ _impl_._has_bits_[0] |= 0x00000001u;
+ _impl_.code_.Set(static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
   // @@protoc_insertion_point(field_set:Document.Name.Language.Code)
 }
-#if LANG_CXX11
-inline void Document_Name_Language::set_code(::std::string&& value) {
-  set_has_code();
-  code_.SetNoArena(
-    &::google::protobuf::internal::GetEmptyStringAlreadyInited(), ::std::move(value));
-  // @@protoc_insertion_point(field_set_rvalue:Document.Name.Language.Code)
-}
-#endif
-inline void Document_Name_Language::set_code(const char* value) {
-  GOOGLE_DCHECK(value != NULL);
-  set_has_code();
-  code_.SetNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), ::std::string(value));
-  // @@protoc_insertion_point(field_set_char:Document.Name.Language.Code)
-}
-inline void Document_Name_Language::set_code(const char* value, size_t size) {
-  set_has_code();
-  code_.SetNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited(),
-      ::std::string(reinterpret_cast<const char*>(value), size));
-  // @@protoc_insertion_point(field_set_pointer:Document.Name.Language.Code)
-}
-inline ::std::string* Document_Name_Language::mutable_code() {
-  set_has_code();
+inline std::string* Document_Name_Language::mutable_code() {
+  std::string* _s = _internal_mutable_code();
   // @@protoc_insertion_point(field_mutable:Document.Name.Language.Code)
-  return code_.MutableNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
+  return _s;
+}
+inline const std::string& Document_Name_Language::_internal_code() const {
+  return _impl_.code_.Get();
 }
-inline ::std::string* Document_Name_Language::release_code() {
+inline void Document_Name_Language::_internal_set_code(const std::string& value) {
+  _impl_._has_bits_[0] |= 0x00000001u;
+  _impl_.code_.Set(value, GetArenaForAllocation());
+}
+inline std::string* Document_Name_Language::_internal_mutable_code() {
+  _impl_._has_bits_[0] |= 0x00000001u;
+  return _impl_.code_.Mutable(GetArenaForAllocation());
+}
+inline std::string* Document_Name_Language::release_code() {
   // @@protoc_insertion_point(field_release:Document.Name.Language.Code)
-  if (!has_code()) {
-    return NULL;
+  if (!_internal_has_code()) {
+    return nullptr;
+  }
+  _impl_._has_bits_[0] &= ~0x00000001u;
+  auto* p = _impl_.code_.Release();
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (_impl_.code_.IsDefault()) {
+    _impl_.code_.Set("", GetArenaForAllocation());
   }
-  clear_has_code();
-  return code_.ReleaseNonDefaultNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  return p;
 }
-inline void Document_Name_Language::set_allocated_code(::std::string* code) {
-  if (code != NULL) {
-    set_has_code();
+inline void Document_Name_Language::set_allocated_code(std::string* code) {
+  if (code != nullptr) {
+    _impl_._has_bits_[0] |= 0x00000001u;
   } else {
-    clear_has_code();
+    _impl_._has_bits_[0] &= ~0x00000001u;
   }
-  code_.SetAllocatedNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), code);
+  _impl_.code_.SetAllocated(code, GetArenaForAllocation());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (_impl_.code_.IsDefault()) {
+    _impl_.code_.Set("", GetArenaForAllocation());
+  }
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
   // @@protoc_insertion_point(field_set_allocated:Document.Name.Language.Code)
 }
 
 // optional string Country = 8;
-inline bool Document_Name_Language::has_country() const {
-  return (_has_bits_[0] & 0x00000002u) != 0;
+inline bool Document_Name_Language::_internal_has_country() const {
+  bool value = (_impl_._has_bits_[0] & 0x00000002u) != 0;
+  return value;
 }
-inline void Document_Name_Language::set_has_country() {
-  _has_bits_[0] |= 0x00000002u;
-}
-inline void Document_Name_Language::clear_has_country() {
-  _has_bits_[0] &= ~0x00000002u;
+inline bool Document_Name_Language::has_country() const {
+  return _internal_has_country();
 }
 inline void Document_Name_Language::clear_country() {
-  country_.ClearToEmptyNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
-  clear_has_country();
+  _impl_.country_.ClearToEmpty();
+  _impl_._has_bits_[0] &= ~0x00000002u;
 }
-inline const ::std::string& Document_Name_Language::country() const {
+inline const std::string& Document_Name_Language::country() const {
   // @@protoc_insertion_point(field_get:Document.Name.Language.Country)
-  return country_.GetNoArena();
+  return _internal_country();
 }
-inline void Document_Name_Language::set_country(const ::std::string& value) {
-  set_has_country();
-  country_.SetNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), value);
+template <typename ArgT0, typename... ArgT>
+inline PROTOBUF_ALWAYS_INLINE
+void Document_Name_Language::set_country(ArgT0&& arg0, ArgT... args) {
+ _impl_._has_bits_[0] |= 0x00000002u;
+ _impl_.country_.Set(static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
   // @@protoc_insertion_point(field_set:Document.Name.Language.Country)
 }
-#if LANG_CXX11
-inline void Document_Name_Language::set_country(::std::string&& value) {
-  set_has_country();
-  country_.SetNoArena(
-    &::google::protobuf::internal::GetEmptyStringAlreadyInited(), ::std::move(value));
-  // @@protoc_insertion_point(field_set_rvalue:Document.Name.Language.Country)
-}
-#endif
-inline void Document_Name_Language::set_country(const char* value) {
-  GOOGLE_DCHECK(value != NULL);
-  set_has_country();
-  country_.SetNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), ::std::string(value));
-  // @@protoc_insertion_point(field_set_char:Document.Name.Language.Country)
-}
-inline void Document_Name_Language::set_country(const char* value, size_t size) {
-  set_has_country();
-  country_.SetNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited(),
-      ::std::string(reinterpret_cast<const char*>(value), size));
-  // @@protoc_insertion_point(field_set_pointer:Document.Name.Language.Country)
-}
-inline ::std::string* Document_Name_Language::mutable_country() {
-  set_has_country();
+inline std::string* Document_Name_Language::mutable_country() {
+  std::string* _s = _internal_mutable_country();
   // @@protoc_insertion_point(field_mutable:Document.Name.Language.Country)
-  return country_.MutableNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
+  return _s;
+}
+inline const std::string& Document_Name_Language::_internal_country() const {
+  return _impl_.country_.Get();
 }
-inline ::std::string* Document_Name_Language::release_country() {
+inline void Document_Name_Language::_internal_set_country(const std::string& value) {
+  _impl_._has_bits_[0] |= 0x00000002u;
+  _impl_.country_.Set(value, GetArenaForAllocation());
+}
+inline std::string* Document_Name_Language::_internal_mutable_country() {
+  _impl_._has_bits_[0] |= 0x00000002u;
+  return _impl_.country_.Mutable(GetArenaForAllocation());
+}
+inline std::string* Document_Name_Language::release_country() {
   // @@protoc_insertion_point(field_release:Document.Name.Language.Country)
-  if (!has_country()) {
-    return NULL;
+  if (!_internal_has_country()) {
+    return nullptr;
   }
-  clear_has_country();
-  return country_.ReleaseNonDefaultNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
+  _impl_._has_bits_[0] &= ~0x00000002u;
+  auto* p = _impl_.country_.Release();
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (_impl_.country_.IsDefault()) {
+    _impl_.country_.Set("", GetArenaForAllocation());
+  }
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  return p;
 }
-inline void Document_Name_Language::set_allocated_country(::std::string* country) {
-  if (country != NULL) {
-    set_has_country();
+inline void Document_Name_Language::set_allocated_country(std::string* country) {
+  if (country != nullptr) {
+    _impl_._has_bits_[0] |= 0x00000002u;
   } else {
-    clear_has_country();
+    _impl_._has_bits_[0] &= ~0x00000002u;
+  }
+  _impl_.country_.SetAllocated(country, GetArenaForAllocation());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (_impl_.country_.IsDefault()) {
+    _impl_.country_.Set("", GetArenaForAllocation());
   }
-  country_.SetAllocatedNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), country);
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
   // @@protoc_insertion_point(field_set_allocated:Document.Name.Language.Country)
 }
 
@@ -830,98 +1080,110 @@ inline void Document_Name_Language::set_allocated_country(::std::string* country
 // Document_Name
 
 // repeated group Language = 6 { ... };
+inline int Document_Name::_internal_language_size() const {
+  return _impl_.language_.size();
+}
 inline int Document_Name::language_size() const {
-  return language_.size();
+  return _internal_language_size();
 }
 inline void Document_Name::clear_language() {
-  language_.Clear();
+  _impl_.language_.Clear();
 }
 inline ::Document_Name_Language* Document_Name::mutable_language(int index) {
   // @@protoc_insertion_point(field_mutable:Document.Name.language)
-  return language_.Mutable(index);
+  return _impl_.language_.Mutable(index);
 }
-inline ::google::protobuf::RepeatedPtrField< ::Document_Name_Language >*
+inline ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::Document_Name_Language >*
 Document_Name::mutable_language() {
   // @@protoc_insertion_point(field_mutable_list:Document.Name.language)
-  return &language_;
+  return &_impl_.language_;
+}
+inline const ::Document_Name_Language& Document_Name::_internal_language(int index) const {
+  return _impl_.language_.Get(index);
 }
 inline const ::Document_Name_Language& Document_Name::language(int index) const {
   // @@protoc_insertion_point(field_get:Document.Name.language)
-  return language_.Get(index);
+  return _internal_language(index);
+}
+inline ::Document_Name_Language* Document_Name::_internal_add_language() {
+  return _impl_.language_.Add();
 }
 inline ::Document_Name_Language* Document_Name::add_language() {
+  ::Document_Name_Language* _add = _internal_add_language();
   // @@protoc_insertion_point(field_add:Document.Name.language)
-  return language_.Add();
+  return _add;
 }
-inline const ::google::protobuf::RepeatedPtrField< ::Document_Name_Language >&
+inline const ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::Document_Name_Language >&
 Document_Name::language() const {
   // @@protoc_insertion_point(field_list:Document.Name.language)
-  return language_;
+  return _impl_.language_;
 }
 
 // optional string Url = 9;
-inline bool Document_Name::has_url() const {
-  return (_has_bits_[0] & 0x00000001u) != 0;
-}
-inline void Document_Name::set_has_url() {
-  _has_bits_[0] |= 0x00000001u;
+inline bool Document_Name::_internal_has_url() const {
+  bool value = (_impl_._has_bits_[0] & 0x00000001u) != 0;
+  return value;
 }
-inline void Document_Name::clear_has_url() {
-  _has_bits_[0] &= ~0x00000001u;
+inline bool Document_Name::has_url() const {
+  return _internal_has_url();
 }
 inline void Document_Name::clear_url() {
-  url_.ClearToEmptyNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
-  clear_has_url();
+  _impl_.url_.ClearToEmpty();
+  _impl_._has_bits_[0] &= ~0x00000001u;
 }
-inline const ::std::string& Document_Name::url() const {
+inline const std::string& Document_Name::url() const {
   // @@protoc_insertion_point(field_get:Document.Name.Url)
-  return url_.GetNoArena();
+  return _internal_url();
 }
-inline void Document_Name::set_url(const ::std::string& value) {
-  set_has_url();
-  url_.SetNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), value);
+template <typename ArgT0, typename... ArgT>
+inline PROTOBUF_ALWAYS_INLINE
+void Document_Name::set_url(ArgT0&& arg0, ArgT... args) {
+ _impl_._has_bits_[0] |= 0x00000001u;
+ _impl_.url_.Set(static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
   // @@protoc_insertion_point(field_set:Document.Name.Url)
 }
-#if LANG_CXX11
-inline void Document_Name::set_url(::std::string&& value) {
-  set_has_url();
-  url_.SetNoArena(
-    &::google::protobuf::internal::GetEmptyStringAlreadyInited(), ::std::move(value));
-  // @@protoc_insertion_point(field_set_rvalue:Document.Name.Url)
-}
-#endif
-inline void Document_Name::set_url(const char* value) {
-  GOOGLE_DCHECK(value != NULL);
-  set_has_url();
-  url_.SetNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), ::std::string(value));
-  // @@protoc_insertion_point(field_set_char:Document.Name.Url)
-}
-inline void Document_Name::set_url(const char* value, size_t size) {
-  set_has_url();
-  url_.SetNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited(),
-      ::std::string(reinterpret_cast<const char*>(value), size));
-  // @@protoc_insertion_point(field_set_pointer:Document.Name.Url)
-}
-inline ::std::string* Document_Name::mutable_url() {
-  set_has_url();
+inline std::string* Document_Name::mutable_url() {
+  std::string* _s = _internal_mutable_url();
   // @@protoc_insertion_point(field_mutable:Document.Name.Url)
-  return url_.MutableNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
+  return _s;
+}
+inline const std::string& Document_Name::_internal_url() const {
+  return _impl_.url_.Get();
 }
-inline ::std::string* Document_Name::release_url() {
+inline void Document_Name::_internal_set_url(const std::string& value) {
+  _impl_._has_bits_[0] |= 0x00000001u;
+  _impl_.url_.Set(value, GetArenaForAllocation());
+}
+inline std::string* Document_Name::_internal_mutable_url() {
+  _impl_._has_bits_[0] |= 0x00000001u;
+  return _impl_.url_.Mutable(GetArenaForAllocation());
+}
+inline std::string* Document_Name::release_url() {
   // @@protoc_insertion_point(field_release:Document.Name.Url)
-  if (!has_url()) {
-    return NULL;
+  if (!_internal_has_url()) {
+    return nullptr;
   }
-  clear_has_url();
-  return url_.ReleaseNonDefaultNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
+  _impl_._has_bits_[0] &= ~0x00000001u;
+  auto* p = _impl_.url_.Release();
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (_impl_.url_.IsDefault()) {
+    _impl_.url_.Set("", GetArenaForAllocation());
+  }
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  return p;
 }
-inline void Document_Name::set_allocated_url(::std::string* url) {
-  if (url != NULL) {
-    set_has_url();
+inline void Document_Name::set_allocated_url(std::string* url) {
+  if (url != nullptr) {
+    _impl_._has_bits_[0] |= 0x00000001u;
   } else {
-    clear_has_url();
+    _impl_._has_bits_[0] &= ~0x00000001u;
+  }
+  _impl_.url_.SetAllocated(url, GetArenaForAllocation());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (_impl_.url_.IsDefault()) {
+    _impl_.url_.Set("", GetArenaForAllocation());
   }
-  url_.SetAllocatedNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), url);
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
   // @@protoc_insertion_point(field_set_allocated:Document.Name.Url)
 }
 
@@ -930,115 +1192,161 @@ inline void Document_Name::set_allocated_url(::std::string* url) {
 // Document
 
 // required int64 DocId = 1;
-inline bool Document::has_docid() const {
-  return (_has_bits_[0] & 0x00000002u) != 0;
-}
-inline void Document::set_has_docid() {
-  _has_bits_[0] |= 0x00000002u;
+inline bool Document::_internal_has_docid() const {
+  bool value = (_impl_._has_bits_[0] & 0x00000002u) != 0;
+  return value;
 }
-inline void Document::clear_has_docid() {
-  _has_bits_[0] &= ~0x00000002u;
+inline bool Document::has_docid() const {
+  return _internal_has_docid();
 }
 inline void Document::clear_docid() {
-  docid_ = GOOGLE_LONGLONG(0);
-  clear_has_docid();
+  _impl_.docid_ = int64_t{0};
+  _impl_._has_bits_[0] &= ~0x00000002u;
 }
-inline ::google::protobuf::int64 Document::docid() const {
+inline int64_t Document::_internal_docid() const {
+  return _impl_.docid_;
+}
+inline int64_t Document::docid() const {
   // @@protoc_insertion_point(field_get:Document.DocId)
-  return docid_;
+  return _internal_docid();
+}
+inline void Document::_internal_set_docid(int64_t value) {
+  _impl_._has_bits_[0] |= 0x00000002u;
+  _impl_.docid_ = value;
 }
-inline void Document::set_docid(::google::protobuf::int64 value) {
-  set_has_docid();
-  docid_ = value;
+inline void Document::set_docid(int64_t value) {
+  _internal_set_docid(value);
   // @@protoc_insertion_point(field_set:Document.DocId)
 }
 
 // optional group Links = 2 { ... };
-inline bool Document::has_links() const {
-  return (_has_bits_[0] & 0x00000001u) != 0;
+inline bool Document::_internal_has_links() const {
+  bool value = (_impl_._has_bits_[0] & 0x00000001u) != 0;
+  PROTOBUF_ASSUME(!value || _impl_.links_ != nullptr);
+  return value;
 }
-inline void Document::set_has_links() {
-  _has_bits_[0] |= 0x00000001u;
-}
-inline void Document::clear_has_links() {
-  _has_bits_[0] &= ~0x00000001u;
+inline bool Document::has_links() const {
+  return _internal_has_links();
 }
 inline void Document::clear_links() {
-  if (links_ != NULL) links_->Clear();
-  clear_has_links();
+  if (_impl_.links_ != nullptr) _impl_.links_->Clear();
+  _impl_._has_bits_[0] &= ~0x00000001u;
 }
 inline const ::Document_Links& Document::_internal_links() const {
-  return *links_;
+  const ::Document_Links* p = _impl_.links_;
+  return p != nullptr ? *p : reinterpret_cast<const ::Document_Links&>(
+      ::_Document_Links_default_instance_);
 }
 inline const ::Document_Links& Document::links() const {
-  const ::Document_Links* p = links_;
   // @@protoc_insertion_point(field_get:Document.links)
-  return p != NULL ? *p : *reinterpret_cast<const ::Document_Links*>(
-      &::_Document_Links_default_instance_);
+  return _internal_links();
+}
+inline void Document::unsafe_arena_set_allocated_links(
+    ::Document_Links* links) {
+  if (GetArenaForAllocation() == nullptr) {
+    delete reinterpret_cast<::PROTOBUF_NAMESPACE_ID::MessageLite*>(_impl_.links_);
+  }
+  _impl_.links_ = links;
+  if (links) {
+    _impl_._has_bits_[0] |= 0x00000001u;
+  } else {
+    _impl_._has_bits_[0] &= ~0x00000001u;
+  }
+  // @@protoc_insertion_point(field_unsafe_arena_set_allocated:Document.links)
 }
 inline ::Document_Links* Document::release_links() {
+  _impl_._has_bits_[0] &= ~0x00000001u;
+  ::Document_Links* temp = _impl_.links_;
+  _impl_.links_ = nullptr;
+#ifdef PROTOBUF_FORCE_COPY_IN_RELEASE
+  auto* old =  reinterpret_cast<::PROTOBUF_NAMESPACE_ID::MessageLite*>(temp);
+  temp = ::PROTOBUF_NAMESPACE_ID::internal::DuplicateIfNonNull(temp);
+  if (GetArenaForAllocation() == nullptr) { delete old; }
+#else  // PROTOBUF_FORCE_COPY_IN_RELEASE
+  if (GetArenaForAllocation() != nullptr) {
+    temp = ::PROTOBUF_NAMESPACE_ID::internal::DuplicateIfNonNull(temp);
+  }
+#endif  // !PROTOBUF_FORCE_COPY_IN_RELEASE
+  return temp;
+}
+inline ::Document_Links* Document::unsafe_arena_release_links() {
   // @@protoc_insertion_point(field_release:Document.links)
-  clear_has_links();
-  ::Document_Links* temp = links_;
-  links_ = NULL;
+  _impl_._has_bits_[0] &= ~0x00000001u;
+  ::Document_Links* temp = _impl_.links_;
+  _impl_.links_ = nullptr;
   return temp;
 }
-inline ::Document_Links* Document::mutable_links() {
-  set_has_links();
-  if (links_ == NULL) {
-    auto* p = CreateMaybeMessage<::Document_Links>(GetArenaNoVirtual());
-    links_ = p;
+inline ::Document_Links* Document::_internal_mutable_links() {
+  _impl_._has_bits_[0] |= 0x00000001u;
+  if (_impl_.links_ == nullptr) {
+    auto* p = CreateMaybeMessage<::Document_Links>(GetArenaForAllocation());
+    _impl_.links_ = p;
   }
+  return _impl_.links_;
+}
+inline ::Document_Links* Document::mutable_links() {
+  ::Document_Links* _msg = _internal_mutable_links();
   // @@protoc_insertion_point(field_mutable:Document.links)
-  return links_;
+  return _msg;
 }
 inline void Document::set_allocated_links(::Document_Links* links) {
-  ::google::protobuf::Arena* message_arena = GetArenaNoVirtual();
-  if (message_arena == NULL) {
-    delete links_;
+  ::PROTOBUF_NAMESPACE_ID::Arena* message_arena = GetArenaForAllocation();
+  if (message_arena == nullptr) {
+    delete _impl_.links_;
   }
   if (links) {
-    ::google::protobuf::Arena* submessage_arena = NULL;
+    ::PROTOBUF_NAMESPACE_ID::Arena* submessage_arena =
+        ::PROTOBUF_NAMESPACE_ID::Arena::InternalGetOwningArena(links);
     if (message_arena != submessage_arena) {
-      links = ::google::protobuf::internal::GetOwnedMessage(
+      links = ::PROTOBUF_NAMESPACE_ID::internal::GetOwnedMessage(
           message_arena, links, submessage_arena);
     }
-    set_has_links();
+    _impl_._has_bits_[0] |= 0x00000001u;
   } else {
-    clear_has_links();
+    _impl_._has_bits_[0] &= ~0x00000001u;
   }
-  links_ = links;
+  _impl_.links_ = links;
   // @@protoc_insertion_point(field_set_allocated:Document.links)
 }
 
 // repeated group Name = 5 { ... };
+inline int Document::_internal_name_size() const {
+  return _impl_.name_.size();
+}
 inline int Document::name_size() const {
-  return name_.size();
+  return _internal_name_size();
 }
 inline void Document::clear_name() {
-  name_.Clear();
+  _impl_.name_.Clear();
 }
 inline ::Document_Name* Document::mutable_name(int index) {
   // @@protoc_insertion_point(field_mutable:Document.name)
-  return name_.Mutable(index);
+  return _impl_.name_.Mutable(index);
 }
-inline ::google::protobuf::RepeatedPtrField< ::Document_Name >*
+inline ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::Document_Name >*
 Document::mutable_name() {
   // @@protoc_insertion_point(field_mutable_list:Document.name)
-  return &name_;
+  return &_impl_.name_;
+}
+inline const ::Document_Name& Document::_internal_name(int index) const {
+  return _impl_.name_.Get(index);
 }
 inline const ::Document_Name& Document::name(int index) const {
   // @@protoc_insertion_point(field_get:Document.name)
-  return name_.Get(index);
+  return _internal_name(index);
+}
+inline ::Document_Name* Document::_internal_add_name() {
+  return _impl_.name_.Add();
 }
 inline ::Document_Name* Document::add_name() {
+  ::Document_Name* _add = _internal_add_name();
   // @@protoc_insertion_point(field_add:Document.name)
-  return name_.Add();
+  return _add;
 }
-inline const ::google::protobuf::RepeatedPtrField< ::Document_Name >&
+inline const ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::Document_Name >&
 Document::name() const {
   // @@protoc_insertion_point(field_list:Document.name)
-  return name_;
+  return _impl_.name_;
 }
 
 #ifdef __GNUC__
@@ -1056,4 +1364,5 @@ Document::name() const {
 
 // @@protoc_insertion_point(global_scope)
 
-#endif  // PROTOBUF_INCLUDED_schema_2eproto
+#include <google/protobuf/port_undef.inc>
+#endif  // GOOGLE_PROTOBUF_INCLUDED_GOOGLE_PROTOBUF_INCLUDED_schema_2eproto
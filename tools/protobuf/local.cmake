@@ -14,5 +14,6 @@ file(GLOB_RECURSE SRC_CC "tools/protobuf/gen/*.cc")
 # ---------------------------------------------------------------------------
 
 add_library(proto_schema STATIC ${SRC_CC})
+add_dependencies(proto_schema rapidjson)
 target_compile_options(proto_schema PUBLIC "-fPIC")
-target_link_libraries(proto_schema ${PROTOBUF_LIBRARY} gflags Threads::Threads)
+target_link_libraries(proto_schema ${PROTOBUF_LIBRARY} tbb gflags Threads::Threads)
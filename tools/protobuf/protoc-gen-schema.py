@@ -96,6 +96,435 @@ def flatten_fields(message, includeInner=False):
     return _flatten_fields([], message)
 
 
+def generate_shredder(message, syntax):
+    """
+    Generates the body of a function that shreds a record of the given message type into the columns.
+    Instead of walking the record through Protobuf's reflection, the generated code uses the accessors of the message
+    classes and writes into the columns directly. Repetition and definition levels are known for every field when
+    generating the code, only the repetition level of the first value in a repeated field depends on its parent.
+    Produces the same rows as Shredder::DissectRecord.
+    """
+    def has_presence(field):
+        # Proto3 scalars do not track their presence; reflection treats a default value as missing.
+        return syntax != 'proto3' or field.type in (FieldDescriptorProto.TYPE_MESSAGE, FieldDescriptorProto.TYPE_GROUP) \
+            or field.proto3_optional
+
+    def is_set(variable, field):
+        accessor = field.name.lower()
+        if has_presence(field):
+            return variable + '.has_' + accessor + '()'
+        if field.type == FieldDescriptorProto.TYPE_STRING:
+            return '!' + variable + '.' + accessor + '().empty()'
+        return variable + '.' + accessor + '() != 0'
+
+    def leaf_columns(path, descriptorproto):
+        for fields in flatten_fields(descriptorproto):
+            yield '_'.join([f.name for f in path + fields]) + '_Column'
+
+    def write_nulls(path, descriptorproto, repetition_level, definition_level, indent):
+        for column in leaf_columns(path, descriptorproto):
+            yield indent + column + '.insert_null(' + repetition_level + ', ' + str(definition_level) + ');\n'
+
+    def shred_message(path, descriptorproto, variable, repetition_level, definition_level, indent):
+        for field in descriptorproto.field:
+            accessor = variable + '.' + field.name.lower()
+            is_nested = field.type in (FieldDescriptorProto.TYPE_MESSAGE, FieldDescriptorProto.TYPE_GROUP)
+            nested = next(x for x in descriptorproto.nested_type if x.name.lower() == field.name.lower()) \
+                if is_nested else None
+            if is_nested:
+                # Use the original name from the schema file, like flatten_fields().
+                field.name = nested.name
+            field_path = path + [field]
+            name = '_'.join([f.name for f in field_path])
+            field_definition_level = definition_level + (field.label != FieldDescriptorProto.LABEL_REQUIRED)
+            field_repetition_level = repetition_level_of(field_path)
+
+            if field.label == FieldDescriptorProto.LABEL_REPEATED:
+                index = name.lower() + '_index'
+                # An empty repetition is written as a single NULL.
+                yield indent + 'if (' + accessor + '_size() == 0) {\n'
+                if is_nested:
+                    for line in write_nulls(field_path, nested, repetition_level, field_definition_level - 1, indent + '    '):
+                        yield line
+                else:
+                    yield indent + '    ' + name + '_Column.insert_null(' + repetition_level + ', ' + str(field_definition_level - 1) + ');\n'
+                yield indent + '}\n'
+                yield indent + 'for (int ' + index + ' = 0; ' + index + ' < ' + accessor + '_size(); ' + index + '++) {\n'
+                child_repetition_level = index + ' == 0 ? ' + repetition_level + ' : ' + str(field_repetition_level)
+                if is_nested:
+                    yield indent + '    const auto& ' + name.lower() + ' = ' + accessor + '(' + index + ');\n'
+                    yield indent + '    const unsigned ' + name.lower() + '_r = ' + child_repetition_level + ';\n'
+                    for line in shred_message(field_path, nested, name.lower(), name.lower() + '_r', field_definition_level, indent + '    '):
+                        yield line
+                else:
+                    yield indent + '    ' + name + '_Column.insert_value(' + accessor + '(' + index + '), ' + child_repetition_level + ');\n'
+                yield indent + '}\n'
+            elif field.label == FieldDescriptorProto.LABEL_REQUIRED:
+                if is_nested:
+                    yield indent + '{\n'
+                    yield indent + '    const auto& ' + name.lower() + ' = ' + accessor + '();\n'
+                    for line in shred_message(field_path, nested, name.lower(), repetition_level, field_definition_level, indent + '    '):
+                        yield line
+                    yield indent + '}\n'
+                else:
+                    yield indent + name + '_Column.insert_value(' + accessor + '(), ' + repetition_level + ');\n'
+            else:
+                yield indent + 'if (' + is_set(variable, field) + ') {\n'
+                if is_nested:
+                    yield indent + '    const auto& ' + name.lower() + ' = ' + accessor + '();\n'
+                    for line in shred_message(field_path, nested, name.lower(), repetition_level, field_definition_level, indent + '    '):
+                        yield line
+                else:
+                    yield indent + '    ' + name + '_Column.insert_value(' + accessor + '(), ' + repetition_level + ');\n'
+                yield indent + '} else {\n'
+                if is_nested:
+                    for line in write_nulls(field_path, nested, repetition_level, field_definition_level - 1, indent + '    '):
+                        yield line
+                else:
+                    yield indent + '    ' + name + '_Column.insert_null(' + repetition_level + ', ' + str(field_definition_level - 1) + ');\n'
+                yield indent + '}\n'
+
+    def repetition_level_of(path):
+        return sum(1 for f in path if f.label == FieldDescriptorProto.LABEL_REPEATED)
+
+    return shred_message([], message, 'record', '0', 0, '    ')
+
+
+def generate_wire_shredder(message, check=False):
+    """
+    Generates the body of a function that shreds a serialized record of the given message type into the columns.
+    The fields are read from the Protobuf wire format with a WireReader and every value is written into its column as
+    soon as it is decoded, so no message objects are built. A switch over the field numbers maps every field to its
+    column or nested message; unknown fields are skipped.
+    Fields that did not occur in a message are written as NULLs when the message ends, which produces the same rows
+    as Shred() for the parsed record.
+
+    With check, the body of a function is generated that walks the record the same way without writing anything.
+    It throws if the record is malformed and returns false if a field that is not repeated occurs more than once.
+    Protobuf keeps the last value of such a field and merges nested messages, so these records are parsed and
+    shredded as messages instead. The shredder checks every record first, so a malformed record leaves all columns
+    as they were.
+    """
+    # The wire type and the WireReader call that decode a value, by field type
+    encodings = {
+        FieldDescriptorProto.TYPE_DOUBLE: ('kFixed64', 'read_fixed<double>()'),
+        FieldDescriptorProto.TYPE_FLOAT: ('kFixed32', 'read_fixed<float>()'),
+        FieldDescriptorProto.TYPE_INT64: ('kVarint', 'read_varint<int64_t>()'),
+        FieldDescriptorProto.TYPE_UINT64: ('kVarint', 'read_varint<uint64_t>()'),
+        FieldDescriptorProto.TYPE_INT32: ('kVarint', 'read_varint<int32_t>()'),
+        FieldDescriptorProto.TYPE_FIXED64: ('kFixed64', 'read_fixed<uint64_t>()'),
+        FieldDescriptorProto.TYPE_FIXED32: ('kFixed32', 'read_fixed<uint32_t>()'),
+        FieldDescriptorProto.TYPE_BOOL: ('kVarint', 'read_varint<bool>()'),
+        FieldDescriptorProto.TYPE_STRING: ('kLengthDelimited', 'read_string()'),
+        FieldDescriptorProto.TYPE_UINT32: ('kVarint', 'read_varint<uint32_t>()'),
+        FieldDescriptorProto.TYPE_SFIXED32: ('kFixed32', 'read_fixed<int32_t>()'),
+        FieldDescriptorProto.TYPE_SFIXED64: ('kFixed64', 'read_fixed<int64_t>()'),
+        FieldDescriptorProto.TYPE_SINT32: ('kVarint', 'read_zigzag<int32_t>()'),
+        FieldDescriptorProto.TYPE_SINT64: ('kVarint', 'read_zigzag<int64_t>()'),
+    }
+
+    def leaf_columns(path, descriptorproto):
+        for fields in flatten_fields(descriptorproto):
+            yield '_'.join([f.name for f in path + fields]) + '_Column'
+
+    def repetition_level_of(path):
+        return sum(1 for f in path if f.label == FieldDescriptorProto.LABEL_REPEATED)
+
+    def shred_message(path, descriptorproto, reader, repetition_level, definition_level, indent):
+        fields = []
+        for field in descriptorproto.field:
+            is_nested = field.type in (FieldDescriptorProto.TYPE_MESSAGE, FieldDescriptorProto.TYPE_GROUP)
+            nested = next(x for x in descriptorproto.nested_type if x.name.lower() == field.name.lower()) \
+                if is_nested else None
+            if is_nested:
+                # Use the original name from the schema file, like flatten_fields().
+                field.name = nested.name
+            name = '_'.join([f.name for f in path + [field]])
+            # The check needs to know whether fields that are not repeated occurred (again), the shredder whether
+            # optional and repeated fields occurred.
+            if check:
+                tracked = field.label != FieldDescriptorProto.LABEL_REPEATED
+            else:
+                tracked = field.label != FieldDescriptorProto.LABEL_REQUIRED
+            fields.append((field, nested, name, tracked))
+
+        tag = reader + '_tag'
+        for field, nested, name, tracked in fields:
+            if tracked:
+                yield indent + 'bool ' + name.lower() + '_seen = false;\n'
+        yield indent + 'for (uint32_t ' + tag + '; ' + reader + '.next_tag(&' + tag + ');) {\n'
+        yield indent + '    switch (WireReader::NumberOf(' + tag + ')) {\n'
+        for field, nested, name, tracked in fields:
+            field_path = path + [field]
+            seen = name.lower() + '_seen'
+            field_definition_level = definition_level + (field.label != FieldDescriptorProto.LABEL_REQUIRED)
+            repeated = field.label == FieldDescriptorProto.LABEL_REPEATED
+            # Every value of a repeated field but the first one in its message repeats the field.
+            value_repetition_level = seen + ' ? ' + str(repetition_level_of(field_path)) + ' : ' + repetition_level \
+                if repeated else repetition_level
+            case_indent = indent + '        '
+            yield indent + '        case ' + str(field.number) + ': {\n'
+            if check and not repeated:
+                yield case_indent + '    if (' + seen + ') {\n'
+                yield case_indent + '        return false;\n'
+                yield case_indent + '    }\n'
+            if nested is not None:
+                nested_reader = name.lower()
+                yield case_indent + '    WireReader ' + nested_reader + ' = ' + reader + '.begin_nested(' + tag + ');\n'
+                nested_repetition_level = repetition_level
+                if repeated and not check:
+                    nested_repetition_level = nested_reader + '_r'
+                    yield case_indent + '    const unsigned ' + nested_repetition_level + ' = ' + value_repetition_level + ';\n'
+                if tracked:
+                    yield case_indent + '    ' + seen + ' = true;\n'
+                for line in shred_message(field_path, nested, nested_reader, nested_repetition_level, field_definition_level, case_indent + '    '):
+                    yield line
+                yield case_indent + '    ' + reader + '.end_nested(' + nested_reader + ');\n'
+            else:
+                wire_type, read = encodings[field.type]
+                write = name + '_Column.insert_value('
+                if repeated and wire_type != 'kLengthDelimited':
+                    # Repeated scalars may also be packed into a single length-delimited value.
+                    yield case_indent + '    if (WireReader::TypeOf(' + tag + ') == WireType::kLengthDelimited) {\n'
+                    if check:
+                        yield case_indent + '        for (WireReader packed = ' + reader + '.read_packed(); !packed.done();) {\n'
+                        yield case_indent + '            packed.' + read + ';\n'
+                    else:
+                        yield case_indent + '        for (WireReader packed = ' + reader + '.read_packed(); !packed.done(); ' + seen + ' = true) {\n'
+                        yield case_indent + '            ' + write + 'packed.' + read + ', ' + value_repetition_level + ');\n'
+                    yield case_indent + '        }\n'
+                    yield case_indent + '        break;\n'
+                    yield case_indent + '    }\n'
+                yield case_indent + '    WireReader::Expect(' + tag + ', WireType::' + wire_type + ');\n'
+                if check:
+                    yield case_indent + '    ' + reader + '.' + read + ';\n'
+                else:
+                    yield case_indent + '    ' + write + reader + '.' + read + ', ' + value_repetition_level + ');\n'
+                if tracked:
+                    yield case_indent + '    ' + seen + ' = true;\n'
+            yield case_indent + '    break;\n'
+            yield case_indent + '}\n'
+        yield indent + '        default:\n'
+        yield indent + '            ' + reader + '.skip(' + tag + ');\n'
+        yield indent + '    }\n'
+        yield indent + '}\n'
+
+        # Required fields must not be missing, all others are NULL.
+        for field, nested, name, tracked in fields:
+            field_definition_level = definition_level + (field.label != FieldDescriptorProto.LABEL_REQUIRED)
+            if field.label == FieldDescriptorProto.LABEL_REQUIRED:
+                if check:
+                    yield indent + 'if (!' + name.lower() + '_seen) {\n'
+                    yield indent + '    throw FileFormatError("the required field ' + field.name + ' is missing");\n'
+                    yield indent + '}\n'
+            elif not check:
+                yield indent + 'if (!' + name.lower() + '_seen) {\n'
+                columns = leaf_columns(path + [field], nested) if nested is not None else [name + '_Column']
+                for column in columns:
+                    yield indent + '    ' + column + '.insert_null(' + repetition_level + ', ' + str(field_definition_level - 1) + ');\n'
+                yield indent + '}\n'
+
+    if not check:
+        yield '    // Nothing is written before the whole record was checked.\n'
+        yield '    if (!CheckSerialized(bytes)) {\n'
+        yield '        ' + message.name + ' parsed;\n'
+        yield '        if (!parsed.ParseFromArray(bytes.data(), static_cast<int>(bytes.size()))) {\n'
+        yield '            throw FileFormatError("invalid serialized ' + message.name + '");\n'
+        yield '        }\n'
+        yield '        Shred(parsed);\n'
+        yield '        return;\n'
+        yield '    }\n'
+    yield '    WireReader record { bytes };\n'
+    for line in shred_message([], message, 'record', '0', 0, '    '):
+        yield line
+    if check:
+        yield '    return true;\n'
+
+
+def nested_messages(message):
+    """
+    Yields the path to every group or nested message in a Protobuf message, together with its DescriptorProto.
+    """
+    def _nested_messages(path, descriptorproto):
+        for field in descriptorproto.field:
+            if field.type in (FieldDescriptorProto.TYPE_MESSAGE, FieldDescriptorProto.TYPE_GROUP):
+                nested = next(x for x in descriptorproto.nested_type if x.name.lower() == field.name.lower())
+                # Use the original name from the schema file, like flatten_fields().
+                field.name = nested.name
+                yield path + [field], nested
+                for inner in _nested_messages(path + [field], nested):
+                    yield inner
+    return _nested_messages([], message)
+
+
+def leaf_columns(path, descriptorproto):
+    """
+    Yields the names of all columns below a group or nested message.
+    """
+    for fields in flatten_fields(descriptorproto):
+        yield '_'.join([f.name for f in path + fields])
+
+
+def generate_cursor_declaration(message):
+    """
+    Generates the declaration of the cursor that assembles records of a table (see generate_cursor()).
+    """
+    yield '    /// Assembles records from the selected columns one after the other, with code that is generated for this schema.\n'
+    yield '    /// A cursor keeps a positioned reader for every selected column, so it can move on to the next range of records\n'
+    yield '    /// without setting up its readers again. A cursor is not thread-safe.\n'
+    yield '    class Cursor {\n'
+    yield '     public:\n'
+    yield '        /// Creates a cursor for the selected fields that points to a record.\n'
+    yield '        Cursor(' + message.name + 'Table& table, const std::vector<const FieldDescriptor*>& fields, uint64_t tid = 0);\n'
+    yield '        /// Moves the cursor to a record; moving to the record under the cursor costs nothing.\n'
+    yield '        void Seek(uint64_t tid) { if (tid != _tid) Position(tid); }\n'
+    yield '        /// Assembles the record under the cursor into a message, which has to be empty, and moves to the next record.\n'
+    yield '        void AssembleNext(' + message.name + '* record);\n'
+    yield '        /// The record under the cursor.\n'
+    yield '        uint64_t tid() const { return _tid; }\n'
+    yield '\n'
+    yield '     protected:\n'
+    yield '        /// Positions the readers of the selected columns at the first row of a record.\n'
+    yield '        void Position(uint64_t tid);\n'
+    nested = list(nested_messages(message))
+    if nested:
+        yield '        // The levels of a nested field are those of the first selected column below it.\n'
+    for path, _ in nested:
+        yield '        FieldValue ' + '_'.join([f.name for f in path]) + '_Peek();\n'
+    yield '\n'
+    yield '        ' + message.name + 'Table& _table;\n'
+    yield '        uint64_t _tid;\n'
+    for fields in flatten_fields(message):
+        yield '        bool ' + '_'.join([f.name for f in fields]) + '_selected = false;\n'
+    for path, _ in nested:
+        yield '        bool ' + '_'.join([f.name for f in path]) + '_selected = false;\n'
+    for fields in flatten_fields(message):
+        column_name = '_'.join([f.name for f in fields])
+        yield '        FieldReader<' + cpp_type_name(fields[-1]) + '> ' + column_name + '_Reader;\n'
+    yield '    };\n'
+
+
+def generate_cursor(message):
+    """
+    Generates the cursor that assembles records from the selected columns into given messages.
+    For a fixed schema, the finite state machine of the Dremel paper compiles into nested loops that follow the nesting
+    of the messages: Within a message, the fields are read one after the other. A repeated field is read again as long
+    as the next row repeats it, i.e. has the repetition level of the field. A nested field is present if the first
+    selected column below it is defined at its level; otherwise every selected column below it has a single NULL.
+    Values are stored with the generated setters of the message classes, so no reflection is needed either.
+    Only which columns are selected is decided at runtime, once per cursor. Produces the same records as
+    RecordAssembler.
+    """
+    def definition_level_of(path):
+        return sum(1 for f in path if f.label != FieldDescriptorProto.LABEL_REQUIRED)
+
+    def repetition_level_of(path):
+        return sum(1 for f in path if f.label == FieldDescriptorProto.LABEL_REPEATED)
+
+    def assemble_message(path, descriptorproto, variable, indent):
+        for field in descriptorproto.field:
+            is_nested = field.type in (FieldDescriptorProto.TYPE_MESSAGE, FieldDescriptorProto.TYPE_GROUP)
+            nested = next(x for x in descriptorproto.nested_type if x.name.lower() == field.name.lower()) \
+                if is_nested else None
+            if is_nested:
+                field.name = nested.name
+            field_path = path + [field]
+            name = '_'.join([f.name for f in field_path])
+            accessor = field.name.lower()
+            repeated = field.label == FieldDescriptorProto.LABEL_REPEATED
+            repetition_level = str(repetition_level_of(field_path))
+
+            yield indent + 'if (' + name + '_selected) {\n'
+            if is_nested:
+                child = name.lower()
+                inner = indent + '    '
+                if field.label != FieldDescriptorProto.LABEL_REQUIRED:
+                    yield inner + 'if (' + name + '_Peek().definition_level() >= ' + str(definition_level_of(field_path)) + ') {\n'
+                    inner += '    '
+                if repeated:
+                    yield inner + 'do {\n'
+                    yield inner + '    auto* ' + child + ' = ' + variable + '->add_' + accessor + '();\n'
+                    for line in assemble_message(field_path, nested, child, inner + '    '):
+                        yield line
+                    yield inner + '} while (' + name + '_Peek().repetition_level() == ' + repetition_level + ');\n'
+                else:
+                    yield inner + 'auto* ' + child + ' = ' + variable + '->mutable_' + accessor + '();\n'
+                    for line in assemble_message(field_path, nested, child, inner):
+                        yield line
+                if field.label != FieldDescriptorProto.LABEL_REQUIRED:
+                    yield indent + '    } else {\n'
+                    yield indent + '        // The field is missing, so every column below it has a single NULL.\n'
+                    for column in leaf_columns(field_path, nested):
+                        yield indent + '        if (' + column + '_selected) ' + column + '_Reader.ReadNext();\n'
+                    yield indent + '    }\n'
+            else:
+                value = name + '_Reader.PeekValue()'
+                if field.type == FieldDescriptorProto.TYPE_STRING:
+                    value = 'std::string(' + value + ')'
+                setter = variable + '->' + ('add_' if repeated else 'set_') + accessor + '(' + value + ');\n'
+                inner = indent + '    '
+                if repeated:
+                    yield inner + 'do {\n'
+                    inner += '    '
+                yield inner + 'if (!' + name + '_Reader.Peek().is_null()) ' + setter
+                yield inner + name + '_Reader.ReadNext();\n'
+                if repeated:
+                    yield indent + '    } while (' + name + '_Reader.Peek().repetition_level() == ' + repetition_level + ');\n'
+            yield indent + '}\n'
+
+    cursor = message.name + 'Table::Cursor'
+    nested = list(nested_messages(message))
+
+    yield cursor + '::Cursor(' + message.name + 'Table& table, const std::vector<const FieldDescriptor*>& fields, uint64_t tid)\n'
+    yield '    : _table(table), _tid(tid)'
+    for fields in flatten_fields(message):
+        column_name = '_'.join([f.name for f in fields])
+        yield ',\n      ' + column_name + '_Reader { &table.' + column_name + '_Column, 0 }'
+    yield ' {\n'
+    yield '    for (auto& field : fields) {\n'
+    for fields in flatten_fields(message):
+        column_name = '_'.join([f.name for f in fields])
+        yield '        if (field == ' + column_name + '_Descriptor) {\n'
+        yield '            ' + column_name + '_selected = true;\n'
+        yield '        } else\n'
+    yield '        {}\n'
+    yield '    }\n'
+    for path, descriptorproto in nested:
+        name = '_'.join([f.name for f in path])
+        yield '    ' + name + '_selected = ' + \
+            ' || '.join([column + '_selected' for column in leaf_columns(path, descriptorproto)]) + ';\n'
+    yield '    Position(tid);\n'
+    yield '}\n'
+    yield '\n'
+
+    yield 'void ' + cursor + '::Position(uint64_t tid) {\n'
+    yield '    assert(tid <= _table.size());\n'
+    for fields in flatten_fields(message):
+        column_name = '_'.join([f.name for f in fields])
+        yield '    if (' + column_name + '_selected) ' + column_name + '_Reader.Seek(_table.' + column_name + '_Column.record_start(tid));\n'
+    yield '    _tid = tid;\n'
+    yield '}\n'
+    yield '\n'
+
+    for path, descriptorproto in nested:
+        name = '_'.join([f.name for f in path])
+        columns = list(leaf_columns(path, descriptorproto))
+        peek = columns[-1] + '_Reader.Peek()'
+        for column in reversed(columns[:-1]):
+            peek = column + '_selected ? ' + column + '_Reader.Peek() : ' + peek
+        yield 'FieldValue ' + cursor + '::' + name + '_Peek() {\n'
+        yield '    return ' + peek + ';\n'
+        yield '}\n'
+        yield '\n'
+
+    yield 'void ' + cursor + '::AssembleNext(' + message.name + '* record) {\n'
+    yield '    assert(_tid < _table.size());\n'
+    for line in assemble_message([], message, 'record', '    '):
+        yield line
+    yield '    _tid++;\n'
+    yield '}\n'
+
+
 def generate_header(filedescriptorproto):
     yield '// ---------------------------------------------------------------------------\n'
     yield '// This file is auto-generated.\n'
@@ -104,13 +533,23 @@ def generate_header(filedescriptorproto):
     yield '#ifndef INCLUDE_IMLAB_SCHEMA_H_\n'
     yield '#define INCLUDE_IMLAB_SCHEMA_H_\n'
     yield '// ---------------------------------------------------------------------------\n'
+    yield '#include <istream>\n'
     yield '#include <optional>\n'
+    yield '#include <stdexcept>\n'
+    yield '#include <string>\n'
+    yield '#include <string_view>\n'
+    yield '#include <type_traits>\n'
     yield '#include <vector>\n'
     yield '#include "./schema.pb.h"\n'
+    yield '#include "../../../include/imlab/dremel/bulk_loading.h"\n'
     yield '#include "../../../include/imlab/dremel/storage.h"\n'
+    yield '#include "../../../include/imlab/dremel/field_reader.h"\n'
     yield '#include "../../../include/imlab/dremel/field_writer.h"\n'
+    yield '#include "../../../include/imlab/dremel/record_batch.h"\n'
     yield '#include "../../../include/imlab/infra/types.h"\n'
     yield '#include <google/protobuf/descriptor.h>\n'
+    yield '#include <tbb/enumerable_thread_specific.h>\n'
+    yield '#include <tbb/parallel_for.h>\n'
     yield '// ---------------------------------------------------------------------------\n'
     yield 'namespace imlab {\n'
     yield 'namespace schema {\n'
@@ -123,23 +562,117 @@ def generate_header(filedescriptorproto):
         yield ' public:\n'
         yield '    /// Insert a new record into the table.\n'
         yield '    uint64_t insert(' + message.name + '& record);\n'
+        yield '    /// Insert a new record into the table with the generic shredder that walks the record via reflection.\n'
+        yield '    uint64_t insert_reflection(' + message.name + '& record);\n'
+        yield '    /// Insert a serialized record into the table; it is shredded straight from the Protobuf wire format.\n'
+        yield '    uint64_t insert_serialized(std::string_view bytes);\n'
         yield '    /// Gets one record from the table.\n'
         yield '    ' + message.name + ' get(uint64_t tid, const std::vector<const FieldDescriptor*>& fields) { return get_range(tid, tid + 1, fields)[0]; }\n'
+        yield '    /// Gets one record from the table into an existing message, which is cleared first.\n'
+        yield '    /// The nested messages that the message has allocated already are reused.\n'
+        yield '    void get(uint64_t tid, const std::vector<const FieldDescriptor*>& fields, ' + message.name + '* record) { record->Clear(); AssembleRange(tid, tid + 1, fields, &record); }\n'
         yield '    /// Gets a range of record from the table. `to_tid` is exclusive.\n'
+        yield '    /// The records are assembled by code that is generated for this schema, without a RecordFSM or reflection.\n'
         yield '    std::vector<' + message.name + '> get_range(uint64_t from_tid, uint64_t to_tid, const std::vector<const FieldDescriptor*>& fields);\n'
+        yield '    /// Gets a range of records that are allocated on an arena, which is freed together with the batch.\n'
+        yield '    RecordBatch<' + message.name + '> get_batch(uint64_t from_tid, uint64_t to_tid, const std::vector<const FieldDescriptor*>& fields);\n'
+        yield '    /// Gets a range of records with the generic assembler that is driven by a RecordFSM and builds the records via reflection.\n'
+        yield '    std::vector<' + message.name + '> get_range_reflection(uint64_t from_tid, uint64_t to_tid, const std::vector<const FieldDescriptor*>& fields);\n'
         yield '    /// Get the corresponding FieldWriter-tree for this table.\n'
         yield '    FieldWriter* record_writer() override { return &Root_Writer; }\n'
         yield '    /// Get a reference to the fields in this table.\n'
         yield '    static std::vector<const FieldDescriptor*> fields();\n'
+        yield '    /// Split the records into morsels that are aligned to segments.\n'
+        yield '    std::vector<RecordRange> morsels() override;\n'
+        yield '    /// Get the records that might satisfy a predicate according to the zone maps.\n'
+        yield '    std::vector<RecordRange> candidate_records(const RangePredicate& predicate) override;\n'
+        yield '    using TableBase::morsels;\n'
+        yield '    /// Write all records to a file.\n'
+        yield '    void save(const std::string& path, const std::string& source = "") override;\n'
+        yield '    /// Replace all records with those in a file written by save(); the table is left empty if that fails.\n'
+        yield '    void open(const std::string& path, const std::string& source = "") override;\n'
+        yield '    /// Remove all records.\n'
+        yield '    void clear();\n'
+        yield '    /// Write all records to a Parquet file.\n'
+        yield '    void export_parquet(const std::string& path);\n'
+        yield '    /// Append the records of a Parquet file.\n'
+        yield '    void import_parquet(const std::string& path);\n'
+        yield '    /// Append the records of a JSON array; they are shredded while the JSON is parsed.\n'
+        yield '    void load_json(std::istream& in);\n'
+        yield '    /// Append the records of newline-delimited JSON; chunks of the input are shredded in parallel.\n'
+        yield '    void load_json_lines(std::istream& in, size_t chunk_size = kDefaultBulkLoadChunkSize);\n'
+        yield '    /// Append the records of a stream of length-delimited serialized records; chunks of it are shredded in parallel.\n'
+        yield '    void load_protobuf(std::string_view stream, size_t chunk_size = kDefaultBulkLoadChunkSize);\n'
+        yield '    /// Append the records of a file of length-delimited serialized records; the file is memory-mapped.\n'
+        yield '    void load_protobuf_file(const std::string& path, size_t chunk_size = kDefaultBulkLoadChunkSize);\n'
+        yield '    /// Append all records of another table, which is left empty; its segments are moved column by column in parallel.\n'
+        yield '    void append(' + message.name + 'Table& other);\n'
+        yield '    /// Call a function with every column of the table, in the order of fields().\n'
+        yield '    template<typename Function>\n'
+        yield '    void for_each_column(Function&& function) {\n'
+        for fields in flatten_fields(message):
+            column_name = '_'.join([f.name for f in fields])
+            yield '        function(' + column_name + '_Column);\n'
+        yield '    }\n'
+        yield '    /// Get the column of a field, e.g. to scan it directly. T has to be the type of its values.\n'
+        yield '    template<typename T>\n'
+        yield '    DremelColumn<T>& column(const FieldDescriptor* field) {\n'
+        yield '        DremelColumn<T>* result = nullptr;\n'
+        yield '        for_each_column([&](auto& column) {\n'
+        yield '            if constexpr (std::is_same_v<std::decay_t<decltype(column)>, DremelColumn<T>>) {\n'
+        yield '                if (column.field() == field) result = &column;\n'
+        yield '            }\n'
+        yield '        });\n'
+        yield '        if (result == nullptr) {\n'
+        yield '            throw std::invalid_argument("no column of this type for the field " + field->full_name());\n'
+        yield '        }\n'
+        yield '        return *result;\n'
+        yield '    }\n'
+        yield '\n'
+        for line in generate_cursor_declaration(message):
+            yield line
+        yield '\n'
+        yield '    /// Assembles all records with the selected fields and calls callback(uint64_t tid, const ' + message.name + '& record)\n'
+        yield '    /// for every one of them. The morsels (see morsels()) are scanned in parallel: Every worker keeps one Cursor\n'
+        yield '    /// and one message for the whole scan and assembles the records of a morsel sequentially into the message.\n'
+        yield '    /// The callback is called concurrently; the record is only valid until it returns.\n'
+        yield '    template<typename Callback>\n'
+        yield '    void scan_morsels(const std::vector<const FieldDescriptor*>& fields, Callback&& callback) {\n'
+        yield '        struct Worker {\n'
+        yield '            Cursor cursor;\n'
+        yield '            ' + message.name + ' record;\n'
+        yield '        };\n'
+        yield '        tbb::enumerable_thread_specific<Worker> workers([&] { return Worker { Cursor(*this, fields), {} }; });\n'
+        yield '        const auto ranges = morsels();\n'
+        yield '        tbb::parallel_for(tbb::blocked_range<size_t>(0, ranges.size(), 1), [&](const tbb::blocked_range<size_t>& morsel_range) {\n'
+        yield '            auto& worker = workers.local();\n'
+        yield '            for (size_t m = morsel_range.begin(); m != morsel_range.end(); ++m) {\n'
+        yield '                worker.cursor.Seek(ranges[m].begin);\n'
+        yield '                for (uint64_t tid = ranges[m].begin; tid != ranges[m].end; ++tid) {\n'
+        yield '                    worker.record.Clear();\n'
+        yield '                    worker.cursor.AssembleNext(&worker.record);\n'
+        yield '                    callback(tid, static_cast<const ' + message.name + '&>(worker.record));\n'
+        yield '                }\n'
+        yield '            }\n'
+        yield '        });\n'
+        yield '    }\n'
         yield '\n'
         yield ' protected:\n'
+        yield '    /// Shred a record into the columns; generated for this schema, so it needs no reflection.\n'
+        yield '    void Shred(const ' + message.name + '& record);\n'
+        yield '    /// Shred a serialized record into the columns without parsing it into a message.\n'
+        yield '    /// Records are checked first, so a malformed record leaves all columns as they were.\n'
+        yield '    void ShredSerialized(std::string_view bytes);\n'
+        yield '    /// Check a serialized record; returns false if a field that is not repeated occurs more than once.\n'
+        yield '    bool CheckSerialized(std::string_view bytes);\n'
+        yield '    /// Assemble the records of a range into the given messages, which have to be empty.\n'
+        yield '    void AssembleRange(uint64_t from_tid, uint64_t to_tid, const std::vector<const FieldDescriptor*>& fields, ' + message.name + '* const* records);\n'
+        yield '\n'
         for fields in flatten_fields(message):
             column_name = '_'.join([f.name for f in fields])
             containing_type = message.name + ('_' + column_name.rsplit('_', 1)[0] if len(fields) > 1 else '')
             yield '    ' + 'static inline const FieldDescriptor* ' + column_name + '_Descriptor = ' + containing_type + '::descriptor()->FindFieldByName("' + fields[len(fields) - 1].name + '");\n'
             yield '    ' + 'DremelColumn<' + cpp_type_name(fields[-1]) + '> ' + column_name + '_Column { ' + column_name + '_Descriptor };\n'
-            yield '    ' + 'std::vector<uint64_t> ' + column_name + '_Record_TIDs;'
-            yield '  // Maps the beginning of a record to a TID in the column.\n'
             yield '\n'
 
         complex_field_writers = {}
@@ -193,7 +726,13 @@ def generate_source(filedescriptorproto):
     yield '// Do not edit this file directly.\n'
     yield '// ---------------------------------------------------------------------------\n'
     yield '#include "./schema.h"\n'
+    yield '#include <fstream>\n'
+    yield '#include <memory>\n'
+    yield '#include <tbb/task_group.h>\n'
+    yield '#include "../../../include/imlab/dremel/json_shredding.h"\n'
+    yield '#include "../../../include/imlab/dremel/parquet.h"\n'
     yield '#include "../../../include/imlab/dremel/shredding.h"\n'
+    yield '#include "../../../include/imlab/dremel/wire_shredding.h"\n'
     yield '#include "../../../include/imlab/dremel/assembling.h"\n'
     yield '#include "../../../include/imlab/dremel/record_fsm.h"\n'
     yield '// ---------------------------------------------------------------------------\n'
@@ -213,13 +752,129 @@ def generate_source(filedescriptorproto):
         yield '}\n'
         yield '\n'
 
-        yield 'uint64_t ' + message.name + 'Table::insert(' + message.name + '& record) {\n'
-        yield '    // Before we insert records with DissectRecord, we need to remember the last indices in each column.\n'
-        yield '    // They will be the starting points of the fields of the dissected record.\n'
+        yield 'std::vector<RecordRange> ' + message.name + 'Table::morsels() {\n'
+        yield '    // The column with the most rows has the finest segments.\n'
+        yield '    uint64_t rows = std::max({ '
+        for fields in flatten_fields(message):
+            column_name = '_'.join([f.name for f in fields])
+            yield column_name + '_Column.size(), '
+        yield '});\n'
+        for fields in flatten_fields(message):
+            column_name = '_'.join([f.name for f in fields])
+            yield '    if (' + column_name + '_Column.size() == rows) return AlignMorsels(' + column_name + '_Column);\n'
+        yield '    return {};\n'
+        yield '}\n'
+        yield '\n'
+
+        yield 'std::vector<RecordRange> ' + message.name + 'Table::candidate_records(const RangePredicate& predicate) {\n'
         for fields in flatten_fields(message):
             column_name = '_'.join([f.name for f in fields])
-            yield '    ' + column_name + '_Record_TIDs.push_back(' + column_name + '_Column.size());\n'
+            yield '    if (predicate.field == ' + column_name + '_Descriptor) return CandidateRecords(' + column_name + '_Column, predicate);\n'
+        yield '    return { { 0, size() } };\n'
+        yield '}\n'
+        yield '\n'
+
+        yield 'void ' + message.name + 'Table::save(const std::string& path, const std::string& source) {\n'
+        yield '    std::ofstream out(path, std::ios::binary | std::ios::trunc);\n'
+        yield '    BinaryWriter writer { out };\n'
+        yield '    WriteHeader(writer, ' + message.name + '::descriptor(), source);\n'
+        for fields in flatten_fields(message):
+            column_name = '_'.join([f.name for f in fields])
+            yield '    ' + column_name + '_Column.write(writer);\n'
+        yield '    if (!out.flush()) {\n'
+        yield '        throw FileFormatError("cannot write " + path);\n'
+        yield '    }\n'
+        yield '}\n'
         yield '\n'
+
+        yield 'void ' + message.name + 'Table::open(const std::string& path, const std::string& source) {\n'
+        yield '    // A table whose columns were only partly replaced would be inconsistent, so it is emptied instead.\n'
+        yield '    try {\n'
+        yield '        BinaryReader reader { std::make_shared<const MappedFile>(path) };\n'
+        yield '        ReadHeader(reader, ' + message.name + '::descriptor(), source);\n'
+        for fields in flatten_fields(message):
+            column_name = '_'.join([f.name for f in fields])
+            yield '        ' + column_name + '_Column.read(reader);\n'
+        yield '        // Every record has at least one row in every column.\n'
+        yield '        if ('
+        yield '\n                || '.join('_'.join([f.name for f in fields]) + '_Column.record_count() != _size' for fields in flatten_fields(message))
+        yield ') {\n'
+        yield '            throw FileFormatError("the columns of " + path + " have different numbers of records");\n'
+        yield '        }\n'
+        yield '    } catch (...) {\n'
+        yield '        clear();\n'
+        yield '        throw;\n'
+        yield '    }\n'
+        yield '}\n'
+        yield '\n'
+
+        yield 'void ' + message.name + 'Table::clear() {\n'
+        yield '    _size = 0;\n'
+        for fields in flatten_fields(message):
+            column_name = '_'.join([f.name for f in fields])
+            yield '    ' + column_name + '_Column.clear();\n'
+        yield '}\n'
+        yield '\n'
+
+        yield 'void ' + message.name + 'Table::export_parquet(const std::string& path) {\n'
+        yield '    std::ofstream out(path, std::ios::binary | std::ios::trunc);\n'
+        yield '    ExportParquet(*this, ' + message.name + '::descriptor(), out);\n'
+        yield '}\n'
+        yield '\n'
+
+        yield 'void ' + message.name + 'Table::import_parquet(const std::string& path) {\n'
+        yield '    _size += ImportParquet(*this, path);\n'
+        yield '}\n'
+        yield '\n'
+
+        yield 'void ' + message.name + 'Table::load_json(std::istream& in) {\n'
+        yield '    _size += ShredJson(*this, ' + message.name + '::descriptor(), in);\n'
+        yield '}\n'
+        yield '\n'
+
+        yield 'void ' + message.name + 'Table::load_json_lines(std::istream& in, size_t chunk_size) {\n'
+        yield '    BulkLoad(*this, [&](std::string* chunk) { return ReadJsonLines(in, chunk, chunk_size); },\n'
+        yield '             [](' + message.name + 'Table& fragment, const std::string& chunk) {\n'
+        yield '                 fragment._size += ShredJsonLines(fragment, ' + message.name + '::descriptor(), chunk);\n'
+        yield '             });\n'
+        yield '}\n'
+        yield '\n'
+
+        yield 'void ' + message.name + 'Table::load_protobuf(std::string_view stream, size_t chunk_size) {\n'
+        yield '    BulkLoad<' + message.name + 'Table, std::string_view>(*this,\n'
+        yield '        [&](std::string_view* chunk) { return SplitDelimitedRecords(&stream, chunk, chunk_size); },\n'
+        yield '        [](' + message.name + 'Table& fragment, std::string_view chunk) {\n'
+        yield '            ForEachDelimitedRecord(chunk, [&](std::string_view record) { fragment.insert_serialized(record); });\n'
+        yield '        });\n'
+        yield '}\n'
+        yield '\n'
+
+        yield 'void ' + message.name + 'Table::load_protobuf_file(const std::string& path, size_t chunk_size) {\n'
+        yield '    MappedFile file { path };\n'
+        yield '    load_protobuf(std::string_view(file.data(), file.size()), chunk_size);\n'
+        yield '}\n'
+        yield '\n'
+
+        yield 'void ' + message.name + 'Table::append(' + message.name + 'Table& other) {\n'
+        yield '    tbb::task_group columns;\n'
+        for fields in flatten_fields(message):
+            column_name = '_'.join([f.name for f in fields])
+            yield '    columns.run([&] { ' + column_name + '_Column.append(other.' + column_name + '_Column); });\n'
+        yield '    columns.wait();\n'
+        yield '    _size += other.size();\n'
+        yield '    other.clear();\n'
+        yield '}\n'
+        yield '\n'
+
+        yield 'uint64_t ' + message.name + 'Table::insert(' + message.name + '& record) {\n'
+        yield '    Shred(record);\n'
+        yield '\n'
+        yield '    // Now the table contains one more record\n'
+        yield '    return _size++;\n'
+        yield '}\n'
+        yield '\n'
+
+        yield 'uint64_t ' + message.name + 'Table::insert_reflection(' + message.name + '& record) {\n'
         yield '    Shredder::DissectRecord(dynamic_cast<TableBase&>(*this), record);\n'
         yield '\n'
         yield '    // Now the table contains one more record\n'
@@ -227,7 +882,64 @@ def generate_source(filedescriptorproto):
         yield '}\n'
         yield '\n'
 
+        yield 'uint64_t ' + message.name + 'Table::insert_serialized(std::string_view bytes) {\n'
+        yield '    ShredSerialized(bytes);\n'
+        yield '\n'
+        yield '    // Now the table contains one more record\n'
+        yield '    return _size++;\n'
+        yield '}\n'
+        yield '\n'
+
+        yield 'void ' + message.name + 'Table::Shred(const ' + message.name + '& record) {\n'
+        for line in generate_shredder(message, filedescriptorproto.syntax):
+            yield line
+        yield '}\n'
+        yield '\n'
+
+        yield 'void ' + message.name + 'Table::ShredSerialized(std::string_view bytes) {\n'
+        for line in generate_wire_shredder(message):
+            yield line
+        yield '}\n'
+        yield '\n'
+
+        yield 'bool ' + message.name + 'Table::CheckSerialized(std::string_view bytes) {\n'
+        for line in generate_wire_shredder(message, check=True):
+            yield line
+        yield '}\n'
+        yield '\n'
+
+        yield 'void ' + message.name + 'Table::AssembleRange(uint64_t from_tid, uint64_t to_tid, const std::vector<const FieldDescriptor*>& fields, ' + message.name + '* const* records) {\n'
+        yield '    assert(from_tid >= 0 && from_tid <= to_tid && to_tid <= size());\n'
+        yield '    Cursor cursor { *this, fields, from_tid };\n'
+        yield '    for (uint64_t i = 0; i < to_tid - from_tid; i++) {\n'
+        yield '        cursor.AssembleNext(records[i]);\n'
+        yield '    }\n'
+        yield '}\n'
+        yield '\n'
+
+        for line in generate_cursor(message):
+            yield line
+        yield '\n'
+
         yield 'std::vector<' + message.name + '> ' + message.name + 'Table::get_range(uint64_t from_tid, uint64_t to_tid, const std::vector<const FieldDescriptor*>& fields) {\n'
+        yield '    std::vector<' + message.name + '> records(to_tid - from_tid);\n'
+        yield '    std::vector<' + message.name + '*> targets(records.size());\n'
+        yield '    for (size_t i = 0; i < records.size(); i++) {\n'
+        yield '        targets[i] = &records[i];\n'
+        yield '    }\n'
+        yield '    AssembleRange(from_tid, to_tid, fields, targets.data());\n'
+        yield '    return records;\n'
+        yield '}\n'
+        yield '\n'
+
+        yield 'RecordBatch<' + message.name + '> ' + message.name + 'Table::get_batch(uint64_t from_tid, uint64_t to_tid, const std::vector<const FieldDescriptor*>& fields) {\n'
+        yield '    RecordBatch<' + message.name + '> batch(to_tid - from_tid);\n'
+        yield '    AssembleRange(from_tid, to_tid, fields, batch.data());\n'
+        yield '    return batch;\n'
+        yield '}\n'
+        yield '\n'
+
+        yield 'std::vector<' + message.name + '> ' + message.name + 'Table::get_range_reflection(uint64_t from_tid, uint64_t to_tid, const std::vector<const FieldDescriptor*>& fields) {\n'
         yield '    assert(from_tid >= 0 && from_tid <= to_tid && to_tid <= size());\n'
         yield '    RecordFSM fsm {fields};\n'
         yield '\n'
@@ -235,7 +947,7 @@ def generate_source(filedescriptorproto):
         yield '\n'
         for fields in flatten_fields(message):
             column_name = '_'.join([f.name for f in fields])
-            yield '    uint64_t ' + column_name + '_index = ' + column_name + '_Record_TIDs[from_tid];\n'
+            yield '    uint64_t ' + column_name + '_index = ' + column_name + '_Column.record_start(from_tid);\n'
             yield '    FieldReader ' + column_name + '_Reader { &' + column_name + '_Column, ' + column_name + '_index };\n'
         yield '\n'
         yield '    for (auto& field : fields) {\n'
@@ -248,9 +960,9 @@ def generate_source(filedescriptorproto):
         yield '    }\n'
         yield '\n'
         yield '    RecordAssembler<' + message.name + '> assembler { fsm, readers };\n'
-        yield '    std::vector<' + message.name + '> records {};\n'
-        yield '    for (unsigned i = from_tid; i < to_tid; i++) {\n'
-        yield '        records.push_back(assembler.AssembleNextRecord());\n'
+        yield '    std::vector<' + message.name + '> records(to_tid - from_tid);\n'
+        yield '    for (auto& record : records) {\n'
+        yield '        assembler.AssembleNextRecord(&record);\n'
         yield '    }\n'
         yield '    return records;\n'
         yield '}\n'
@@ -34,6 +34,7 @@ namespace imlab {
 
 //#include "../../../tools/protobuf/gen/schema.h"
 #include "../../../include/database.h"
+#include "../../../include/imlab/dremel/field_reader.h"
 #include "../../../include/imlab/infra/hash.h"
 #include "../../../include/imlab/infra/hash_table.h"
 //#include "../../../include/imlab/schemac/schema_parse_context.h"
@@ -41,6 +42,9 @@ namespace imlab {
 #include <iostream>
 #include <iomanip>
 #include <mutex>
+#include <optional>
+#include <sstream>
+#include <string>
 #include <google/protobuf/descriptor.h>
 
 namespace imlab {
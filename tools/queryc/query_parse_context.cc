@@ -6,12 +6,14 @@
 #include <sstream>
 #include <set>
 #include <algorithm>
+#include <cctype>
 #include "imlab/infra/error.h"
 #include "imlab/schemac/schema_compiler.h"
 #include "imlab/algebra/table_scan.h"
 #include "imlab/algebra/print.h"
 #include "imlab/algebra/inner_join.h"
 #include "imlab/algebra/selection.h"
+#include "imlab/algebra/aggregation.h"
 // ---------------------------------------------------------------------------------------------------
 using namespace imlab;
 using namespace imlab::schemac;
@@ -49,10 +51,11 @@ void QueryParseContext::Error(uint32_t line, uint32_t column, const std::string
 }
 // ---------------------------------------------------------------------------------------------------
 // Define a table
-void QueryParseContext::CreateSqlQuery(const std::vector<std::string> &select_columns,
+void QueryParseContext::CreateSqlQuery(const std::vector<SelectItem> &select_items,
                                        const std::vector<std::string> &relations,
-                                       const std::vector<std::pair<std::string, std::string>> &where_predicates) {
-    if (select_columns.size() == 0) {
+                                       const std::vector<Condition> &where_predicates,
+                                       const std::vector<std::string> &group_by_columns) {
+    if (select_items.size() == 0) {
         throw QueryCompilationError("You need to provide at least one column name in the SELECT clause.");
     }
     if (relations.size() == 0) {
@@ -64,11 +67,14 @@ void QueryParseContext::CreateSqlQuery(const std::vector<std::string> &select_co
     std::vector<Selection> selections {};
     std::vector<InnerJoin> joins {};
     std::vector<const google::protobuf::FieldDescriptor*> columns_to_print {};
+    std::vector<Aggregate> aggregates {};
+    bool within_record = false;
+    std::vector<const google::protobuf::FieldDescriptor*> group_by {};
 
     // Helper structures that collect all the info we get during the processing step
     std::vector<Table*> involved_tables {};
     std::set<const google::protobuf::FieldDescriptor*> involved_ius {};
-    std::vector<std::pair<const google::protobuf::FieldDescriptor*, std::string>> selection_attr {};
+    std::vector<Predicate> selection_attr {};
     std::vector<std::pair<const google::protobuf::FieldDescriptor*, const google::protobuf::FieldDescriptor*>> join_attr {};
 
     // Get all the involved tables, e.g. resolve all strings after the "from ..." clause in the query.
@@ -93,42 +99,112 @@ void QueryParseContext::CreateSqlQuery(const std::vector<std::string> &select_co
     // The first set is just used for the print statement; the second set actually needs some processing afterwards.
 
     // Resolves a column name to an IU by searching all tables that are used for this query.
+    // Columns are the leaf fields of a table, named by their path with or without the table, e.g.
+    // Name.Language.Code or Document.Name.Language.Code. Like the keywords, names are case-insensitive.
+    auto equals_ignore_case = [](const std::string& a, const std::string& b) {
+        return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+            return std::tolower(static_cast<unsigned char>(x)) == std::tolower(static_cast<unsigned char>(y));
+        });
+    };
     auto find_iu_by_column = [&](const std::string& column) -> std::optional<const google::protobuf::FieldDescriptor*> {
         for (auto& s : scans) {
             const auto& ius = s.CollectFields();
-//TODO            auto it_iu = std::find_if(ius.begin(), ius.end(), [&](const auto& iu) { return std::string(iu->column) == column; });
-//TODO            if (it_iu != ius.end()) {
-//TODO                return *it_iu;
-//TODO            }
+            auto it_iu = std::find_if(ius.begin(), ius.end(), [&](const auto& iu) {
+                const auto& full_name = iu->full_name();
+                return equals_ignore_case(full_name, column)
+                    || equals_ignore_case(full_name.substr(full_name.find('.') + 1), column);
+            });
+            if (it_iu != ius.end()) {
+                return *it_iu;
+            }
         }
         return {};
     };
-    // Gather all the IUs from the "select..." clause.
-    for (auto& column : select_columns) {
-        auto iu = find_iu_by_column(column);
+    // Gather all the IUs from the "select..." clause, either printed as they are or aggregated.
+    for (auto& item : select_items) {
+        std::optional<const google::protobuf::FieldDescriptor*> iu {};
+        if (item.column == "*") {
+            iu = nullptr;
+        } else {
+            iu = find_iu_by_column(item.column);
+        }
         if (!iu) {
             std::stringstream ss {};
-            ss << "Column '" << column << "' not found.";
+            ss << "Column '" << item.column << "' not found.";
             throw QueryCompilationError(ss.str());
-        } else {
+        }
+        if (item.function.empty()) {
             involved_ius.insert(*iu);
             columns_to_print.push_back(*iu);
+            continue;
+        }
+
+        // AGGREGATES
+        static const std::pair<const char*, Aggregate::Function> functions[] = {
+            { "count", Aggregate::Function::kCount },
+            { "sum", Aggregate::Function::kSum },
+            { "min", Aggregate::Function::kMin },
+            { "max", Aggregate::Function::kMax },
+            { "avg", Aggregate::Function::kAvg },
+        };
+        auto it_f = std::find_if(std::begin(functions), std::end(functions), [&](const auto& f) {
+            return equals_ignore_case(f.first, item.function);
+        });
+        if (it_f == std::end(functions)) {
+            std::stringstream ss {};
+            ss << "Aggregate function '" << item.function << "' not found.";
+            throw QueryCompilationError(ss.str());
+        }
+        if (!aggregates.empty() && item.within_record != within_record) {
+            throw QueryCompilationError("Either all or none of the aggregates must be computed WITHIN RECORD.");
+        }
+        within_record = item.within_record;
+        if (*iu != nullptr) {
+            involved_ius.insert(*iu);
+        }
+        aggregates.push_back({it_f->second, *iu});
+    }
+    // Gather all IUs from the "group by..." clause.
+    // Every selected column must be grouped by, unless it is passed on with the aggregates of its record.
+    for (auto& column : group_by_columns) {
+        auto iu = find_iu_by_column(column);
+        if (!iu) {
+            std::stringstream ss {};
+            ss << "Column '" << column << "' not found.";
+            throw QueryCompilationError(ss.str());
+        }
+        involved_ius.insert(*iu);
+        group_by.push_back(*iu);
+    }
+    if (!group_by.empty() && within_record) {
+        throw QueryCompilationError("Aggregates WITHIN RECORD can't be grouped.");
+    }
+    if (!within_record && (!aggregates.empty() || !group_by.empty())) {
+        for (auto* iu : columns_to_print) {
+            if (std::find(group_by.begin(), group_by.end(), iu) == group_by.end()) {
+                std::stringstream ss {};
+                ss << "Column '" << iu->full_name() << "' must be grouped by or aggregated.";
+                throw QueryCompilationError(ss.str());
+            }
         }
     }
     // Gather all IUs from the predicates after the "where..."
-    for (auto& [column1, column2] : where_predicates) {
-        auto iu_1 = find_iu_by_column(column1);
+    for (auto& condition : where_predicates) {
+        auto iu_1 = find_iu_by_column(condition.column);
         if (iu_1) {
             involved_ius.insert(*iu_1);
         }
-        auto iu_2 = find_iu_by_column(column2);
+        std::optional<const google::protobuf::FieldDescriptor*> iu_2 {};
+        if (!condition.constant) {
+            iu_2 = find_iu_by_column(condition.value);
+        }
         if (iu_2) {
             involved_ius.insert(*iu_2);
         }
 
         // Now things get interesting:
         // - if we found IUs for both identifiers, we have a join
-        // - if we found an IU for just one of them, we have a selection -> we need to get the type
+        // - if we found an IU for just one of them, we have a selection -> the other identifier is a constant
 
         // JOIN
         if (iu_1 && iu_2) {
@@ -139,17 +215,30 @@ void QueryParseContext::CreateSqlQuery(const std::vector<std::string> &select_co
         // SELECTIONS
         if ((iu_1 && !iu_2) || (!iu_1 && iu_2)) {
             auto &select_iu = (iu_1) ? *iu_1 : *iu_2;
-            auto &select_value_raw = (iu_1) ? column2 : column1;
-            auto select_value =
-                    std::string(select_iu->cpp_type_name()) + "::castString(\"" + select_value_raw + "\", " +
-                    std::to_string(select_value_raw.length()) + ")";
-            selection_attr.emplace_back(select_iu, select_value);
+            auto &select_value = (iu_1) ? condition.value : condition.column;
+            Predicate::Type type = Predicate::Type::kEqual;
+            if (condition.comparison == "<>") {
+                type = Predicate::Type::kNotEqual;
+            } else if (condition.comparison == "<") {
+                type = Predicate::Type::kLess;
+            } else if (condition.comparison == ">") {
+                type = Predicate::Type::kGreater;
+            } else if (condition.comparison == "between") {
+                type = Predicate::Type::kBetween;
+            } else if (condition.comparison == "like") {
+                type = Predicate::Type::kLike;
+            }
+            selection_attr.emplace_back(select_iu, type, select_value, condition.upper);
             continue;
         }
 
         // If we got here, neither iu_1 nor iu_2 reference a valid IU.
         std::stringstream ss {};
-        ss << "Column '" << column1 << "' and '" << column2 << "' not found.";
+        if (condition.constant) {
+            ss << "Column '" << condition.column << "' not found.";
+        } else {
+            ss << "Column '" << condition.column << "' and '" << condition.value << "' not found.";
+        }
         throw QueryCompilationError(ss.str());
     }
 
@@ -161,11 +250,16 @@ void QueryParseContext::CreateSqlQuery(const std::vector<std::string> &select_co
         auto& scan = scans[i];
         auto& table = involved_tables[i];
 
-        std::vector<std::pair<const google::protobuf::FieldDescriptor*, std::string>> predicates {};
+        std::vector<Predicate> predicates {};
         for (auto& selection : selection_attr) {
-//TODO            if (table->id == std::string(selection.first->table)) {
-//TODO                predicates.push_back(selection);
-//TODO            }
+            // The table of a field is its root message.
+            const auto* message = selection.field()->containing_type();
+            while (message->containing_type() != nullptr) {
+                message = message->containing_type();
+            }
+            if (table->id == message->name()) {
+                predicates.push_back(selection);
+            }
         }
         Selection s(std::make_unique<TableScan>(scan), predicates);
         selections.push_back(std::move(s));
@@ -217,17 +311,23 @@ void QueryParseContext::CreateSqlQuery(const std::vector<std::string> &select_co
     }
 
     // The final statement of the query is a "print()".
-    // Take the uppermost join and print the requested columns of the result.
+    // Take the uppermost join and print the requested columns of the result (or their aggregates).
+    std::unique_ptr<Operator> root {};
     if (joins.size() == 0 && selections.size() == 1) {
-        Print print(std::make_unique<Selection>(std::move(selections[0])));
-        this->query.op = std::move(print);
+        root = std::make_unique<Selection>(std::move(selections[0]));
     } else if (joins.size() > 0) {
-        Print print(std::make_unique<InnerJoin>(std::move(joins[joins.size() - 1])));
-        this->query.op = std::move(print);
+        root = std::make_unique<InnerJoin>(std::move(joins[joins.size() - 1]));
     } else {
         // Strange query: multiple tables, but no joins...
         throw QueryCompilationError("Cross-products are not allowed.");
     }
+    if (within_record) {
+        root = std::make_unique<Aggregation>(std::move(root), aggregates, true, columns_to_print);
+    } else if (!aggregates.empty() || !group_by.empty()) {
+        // The groups are printed in the order of the "group by..." clause, followed by the aggregates.
+        root = std::make_unique<Aggregation>(std::move(root), aggregates, false, group_by);
+    }
+    this->query.op = Print(std::move(root));
 
     // We must call the Prepare function at the end because this internally connects
     // the query components with raw pointers. They should be stable, so no object
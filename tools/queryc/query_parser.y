@@ -48,32 +48,69 @@ imlab::queryc::QueryParser::symbol_type yylex(imlab::queryc::QueryParseContext&
 %token RCB              "right_curly_brackets"
 %token LPAR             "left_parentheses"
 %token RPAR             "right_parentheses"
+%token STAR             "star"
 %token EQUAL            "equal"
+%token NOT_EQUAL        "not_equal"
+%token LESS             "less"
+%token GREATER          "greater"
 %token QUOTE            "quote"
 %token SQUOTE           "squote"
 %token SELECT           "select"
 %token FROM             "from"
 %token WHERE            "where"
 %token AND              "and"
+%token BETWEEN          "between"
+%token LIKE             "like"
+%token WITHIN           "within"
+%token RECORD           "record"
+%token GROUP            "group"
+%token BY               "by"
 %token <std::string>    INTEGER_VALUE    "integer_value"
 %token <std::string>    IDENTIFIER       "identifier"
 %token <std::string>    STRING_VALUE     "string_value"
 %token EOF 0            "eof"
 // ---------------------------------------------------------------------------------------------------
+%type <std::vector<imlab::queryc::SelectItem>> select_list;
+%type <imlab::queryc::SelectItem> select_item;
 %type <std::vector<std::string>> identifier_list;
 %type <std::string> identifier;
-%type <std::vector<std::pair<std::string, std::string>>> condition_list;
-%type <std::pair<std::string, std::string>> condition;
+%type <std::vector<imlab::queryc::Condition>> where_clause;
+%type <std::vector<std::string>> group_by_clause;
+%type <std::vector<imlab::queryc::Condition>> condition_list;
+%type <imlab::queryc::Condition> condition;
+%type <std::string> constant;
 // ---------------------------------------------------------------------------------------------------
 %%
 
 %start sql_query;
 
 sql_query:
-    SELECT identifier_list FROM identifier_list                                 { sc.CreateSqlQuery($2, $4); }
- |  SELECT identifier_list FROM identifier_list SEMICOLON                       { sc.CreateSqlQuery($2, $4); }
- |  SELECT identifier_list FROM identifier_list WHERE condition_list            { sc.CreateSqlQuery($2, $4, $6); }
- |  SELECT identifier_list FROM identifier_list WHERE condition_list SEMICOLON  { sc.CreateSqlQuery($2, $4, $6); }
+    SELECT select_list FROM identifier_list where_clause group_by_clause             { sc.CreateSqlQuery($2, $4, $5, $6); }
+ |  SELECT select_list FROM identifier_list where_clause group_by_clause SEMICOLON   { sc.CreateSqlQuery($2, $4, $5, $6); }
+    ;
+
+where_clause:
+    WHERE condition_list                                { std::swap($$, $2); }
+ |  %empty                                              {}
+    ;
+
+group_by_clause:
+    GROUP BY identifier_list                            { std::swap($$, $3); }
+ |  %empty                                              {}
+    ;
+
+select_list:
+    select_list COMMA select_item                       { $1.push_back($3); std::swap($$, $1); }
+ |  select_item                                         { $$ = std::vector<imlab::queryc::SelectItem> { $1 }; }
+ |  %empty                                              {}
+    ;
+
+select_item:
+    identifier                                          { $$ = {$1}; }
+ |  IDENTIFIER LPAR identifier RPAR                     { $$ = {$3, $1}; }
+ |  IDENTIFIER LPAR identifier RPAR WITHIN RECORD       { $$ = {$3, $1, true}; }
+ |  IDENTIFIER LPAR STAR RPAR                           { $$ = {"*", $1}; }
+ |  IDENTIFIER LPAR STAR RPAR WITHIN RECORD             { $$ = {"*", $1, true}; }
     ;
 
 identifier_list:
@@ -89,14 +126,23 @@ identifier:
 
 condition_list:
     condition_list AND condition                        { $1.push_back($3); std::swap($$, $1); }
- |  condition                                           { $$ = std::vector<std::pair<std::string, std::string>> { $1 }; }
+ |  condition                                           { $$ = std::vector<imlab::queryc::Condition> { $1 }; }
  |  %empty                                              {}
     ;
 
 condition:
-    identifier EQUAL identifier                         { $$ = {$1, $3}; }
- |  identifier EQUAL STRING_VALUE                       { $$ = {$1, $3}; }
- |  identifier EQUAL INTEGER_VALUE                      { $$ = {$1, $3}; }
+    identifier EQUAL identifier                         { $$ = {$1, "=", $3, false}; }
+ |  identifier EQUAL constant                           { $$ = {$1, "=", $3}; }
+ |  identifier NOT_EQUAL constant                       { $$ = {$1, "<>", $3}; }
+ |  identifier LESS constant                            { $$ = {$1, "<", $3}; }
+ |  identifier GREATER constant                         { $$ = {$1, ">", $3}; }
+ |  identifier BETWEEN constant AND constant            { $$ = {$1, "between", $3, true, $5}; }
+ |  identifier LIKE STRING_VALUE                        { $$ = {$1, "like", $3}; }
+    ;
+
+constant:
+    STRING_VALUE                                        { $$ = $1; }
+ |  INTEGER_VALUE                                       { $$ = $1; }
     ;
 
 %%